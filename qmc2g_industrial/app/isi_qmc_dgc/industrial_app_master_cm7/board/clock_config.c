@@ -161,6 +161,7 @@ settings:
 - {id: CCM.CLOCK_ROOT12.MUX.sel, value: ANADIG_PLL.SYS_PLL3_DIV2_CLK}
 - {id: CCM.CLOCK_ROOT13.DIV.scale, value: '2', locked: true}
 - {id: CCM.CLOCK_ROOT13.MUX.sel, value: ANADIG_PLL.SYS_PLL3_DIV2_CLK}
+- {id: CCM.CLOCK_ROOT18.MUX.sel, value: ANADIG_OSC.OSC_24M}
 - {id: CCM.CLOCK_ROOT2.DIV.scale, value: '2', locked: true}
 - {id: CCM.CLOCK_ROOT2.MUX.sel, value: ANADIG_PLL.SYS_PLL3_CLK}
 - {id: CCM.CLOCK_ROOT25.DIV.scale, value: '3', locked: true}
@@ -500,8 +501,8 @@ void BOARD_BootClockOverDriveRUN(void)
     rootCfg.div = 1;
     CLOCK_SetRootClock(kCLOCK_Root_Gpt4, &rootCfg);
 
-    /* Configure GPT5 using OSC_RC_48M_DIV2 */
-    rootCfg.mux = kCLOCK_GPT5_ClockRoot_MuxOscRc48MDiv2;
+    /* Configure GPT5 using OSC_24M */
+    rootCfg.mux = kCLOCK_GPT5_ClockRoot_MuxOsc24MOut;
     rootCfg.div = 1;
     CLOCK_SetRootClock(kCLOCK_Root_Gpt5, &rootCfg);
 
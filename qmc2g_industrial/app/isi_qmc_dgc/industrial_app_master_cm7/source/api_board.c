@@ -13,13 +13,14 @@
 #include "api_rpc.h"
 #include "api_rpc_internal.h"
 #include "fsl_gpio.h"
+#include "fsl_gpt.h"
 #include "fsl_lpi2c.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 #include "board.h"
 #include "se_session.h"
 #include "main_cm7.h"
-
+#include "utils/testing.h"
 
 
 /*******************************************************************************
@@ -47,6 +48,27 @@
 
 #define PCT2075_I2C_ADDRESS		0x49		/* A2 = A1 = 0, A0 = 1 */
 
+#define GETTIME_GPT             GPT5        /* free-running 1 MHz counter backing BOARD_GetTime(), clocked from the 24 MHz crystal */
+#define GETTIME_GPT_CLK_ROOT    kCLOCK_Root_Gpt5
+#define GETTIME_COUNTER_HZ      (1000000U)
+#define GETTIME_RATE_FRAC_BITS  (32)        /* rate correction is a signed Q0.32 fraction */
+#define GETTIME_MAX_RATE        ((int64_t)BOARD_GETTIME_MAX_RATE_PPM * (1LL << GETTIME_RATE_FRAC_BITS) / 1000000LL)
+#define GETTIME_HOLDOVER_AGE_US (1UL << 31) /* anchor age at which the anchor is renewed without the RTC, half the counter wrap */
+
+/*!
+ * @brief Anchor relating the free-running counter to the wall-clock time.
+ *
+ * time = anchorUs + elapsed + elapsed * rate / 2^32, with elapsed = counter - anchorCount (modulo 2^32).
+ * The sequence number is odd while the anchor is being updated.
+ */
+typedef struct _board_time_sync
+{
+	uint32_t sequence;
+	uint32_t anchorCount;
+	uint64_t anchorUs;
+	int32_t  rate;
+} board_time_sync_t;
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -58,16 +80,14 @@ bool g_needsRefresh_getTime = false;
 void (*g_TimeChangedCallback)(void) = NULL;
 
 static bool              gs_isInitialized_getTime = false;
-static TimerHandle_t     gs_getTime_OverflowProtectionTimerHandle;
-static StaticTimer_t     gs_getTime_OverflowProtectionTimer;
 static SemaphoreHandle_t gs_getTimeMutexHandle;
 static StaticSemaphore_t gs_getTimeMutex;
 static SemaphoreHandle_t gs_getDevIdMutexHandle;
 static StaticSemaphore_t gs_getDevIdMutex;
 static SemaphoreHandle_t gs_SnvsAccessMutexHandle;
 static StaticSemaphore_t gs_SnvsAccessMutex;
-static qmc_timestamp_t   gs_getTimeOffset;
-static TickType_t        gs_getTimeLastRefresh;
+STATIC_TEST_VISIBLE volatile board_time_sync_t gs_getTimeSync; /* published with a sequence lock, see BOARD_GetTimeUs() */
+STATIC_TEST_VISIBLE int32_t gs_getTimeFrequency;          /* writer-only long-term frequency estimate (Q0.32) */
 
 extern SemaphoreHandle_t gSmComlock;
 extern double g_PSBTemps[8];
@@ -81,7 +101,10 @@ extern const header_t fw_hdr;
 
 static bool          isLeapYear(uint16_t year);
 static qmc_weekday_t computeDayOfWeek(const qmc_datetime_t *dt);
-static void getTime_OverflowProtectionTimerCallback(TimerHandle_t xTimer);
+static uint64_t      getTime_Project(const board_time_sync_t *sync, uint32_t count);
+static void          getTime_Publish(const board_time_sync_t *sync);
+STATIC_TEST_VISIBLE void getTime_Discipline(board_time_sync_t *sync, int32_t *frequency, uint32_t count, uint64_t rtcUs, bool forceStep);
+STATIC_TEST_VISIBLE void getTime_Holdover(board_time_sync_t *sync, int32_t frequency, uint32_t count);
 
 /*******************************************************************************
  * Code
@@ -96,21 +119,20 @@ qmc_status_t BOARD_Init()
     if( (NULL == gs_getTimeMutexHandle) || (NULL == gs_SnvsAccessMutexHandle) || (NULL == gs_getDevIdMutexHandle) )
     	return kStatus_QMC_Err;
 
-
-    /* initialize timer */
-	gs_getTime_OverflowProtectionTimerHandle = xTimerCreateStatic("getTime ovf.", /* one day before overflow */
-			                                                      UINT32_MAX - pdMS_TO_TICKS(SECONDS_PER_DAY * 1000),
-																  pdFALSE, NULL,
-																  getTime_OverflowProtectionTimerCallback,
-																  &gs_getTime_OverflowProtectionTimer);
-	if( NULL == gs_getTime_OverflowProtectionTimerHandle )
-	    return kStatus_QMC_Err;
-
-	/* get current time / tick count */
-	if(kStatus_QMC_Ok != RPC_GetTimeFromRTC(&gs_getTimeOffset))
+    /* start the free-running microsecond counter */
+    gpt_config_t gptConfig;
+    GPT_GetDefaultConfig(&gptConfig);
+    gptConfig.clockSource   = kGPT_ClockSource_Periph;
+    gptConfig.divider       = CLOCK_GetRootClockFreq(GETTIME_GPT_CLK_ROOT) / GETTIME_COUNTER_HZ;
+    gptConfig.enableFreeRun = true;
+    GPT_Init(GETTIME_GPT, &gptConfig);
+    GPT_StartTimer(GETTIME_GPT);
+
+	/* get current time and anchor it to the counter */
+	gs_getTimeFrequency = 0;
+	g_needsRefresh_getTime = true;
+	if(kStatus_QMC_Ok != BOARD_DisciplineTime())
 		return kStatus_QMC_Err;
-	gs_getTimeLastRefresh = xTaskGetTickCount();
-	xTimerStart(gs_getTime_OverflowProtectionTimerHandle, 0);
 
 	gs_isInitialized_getTime = true;
 
@@ -427,50 +449,114 @@ void BOARD_SetUserLed(qmc_led_cmd_t mode, qmc_led_id_t led)
 	}
 }
 
+qmc_status_t BOARD_GetTimeUs(uint64_t* microseconds)
+{
+	board_time_sync_t sync;
+	uint32_t seqBegin, seqEnd, count;
+
+	/* input sanitation and limit checks */
+	if(NULL == microseconds)
+	    return kStatus_QMC_ErrArgInvalid;
+	if(false == gs_isInitialized_getTime)
+		return kStatus_QMC_Err;
+
+	/* sequence lock read side: retry if the writer was active or published in between */
+	do
+	{
+		seqBegin = gs_getTimeSync.sequence;
+		__DMB();
+		sync.anchorCount = gs_getTimeSync.anchorCount;
+		sync.anchorUs    = gs_getTimeSync.anchorUs;
+		sync.rate        = gs_getTimeSync.rate;
+		/* the counter must be sampled inside the read section, so it is never older than the anchor */
+		count = GPT_GetCurrentTimerCount(GETTIME_GPT);
+		__DMB();
+		seqEnd = gs_getTimeSync.sequence;
+	} while((seqBegin != seqEnd) || (seqBegin & 1U));
+
+	*microseconds = getTime_Project(&sync, count);
+
+	return kStatus_QMC_Ok;
+}
+
 qmc_status_t BOARD_GetTime(qmc_timestamp_t* timestamp)
 {
-    TickType_t ticks;
+	uint64_t microseconds;
+	qmc_status_t retval;
 
 	/* input sanitation and limit checks */
 	if(NULL == timestamp)
 	    return kStatus_QMC_ErrArgInvalid;
-	if(false == gs_isInitialized_getTime)
+
+	retval = BOARD_GetTimeUs(&microseconds);
+	if(kStatus_QMC_Ok != retval)
+		return retval;
+
+	timestamp->seconds      = microseconds / 1000000U;
+	timestamp->milliseconds = (microseconds % 1000000U) / 1000U;
+
+	return kStatus_QMC_Ok;
+}
+
+qmc_status_t BOARD_DisciplineTime(void)
+{
+	static uint32_t   lastDisciplineCount = 0;
+	board_time_sync_t sync;
+	qmc_timestamp_t   rtcTime;
+	uint32_t          countBefore, countAfter;
+	bool              forceStep;
+
+	if(NULL == gs_getTimeMutexHandle)
 		return kStatus_QMC_Err;
 
-	/* take mutex */
+	/* nothing to do until the refresh interval elapsed, unless a refresh is requested */
+	countBefore = GPT_GetCurrentTimerCount(GETTIME_GPT);
+	if(!g_needsRefresh_getTime && gs_isInitialized_getTime &&
+	   ((countBefore - lastDisciplineCount) < (BOARD_GETTIME_REFRESH_INTERVAL_S * GETTIME_COUNTER_HZ)))
+		return kStatus_QMC_Ok;
+
+	/* serialize writers, readers never take this mutex */
 	xSemaphoreTake(gs_getTimeMutexHandle, portMAX_DELAY);
 
-	/* get current ticks count */
-	ticks = xTaskGetTickCount();
+	forceStep = g_needsRefresh_getTime;
+	g_needsRefresh_getTime = false;
 
-	/* refresh gs_getTimeOffset */
-    if((((ticks-gs_getTimeLastRefresh)/configTICK_RATE_HZ) > BOARD_GETTIME_REFRESH_INTERVAL_S) || g_needsRefresh_getTime )
-    {
-		if(kStatus_QMC_Ok != RPC_GetTimeFromRTC(&gs_getTimeOffset))
+	countBefore = GPT_GetCurrentTimerCount(GETTIME_GPT);
+	if(kStatus_QMC_Ok != RPC_GetTimeFromRTC(&rtcTime))
+	{
+		/* try again with the next call; if the RTC stays unavailable, renew the anchor from the counter
+		 * before the counter difference wraps after 2^32 microseconds */
+		countAfter = GPT_GetCurrentTimerCount(GETTIME_GPT);
+		if(gs_isInitialized_getTime && ((countAfter - gs_getTimeSync.anchorCount) >= GETTIME_HOLDOVER_AGE_US))
 		{
-			xSemaphoreGive(gs_getTimeMutexHandle);
-			return kStatus_QMC_Err;
+			sync.sequence    = gs_getTimeSync.sequence;
+			sync.anchorCount = gs_getTimeSync.anchorCount;
+			sync.anchorUs    = gs_getTimeSync.anchorUs;
+			sync.rate        = gs_getTimeSync.rate;
+			getTime_Holdover(&sync, gs_getTimeFrequency, countAfter);
+			getTime_Publish(&sync);
 		}
-		gs_getTimeLastRefresh   = xTaskGetTickCount();
-		ticks                   = gs_getTimeLastRefresh;
-		g_needsRefresh_getTime  = false;
-		xTimerReset(gs_getTime_OverflowProtectionTimerHandle, 0);
-    }
 
-    /* compute current time */
-    *timestamp               = gs_getTimeOffset;
-    timestamp->seconds      += (ticks-gs_getTimeLastRefresh) / configTICK_RATE_HZ;
-    timestamp->milliseconds += ((ticks-gs_getTimeLastRefresh) % configTICK_RATE_HZ) * 1000 / configTICK_RATE_HZ;
-    if(timestamp->milliseconds >= 1000) /* handle milliseconds overflow */
-    {
-    	timestamp->milliseconds -= 1000;
-    	timestamp->seconds++;
-    }
+		g_needsRefresh_getTime = forceStep;
+		xSemaphoreGive(gs_getTimeMutexHandle);
+		return kStatus_QMC_Err;
+	}
+	countAfter = GPT_GetCurrentTimerCount(GETTIME_GPT);
 
-    /* return mutex */
-    xSemaphoreGive(gs_getTimeMutexHandle);
+	/* the RTC was sampled somewhere within the round trip, assume the middle;
+	 * the RTC value is truncated to milliseconds, so add half a millisecond */
+	sync.sequence    = gs_getTimeSync.sequence;
+	sync.anchorCount = gs_getTimeSync.anchorCount;
+	sync.anchorUs    = gs_getTimeSync.anchorUs;
+	sync.rate        = gs_getTimeSync.rate;
+	getTime_Discipline(&sync, &gs_getTimeFrequency, countBefore + ((countAfter - countBefore) >> 1),
+			           (rtcTime.seconds * 1000000U) + (rtcTime.milliseconds * 1000U) + 500U, forceStep);
+	getTime_Publish(&sync);
+	lastDisciplineCount = countAfter;
 
-    return kStatus_QMC_Ok;
+	xSemaphoreGive(gs_getTimeMutexHandle);
+
+	return kStatus_QMC_Ok;
 }
 
 void BOARD_SetTimeChangedCallback(void (*callback)(void))
@@ -869,7 +955,104 @@ static qmc_weekday_t computeDayOfWeek(const qmc_datetime_t *dt)
 	return (year + LEAP_YEARS_SINCE_YEAR(year) + gs_modularDaysInYearPerMonth[dt->month-1] + dt->day) % 7;
 }
 
-static void getTime_OverflowProtectionTimerCallback(TimerHandle_t xTimer)
+/*!
+ * @brief Convert a counter value to microseconds since the epoch using the given anchor.
+ *
+ * The counter difference is taken modulo 2^32, so the anchor must be refreshed at least every
+ * 2^32 microseconds (about 71 minutes), see BOARD_GETTIME_REFRESH_INTERVAL_S.
+ */
+static uint64_t getTime_Project(const board_time_sync_t *sync, uint32_t count)
+{
+	uint32_t elapsed = count - sync->anchorCount;
+
+	return sync->anchorUs + elapsed + (((int64_t)elapsed * sync->rate) >> GETTIME_RATE_FRAC_BITS);
+}
+
+/*!
+ * @brief Sequence lock write side. Must be called with gs_getTimeMutexHandle taken.
+ *
+ * The update is done in a critical section, so a reader can not preempt the writer and spin on an odd sequence.
+ */
+static void getTime_Publish(const board_time_sync_t *sync)
 {
-	g_needsRefresh_getTime = true;
+	taskENTER_CRITICAL();
+	gs_getTimeSync.sequence++;
+	__DMB();
+	gs_getTimeSync.anchorCount = sync->anchorCount;
+	gs_getTimeSync.anchorUs    = sync->anchorUs;
+	gs_getTimeSync.rate        = sync->rate;
+	__DMB();
+	gs_getTimeSync.sequence++;
+	taskEXIT_CRITICAL();
+}
+
+/*!
+ * @brief Discipline the counter-based time against an RTC measurement.
+ *
+ * The difference between the RTC and the local time is not applied as a step but slewed out over the next
+ * refresh interval, so the local time stays monotonic. A fraction of the error is also integrated into a
+ * long-term frequency estimate, which compensates the drift of the counter's crystal against the RTC. The
+ * resulting rate is limited to +/- BOARD_GETTIME_MAX_RATE_PPM.
+ * The time is stepped on the first measurement, after the RTC was set (forceStep) or if the error
+ * exceeds BOARD_GETTIME_STEP_THRESHOLD_MS.
+ *
+ * @param[in,out] sync Anchor to update, the new anchor is placed at count
+ * @param[in,out] frequency Long-term frequency estimate in Q0.32
+ * @param[in] count Counter value at which the RTC was sampled
+ * @param[in] rtcUs RTC time in microseconds since the epoch
+ * @param[in] forceStep Set the time to the RTC time instead of slewing
+ */
+STATIC_TEST_VISIBLE void getTime_Discipline(board_time_sync_t *sync, int32_t *frequency, uint32_t count, uint64_t rtcUs, bool forceStep)
+{
+	uint64_t localUs  = getTime_Project(sync, count);
+	int64_t  errorUs  = (int64_t)(rtcUs - localUs);
+	uint32_t interval = count - sync->anchorCount;
+	int64_t  rate;
+
+	if(forceStep || (0U == interval) || (errorUs > (BOARD_GETTIME_STEP_THRESHOLD_MS * 1000LL)) ||
+	   (errorUs < -(BOARD_GETTIME_STEP_THRESHOLD_MS * 1000LL)))
+	{
+		sync->anchorCount = count;
+		sync->anchorUs    = rtcUs;
+		sync->rate        = *frequency;
+		return;
+	}
+
+	/* integrate a quarter of the observed frequency error */
+	rate = *frequency + (((errorUs * (1LL << GETTIME_RATE_FRAC_BITS)) / interval) >> 2);
+	if(rate > GETTIME_MAX_RATE)
+		rate = GETTIME_MAX_RATE;
+	if(rate < -GETTIME_MAX_RATE)
+		rate = -GETTIME_MAX_RATE;
+	*frequency = (int32_t)rate;
+
+	/* slew the remaining phase error out over the next interval */
+	rate += (errorUs * (1LL << GETTIME_RATE_FRAC_BITS)) / ((int64_t)BOARD_GETTIME_REFRESH_INTERVAL_S * GETTIME_COUNTER_HZ);
+	if(rate > GETTIME_MAX_RATE)
+		rate = GETTIME_MAX_RATE;
+	if(rate < -GETTIME_MAX_RATE)
+		rate = -GETTIME_MAX_RATE;
+
+	/* re-anchor at the current local time, so the published time is continuous */
+	sync->anchorCount = count;
+	sync->anchorUs    = localUs;
+	sync->rate        = (int32_t)rate;
+}
+
+/*!
+ * @brief Renew the anchor without an RTC measurement.
+ *
+ * Used while the RTC can not be read, so the anchor never gets older than the counter wrap. The time stays
+ * continuous; the phase slew of the last discipline is dropped and the counter runs on with the long-term
+ * frequency estimate until the RTC is available again.
+ *
+ * @param[in,out] sync Anchor to update, the new anchor is placed at count
+ * @param[in] frequency Long-term frequency estimate in Q0.32
+ * @param[in] count Current counter value
+ */
+STATIC_TEST_VISIBLE void getTime_Holdover(board_time_sync_t *sync, int32_t frequency, uint32_t count)
+{
+	sync->anchorUs    = getTime_Project(sync, count);
+	sync->anchorCount = count;
+	sync->rate        = frequency;
 }
@@ -87,14 +87,35 @@ qmc_status_t BOARD_ConvertTimestamp2Datetime(const qmc_timestamp_t* timestamp, q
 qmc_status_t BOARD_ConvertDatetime2Timestamp(const qmc_datetime_t* dt, qmc_timestamp_t* timestamp);
 
  /*!
- * @brief Get a timestamp derived from the internal systick counter.
+ * @brief Get a timestamp derived from a free-running hardware counter.
  *
- * The function shall add the offset to the wall-clock time retrieved by BOARD_GetTimeFromRTCSync(timestamp : qmc_timestamp_t*) : qmc_status_t during system start-up.
+ * Millisecond view of BOARD_GetTimeUs(). Lock-free, never blocks and never issues an RPC.
  *
  * @param[out] timestamp Pointer to write the retrieved timestamp to
  */
 qmc_status_t BOARD_GetTime(qmc_timestamp_t* timestamp);
 
+ /*!
+ * @brief Get the time in microseconds since the epoch (01.01.1970 00:00:00 UT).
+ *
+ * The time is derived from a free-running 1 MHz GPT counter, which is disciplined against the SNVS RTC by
+ * BOARD_DisciplineTime(). Drift is slewed out, so the time is monotonic unless the RTC is set.
+ * Lock-free (sequence lock), never blocks and never issues an RPC. Must not be called from interrupts
+ * with a priority above configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ *
+ * @param[out] microseconds Pointer to write the retrieved time to
+ */
+qmc_status_t BOARD_GetTimeUs(uint64_t* microseconds);
+
+ /*!
+ * @brief Discipline the counter-based time against the SNVS RTC.
+ *
+ * Must be called periodically from task context (done by the Board Service task). Returns immediately
+ * unless BOARD_GETTIME_REFRESH_INTERVAL_S elapsed or the RTC was set in the meantime, in which case the
+ * RTC is read via RPC and the rate correction of BOARD_GetTimeUs() is updated.
+ */
+qmc_status_t BOARD_DisciplineTime(void);
+
 /*!
 * @brief Set a callback function that shall be called whenever RPC_SetTimeToRTC(timestamp : qmc_timestamp_t*) : qmc_status_t successfully changed the system time
 *
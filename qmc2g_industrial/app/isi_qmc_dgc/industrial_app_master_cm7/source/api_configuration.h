@@ -43,6 +43,11 @@ typedef enum _config_id
 	kCONFIG_Key_CloudGenericDeviceName = 0x10U,
 	kCONFIG_Key_CloudGenericPort = 0x11U,
 
+    kCONFIG_Key_M1CtrlTuning      = 0x20U, /*!< Identified or configured controller gains and speed gain schedule of motor 1 (mc_ctrl_tuning_t) */
+    kCONFIG_Key_M2CtrlTuning      = 0x21U,
+    kCONFIG_Key_M3CtrlTuning      = 0x22U,
+    kCONFIG_Key_M4CtrlTuning      = 0x23U,
+
     kCONFIG_Key_MOTD              = 0x70U, /*!< System Usage Message */
     kCONFIG_Key_User1              = 0x80U, /*!< first user config */
     kCONFIG_Key_User2              = 0x81U, 
@@ -71,6 +76,7 @@ typedef enum _config_id
 #define kCONFIG_Key_UserLast  kCONFIG_Key_User10
 #define kCONFIG_Key_UserHashesFirst kCONFIG_Key_UserHashes1
 #define kCONFIG_Key_UserHashesLast  kCONFIG_Key_UserHashes10
+#define kCONFIG_Key_CtrlTuningFirst kCONFIG_Key_M1CtrlTuning
 
 /*******************************************************************************
  * API
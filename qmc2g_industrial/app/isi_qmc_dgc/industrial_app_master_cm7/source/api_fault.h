@@ -224,7 +224,7 @@ __attribute__((always_inline)) static inline mc_fault_t FAULT_GetMotorFault_from
 	/* input sanitation and limit checks */
     if(IS_MOTORID_INVALID(motorId))
         return kMC_NoFaultMC;
-    return g_p.sStatus[motorId].sFast.eFaultStatus;
+    return g_p.sStatusFast[motorId][MC_SHM_SEQ_IDX(g_p.ui32StatusSeqFast[motorId])].eFaultStatus;
 }
 
 #endif /* _API_FAULT_H_ */
@@ -14,17 +14,13 @@
 #include "mc_common.h"
 #include "semphr.h"
 
+#include <math.h>
+
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 
-#define WRITE_PARAMETER_WITH_CHECK(x, y, f) { \
-    (x) = (y);                                \
-	if(false == (f))                          \
-		return kStatus_QMC_ErrInterrupted;    \
-}
-
 #define IS_MOTORID_INVALID(x) \
 		(((x) < kMC_Motor1) || ((x) >= (MC_MAX_MOTORS)))
 
@@ -35,12 +31,12 @@
  ******************************************************************************/
 
 extern bool                   g_isInitialized_DataHub; /* indicates that the DataHub task initialized the message queues for motor commands and status values */
-extern uint32_t               g_motorStatusQueuePrescalers[DATAHUB_MAX_STATUS_QUEUES];
-extern uint32_t               g_motorStatusQueuePrescalerCounters[DATAHUB_MAX_STATUS_QUEUES];
 extern QueueHandle_t          g_motorCommandQueue;
-extern QueueHandle_t          g_motorStatusQueues[DATAHUB_MAX_STATUS_QUEUES];
+extern mc_status_ring_t       g_motorStatusRing;
+extern mc_status_reader_t     g_motorStatusReaders[DATAHUB_MAX_STATUS_QUEUES];
 extern qmc_msg_queue_handle_t g_motorStatusQueueHandles[DATAHUB_MAX_STATUS_QUEUES];
-extern const EventBits_t      g_motorCommandQueueEventBit;
+extern const uint32_t         g_motorCommandQueueNotifyBit;
+extern TaskHandle_t           g_datahub_task_handle;
 extern EventGroupHandle_t     g_motorQueueEventGroupHandle;
 extern TimerHandle_t          g_statusSamplingTimerHandle;
 extern SemaphoreHandle_t      g_statusQueueMutexHandle;
@@ -56,17 +52,19 @@ extern mc_fault_t             g_psbFaults[MC_MAX_MOTORS];
 mc_control_shm g_p = {
 		.bIsTsnCommandInjectionOn	 = { 0 },
 		.ui16MotorFaultConfiguration = 0,
-		.sCommands                   = { {kMC_Motor1, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
+		.sCommands                   = { {{kMC_Motor1, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}, {kMC_Motor1, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}},
 #if (MC_MAX_MOTORS > 1)
-										 {kMC_Motor2, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
+										 {{kMC_Motor2, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}, {kMC_Motor2, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}},
 #endif
 #if (MC_MAX_MOTORS > 2)
-										 {kMC_Motor3, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
+										 {{kMC_Motor3, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}, {kMC_Motor3, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}},
 #endif
 #if (MC_MAX_MOTORS > 3)
-										 {kMC_Motor4, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
+										 {{kMC_Motor4, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}, {kMC_Motor4, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}}},
 #endif
 										},
+		.ui32CommandSeq              = { 0 },
+		.ui32CommandSeqTaken         = { 0 },
 		.sCommands_int               = { {kMC_Motor1, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
 #if (MC_MAX_MOTORS > 1)
 										 {kMC_Motor2, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
@@ -78,30 +76,72 @@ mc_control_shm g_p = {
 										 {kMC_Motor4, kMC_App_Off, kMC_FOC_SpeedControl, {.fltSpeed = 0.0f}},
 #endif
 		},
-		.bWriteInProgress            = { 0 },
-		.bReadInProgress_fast        = { 0 },
-		.bReadInProgress_slow        = { 0 },
 		.bIsFrozen					 = { 0 },
-		.sStatus                     = { {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}, kMC_Motor1},
+		.sCtrlTuning                 = { { 0 } },
+		.bCtrlTuningReadInProgress   = { 0 },
+		.sCtrlTuningReq              = { { 0 } },
+		.bCtrlTuningReqPending       = { 0 },
+		.sStatusFast                 = { {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}},
 #if (MC_MAX_MOTORS > 1)
-										 {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}, kMC_Motor2},
+										 {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}},
 #endif
 #if (MC_MAX_MOTORS > 2)
-										 {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}, kMC_Motor3},
+										 {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}},
 #endif
 #if (MC_MAX_MOTORS > 3)
-										 {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}, kMC_Motor4},
+										 {{kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, {kMC_Init, kMC_NoFaultMC, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}},
 #endif
-		}
+		},
+		.sStatusSlow                 = { {{kMC_App_Off, 0.0f, {.i32Raw = 0}}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}},
+#if (MC_MAX_MOTORS > 1)
+										 {{kMC_App_Off, 0.0f, {.i32Raw = 0}}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}},
+#endif
+#if (MC_MAX_MOTORS > 2)
+										 {{kMC_App_Off, 0.0f, {.i32Raw = 0}}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}},
+#endif
+#if (MC_MAX_MOTORS > 3)
+										 {{kMC_App_Off, 0.0f, {.i32Raw = 0}}, {kMC_App_Off, 0.0f, {.i32Raw = 0}}},
+#endif
+		},
+		.ui32StatusSeqFast           = { 0 },
+		.ui32StatusSeqSlow           = { 0 }
 };
 
 static bool gs_isStatusSamplingTimerStarted = false;
 
+/* Upper limits of the controller gains, MC_LIMIT_CTRL_TUNING_GAIN_RANGE times the gains of the Mx_pmsm_appconfig.h headers */
+static const mc_ctrl_tuning_t gs_ctrlTuningMax[MC_MAX_MOTORS] = {
+		{ .fltDKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M1_D_KP_GAIN, .fltDKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M1_D_KI_GAIN,
+		  .fltQKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M1_Q_KP_GAIN, .fltQKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M1_Q_KI_GAIN,
+		  .fltSpeedPGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M1_SPEED_PI_PROP_GAIN, .fltSpeedIGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M1_SPEED_PI_INTEG_GAIN },
+#if (MC_MAX_MOTORS > 1)
+		{ .fltDKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M2_D_KP_GAIN, .fltDKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M2_D_KI_GAIN,
+		  .fltQKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M2_Q_KP_GAIN, .fltQKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M2_Q_KI_GAIN,
+		  .fltSpeedPGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M2_SPEED_PI_PROP_GAIN, .fltSpeedIGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M2_SPEED_PI_INTEG_GAIN },
+#endif
+#if (MC_MAX_MOTORS > 2)
+		{ .fltDKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M3_D_KP_GAIN, .fltDKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M3_D_KI_GAIN,
+		  .fltQKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M3_Q_KP_GAIN, .fltQKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M3_Q_KI_GAIN,
+		  .fltSpeedPGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M3_SPEED_PI_PROP_GAIN, .fltSpeedIGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M3_SPEED_PI_INTEG_GAIN },
+#endif
+#if (MC_MAX_MOTORS > 3)
+		{ .fltDKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M4_D_KP_GAIN, .fltDKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M4_D_KI_GAIN,
+		  .fltQKpGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M4_Q_KP_GAIN, .fltQKiGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M4_Q_KI_GAIN,
+		  .fltSpeedPGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M4_SPEED_PI_PROP_GAIN, .fltSpeedIGain = MC_LIMIT_CTRL_TUNING_GAIN_RANGE * M4_SPEED_PI_INTEG_GAIN },
+#endif
+};
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
 
+static void publishMotorCommand(mc_motor_id_t motorId, const mc_motor_command_t* cmd);
+static mc_status_reader_t* getStatusReader(const qmc_msg_queue_handle_t* handle);
+static inline void getFastMotorStatus(mc_motor_id_t motorId, mc_motor_status_fast_t* status);
+static inline void getSlowMotorStatus(mc_motor_id_t motorId, mc_motor_status_slow_t* status);
 static bool isMotorCommandInRange(const mc_motor_command_t* cmd);
+static bool isControllerTuningInRange(mc_motor_id_t motorId, const mc_ctrl_tuning_t* tuning);
+static bool isGainInRange(float fltGain, float fltMax, bool isZeroAllowed);
 
 
 
@@ -125,46 +165,51 @@ qmc_status_t MC_SetMotorCommand(const mc_motor_command_t* cmd)
 	{
 		 g_p.bIsFrozen[cmd->eMotorId] = true;
 	}
-	else if (cmd->eAppSwitch == kMC_App_FreezeAndStop)
+	else
 	{
-		g_p.bIsFrozen[cmd->eMotorId] = true;
+		mc_motor_command_t sCmd;
+		qmc_status_t retval = kStatus_QMC_Ok;
 
-		/* lock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = true;
+		/* the TSN task also publishes commands; keep the mailbox single-producer */
+		taskENTER_CRITICAL();
 
-		/* copy parameters */
-		WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].eAppSwitch, kMC_App_Off, g_p.bWriteInProgress[cmd->eMotorId]);
+		/* start from the last published command, so that unused parameters are kept */
+		sCmd = g_p.sCommands[cmd->eMotorId][MC_SHM_SEQ_IDX(g_p.ui32CommandSeq[cmd->eMotorId])];
 
-		/* unlock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = false;
-	}
-	else
-	{
-		/* lock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = true;
-
-		/* copy parameters */
-		WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].eAppSwitch, cmd->eAppSwitch, g_p.bWriteInProgress[cmd->eMotorId]);
-		WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].eControlMethodSel, cmd->eControlMethodSel, g_p.bWriteInProgress[cmd->eMotorId]);
-		switch(cmd->eControlMethodSel){
-		case kMC_ScalarControl:
-			WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].uSpeed_pos.sScalarParam.fltScalarControlFrequency, cmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency, g_p.bWriteInProgress[cmd->eMotorId]);
-			WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].uSpeed_pos.sScalarParam.fltScalarControlVHzGain, cmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain, g_p.bWriteInProgress[cmd->eMotorId]);
-			break;
-		case kMC_FOC_SpeedControl:
-			WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].uSpeed_pos.fltSpeed, cmd->uSpeed_pos.fltSpeed, g_p.bWriteInProgress[cmd->eMotorId]);
-			break;
-		case kMC_FOC_PositionControl:
-			WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].uSpeed_pos.sPosParam.uPosition.i32Raw, cmd->uSpeed_pos.sPosParam.uPosition.i32Raw, g_p.bWriteInProgress[cmd->eMotorId]);
-			WRITE_PARAMETER_WITH_CHECK(g_p.sCommands[cmd->eMotorId].uSpeed_pos.sPosParam.bIsRandomPosition, cmd->uSpeed_pos.sPosParam.bIsRandomPosition, g_p.bWriteInProgress[cmd->eMotorId]);
-			break;
-		default:
-			g_p.bWriteInProgress[cmd->eMotorId] = false; /* unlock memory */
-			return kStatus_QMC_ErrRange;
+		if (cmd->eAppSwitch == kMC_App_FreezeAndStop)
+		{
+			g_p.bIsFrozen[cmd->eMotorId] = true;
+			sCmd.eAppSwitch = kMC_App_Off;
+		}
+		else
+		{
+			sCmd.eAppSwitch = cmd->eAppSwitch;
+			sCmd.eControlMethodSel = cmd->eControlMethodSel;
+			switch(cmd->eControlMethodSel){
+			case kMC_ScalarControl:
+				sCmd.uSpeed_pos.sScalarParam.fltScalarControlFrequency = cmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency;
+				sCmd.uSpeed_pos.sScalarParam.fltScalarControlVHzGain = cmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain;
+				break;
+			case kMC_FOC_SpeedControl:
+				sCmd.uSpeed_pos.fltSpeed = cmd->uSpeed_pos.fltSpeed;
+				break;
+			case kMC_FOC_PositionControl:
+				sCmd.uSpeed_pos.sPosParam.uPosition.i32Raw = cmd->uSpeed_pos.sPosParam.uPosition.i32Raw;
+				sCmd.uSpeed_pos.sPosParam.bIsRandomPosition = cmd->uSpeed_pos.sPosParam.bIsRandomPosition;
+				break;
+			default:
+				retval = kStatus_QMC_ErrRange;
+				break;
+			}
 		}
 
-		/* unlock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = false;
+		/* the whole command becomes visible to the Slow Motor Control Loop at once */
+		if(kStatus_QMC_Ok == retval)
+			publishMotorCommand(cmd->eMotorId, &sCmd);
+
+		taskEXIT_CRITICAL();
+
+		return retval;
 	}
 
 	return kStatus_QMC_Ok;
@@ -178,16 +223,10 @@ void MC_GetMotorStatus(mc_motor_id_t motorId, mc_motor_status_t* status)
 	if(IS_MOTORID_INVALID(motorId))
 		return;
 
-	/* lock memory */
-	g_p.bReadInProgress_slow[motorId] = true;
-	g_p.bReadInProgress_fast[motorId] = true;
-
-	/* copy status values */
-	*status = g_p.sStatus[motorId];
-
-	/* unlock memory */
-	g_p.bReadInProgress_fast[motorId] = false;
-	g_p.bReadInProgress_slow[motorId] = false;
+	/* copy status values, the motor control loops are not blocked */
+	getFastMotorStatus(motorId, &status->sFast);
+	getSlowMotorStatus(motorId, &status->sSlow);
+	status->eMotorId = motorId;
 }
 
 RAM_FUNC_CRITICAL void MC_SetFastMotorStatus_fromISR(mc_motor_id_t motorId, const mc_motor_status_fast_t* status)
@@ -228,13 +267,19 @@ RAM_FUNC_CRITICAL void MC_SetFastMotorStatus_fromISR(mc_motor_id_t motorId, cons
 	}
     #endif
 
-	/* copy status values */
-	if(!g_p.bReadInProgress_fast[motorId])
+	/* publish status values to the spare buffer; readers retry instead of blocking the update */
 	{
-	    g_p.sStatus[motorId].sFast = *status;
+	    uint32_t seq = g_p.ui32StatusSeqFast[motorId];
+	    volatile mc_motor_status_fast_t* psBuf = &(g_p.sStatusFast[motorId][MC_SHM_SEQ_IDX(seq) ^ 1U]);
+
+	    g_p.ui32StatusSeqFast[motorId] = seq + 1U;
+	    __DMB();
+	    *psBuf = *status;
         #if FEATURE_MC_PSB_TEMPERATURE_FAULTS
-            g_p.sStatus[motorId].sFast.eFaultStatus |= g_psbFaults[motorId] & (kMC_PsbOverTemperature1 | kMC_PsbOverTemperature2 | kMC_GD3000_OverTemperature | kMC_GD3000_Desaturation | kMC_GD3000_LowVLS | kMC_GD3000_OverCurrent |	kMC_GD3000_PhaseError |	kMC_GD3000_Reset);
+            psBuf->eFaultStatus |= g_psbFaults[motorId] & (kMC_PsbOverTemperature1 | kMC_PsbOverTemperature2 | kMC_GD3000_OverTemperature | kMC_GD3000_Desaturation | kMC_GD3000_LowVLS | kMC_GD3000_OverCurrent |	kMC_GD3000_PhaseError |	kMC_GD3000_Reset);
         #endif
+	    __DMB();
+	    g_p.ui32StatusSeqFast[motorId] = seq + 2U;
 	}
 	return;
 }
@@ -247,9 +292,16 @@ RAM_FUNC_CRITICAL void MC_SetSlowMotorStatus_fromISR(mc_motor_id_t motorId, cons
 	if(IS_MOTORID_INVALID(motorId))
 		return;
 
-	/* copy status values */
-	if(!g_p.bReadInProgress_slow[motorId])
-	    g_p.sStatus[motorId].sSlow = *status;
+	/* publish status values to the spare buffer; readers retry instead of blocking the update */
+	{
+	    uint32_t seq = g_p.ui32StatusSeqSlow[motorId];
+
+	    g_p.ui32StatusSeqSlow[motorId] = seq + 1U;
+	    __DMB();
+	    g_p.sStatusSlow[motorId][MC_SHM_SEQ_IDX(seq) ^ 1U] = *status;
+	    __DMB();
+	    g_p.ui32StatusSeqSlow[motorId] = seq + 2U;
+	}
 
 	return;
 }
@@ -260,15 +312,69 @@ RAM_FUNC_CRITICAL mc_motor_command_t* MC_GetMotorCommand_fromISR(mc_motor_id_t m
 	if(IS_MOTORID_INVALID(motorId))
 		return NULL;
 
-	/* update internal command buffer */
-	if(!g_p.bWriteInProgress[motorId])
-		g_p.sCommands_int[motorId] = g_p.sCommands[motorId];
+	/* update internal command buffer with the latest published command; tasks never block this loop */
+	{
+		uint32_t seq = g_p.ui32CommandSeq[motorId] & ~1U;
+
+		if(seq != g_p.ui32CommandSeqTaken[motorId])
+		{
+			mc_motor_command_t sCmd;
+
+			__DMB();
+			sCmd = g_p.sCommands[motorId][MC_SHM_SEQ_IDX(seq)];
+			__DMB();
+
+			/* only a concurrent writer could have rewritten the buffer; keep the previous command then */
+			if(MC_SHM_SEQ_VALID(seq, g_p.ui32CommandSeq[motorId]))
+			{
+				g_p.sCommands_int[motorId] = sCmd;
+				g_p.ui32CommandSeqTaken[motorId] = seq;
+			}
+		}
+	}
 
 	/* Cast removes "volatile" modifier. The calling motor control loop
 	 * cannot be interrupted by any code modifying this memory location */
 	return (mc_motor_command_t*)&(g_p.sCommands_int[motorId]);
 }
 
+RAM_FUNC_CRITICAL void MC_ExchangeControllerTuning_fromISR(mc_motor_id_t motorId, mc_ctrl_tuning_t* tuning, bool isStopped)
+{
+	static bool     isPublished[MC_MAX_MOTORS];         /* sCtrlTuning holds the gains in use */
+	static uint32_t ui32UpdatePublished[MC_MAX_MOTORS]; /* ui32Update of the gains in sCtrlTuning */
+	uint32_t ui32Update;
+
+	/* input sanitation and limit checks */
+	if(NULL == tuning)
+		return;
+	if(IS_MOTORID_INVALID(motorId))
+		return;
+
+	/* take over requested gains, the update counter stays with the loop */
+	if(isStopped && g_p.bCtrlTuningReqPending[motorId])
+	{
+		ui32Update = tuning->ui32Update;
+		*tuning = g_p.sCtrlTuningReq[motorId];
+		tuning->ui32Update = ui32Update;
+		g_p.bCtrlTuningReqPending[motorId] = false;
+		isPublished[motorId] = false;
+	}
+
+	/* the loop changes its gains only with a new identification result */
+	if(tuning->ui32Update != ui32UpdatePublished[motorId])
+		isPublished[motorId] = false;
+
+	/* publish gains in use, retried with the next period while a task reads them */
+	if(!isPublished[motorId] && !g_p.bCtrlTuningReadInProgress[motorId])
+	{
+		g_p.sCtrlTuning[motorId] = *tuning;
+		ui32UpdatePublished[motorId] = tuning->ui32Update;
+		isPublished[motorId] = true;
+	}
+
+	return;
+}
+
 #if (FEATURE_ANOMALY_DETECTION != 0)
 qmc_status_t MC_GetFastMotorStatusSync_fromISR(mc_motor_id_t motorId, mc_motor_status_fast_t** status)
 {
@@ -320,32 +426,65 @@ qmc_status_t MC_QueueMotorCommand(const mc_motor_command_t* cmd)
 	if(pdTRUE != retval)
 		return kStatus_QMC_Err;
 
-	/* trigger corresponding new-message-event */
-	xEventGroupSetBits(g_motorQueueEventGroupHandle, g_motorCommandQueueEventBit);
+	/* wake the Data Hub task directly */
+	xTaskNotify(g_datahub_task_handle, g_motorCommandQueueNotifyBit, eSetBits);
 
 	return kStatus_QMC_Ok;
 }
 
 qmc_status_t MC_DequeueMotorStatus(const qmc_msg_queue_handle_t* handle, uint32_t timeout, mc_motor_status_t* status)
 {
-	BaseType_t retval;
+	mc_status_reader_t* psReader;
+	uint32_t next;
 
 	/* input sanitation and limit checks */
-	if((NULL == handle) || (NULL == handle->queueHandle))
-		return kStatus_QMC_ErrArgInvalid;
 	if(NULL == status)
 		return kStatus_QMC_ErrArgInvalid;
 	if(!g_isInitialized_DataHub)
 		return kStatus_QMC_Err;
+	psReader = getStatusReader(handle);
+	if(NULL == psReader)
+		return kStatus_QMC_ErrArgInvalid;
 
-	/* dequeue status item (xQueueReceive copies the value) */
-	retval = xQueueReceive(*(handle->queueHandle), status, pdMS_TO_TICKS(timeout));
-	if(pdTRUE != retval)
-		return kStatus_QMC_ErrNoMsg;
-
-	/* clear event if all elements have been dequeued */
-	if( 0 == uxQueueMessagesWaiting(*(handle->queueHandle)))
+	/* wait for the next snapshot of this handle; the event is set again by the Data Hub for every new snapshot */
+	if((int32_t)(g_motorStatusRing.ui32Head - psReader->ui32NextSnapshot) <= 0)
+	{
+		if(0U == timeout)
+			return kStatus_QMC_ErrNoMsg;
 		xEventGroupClearBits(*(handle->eventHandle), handle->eventMask);
+		if((int32_t)(g_motorStatusRing.ui32Head - psReader->ui32NextSnapshot) <= 0)
+			xEventGroupWaitBits(*(handle->eventHandle), handle->eventMask, pdTRUE, pdFALSE, pdMS_TO_TICKS(timeout));
+		if((int32_t)(g_motorStatusRing.ui32Head - psReader->ui32NextSnapshot) <= 0)
+			return kStatus_QMC_ErrNoMsg;
+	}
+
+	/* copy the status values; repeat if the snapshot was overwritten meanwhile */
+	do
+	{
+		next = psReader->ui32NextSnapshot;
+		if((int32_t)(g_motorStatusRing.ui32Oldest - next) > 0)
+		{
+			/* skip to the oldest available snapshot of this handle, keeping the prescaler phase */
+			uint32_t skipped = (g_motorStatusRing.ui32Oldest - next + psReader->ui32Prescaler - 1U) / psReader->ui32Prescaler;
+
+			next += skipped * psReader->ui32Prescaler;
+			psReader->ui32NextSnapshot = next;
+			psReader->ui32NextMotor    = 0U;
+			psReader->ui32Overruns    += skipped;
+			if((int32_t)(g_motorStatusRing.ui32Head - next) <= 0)
+				return kStatus_QMC_ErrNoMsg; /* prescaler exceeds the ring length */
+		}
+		__DMB();
+		*status = g_motorStatusRing.sSnapshots[next & (DATAHUB_STATUS_RING_LENGTH - 1U)][psReader->ui32NextMotor];
+		__DMB();
+	} while((int32_t)(g_motorStatusRing.ui32Oldest - next) > 0);
+
+	/* advance the cursor */
+	if(MC_MAX_MOTORS <= ++psReader->ui32NextMotor)
+	{
+		psReader->ui32NextMotor    = 0U;
+		psReader->ui32NextSnapshot = next + psReader->ui32Prescaler;
+	}
 
 	return kStatus_QMC_Ok;
 }
@@ -391,11 +530,15 @@ qmc_status_t MC_GetNewStatusQueueHandle(qmc_msg_queue_handle_t** handle, uint32_
 		return kStatus_QMC_Err;
 	for(i=0; i<DATAHUB_MAX_STATUS_QUEUES; i++)
 	{
-		if(NULL == g_motorStatusQueueHandles[i].queueHandle)
+		if(!g_motorStatusReaders[i].bIsActive)
 		{
-			g_motorStatusQueueHandles[i].queueHandle = &(g_motorStatusQueues[i]);
-			g_motorStatusQueuePrescalers[i]          = prescaler;
-			g_motorStatusQueuePrescalerCounters[i]   = prescaler;
+			/* the first snapshot is delivered after the prescaler expired once */
+			g_motorStatusReaders[i].ui32Prescaler    = prescaler;
+			g_motorStatusReaders[i].ui32NextSnapshot = g_motorStatusRing.ui32Head + prescaler - 1U;
+			g_motorStatusReaders[i].ui32NextMotor    = 0U;
+			g_motorStatusReaders[i].ui32Overruns     = 0U;
+			__DMB();
+			g_motorStatusReaders[i].bIsActive        = true;
 			*handle                                  = &(g_motorStatusQueueHandles[i]);
 			if(!gs_isStatusSamplingTimerStarted) /* check required as starting an already running timer is equivalent to a reset */
 			{
@@ -429,12 +572,12 @@ qmc_status_t MC_ReturnStatusQueueHandle(const qmc_msg_queue_handle_t* handle)
 		/* search handle and mark it as available again */
 		if(handle == &(g_motorStatusQueueHandles[i]))
 		{
-			g_motorStatusQueueHandles[i].queueHandle = NULL;
+			g_motorStatusReaders[i].bIsActive = false;
 			retval =  kStatus_QMC_Ok;
 		}
 
 		/* check, if all handles are returned */
-		if(NULL != g_motorStatusQueueHandles[i].queueHandle)
+		if(g_motorStatusReaders[i].bIsActive)
 			areAllHandlesReturned = false;
 	}
 
@@ -449,6 +592,23 @@ qmc_status_t MC_ReturnStatusQueueHandle(const qmc_msg_queue_handle_t* handle)
     return retval;
 }
 
+qmc_status_t MC_GetStatusQueueOverruns(const qmc_msg_queue_handle_t* handle, uint32_t* overruns)
+{
+	mc_status_reader_t* psReader;
+
+	/* input sanitation and limit checks */
+	if(NULL == overruns)
+		return kStatus_QMC_ErrArgInvalid;
+	if(!g_isInitialized_DataHub)
+		return kStatus_QMC_Err;
+	psReader = getStatusReader(handle);
+	if(NULL == psReader)
+		return kStatus_QMC_ErrArgInvalid;
+
+	*overruns = psReader->ui32Overruns;
+	return kStatus_QMC_Ok;
+}
+
 qmc_status_t MC_ExecuteMotorCommandFromTsn(const mc_motor_command_t* cmd)
 {
 	/* input sanitation and limit checks */
@@ -480,32 +640,14 @@ qmc_status_t MC_ExecuteMotorCommandFromTsn(const mc_motor_command_t* cmd)
 
 		/* shared memory access must not be interrupted by other tasks (e.g. DataHub) */
 		taskENTER_CRITICAL();
-
-		/* lock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = true;
-
-		/* copy parameters */
-		g_p.sCommands[cmd->eMotorId] = cmd_stop;
-
-		/* unlock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = false;
-
+		publishMotorCommand(cmd->eMotorId, &cmd_stop);
 		taskEXIT_CRITICAL();
 	}
 	else
 	{
 		/* shared memory access must not be interrupted by other tasks (e.g. DataHub) */
 		taskENTER_CRITICAL();
-
-		/* lock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = true;
-
-		/* copy parameters */
-		g_p.sCommands[cmd->eMotorId] = *cmd;
-
-		/* unlock memory */
-		g_p.bWriteInProgress[cmd->eMotorId] = false;
-
+		publishMotorCommand(cmd->eMotorId, cmd);
 		taskEXIT_CRITICAL();
 	}
 
@@ -520,34 +662,9 @@ qmc_status_t MC_GetMotorStatusforTsn(mc_motor_id_t motorId, mc_motor_status_t* s
 	if(IS_MOTORID_INVALID(motorId))
 		return kStatus_QMC_ErrRange;
 
-	/* shared memory access must not be interrupted by other tasks (e.g. DataHub) */
-	taskENTER_CRITICAL();
-
-	/* copy fast loop status values */
-	if(g_p.bReadInProgress_fast[motorId])
-	{ /* locking not required */
-		status->sFast = g_p.sStatus[motorId].sFast;
-	}
-	else
-	{ /* locking required */
-		g_p.bReadInProgress_fast[motorId] = true;
-		status->sFast = g_p.sStatus[motorId].sFast;
-		g_p.bReadInProgress_fast[motorId] = false;
-	}
-
-	/* copy slow loop status values */
-	if(g_p.bReadInProgress_slow[motorId])
-	{ /* locking not required */
-		status->sSlow = g_p.sStatus[motorId].sSlow;
-	}
-	else
-	{ /* locking required */
-		g_p.bReadInProgress_fast[motorId] = true;
-		status->sSlow = g_p.sStatus[motorId].sSlow;
-		g_p.bReadInProgress_fast[motorId] = false;
-	}
-
-	taskEXIT_CRITICAL();
+	/* copy status values, the motor control loops are not blocked */
+	getFastMotorStatus(motorId, &status->sFast);
+	getSlowMotorStatus(motorId, &status->sSlow);
 
 	return kStatus_QMC_Ok;
 }
@@ -570,6 +687,56 @@ qmc_status_t MC_UnfreezeMotor(mc_motor_id_t motor_id)
 	return kStatus_QMC_Ok;
 }
 
+qmc_status_t MC_GetControllerTuning(mc_motor_id_t motorId, mc_ctrl_tuning_t* tuning)
+{
+	/* input sanitation and limit checks */
+	if(NULL == tuning)
+		return kStatus_QMC_ErrArgInvalid;
+	if(IS_MOTORID_INVALID(motorId))
+		return kStatus_QMC_ErrRange;
+
+	/* shared memory access must not be interrupted by other tasks */
+	taskENTER_CRITICAL();
+
+	g_p.bCtrlTuningReadInProgress[motorId] = true;
+	*tuning = g_p.sCtrlTuning[motorId];
+	g_p.bCtrlTuningReadInProgress[motorId] = false;
+
+	taskEXIT_CRITICAL();
+
+	return kStatus_QMC_Ok;
+}
+
+qmc_status_t MC_SetControllerTuning(mc_motor_id_t motorId, const mc_ctrl_tuning_t* tuning)
+{
+	qmc_status_t retval = kStatus_QMC_Ok;
+
+	/* input sanitation and limit checks */
+	if(NULL == tuning)
+		return kStatus_QMC_ErrArgInvalid;
+	if(IS_MOTORID_INVALID(motorId))
+		return kStatus_QMC_ErrRange;
+	if(!isControllerTuningInRange(motorId, tuning))
+		return kStatus_QMC_ErrRange;
+
+	/* shared memory access must not be interrupted by other tasks */
+	taskENTER_CRITICAL();
+
+	if(g_p.bCtrlTuningReqPending[motorId])
+	{
+		retval = kStatus_QMC_ErrBusy;
+	}
+	else
+	{
+		g_p.sCtrlTuningReq[motorId] = *tuning;
+		g_p.bCtrlTuningReqPending[motorId] = true;
+	}
+
+	taskEXIT_CRITICAL();
+
+	return retval;
+}
+
 static bool isMotorCommandInRange(const mc_motor_command_t* cmd)
 {
 	if(IS_MOTORID_INVALID(cmd->eMotorId))
@@ -596,3 +763,105 @@ static bool isMotorCommandInRange(const mc_motor_command_t* cmd)
 	}
 	return true;
 }
+
+static bool isControllerTuningInRange(mc_motor_id_t motorId, const mc_ctrl_tuning_t* tuning)
+{
+	const mc_ctrl_tuning_t* max = &gs_ctrlTuningMax[motorId];
+	uint32_t i;
+
+	if(0U != (tuning->ui32Valid & ~(MC_CTRL_TUNING_CURRENT | MC_CTRL_TUNING_SPEED | MC_CTRL_TUNING_SPEED_SCHED)))
+		return false;
+	if(0U != (tuning->ui32Valid & MC_CTRL_TUNING_CURRENT))
+	{
+		if(!isGainInRange(tuning->fltDKpGain, max->fltDKpGain, true) || !isGainInRange(tuning->fltDKiGain, max->fltDKiGain, false) ||
+		   !isGainInRange(tuning->fltQKpGain, max->fltQKpGain, true) || !isGainInRange(tuning->fltQKiGain, max->fltQKiGain, false))
+			return false;
+	}
+	if(0U != (tuning->ui32Valid & MC_CTRL_TUNING_SPEED))
+	{
+		if(!isGainInRange(tuning->fltSpeedPGain, max->fltSpeedPGain, true) || !isGainInRange(tuning->fltSpeedIGain, max->fltSpeedIGain, false))
+			return false;
+	}
+	if(0U != (tuning->ui32Valid & MC_CTRL_TUNING_SPEED_SCHED))
+	{
+		if((tuning->ui32SpeedGainPoints < 1U) || (tuning->ui32SpeedGainPoints > MC_SPEED_GAIN_SCHED_MAX_POINTS))
+			return false;
+		if(!(tuning->sSpeedGainSched[0].fltSpeed >= 0.0f))
+			return false;
+		for(i = 0U; i < tuning->ui32SpeedGainPoints; i++)
+		{
+			if(!isGainInRange(tuning->sSpeedGainSched[i].fltPGain, max->fltSpeedPGain, true) ||
+			   !isGainInRange(tuning->sSpeedGainSched[i].fltIGain, max->fltSpeedIGain, false))
+				return false;
+			if(!isfinite(tuning->sSpeedGainSched[i].fltSpeed))
+				return false;
+			/* the interpolation divides by the distance of neighbouring breakpoints */
+			if((i > 0U) && !(tuning->sSpeedGainSched[i].fltSpeed > tuning->sSpeedGainSched[i - 1U].fltSpeed))
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool isGainInRange(float fltGain, float fltMax, bool isZeroAllowed)
+{
+	/* isfinite() rejects NaN and infinity, fltMax any other gain far off the configured one */
+	if(!isfinite(fltGain) || (fltGain > fltMax))
+		return false;
+	return isZeroAllowed ? (fltGain >= 0.0f) : (fltGain > 0.0f);
+}
+
+static mc_status_reader_t* getStatusReader(const qmc_msg_queue_handle_t* handle)
+{
+	uintptr_t offset = (uintptr_t)handle - (uintptr_t)&(g_motorStatusQueueHandles[0]);
+	unsigned int i = (unsigned int)(offset / sizeof(qmc_msg_queue_handle_t));
+
+	/* only handles handed out by MC_GetNewStatusQueueHandle() and not yet returned are valid */
+	if((NULL == handle) || (i >= DATAHUB_MAX_STATUS_QUEUES) || (handle != &(g_motorStatusQueueHandles[i])))
+		return NULL;
+	if(!g_motorStatusReaders[i].bIsActive)
+		return NULL;
+	return &(g_motorStatusReaders[i]);
+}
+
+static inline void getFastMotorStatus(mc_motor_id_t motorId, mc_motor_status_fast_t* status)
+{
+	uint32_t seqStart, seqEnd;
+
+	/* repeat the copy if the Fast Motor Control Loop rewrote the buffer meanwhile */
+	do
+	{
+		seqStart = g_p.ui32StatusSeqFast[motorId];
+		__DMB();
+		*status = g_p.sStatusFast[motorId][MC_SHM_SEQ_IDX(seqStart)];
+		__DMB();
+		seqEnd = g_p.ui32StatusSeqFast[motorId];
+	} while(!MC_SHM_SEQ_VALID(seqStart, seqEnd));
+}
+
+static inline void getSlowMotorStatus(mc_motor_id_t motorId, mc_motor_status_slow_t* status)
+{
+	uint32_t seqStart, seqEnd;
+
+	/* repeat the copy if the Slow Motor Control Loop rewrote the buffer meanwhile */
+	do
+	{
+		seqStart = g_p.ui32StatusSeqSlow[motorId];
+		__DMB();
+		*status = g_p.sStatusSlow[motorId][MC_SHM_SEQ_IDX(seqStart)];
+		__DMB();
+		seqEnd = g_p.ui32StatusSeqSlow[motorId];
+	} while(!MC_SHM_SEQ_VALID(seqStart, seqEnd));
+}
+
+static void publishMotorCommand(mc_motor_id_t motorId, const mc_motor_command_t* cmd)
+{
+	/* caller serializes the producers; the Slow Motor Control Loop keeps reading the published buffer */
+	uint32_t seq = g_p.ui32CommandSeq[motorId];
+
+	g_p.ui32CommandSeq[motorId] = seq + 1U;
+	__DMB();
+	g_p.sCommands[motorId][MC_SHM_SEQ_IDX(seq) ^ 1U] = *cmd;
+	__DMB();
+	g_p.ui32CommandSeq[motorId] = seq + 2U;
+}
@@ -27,6 +27,12 @@
 #define ALL_MC_PSB_FAULTS_BITS_MASK (kMC_NoFaultMC |  MC_PSB_FAULTS_MASK )
 #define ALL_BS_PSB_FAULTS_BITS_MASK (kMC_NoFaultBS |  BS_PSB_FAULTS_MASK )
 #define ALL_PSB_FAULTS_BITS_MASK (ALL_MC_PSB_FAULTS_BITS_MASK | ALL_BS_PSB_FAULTS_BITS_MASK)
+
+#define MC_CTRL_TUNING_CURRENT (1U << 0) /* mc_ctrl_tuning_t holds valid current controller gains */
+#define MC_CTRL_TUNING_SPEED   (1U << 1) /* mc_ctrl_tuning_t holds valid speed controller gains */
+#define MC_CTRL_TUNING_SPEED_SCHED (1U << 2) /* mc_ctrl_tuning_t holds a valid speed controller gain schedule */
+
+#define MC_SPEED_GAIN_SCHED_MAX_POINTS (6U) /* Breakpoints of the speed controller gain schedule, the record must fit CONFIG_MAX_VALUE_LEN */
 /*******************************************************************************
  * Definitions => Enumerations
  ******************************************************************************/
@@ -186,6 +192,41 @@ typedef struct _mc_motor_status
     mc_motor_id_t          eMotorId; /*!< Indicates which motor this status belongs to */
 } mc_motor_status_t;
 
+/*!
+ * @brief Breakpoint of the speed controller gain schedule.
+ */
+typedef struct _mc_speed_gain_point
+{
+    float    fltSpeed;      /*!< [rad/s] Electrical speed magnitude of the breakpoint */
+    float    fltPGain;      /*!< Speed controller proportional gain at fltSpeed */
+    float    fltIGain;      /*!< Speed controller integral gain at fltSpeed */
+} mc_speed_gain_point_t;
+
+/*!
+ * @brief Controller gains of one motor calculated by the motor parameter identification or configured.
+ *
+ * The gains have the units of the motor control loops: current controller in [V/A] with the
+ * integral gain per fast loop sample, speed controller in [A/(rad/s)] of electrical speed with the
+ * integral gain per slow loop sample. Only the parts flagged in ui32Valid are used.
+ *
+ * The speed gain schedule (position sensor control) interpolates the speed controller gains between
+ * breakpoints in ascending speed and holds them outside. It takes precedence over fltSpeedPGain and
+ * fltSpeedIGain; a new identification result replaces it.
+ */
+typedef struct _mc_ctrl_tuning
+{
+    uint32_t ui32Valid;     /*!< MC_CTRL_TUNING_CURRENT, MC_CTRL_TUNING_SPEED and / or MC_CTRL_TUNING_SPEED_SCHED */
+    uint32_t ui32Update;    /*!< Incremented by the motor control loop with every new identification result */
+    float    fltDKpGain;    /*!< d-axis current controller proportional gain */
+    float    fltDKiGain;    /*!< d-axis current controller integral gain */
+    float    fltQKpGain;    /*!< q-axis current controller proportional gain */
+    float    fltQKiGain;    /*!< q-axis current controller integral gain */
+    float    fltSpeedPGain; /*!< Speed controller proportional gain (position sensor control) */
+    float    fltSpeedIGain; /*!< Speed controller integral gain (position sensor control) */
+    uint32_t ui32SpeedGainPoints; /*!< Used breakpoints of sSpeedGainSched, 1 to MC_SPEED_GAIN_SCHED_MAX_POINTS */
+    mc_speed_gain_point_t sSpeedGainSched[MC_SPEED_GAIN_SCHED_MAX_POINTS]; /*!< Speed controller gain schedule */
+} mc_ctrl_tuning_t;
+
 
 /*******************************************************************************
  * API
@@ -201,6 +242,8 @@ qmc_status_t MC_QueueMotorCommand(const mc_motor_command_t* cmd);
  /*!
  * @brief Get one mc_motor_status_t element from the queue, if available.
  *
+ * If the handle is read too slowly, the oldest status values are skipped (see MC_GetStatusQueueOverruns()).
+ *
  * @param[in]  handle Handle of the queue to receive the status from
  * @param[in]  timeout Timeout in milliseconds
  * @param[out] status Pointer to write the retrieved motor status to
@@ -240,6 +283,17 @@ qmc_status_t MC_GetNewStatusQueueHandle(qmc_msg_queue_handle_t** handle, uint32_
  */
 qmc_status_t MC_ReturnStatusQueueHandle(const qmc_msg_queue_handle_t* handle);
 
+ /*!
+ * @brief Get the number of motor status snapshots that were overwritten before they could be read through the given handle.
+ *
+ * Status values are not queued per handle; a handle that is read too slowly skips to the oldest available
+ * status values instead of delaying the Data Hub task.
+ *
+ * @param[in]  handle Handle obtained by MC_GetNewStatusQueueHandle(handle : qmc_msg_queue_handle_t*, prescaler : uint32_t) : qmc_status_t
+ * @param[out] overruns Pointer to write the number of skipped snapshots to
+ */
+qmc_status_t MC_GetStatusQueueOverruns(const qmc_msg_queue_handle_t* handle, uint32_t* overruns);
+
 /*!
 * @brief Unfreeze a motor and tell the motor control API that it can stop ignoring further commands to the motor.
 *
@@ -247,5 +301,30 @@ qmc_status_t MC_ReturnStatusQueueHandle(const qmc_msg_queue_handle_t* handle);
 */
 qmc_status_t MC_UnfreezeMotor(mc_motor_id_t motor_id);
 
+/*!
+* @brief Get the controller gains last published by the motor control loop of a motor.
+*
+* The record changes when a motor parameter identification finishes (ui32Update increments)
+* or when gains set by MC_SetControllerTuning(motorId : mc_motor_id_t, tuning : const mc_ctrl_tuning_t*) : qmc_status_t were taken over.
+*
+* @param[in]  motorId Motor of which to retrieve the gains
+* @param[out] tuning Pointer to write the gains to
+*/
+qmc_status_t MC_GetControllerTuning(mc_motor_id_t motorId, mc_ctrl_tuning_t* tuning);
+
+/*!
+* @brief Hand controller gains (e.g. restored from the configuration) to the motor control loop of a motor.
+*
+* The gains flagged in ui32Valid are taken over by the next slow loop period and used from the next motor start on.
+* The request replaces the whole record; to change one part, e.g. the speed gain schedule, modify the record
+* read with MC_GetControllerTuning(motorId : mc_motor_id_t, tuning : mc_ctrl_tuning_t*) : qmc_status_t.
+* Returns kStatus_QMC_ErrBusy while a previous request has not been taken over yet and kStatus_QMC_ErrRange
+* for gains out of range or a gain schedule whose breakpoints do not ascend.
+*
+* @param[in] motorId Motor to which the gains apply
+* @param[in] tuning Gains to be used
+*/
+qmc_status_t MC_SetControllerTuning(mc_motor_id_t motorId, const mc_ctrl_tuning_t* tuning);
+
 
 #endif /* _API_MOTORCONTROL_H_ */
@@ -26,14 +26,20 @@
  */
 typedef struct _mc_control_shm {
 	volatile _Atomic bool       bIsTsnCommandInjectionOn[MC_MAX_MOTORS];            /*!< Defines, whether the TSN Receive interrupt service routine is allowed to inject a MotorCommand for execution by Slow Motor Control Loop. */
-	volatile mc_motor_command_t sCommands[MC_MAX_MOTORS];            /*!< Array of MotorCommand that holds the motor commands for each of the four motors. Commands are read by the Slow Motor Control Loop and written by the Data Hub task; TSN Receive can also write them. */
-	volatile _Atomic bool       bWriteInProgress[MC_MAX_MOTORS];     /*!< Array of booleans that act as mutexes for the corresponding entries in the commands : MotorCommand[] array. */
-	volatile mc_motor_status_t  sStatus[MC_MAX_MOTORS];              /*!< Array of MotorStatus that holds the motor status for each of the four motors. The status is written by the Fast Motor Control Loop and  Slow Motor Control Loop; it is read by the Data Hub task. */
-	volatile _Atomic bool       bReadInProgress_fast[MC_MAX_MOTORS]; /*!< Array of booleans that act as mutexes for the ms_fast section of the corresponding entries in the status : MotorStatus[] array. */
-	volatile _Atomic bool       bReadInProgress_slow[MC_MAX_MOTORS]; /*!< Array of booleans that act as mutexes for the ms_slow section of the corresponding entries in the status : MotorStatus[] array. */
+	volatile mc_motor_command_t sCommands[MC_MAX_MOTORS][2];         /*!< Double buffered command mailbox of each motor. Complete commands are published by the Data Hub task or TSN Receive and taken over by the Slow Motor Control Loop. */
+	volatile uint32_t           ui32CommandSeq[MC_MAX_MOTORS];       /*!< Sequence counters of sCommands. Odd while a task writes the spare buffer, bit 1 selects the published buffer. */
+	volatile uint32_t           ui32CommandSeqTaken[MC_MAX_MOTORS];  /*!< Sequence counter value of the command last taken over into sCommands_int by the Slow Motor Control Loop. */
+	volatile mc_motor_status_fast_t sStatusFast[MC_MAX_MOTORS][2];   /*!< Double buffer for the part of the motor status written by the Fast Motor Control Loop. The buffer in use is selected by ui32StatusSeqFast; it is read by the Data Hub task. */
+	volatile mc_motor_status_slow_t sStatusSlow[MC_MAX_MOTORS][2];   /*!< Double buffer for the part of the motor status written by the Slow Motor Control Loop. The buffer in use is selected by ui32StatusSeqSlow; it is read by the Data Hub task. */
+	volatile uint32_t           ui32StatusSeqFast[MC_MAX_MOTORS];    /*!< Sequence counters of sStatusFast. Odd while the Fast Motor Control Loop writes the spare buffer, bit 1 selects the published buffer. */
+	volatile uint32_t           ui32StatusSeqSlow[MC_MAX_MOTORS];    /*!< Sequence counters of sStatusSlow. Odd while the Slow Motor Control Loop writes the spare buffer, bit 1 selects the published buffer. */
 	volatile _Atomic bool 		bIsFrozen[MC_MAX_MOTORS];			 /*!< Array of booleans that tell the motor control API to ignore incoming commands. */
 	volatile uint16_t           ui16MotorFaultConfiguration;         /*!< Describes for each of the four motors which other motors need to be stopped immediately in case of a fault. */
 	volatile mc_motor_command_t sCommands_int[MC_MAX_MOTORS];        /*!< Array of MotorCommand that holds the last valid motor command for each motor and acts as an internal buffer for the Slow Motor Control Loop. */
+	volatile mc_ctrl_tuning_t   sCtrlTuning[MC_MAX_MOTORS];          /*!< Array of controller gains in use by each motor. They are written by the Slow Motor Control Loop and read by the tasks. */
+	volatile _Atomic bool       bCtrlTuningReadInProgress[MC_MAX_MOTORS]; /*!< Array of booleans that act as mutexes for the corresponding entries in the sCtrlTuning array. */
+	volatile mc_ctrl_tuning_t   sCtrlTuningReq[MC_MAX_MOTORS];       /*!< Array of controller gains requested by a task, e.g. restored from the configuration. */
+	volatile _Atomic bool       bCtrlTuningReqPending[MC_MAX_MOTORS]; /*!< Array of booleans telling that the corresponding entry in sCtrlTuningReq was not yet taken over by the Slow Motor Control Loop. */
     #if (FEATURE_ANOMALY_DETECTION != 0)
 	    volatile mc_motor_status_fast_t sSyncStatusA[MC_MAX_MOTORS][AD_CURRENT_BLK_SIZE]; /*!< First buffer for motor status values from the Fast Motor Control Loop. It is used exclusively by the Anomaly Detection interrupt service routine. */
 	    volatile mc_motor_status_fast_t sSyncStatusB[MC_MAX_MOTORS][AD_CURRENT_BLK_SIZE]; /*!< Second buffer for motor status values from the Fast Motor Control Loop. It is used exclusively by the Anomaly Detection interrupt service routine. */
@@ -43,6 +49,32 @@ typedef struct _mc_control_shm {
 
 
 
+/*!
+ * @brief Motor status snapshots of all motors, written by the Data Hub task once per sampling interval and read by all status queue handles.
+ */
+typedef struct _mc_status_ring {
+	mc_motor_status_t  sSnapshots[DATAHUB_STATUS_RING_LENGTH][MC_MAX_MOTORS]; /*!< Snapshot with sequence number n is stored at index n % DATAHUB_STATUS_RING_LENGTH. */
+	volatile uint32_t  ui32Head;   /*!< Number of snapshots written so far; the latest complete snapshot has the sequence number ui32Head - 1. */
+	volatile uint32_t  ui32Oldest; /*!< Sequence number of the oldest snapshot that is neither overwritten nor being overwritten. */
+} mc_status_ring_t;
+
+/*!
+ * @brief Read cursor of one status queue handle into the mc_status_ring_t.
+ */
+typedef struct _mc_status_reader {
+	uint32_t           ui32Prescaler;    /*!< Only every ui32Prescaler-th snapshot is delivered through this handle. */
+	volatile uint32_t  ui32NextSnapshot; /*!< Sequence number of the snapshot to be read next. */
+	uint32_t           ui32NextMotor;    /*!< Motor of the snapshot to be read next. */
+	uint32_t           ui32Overruns;     /*!< Number of snapshots that were overwritten before they were read. */
+	volatile bool      bIsActive;        /*!< true, while the handle is in use. */
+} mc_status_reader_t;
+
+/*! @brief Index of the published buffer of sCommands / sStatusFast / sStatusSlow for the given sequence counter value. */
+#define MC_SHM_SEQ_IDX(seq) (((seq) >> 1U) & 1U)
+
+/*! @brief A copy of a published buffer started at sequence value seqStart is consistent, if the buffer was not rewritten until seqEnd. */
+#define MC_SHM_SEQ_VALID(seqStart, seqEnd) (((uint32_t)(seqEnd) - ((uint32_t)(seqStart) & ~1U)) <= 2U)
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -59,6 +91,8 @@ qmc_status_t MC_SetMotorCommand(const mc_motor_command_t* cmd);
  /*!
  * @brief Internal function used by the Data Hub task to read a mc_motor_status_t from the shared memory.
  *
+ * The motor control loops are never blocked; the copy is repeated if a loop republished the buffer being copied.
+ *
  * @param[in]  motorId Motor of which to retrieve the status
  * @param[out] status Pointer to write the retrieved status to
  */
@@ -88,6 +122,20 @@ void MC_SetSlowMotorStatus_fromISR(mc_motor_id_t motorId, const mc_motor_status_
  */
 mc_motor_command_t* MC_GetMotorCommand_fromISR(mc_motor_id_t motorId);
 
+ /*!
+ * @brief Internal function used by the Slow Motor Control Loop to take over requested controller gains and publish the gains in use.
+ *
+ * Requested gains are only taken over while the motor is not running; the update counter of the loop is kept.
+ * The gains are only copied to the shared memory after a change, i.e. when the update counter of the loop
+ * incremented or requested gains were taken over. The loop must change its gains only together with the
+ * update counter.
+ *
+ * @param[in]     motorId Motor ID of the motor the gains apply to
+ * @param[in,out] tuning Controller gains of the motor control loop
+ * @param[in]     isStopped true, if the motor is not running and new gains may be taken over
+ */
+void MC_ExchangeControllerTuning_fromISR(mc_motor_id_t motorId, mc_ctrl_tuning_t* tuning, bool isStopped);
+
  /*!
  * @brief Internal function used by the AD Capture handler to get the part of the mc_motor_status_t written by the Fast Motor Control Loop (phase current values) synchronously. Access to this data uses double buffering.
  *
@@ -12,8 +12,79 @@
 #define _API_RPC_INTERNAL_H_
 
 #include "api_rpc.h"
+#include "qmc_features_config.h"
+#if FEATURE_RPC_STATS
+#include "stats.h"
+#endif
 
 
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*!
+ * @brief Static initialization macro for rpc_gpio_batch_t.
+ */
+#define RPC_GPIO_BATCH_STATIC_INIT \
+    {                              \
+        .gpioState = 0U            \
+    }
+
+/*!
+ * @brief Collects several SNVS output / SPI selection changes which are then applied by one remote call.
+ */
+typedef struct _rpc_gpio_batch
+{
+    uint16_t gpioState; /*!< Coalesced changes, same format as the gpioState of RPC_SetSnvsOutput(). */
+} rpc_gpio_batch_t;
+
+#if FEATURE_RPC_STATS
+#define RPC_STATS_LOG2_WINDOW  (10U) /*!< min/mean/max are computed over windows of 2^RPC_STATS_LOG2_WINDOW calls */
+#define RPC_STATS_HIST_SLOTS   (33U) /*!< slot 0: 0 cycles, slot n: [2^(n-1), 2^n) cycles */
+#define RPC_STATS_CYCLE_BUDGET (200U) /*!< upper bound of the CM7 cycles recording adds to one remote call */
+
+/*!
+ * @brief Remote call types for which latency statistics are recorded.
+ */
+typedef enum _rpc_stats_call_id
+{
+    kRPC_StatsCallSecWd         = 0U,
+    kRPC_StatsCallFuncWd        = 1U,
+    kRPC_StatsCallGpioOut       = 2U,
+    kRPC_StatsCallRtc           = 3U,
+    kRPC_StatsCallFwUpdate      = 4U,
+    kRPC_StatsCallReset         = 5U,
+    kRPC_StatsCallMcuTemp       = 6U,
+    kRPC_StatsCallMemDeltaWrite = 7U,
+    kRPC_StatsCallCount         = 8U
+} rpc_stats_call_id_t;
+
+/*!
+ * @brief Latency statistics of one remote call type, all durations in CM7 core cycles (DWT CYCCNT).
+ *
+ * Recording costs at most RPC_STATS_CYCLE_BUDGET cycles per remote call and is done while the remote call's mutex
+ * is held.
+ */
+typedef struct _rpc_call_stats
+{
+    struct stats prepare;           /*!< Duration of PrepareCall(), including waiting for the call's mutex. */
+    struct stats notify;            /*!< Duration of NotifyCM4(). */
+    struct stats roundTrip;         /*!< Duration from entering PrepareCall() until the CM4's result is received. */
+    struct hist  roundTripLog2;     /*!< log2 histogram of roundTrip (see RPC_STATS_HIST_SLOTS). */
+    uint32_t     calls;             /*!< Number of completed remote calls. */
+    uint32_t     timeouts;          /*!< Number of remote calls which timed out on the CM4. */
+    uint32_t     consistencySleeps; /*!< Number of times ConsistencyCheck() had to wait for a previous call. */
+    uint32_t     startCycles;       /*!< Cycle counter when the pending remote call entered PrepareCall(). */
+} rpc_call_stats_t;
+
+/*!
+ * @brief Latency statistics of all remote call types, indexed by rpc_stats_call_id_t.
+ *
+ * Exported for FreeMASTER; use RPC_GetCallStats() to obtain a consistent snapshot.
+ */
+extern rpc_call_stats_t g_rpcCallStats[kRPC_StatsCallCount];
+#endif
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -37,6 +108,67 @@
  */
 qmc_status_t RPC_SetSnvsOutput(uint16_t gpioState);
 
+/*!
+ * @brief Asynchronous variant of RPC_SetSnvsOutput().
+ *
+ * Posts the request to the CM4 and returns without waiting for the inter-core round trip.
+ * The result must be collected with RPC_WaitAsync().
+ *
+ * @param[in] gpioState See RPC_SetSnvsOutput().
+ * @param[out] token Completion token of the posted request
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_Timeout
+ * Acquiring a mutex timed out.
+ * @retval kStatus_QMC_ErrSync
+ * Trying to recover the remote call from a previous timeout failed.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * A given pointer was NULL.
+ * @retval kStatus_QMC_Ok
+ * The request was posted, the token is valid.
+ */
+qmc_status_t RPC_SetSnvsOutputAsync(uint16_t gpioState, rpc_async_token_t *token);
+
+/*!
+ * @brief Adds an SNVS output / SPI selection change to a batch.
+ *
+ * A later change of the same pin overrides an earlier one.
+ *
+ * @param[in,out] batch The batch to add the change to
+ * @param[in] gpioState See RPC_SetSnvsOutput().
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * The batch is NULL or gpioState contains unsupported bits.
+ * @retval kStatus_QMC_Ok
+ * The change was added.
+ */
+qmc_status_t RPC_GpioBatchAddSnvsOutput(rpc_gpio_batch_t *batch, uint16_t gpioState);
+
+/*!
+ * @brief Adds the selection of a power stage board SPI device to a batch.
+ *
+ * @param[in,out] batch The batch to add the change to
+ * @param[in] mode The SPI device to be selected
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * The batch is NULL.
+ * @retval kStatus_QMC_ErrRange
+ * Specified mode was not part of the supported enumeration.
+ * @retval kStatus_QMC_Ok
+ * The change was added.
+ */
+qmc_status_t RPC_GpioBatchAddPowerStageBoardSpiDevice(rpc_gpio_batch_t *batch, qmc_spi_id_t mode);
+
+/*!
+ * @brief Posts all changes collected in the batch as one atomic remote call.
+ *
+ * The batch is emptied if the request was posted. The result must be collected with RPC_WaitAsync().
+ *
+ * @param[in,out] batch The batch to apply
+ * @param[out] token Completion token of the posted request
+ * @return See RPC_SetSnvsOutputAsync().
+ */
+qmc_status_t RPC_GpioBatchCommitAsync(rpc_gpio_batch_t *batch, rpc_async_token_t *token);
+
 /*!
 * @brief Registers IRQ handlers and Initializes event groups, mutexes and data structures used by the RemoteProcedureCallAPI.
 *
@@ -74,4 +206,83 @@ void RPC_HandleISR(void);
  */
 qmc_status_t RPC_MemoryWriteIntsDisabled(const qmc_mem_write_t *write);
 
+/*!
+ * @brief Forwards a memory delta write request consisting of multiple segments to the M4.
+ *
+ * In contrast to RPC_MemoryWriteIntsDisabled(), this function must be called from task context.
+ * Only the data words of the given segments are transferred; each segment is protected by a
+ * CRC-32 which is checked by the M4 before any segment is applied. The request is applied
+ * as a whole or not at all.
+ *
+ * The same access restrictions as for RPC_MemoryWriteIntsDisabled() apply.
+ *
+ * @param[in] write Pointer to a qmc_mem_delta_write_t structure containing the segments to be written.
+ * @param[out] ackMask Optional pointer (may be NULL) receiving a mask with bit n set if segment n has been applied.
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * A NULL pointer, no segment or an invalid segment layout was given.
+ * @retval kStatus_QMC_ErrRange
+ * The M4 rejected the segment layout.
+ * @retval kStatus_QMC_ErrSync
+ * A segment's CRC did not match on the M4 side; nothing was written.
+ * @retval kStatus_QMC_Timeout
+ * The CM4 did not handle the remote call in time.
+ * @retval kStatus_QMC_Ok
+ * The remote call finished successfully.
+ */
+qmc_status_t RPC_MemoryDeltaWrite(const qmc_mem_delta_write_t *write, uint32_t *ackMask);
+
+/*!
+ * @brief Appends segments for the changed words of a memory block to a memory delta write request.
+ *
+ * Compares the old and new contents of a memory block located at offset (relative to the request's base
+ * address) word by word and appends one word access segment per run of changed words.
+ *
+ * @param[in,out] write Pointer to the qmc_mem_delta_write_t structure to be extended.
+ * @param[in] offset Byte offset of the memory block relative to write->baseAddress.
+ * @param[in] oldData Current contents of the memory block.
+ * @param[in] newData Desired contents of the memory block.
+ * @param[in] dataWords Size of the memory block in words.
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * A NULL pointer was given or the block exceeds the addressable offset range.
+ * @retval kStatus_QMC_ErrNoBufs
+ * The changes do not fit into the request; already appended segments are kept.
+ * @retval kStatus_QMC_Ok
+ * All changes were appended.
+ */
+qmc_status_t RPC_MemoryDeltaWriteAddChanges(qmc_mem_delta_write_t *write, uint16_t offset, const uint32_t *oldData,
+                                            const uint32_t *newData, size_t dataWords);
+
+#if FEATURE_RPC_STATS
+/*!
+ * @brief Returns a consistent snapshot of the latency statistics of a remote call type.
+ *
+ * The min, mean and max values of the returned stats structures refer to the current window of
+ * up to 2^RPC_STATS_LOG2_WINDOW calls (or to the last completed window, if no call was recorded since).
+ * abs_min and abs_max are never reset.
+ *
+ * @param[in] id Remote call type.
+ * @param[out] stats Pointer to the structure receiving the snapshot.
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * A NULL pointer or an unknown id was given.
+ * @retval kStatus_QMC_ErrRange
+ * The remote call type is not available in this configuration.
+ * @retval kStatus_QMC_Timeout
+ * The remote call is in use and did not become available in time.
+ * @retval kStatus_QMC_Ok
+ * The snapshot was taken.
+ */
+qmc_status_t RPC_GetCallStats(rpc_stats_call_id_t id, rpc_call_stats_t *stats);
+
+/*!
+ * @brief Returns a short name of a remote call type, e.g. "rtc".
+ *
+ * @param[in] id Remote call type.
+ * @return Pointer to a constant string; "unknown" for an unknown id.
+ */
+const char *RPC_GetCallStatsName(rpc_stats_call_id_t id);
+#endif
+
 #endif /* _API_RPC_INTERNAL_H_ */
@@ -35,6 +35,10 @@
 #error "Only MAX_LOGICAL_CHANNELS are supported by the AFE. (16 for NAFE11388)"
 #endif
 
+#if (WAKEUPS_BEFORE_TEMPS < 2)
+#error "The chip-select change posted at the task start is collected in the first iteration, which must not measure temperatures."
+#endif
+
 #define R_25 					47000u		/* Thermistor resistance at 25 °C */
 #define BETA 					4101u		/* Thermistor beta */
 #define T_0 					273.15		/* 0 °C in Kelvin */
@@ -54,6 +58,18 @@
  * @return The calculated temperature.
  */
 static double CalculateTemperatureFromVoltage(double V);
+
+/*!
+ * @brief Collects a chip-select change posted by RPC_SelectPowerStageBoardSpiDeviceAsync() and reports its result.
+ *
+ * @param[in] postStatus Return value of the post, the token is only waited for if it is kStatus_QMC_Ok
+ * @param[in,out] token Completion token of the posted change
+ * @param[in] choice FlexIO SPI timing of the selected device, applied once the change is completed
+ * @param[in,out] pFailReported Set if a failed change has been reported, cleared when a change succeeds again
+ *
+ * @return The status of the post or of the remote call.
+ */
+static qmc_status_t CompleteSpiSelect(qmc_status_t postStatus, rpc_async_token_t *token, spi_selection_t choice, bool *pFailReported);
 #endif /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
 
 /*******************************************************************************
@@ -221,6 +237,12 @@ extern EventGroupHandle_t g_systemStatusEventGroupHandle;
 qmc_status_t BoardServiceInit()
 {
 	flexio_spi_master_config_t masterConfig = { 0 };
+	rpc_async_token_t spiSelectToken = { 0 };
+	qmc_status_t spiSelectStatus = kStatus_QMC_Err;
+
+	/* Select the GD3000s asynchronously, the inter-core round trip overlaps with the watchdog kick and the FlexIO setup */
+	spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiMotorDriver, &spiSelectToken);
+
 	FLEXIO_SPI_MasterGetDefaultConfig(&masterConfig);
 	masterConfig.baudRate_Bps = SPI_BAUDRATE;
 	masterConfig.phase = kFLEXIO_SPI_ClockPhaseSecondEdge;
@@ -235,7 +257,12 @@ qmc_status_t BoardServiceInit()
 	NAFE_HAL_init(&gs_FlexioSPIHandle[2], &masterConfig, BOARD_BOOTCLOCKOVERDRIVERUN_FLEXIO2_CLK_ROOT);
 	NAFE_HAL_init(&gs_FlexioSPIHandle[3], &masterConfig, BOARD_BOOTCLOCKOVERDRIVERUN_FLEXIO2_CLK_ROOT);
 
-    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiMotorDriver) != kStatus_QMC_Ok)
+	if (spiSelectStatus == kStatus_QMC_Ok)
+	{
+		spiSelectStatus = RPC_WaitAsync(&spiSelectToken);
+	}
+
+    if (spiSelectStatus != kStatus_QMC_Ok)
     {
     	return kStatus_QMC_Err;
     }
@@ -276,10 +303,27 @@ qmc_status_t BoardServiceInit()
 /*!
  * @brief Runs in an infinite loop. Reads GD3000 status registers, Temperatures on PSB, DB and MCU
  *
+ * Each chip-select change is posted asynchronously and collected only before the selected device is accessed, so
+ * that its inter-core round trip overlaps with other remote calls. The gpioOut call is always collected before
+ * the task waits for its next period or accesses the I2C bus.
+ *
  * @param pvParameters unused
  */
 void BoardServiceTask(void *pvParameters)
 {
+#if (MC_HAS_AFE_ANY_MOTOR != 0)
+	double PSBTemp1 = 0;
+	double PSBTemp2 = 0;
+	bool PSBOvertemperatureReported[4] = { false, false, false, false };
+	qmc_status_t status = kStatus_QMC_Err;
+	qmc_status_t spiSelectStatus = kStatus_QMC_Err;
+	rpc_async_token_t spiSelectToken = { 0 };
+	bool motorDriverSelectPending = false;
+
+	/* Select the AFEs asynchronously, the inter-core round trip overlaps with the watchdog kick */
+	spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiAfe, &spiSelectToken);
+#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
+
 	if (RPC_KickFunctionalWatchdog(kRPC_FunctionalWatchdogBoardService) != kStatus_QMC_Ok)
 	{
 		log_record_t logEntryWithoutId = {
@@ -300,13 +344,6 @@ void BoardServiceTask(void *pvParameters)
 		LOG_QueueLogEntry(&logEntryWithoutId, false);
 	}
 
-#if (MC_HAS_AFE_ANY_MOTOR != 0)
-	double PSBTemp1 = 0;
-	double PSBTemp2 = 0;
-	bool PSBOvertemperatureReported[4] = { false, false, false, false };
-	qmc_status_t status = kStatus_QMC_Err;
-#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
-
 	float MCUTemp = 0;
 	float DBTemp = 0;
 	int wakeupCounter = 0;
@@ -314,12 +351,12 @@ void BoardServiceTask(void *pvParameters)
 	bool MCUOvertemperatureReported = false;
 	bool SPISwitchFailReported = false;
 	bool communicationOK = true;
+	bool systemTempOK = true;
 	TickType_t xLastWakeTime = xTaskGetTickCount();
 
 #if (MC_HAS_AFE_ANY_MOTOR != 0)
-    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiAfe) == kStatus_QMC_Ok)
-    {
-		helper_FLEXIO_SPI_Set_TIMCTL(AFE_ON_PSB, gs_FlexioSPIHandle);
+	if (CompleteSpiSelect(spiSelectStatus, &spiSelectToken, AFE_ON_PSB, &SPISwitchFailReported) == kStatus_QMC_Ok)
+	{
 		for (mc_motor_id_t motorId = kMC_Motor1; motorId <= kMC_Motor4; motorId++)
 		{
 			if (!MC_PSBx_HAS_AFE(motorId))
@@ -340,42 +377,25 @@ void BoardServiceTask(void *pvParameters)
 				gs_communicationErrorReported = true;
 			}
 		}
-    }
-	else
-	{
-		if (!SPISwitchFailReported)
-		{
-			fault_source_t src = kFAULT_RpcCallFailed;
-			FAULT_RaiseFaultEvent(src);
-			SPISwitchFailReported = true;
-		}
 	}
 
-    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiMotorDriver) == kStatus_QMC_Ok)
-    {
-    	if (SPISwitchFailReported)
-    	{
-			fault_source_t src = kFAULT_NoFault;
-			FAULT_RaiseFaultEvent(src);
-			SPISwitchFailReported = false;
-    	}
+	/* Switch back to the GD3000s, the round trip overlaps with the watchdog kick and the time discipline of the first iteration */
+	spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiMotorDriver, &spiSelectToken);
+	motorDriverSelectPending = true;
+#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
 
-    	helper_FLEXIO_SPI_Set_TIMCTL(GD3000_ON_PSB, gs_FlexioSPIHandle);
-    }
-    else
-    {
-		if (!SPISwitchFailReported)
+	for (;;)
+	{
+		wakeupCounter = (wakeupCounter + 1) % (WAKEUPS_BEFORE_TEMPS + 1);
+
+#if (MC_HAS_AFE_ANY_MOTOR != 0)
+		if (wakeupCounter == WAKEUPS_BEFORE_TEMPS)
 		{
-			fault_source_t src = kFAULT_RpcCallFailed;
-			FAULT_RaiseFaultEvent(src);
-			SPISwitchFailReported = true;
+			/* Select the AFEs asynchronously, the round trip overlaps with the watchdog kick and the time discipline */
+			spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiAfe, &spiSelectToken);
 		}
-    }
-
 #endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
 
-	for (;;)
-	{
 		if (RPC_KickFunctionalWatchdog(kRPC_FunctionalWatchdogBoardService) != kStatus_QMC_Ok)
 		{
 			log_record_t logEntryWithoutId = {
@@ -396,46 +416,14 @@ void BoardServiceTask(void *pvParameters)
 			LOG_QueueLogEntry(&logEntryWithoutId, false);
 		}
 
-		wakeupCounter = (wakeupCounter + 1) % (WAKEUPS_BEFORE_TEMPS + 1);
-
-		if (!SPISwitchFailReported)
-		{
-			/*=========================== Motor status polling ===========================*/
-			for (mc_motor_id_t motorId = kMC_Motor1; motorId < MC_MAX_MOTORS; motorId++)
-			{
-				GD3000_getSR(gs_sMGD3000Array[motorId], &gs_FlexioSPIHandle[motorId]);
-
-				if(gs_sMGD3000Array[motorId]->ui8ResetRequest)
-				{
-					GD3000_init(gs_sMGD3000Array[motorId], &gs_FlexioSPIHandle[motorId]);
-					gs_sMGD3000Array[motorId]->ui8ResetRequest = 0;
-				}
-				else if(gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.desaturation || \
-						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.lowVls || \
-						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.overCurrent || \
-						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.overTemp || \
-						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.framingErr || \
-						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.phaseErr)
-				{
-					GD3000_clearFlags(&gs_FlexioSPIHandle[motorId]);
-				}
-
-			}
-		}
+		/* keep the counter-based system time disciplined against the RTC */
+		(void) BOARD_DisciplineTime();
 
+#if (MC_HAS_AFE_ANY_MOTOR != 0)
 		if (wakeupCounter == WAKEUPS_BEFORE_TEMPS)
 		{
-#if (MC_HAS_AFE_ANY_MOTOR != 0)
-		    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiAfe) == kStatus_QMC_Ok)
-		    {
-		    	if (SPISwitchFailReported)
-		    	{
-					fault_source_t src = kFAULT_NoFault;
-					FAULT_RaiseFaultEvent(src);
-					SPISwitchFailReported = false;
-		    	}
-
-				helper_FLEXIO_SPI_Set_TIMCTL(AFE_ON_PSB, gs_FlexioSPIHandle);
+			if (CompleteSpiSelect(spiSelectStatus, &spiSelectToken, AFE_ON_PSB, &SPISwitchFailReported) == kStatus_QMC_Ok)
+			{
 				int index_g_PSBTemps = 0;
 				for (mc_motor_id_t motorId = kMC_Motor1; motorId <= kMC_Motor4; motorId++)
 				{
@@ -546,41 +534,76 @@ void BoardServiceTask(void *pvParameters)
 						}
 					}
 				}
-		    }
-		    else
-		    {
-				if (!SPISwitchFailReported)
+			}
+
+			/* Switch back to the GD3000s, the round trip overlaps with the MCU temperature RPC */
+			spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiMotorDriver, &spiSelectToken);
+			motorDriverSelectPending = true;
+		}
+#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
+
+		if (wakeupCounter == WAKEUPS_BEFORE_TEMPS)
+		{
+			systemTempOK = true;
+
+			/* Check the temperature of the MCU */
+			if (RPC_GetMcuTemperature(&MCUTemp) == kStatus_QMC_Ok)
+ 			{
+				g_MCUTemp = MCUTemp;
+				if (MCUTemp > g_MCU_TEMP_THRESHOLD)
 				{
-					fault_source_t src = kFAULT_RpcCallFailed;
+					fault_source_t src = kFAULT_McuOverTemperature;
 					FAULT_RaiseFaultEvent(src);
-					SPISwitchFailReported = true;
+					MCUOvertemperatureReported = true;
+					systemTempOK = false;
 				}
-		    }
+			}
+			else
+			{
+				fault_source_t src = kFAULT_RpcCallFailed;
+ 				FAULT_RaiseFaultEvent(src);
+				communicationOK = false;
+				gs_communicationErrorReported = true;				
+ 			}
+		}
 
-		    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiMotorDriver) == kStatus_QMC_Ok)
-		    {
-		    	if (SPISwitchFailReported)
-		    	{
-					fault_source_t src = kFAULT_NoFault;
-					FAULT_RaiseFaultEvent(src);
-					SPISwitchFailReported = false;
-		    	}
-
-		    	helper_FLEXIO_SPI_Set_TIMCTL(GD3000_ON_PSB, gs_FlexioSPIHandle);
-		    }
-		    else
-		    {
-				if (!SPISwitchFailReported)
+#if (MC_HAS_AFE_ANY_MOTOR != 0)
+		/* The GD3000s must be selected before they are polled and the gpioOut call must be released before the I2C access */
+		if (motorDriverSelectPending)
+		{
+			(void) CompleteSpiSelect(spiSelectStatus, &spiSelectToken, GD3000_ON_PSB, &SPISwitchFailReported);
+			motorDriverSelectPending = false;
+		}
+#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
+
+		if (!SPISwitchFailReported)
+		{
+			/*=========================== Motor status polling ===========================*/
+			for (mc_motor_id_t motorId = kMC_Motor1; motorId < MC_MAX_MOTORS; motorId++)
+			{
+				GD3000_getSR(gs_sMGD3000Array[motorId], &gs_FlexioSPIHandle[motorId]);
+
+				if(gs_sMGD3000Array[motorId]->ui8ResetRequest)
 				{
-					fault_source_t src = kFAULT_RpcCallFailed;
-					FAULT_RaiseFaultEvent(src);
-					SPISwitchFailReported = true;
+					GD3000_init(gs_sMGD3000Array[motorId], &gs_FlexioSPIHandle[motorId]);
+					gs_sMGD3000Array[motorId]->ui8ResetRequest = 0;
+				}
+				else if(gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.desaturation || \
+						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.lowVls || \
+						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.overCurrent || \
+						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.overTemp || \
+						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.framingErr || \
+						gs_sMGD3000Array[motorId]->sStatus.uStatus0.B.phaseErr)
+				{
+					GD3000_clearFlags(&gs_FlexioSPIHandle[motorId]);
 				}
-		    }
-#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
 
+			}
+		}
+
+		if (wakeupCounter == WAKEUPS_BEFORE_TEMPS)
+		{
 			/* Check the temperature measured by the sensor on the digital board */
-			bool systemTempOK = true;
 			DBTemp = 0;
 			if (BOARD_GetDbTemperature(&DBTemp) == kStatus_QMC_Ok)
 			{
@@ -601,26 +624,6 @@ void BoardServiceTask(void *pvParameters)
 				gs_communicationErrorReported = true;
 			}
 
-			/* Check the temperature of the MCU */
-			if (RPC_GetMcuTemperature(&MCUTemp) == kStatus_QMC_Ok)
- 			{
-				g_MCUTemp = MCUTemp;
-				if (MCUTemp > g_MCU_TEMP_THRESHOLD)
-				{
-					fault_source_t src = kFAULT_McuOverTemperature;
-					FAULT_RaiseFaultEvent(src);
-					MCUOvertemperatureReported = true;
-					systemTempOK = false;
-				}
-			}
-			else
-			{
-				fault_source_t src = kFAULT_RpcCallFailed;
- 				FAULT_RaiseFaultEvent(src);
-				communicationOK = false;
-				gs_communicationErrorReported = true;				
- 			}
-
 			/* If the DB and MCU temperatures and all the communications were OK but had been reported as faulty previously, send a NoFault */
 			if (systemTempOK && communicationOK && (DBOvertemperatureReported || MCUOvertemperatureReported || gs_communicationErrorReported))
 			{
@@ -654,11 +657,70 @@ static double CalculateTemperatureFromVoltage(double V)
 	T_out = T_out - T_0;
 	return T_out;
 }
+
+/*!
+ * @brief Collects a chip-select change posted by RPC_SelectPowerStageBoardSpiDeviceAsync() and reports its result.
+ *
+ * @param[in] postStatus Return value of the post, the token is only waited for if it is kStatus_QMC_Ok
+ * @param[in,out] token Completion token of the posted change
+ * @param[in] choice FlexIO SPI timing of the selected device, applied once the change is completed
+ * @param[in,out] pFailReported Set if a failed change has been reported, cleared when a change succeeds again
+ *
+ * @return The status of the post or of the remote call.
+ */
+static qmc_status_t CompleteSpiSelect(qmc_status_t postStatus, rpc_async_token_t *token, spi_selection_t choice, bool *pFailReported)
+{
+	qmc_status_t status = postStatus;
+
+	if (status == kStatus_QMC_Ok)
+	{
+		status = RPC_WaitAsync(token);
+	}
+
+	if (status == kStatus_QMC_Ok)
+	{
+		if (*pFailReported)
+		{
+			fault_source_t src = kFAULT_NoFault;
+			FAULT_RaiseFaultEvent(src);
+			*pFailReported = false;
+		}
+
+		helper_FLEXIO_SPI_Set_TIMCTL(choice, gs_FlexioSPIHandle);
+	}
+	else
+	{
+		if (!*pFailReported)
+		{
+			fault_source_t src = kFAULT_RpcCallFailed;
+			FAULT_RaiseFaultEvent(src);
+			*pFailReported = true;
+		}
+	}
+
+	return status;
+}
 #endif /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
 
 qmc_status_t SelfTest(void)
 {
+	/* Check if the BoardServiceInit() function was successfully executed - BEGIN */
+	if (!gs_BSInitialized)
+	{
+		return kStatus_QMC_Err;
+	}
+	/* Check if the BoardServiceInit() function was successfully executed - END */
+
+#if (MC_HAS_AFE_ANY_MOTOR != 0)
+	rpc_async_token_t spiSelectToken = { 0 };
+	qmc_status_t spiSelectStatus = kStatus_QMC_Err;
+
+	/* Select the AFEs asynchronously, the inter-core round trip overlaps with the system status check */
+	spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiAfe, &spiSelectToken);
+#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
+
 	uint32_t systemStatus = xEventGroupGetBits(g_systemStatusEventGroupHandle);
+	qmc_status_t retval = kStatus_QMC_Ok;
 
 	/* Check the system status - BEGIN */
 	if ((systemStatus & QMC_SYSEVENT_FAULT_Motor1) ||
@@ -670,75 +732,91 @@ qmc_status_t SelfTest(void)
 		(systemStatus & QMC_SYSEVENT_LOG_FlashError)||
 		(systemStatus & QMC_SYSEVENT_LOG_LowMemory))
 	{
-		return kStatus_QMC_Err;
+		retval = kStatus_QMC_Err;
 	}
 	/* Check the system status - END */
 
-	/* Check if the BoardServiceInit() function was successfully executed - BEGIN */
-	if (!gs_BSInitialized)
-	{
-		return kStatus_QMC_Err;
-	}
-	/* Check if the BoardServiceInit() function was successfully executed - END */
-
 	/*
 	 * GD3000 cannot be checked in current implementation
 	 */
 
 	/* Check the AFEs - BEGIN */
 #if (MC_HAS_AFE_ANY_MOTOR != 0)
-    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiAfe) != kStatus_QMC_Ok)
-    {
-    	return kStatus_QMC_Err;
-    }
-
-	helper_FLEXIO_SPI_Set_TIMCTL(AFE_ON_PSB, gs_FlexioSPIHandle);
-	for (unsigned int motorId = ((unsigned int) kMC_Motor1); motorId < MC_MAX_MOTORS; motorId++)
+	if (spiSelectStatus == kStatus_QMC_Ok)
 	{
-		if (!MC_PSBx_HAS_AFE(motorId))
-			continue;
-		gs_DevHdl[motorId].sysConfig->enabledChnMask = 0x0003;
+		spiSelectStatus = RPC_WaitAsync(&spiSelectToken);
+	}
 
-		qmc_status_t status = (qmc_status_t) NAFE_init(&gs_DevHdl[motorId], &gs_XferHdl);
+	if (spiSelectStatus != kStatus_QMC_Ok)
+	{
+		return kStatus_QMC_Err;
+	}
 
-		if (status != kStatus_QMC_Ok)
+	/* the AFEs are only checked if the system status is fine, the GD3000s are selected again in any case */
+	if (retval == kStatus_QMC_Ok)
+	{
+		helper_FLEXIO_SPI_Set_TIMCTL(AFE_ON_PSB, gs_FlexioSPIHandle);
+		for (unsigned int motorId = ((unsigned int) kMC_Motor1); motorId < MC_MAX_MOTORS; motorId++)
 		{
-			return kStatus_QMC_Err;
+			if (!MC_PSBx_HAS_AFE(motorId))
+				continue;
+			gs_DevHdl[motorId].sysConfig->enabledChnMask = 0x0003;
+
+			qmc_status_t status = (qmc_status_t) NAFE_init(&gs_DevHdl[motorId], &gs_XferHdl);
+
+			if (status != kStatus_QMC_Ok)
+			{
+				retval = kStatus_QMC_Err;
+				break;
+			}
 		}
 	}
 
-    if (RPC_SelectPowerStageBoardSpiDevice(kQMC_SpiMotorDriver) != kStatus_QMC_Ok)
-    {
-    	return kStatus_QMC_Err;
-    }
+	/* Switch back to the GD3000s, the round trip overlaps with the secure element initialization check */
+	spiSelectStatus = RPC_SelectPowerStageBoardSpiDeviceAsync(kQMC_SpiMotorDriver, &spiSelectToken);
+#endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
+	/* Check the AFEs - END */
+
+	/* Check the secure element - BEGIN */
+	if (!SE_IsInitialized())
+	{
+		retval = kStatus_QMC_Err;
+	}
+
+#if (MC_HAS_AFE_ANY_MOTOR != 0)
+	/* the gpioOut call is released before the I2C accesses below */
+	if (spiSelectStatus == kStatus_QMC_Ok)
+	{
+		spiSelectStatus = RPC_WaitAsync(&spiSelectToken);
+	}
+
+	if (spiSelectStatus != kStatus_QMC_Ok)
+	{
+		return kStatus_QMC_Err;
+	}
 
 	helper_FLEXIO_SPI_Set_TIMCTL(GD3000_ON_PSB, gs_FlexioSPIHandle);
 #endif  /* #if (MC_HAS_AFE_ANY_MOTOR != 0) */
-	/* Check the AFEs - END */
 
-	/* Check the DB Temp Sens - BEGIN */
-    float DBTemp = 0;
-    if (BOARD_GetDbTemperature(&DBTemp) != kStatus_QMC_Ok)
-    {
-    	return kStatus_QMC_Err;
-    }
-    /* Check the DB Temp Sens - END */
+	if (retval != kStatus_QMC_Ok)
+	{
+		return retval;
+	}
 
-    /* Check the secure element - BEGIN */
-    if(!SE_IsInitialized())
-    {
-    	return kStatus_QMC_Err;
-    }
-    else
-    {
-		const char *uid = SE_GetUid();
-		if(strlen(uid) <= 2)
-		{
+	const char *uid = SE_GetUid();
+	if (strlen(uid) <= 2)
+	{
+		return kStatus_QMC_Err;
+	}
+	/* Check the secure element - END */
 
-			return kStatus_QMC_Err;
-		}
-    }
-    /* Check the secure element - END */
+	/* Check the DB Temp Sens - BEGIN */
+	float DBTemp = 0;
+	if (BOARD_GetDbTemperature(&DBTemp) != kStatus_QMC_Ok)
+	{
+		return kStatus_QMC_Err;
+	}
+	/* Check the DB Temp Sens - END */
 
-    return kStatus_QMC_Ok;
+	return kStatus_QMC_Ok;
 }
@@ -68,6 +68,10 @@ static const cnf_data_t gs_cnf_data_default = {{
 			"Ensure you have the needed training to operate the system.\n"
 		},
 		{ kCONFIG_Key_CloudAzureHubName, "AZURE_IOTHUB_HubName", "Qmc2gHub" },
+		{ kCONFIG_Key_M1CtrlTuning, "M1_ctrl_tuning", {0}},
+		{ kCONFIG_Key_M2CtrlTuning, "M2_ctrl_tuning", {0}},
+		{ kCONFIG_Key_M3CtrlTuning, "M3_ctrl_tuning", {0}},
+		{ kCONFIG_Key_M4CtrlTuning, "M4_ctrl_tuning", {0}},
 }};
 
 AT_NONCACHEABLE_SECTION_ALIGN(static cnf_struct_t gs_cnf_struct_data, 16);
@@ -15,6 +15,12 @@
 #include "api_qmc_common.h"
 #include "board.h"
 #include "mlib_types.h"
+#include "api_rpc_internal.h"
+#include "mc_profile.h"
+#include "mc_plant_sim.h"
+#if FEATURE_MC_PLANT_SIMULATION
+#include "m1_sm_ref_sol.h"
+#endif
 
 fault_system_fault_t eSysFaultsRegistered;
 mc_fault_t eMotor1FaultsRegistered;
@@ -42,8 +48,38 @@ FMSTR_TSA_TABLE_BEGIN(first_table)
 	FMSTR_TSA_RW_VAR(u8FmstrTsaTemp, FMSTR_TSA_UINT8)
 FMSTR_TSA_TABLE_END()
 
+#if FEATURE_RPC_STATS
+/* RPC latency statistics (rpc_call_stats_t per call type, see api_rpc_internal.h) */
+FMSTR_TSA_TABLE_BEGIN(rpc_stats_table)
+	FMSTR_TSA_RO_MEM(g_rpcCallStats, FMSTR_TSA_MEMORY, &g_rpcCallStats, sizeof(g_rpcCallStats))
+FMSTR_TSA_TABLE_END()
+#endif
+
+#if FEATURE_MC_FOC_PROFILING
+/* FOC fast loop stage profiles (mc_profile_t per motor, see mc_profile.h) */
+FMSTR_TSA_TABLE_BEGIN(foc_profile_table)
+	FMSTR_TSA_RO_MEM(g_sMcProfile, FMSTR_TSA_MEMORY, &g_sMcProfile, sizeof(g_sMcProfile))
+FMSTR_TSA_TABLE_END()
+#endif
+
+#if FEATURE_MC_PLANT_SIMULATION
+/* Motor 1 plant simulation: set bRunReq after editing sParams/sRun, sResult is valid when it reads back 0 */
+FMSTR_TSA_TABLE_BEGIN(plant_sim_table)
+	FMSTR_TSA_RW_MEM(g_sMcPlantSim, FMSTR_TSA_MEMORY, &g_sMcPlantSim, sizeof(g_sMcPlantSim))
+FMSTR_TSA_TABLE_END()
+#endif
+
 FMSTR_TSA_TABLE_LIST_BEGIN()
   FMSTR_TSA_TABLE(first_table)
+#if FEATURE_RPC_STATS
+  FMSTR_TSA_TABLE(rpc_stats_table)
+#endif
+#if FEATURE_MC_FOC_PROFILING
+  FMSTR_TSA_TABLE(foc_profile_table)
+#endif
+#if FEATURE_MC_PLANT_SIMULATION
+  FMSTR_TSA_TABLE(plant_sim_table)
+#endif
 FMSTR_TSA_TABLE_LIST_END()
 
 /*******************************************************************************
@@ -58,7 +94,7 @@ FMSTR_TSA_TABLE_LIST_END()
 
     MC_QueueMotorCommand() is invoked in FreemasterTask() to send motor commands to a command queue.
     (a) DataHubTask() is unblocked when command queue is not empty. Motor commands are fetched from the command queue, and then written into an internal memory.
-    (b) Motor slow loop ISRs read this internal memory by MC_GetMotorCommand_fromISR(). Commands won't be updated (stay as previous one) if DataHubTask() is writing this internal memory.
+    (b) Motor slow loop ISRs read this internal memory by MC_GetMotorCommand_fromISR(). A command is taken over as a whole by the next slow loop after DataHubTask() has published it.
  */
 void FreemasterTask(void *pvParameters)
 {
@@ -78,6 +114,16 @@ void FreemasterTask(void *pvParameters)
 
 	  /* Set motor command test  - end */
 
+#if FEATURE_MC_PLANT_SIMULATION
+	  /* Plant simulation step experiment, blocks this task until it has finished */
+	  if(g_sMcPlantSim.bRunReq == TRUE)
+	  {
+		  (void)MC_PlantSimRun(&g_sMcPlantSim, &g_sM1Drive.sFocPMSM, &g_sM1Drive.sSpeed,
+							   &g_sM1Drive.sFieldWeak);
+		  g_sMcPlantSim.bRunReq = FALSE;
+	  }
+#endif
+
 	  FMSTR_Poll();
 
 	  eSysFaultsRegistered = FAULT_GetSystemFault_fromISR();
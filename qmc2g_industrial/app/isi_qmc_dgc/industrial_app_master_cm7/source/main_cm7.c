@@ -99,6 +99,7 @@ extern void LPUART8_IRQHandler(void);
 #define QMC_TASK_STACKSIZE_FAULTHANDLING         ( 2 * configMINIMAL_STACK_SIZE)
 #define QMC_TASK_STACKSIZE_BOARDSERVICE          ( 2 * configMINIMAL_STACK_SIZE)
 #define QMC_TASK_STACKSIZE_DATAHUB               ( 1 * configMINIMAL_STACK_SIZE)
+#define QMC_TASK_STACKSIZE_CTRLTUNINGSTORE       ( 2 * configMINIMAL_STACK_SIZE)
 #define QMC_TASK_STACKSIZE_LOCALSERVICE          ( 6 * configMINIMAL_STACK_SIZE)
 #define QMC_TASK_STACKSIZE_JSONMOTORAPISERVICE   ( 1 * configMINIMAL_STACK_SIZE)
 #define QMC_TASK_STACKSIZE_WEBSERVICELOGGING     ( 2 * configMINIMAL_STACK_SIZE)
@@ -109,6 +110,7 @@ extern void LPUART8_IRQHandler(void);
 extern TaskHandle_t g_fault_handling_task_handle;
 extern TaskHandle_t g_board_service_task_handle;
 extern TaskHandle_t g_datahub_task_handle;
+extern TaskHandle_t g_ctrl_tuning_store_task_handle;
 extern TaskHandle_t g_datalogger_task_handle;
 extern TaskHandle_t g_local_service_task_handle;
 extern TaskHandle_t g_freemaster_task_handle;
@@ -122,6 +124,7 @@ extern TaskHandle_t g_awdg_connection_service_task_handle;
 static StaticTask_t gs_fault_handling_task;
 static StaticTask_t gs_board_service_task;
 static StaticTask_t gs_datahub_task;
+static StaticTask_t gs_ctrl_tuning_store_task;
 static StaticTask_t gs_datalogger_task;
 static StaticTask_t gs_local_service_task;
 static StaticTask_t gs_json_motor_api_service_task;
@@ -129,6 +132,7 @@ static StaticTask_t gs_webservice_logging_task;
 __attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_fault_handling_task_stack[QMC_TASK_STACKSIZE_FAULTHANDLING];
 __attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_board_service_task_stack[QMC_TASK_STACKSIZE_BOARDSERVICE];
 __attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_datahub_task_stack[QMC_TASK_STACKSIZE_DATAHUB];
+__attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_ctrl_tuning_store_task_stack[QMC_TASK_STACKSIZE_CTRLTUNINGSTORE];
 __attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_datalogger_task_stack[QMC_TASK_STACKSIZE_DATALOGGER];
 __attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_local_service_task_stack[QMC_TASK_STACKSIZE_LOCALSERVICE];
 __attribute__((section(".bss.$SRAM_OC1"))) static StackType_t  gs_json_motor_api_service_task_stack[QMC_TASK_STACKSIZE_JSONMOTORAPISERVICE];
@@ -233,6 +237,8 @@ int main(void) {
 			                                        QMC_TASK_PRIO_NORMAL, gs_board_service_task_stack, &gs_board_service_task);
 	g_datahub_task_handle = xTaskCreateStatic(DataHubTask, "DataHub", QMC_TASK_STACKSIZE_DATAHUB, NULL,
 			                                  QMC_TASK_PRIO_ELEVATED, gs_datahub_task_stack, &gs_datahub_task);
+	g_ctrl_tuning_store_task_handle = xTaskCreateStatic(CtrlTuningStoreTask, "CtrlTuningStore", QMC_TASK_STACKSIZE_CTRLTUNINGSTORE, NULL,
+			                                            QMC_TASK_PRIO_NORMAL, gs_ctrl_tuning_store_task_stack, &gs_ctrl_tuning_store_task);
     g_local_service_task_handle = xTaskCreateStatic(LocalServiceTask, "LocalServiceTask", QMC_TASK_STACKSIZE_LOCALSERVICE, NULL,
     		                                        QMC_TASK_PRIO_NORMAL, gs_local_service_task_stack, &gs_local_service_task);
     g_json_motor_api_service_task_handle = xTaskCreateStatic(JsonMotorAPIServiceTask, "JSONMotorAPIServiceTask", QMC_TASK_STACKSIZE_JSONMOTORAPISERVICE, NULL,
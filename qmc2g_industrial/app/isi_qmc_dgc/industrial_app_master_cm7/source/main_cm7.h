@@ -129,6 +129,7 @@ typedef struct _header
 
 /* Init task definition */
 extern void DataHubTask(void *pvParameters);
+extern void CtrlTuningStoreTask(void *pvParameters);
 extern void DataloggerTask(void *pvParameters);
 extern void StartupTask(void *pvParameters);
 extern void JsonMotorAPIServiceTask(void *pvParameters);
@@ -0,0 +1,540 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#include "mc_plant_sim.h"
+
+#if FEATURE_MC_PLANT_SIMULATION
+
+#include "m1_pmsm_appconfig.h"
+#include "utils/debug.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define MC_PLANT_2PI (2.0F * FLOAT_PI)
+
+/*! @brief Online step response metrics, the samples are normalized to the step size */
+typedef struct _mc_plant_step_metrics
+{
+    uint32_t ui32Rise10;        /* First sample at or above 10 %, UINT32_MAX before */
+    uint32_t ui32Rise90;        /* First sample at or above 90 %, UINT32_MAX before */
+    uint32_t ui32LastOutside;   /* Last sample outside the settling band, UINT32_MAX if none */
+    uint32_t ui32SteadyCount;   /* Number of steady state samples */
+    float_t fltPeak;            /* Highest sample */
+    float_t fltSteadyMin;       /* Steady state extremes and sum */
+    float_t fltSteadyMax;
+    float_t fltSteadySum;
+} mc_plant_step_metrics_t;
+
+/*! @brief Cycle counter statistics */
+typedef struct _mc_plant_cycles
+{
+    uint32_t ui32Count;
+    uint32_t ui32Min;
+    uint32_t ui32Max;
+    uint64_t ui64Sum;
+} mc_plant_cycles_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+
+static bool_t MC_PlantSimIsValid(const mc_plant_sim_t *psSim);
+static void MC_PlantCyclesUpdate(mc_plant_cycles_t *psCycles, uint32_t ui32Cycles);
+static frac16_t MC_PlantAdcQuantize(float_t fltVal, float_t fltScale, uint16_t ui16Bits);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+mc_plant_sim_t g_sMcPlantSim = {
+    .sParams =
+        {
+            .fltRs            = M1_R,
+            .fltLd            = M1_LD,
+            .fltLq            = M1_LQ,
+            .fltFlux          = M1_FLUX,
+            .fltJ             = M1_J,
+            .fltB             = M1_VISC_FRICTION,
+            .fltUDcBus        = 24.0F,
+            .fltDeadTime      = M1_PWM_DEADTIME * 1.0e-6F,
+            .fltPwmFreq       = M1_FAST_LOOP_FREQ,
+            .fltSlowLoopFreq  = M1_SLOW_LOOP_FREQ,
+            .fltIScale        = M1_I_MAX,
+            .fltUDcBusScale   = M1_U_DCB_MAX,
+            .fltQdcTimerFreq  = M1_QDC_TIMER_FREQUENCY,
+            .ui32EncoderLines = M1_ENCODER_LINES,
+            .ui16PolePairs    = M1_MOTOR_PP,
+            .ui16AdcBits      = 12U,
+            .ui16SubSteps     = 4U,
+        },
+    .sRun =
+        {
+            .eMode         = kMC_PlantSimSpeedStep,
+            .fltStep       = 1000.0F * M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF,
+            .fltLoadTorque = 0.0F,
+            .fltSettleBand = 0.02F,
+            .ui32Steps     = (uint32_t)(0.5F * M1_FAST_LOOP_FREQ),
+        },
+    .eStatus = kStatus_QMC_Ok,
+};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void MC_PlantInit(mc_plant_t *psPlant, const mc_plant_params_t *psParams)
+{
+    psPlant->psParams      = psParams;
+    psPlant->fltId         = 0.0F;
+    psPlant->fltIq         = 0.0F;
+    psPlant->fltSpeedMech  = 0.0F;
+    psPlant->fltPosMech    = 0.0F;
+    psPlant->i32Rev        = 0;
+    psPlant->fltLoadTorque = 0.0F;
+    psPlant->bLocked       = FALSE;
+    psPlant->i32QdcCount      = 0;
+    psPlant->ui32QdcTimer     = 0U;
+    psPlant->ui32QdcEdgeTimer = 0U;
+    psPlant->fltQdcTimerFrac  = 0.0F;
+}
+
+void MC_PlantStep(mc_plant_t *psPlant, const GMCLIB_3COOR_T_F16 *psDutyABC)
+{
+    const mc_plant_params_t *psParams = psPlant->psParams;
+    const float_t fltDt      = 0.5F / (psParams->fltPwmFreq * (float_t)psParams->ui16SubSteps);
+    const float_t fltTicks   = fltDt * psParams->fltQdcTimerFreq;
+    const int32_t i32CountsPerRev = 4 * (int32_t)psParams->ui32EncoderLines;
+    const float_t fltCountAngle   = MC_PLANT_2PI / (float_t)i32CountsPerRev;
+    const float_t fltDutyErr = psParams->fltDeadTime * psParams->fltPwmFreq;
+    const float_t fltPp      = (float_t)psParams->ui16PolePairs;
+    const float_t fltDuty[3] = {MLIB_Conv_FLTs(psDutyABC->f16A), MLIB_Conv_FLTs(psDutyABC->f16B),
+                                MLIB_Conv_FLTs(psDutyABC->f16C)};
+    float_t fltPosEl, fltSin, fltCos, fltSpeedEl, fltTorque;
+    float_t fltIAlpha, fltIBeta, fltI[3], fltU[3], fltUCommon, fltUAlpha, fltUBeta, fltUd, fltUq, fltDId, fltDIq;
+    float_t fltEdgeDist;
+    int32_t i32CountInRev, i32Count;
+    uint32_t ui32Ticks;
+
+    for (uint16_t ui16Sub = 0U; ui16Sub < psParams->ui16SubSteps; ui16Sub++)
+    {
+        /* electrical position wrapped to [-pi, pi) */
+        fltPosEl = fltPp * psPlant->fltPosMech;
+        fltPosEl -= MC_PLANT_2PI * (float_t)(int32_t)((fltPosEl + FLOAT_PI) / MC_PLANT_2PI);
+        fltSin   = GFLIB_Sin_FLT(fltPosEl);
+        fltCos   = GFLIB_Cos_FLT(fltPosEl);
+
+        /* phase currents */
+        fltIAlpha = psPlant->fltId * fltCos - psPlant->fltIq * fltSin;
+        fltIBeta  = psPlant->fltId * fltSin + psPlant->fltIq * fltCos;
+        fltI[0]   = fltIAlpha;
+        fltI[1]   = -0.5F * fltIAlpha + 0.8660254F * fltIBeta;
+        fltI[2]   = -0.5F * fltIAlpha - 0.8660254F * fltIBeta;
+
+        /* inverter, the dead time delays the commanded edge in the direction of the phase current */
+        for (uint32_t ui32Ph = 0U; ui32Ph < 3U; ui32Ph++)
+        {
+            float_t fltD = fltDuty[ui32Ph];
+
+            if (fltI[ui32Ph] > 0.0F)
+            {
+                fltD -= fltDutyErr;
+            }
+            else if (fltI[ui32Ph] < 0.0F)
+            {
+                fltD += fltDutyErr;
+            }
+            fltD         = (fltD < 0.0F) ? 0.0F : ((fltD > 1.0F) ? 1.0F : fltD);
+            fltU[ui32Ph] = fltD * psParams->fltUDcBus;
+        }
+        fltUCommon = (fltU[0] + fltU[1] + fltU[2]) * (1.0F / 3.0F);
+        fltUAlpha  = fltU[0] - fltUCommon;
+        fltUBeta   = (fltU[1] - fltU[2]) * 0.57735027F;
+        fltUd      = fltUAlpha * fltCos + fltUBeta * fltSin;
+        fltUq      = -fltUAlpha * fltSin + fltUBeta * fltCos;
+
+        /* motor in the rotor frame */
+        fltSpeedEl = fltPp * psPlant->fltSpeedMech;
+        fltDId     = (fltUd - psParams->fltRs * psPlant->fltId + fltSpeedEl * psParams->fltLq * psPlant->fltIq) /
+                 psParams->fltLd;
+        fltDIq = (fltUq - psParams->fltRs * psPlant->fltIq - fltSpeedEl * psParams->fltLd * psPlant->fltId -
+                  fltSpeedEl * psParams->fltFlux) /
+                 psParams->fltLq;
+        fltTorque = 1.5F * fltPp *
+                    (psParams->fltFlux * psPlant->fltIq +
+                     (psParams->fltLd - psParams->fltLq) * psPlant->fltId * psPlant->fltIq);
+
+        psPlant->fltId += fltDId * fltDt;
+        psPlant->fltIq += fltDIq * fltDt;
+
+        if (!psPlant->bLocked)
+        {
+            psPlant->fltSpeedMech +=
+                (fltTorque - psParams->fltB * psPlant->fltSpeedMech - psPlant->fltLoadTorque) / psParams->fltJ * fltDt;
+            psPlant->fltPosMech += psPlant->fltSpeedMech * fltDt;
+            if (psPlant->fltPosMech >= MC_PLANT_2PI)
+            {
+                psPlant->fltPosMech -= MC_PLANT_2PI;
+                psPlant->i32Rev++;
+            }
+            else if (psPlant->fltPosMech < 0.0F)
+            {
+                psPlant->fltPosMech += MC_PLANT_2PI;
+                psPlant->i32Rev--;
+            }
+        }
+
+        /* quadrature decoder, the timer is captured at the last edge within the step */
+        psPlant->fltQdcTimerFrac += fltTicks;
+        ui32Ticks = (uint32_t)psPlant->fltQdcTimerFrac;
+        psPlant->fltQdcTimerFrac -= (float_t)ui32Ticks;
+        psPlant->ui32QdcTimer += ui32Ticks;
+
+        /* the float position may round up to a full revolution */
+        i32CountInRev = (int32_t)(psPlant->fltPosMech / fltCountAngle);
+        i32CountInRev = (i32CountInRev < i32CountsPerRev) ? i32CountInRev : (i32CountsPerRev - 1);
+        i32Count      = psPlant->i32Rev * i32CountsPerRev + i32CountInRev;
+        if (i32Count != psPlant->i32QdcCount)
+        {
+            /* angle travelled since the edge */
+            fltEdgeDist = (i32Count > psPlant->i32QdcCount) ?
+                              (psPlant->fltPosMech - (float_t)i32CountInRev * fltCountAngle) :
+                              ((float_t)(i32CountInRev + 1) * fltCountAngle - psPlant->fltPosMech);
+            fltEdgeDist = fltEdgeDist / MLIB_Abs_FLT(psPlant->fltSpeedMech) * psParams->fltQdcTimerFreq;
+            psPlant->ui32QdcEdgeTimer =
+                psPlant->ui32QdcTimer - (uint32_t)((fltEdgeDist < fltTicks) ? fltEdgeDist : fltTicks);
+            psPlant->i32QdcCount = i32Count;
+        }
+    }
+}
+
+void MC_PlantGetAdc(const mc_plant_t *psPlant, GMCLIB_3COOR_T_F16 *psIABC, frac16_t *pf16UDcBus)
+{
+    const mc_plant_params_t *psParams = psPlant->psParams;
+    float_t fltPosEl = (float_t)psParams->ui16PolePairs * psPlant->fltPosMech;
+    float_t fltSin, fltCos, fltIAlpha, fltIBeta;
+
+    fltPosEl -= MC_PLANT_2PI * (float_t)(int32_t)((fltPosEl + FLOAT_PI) / MC_PLANT_2PI);
+    fltSin    = GFLIB_Sin_FLT(fltPosEl);
+    fltCos    = GFLIB_Cos_FLT(fltPosEl);
+    fltIAlpha = psPlant->fltId * fltCos - psPlant->fltIq * fltSin;
+    fltIBeta  = psPlant->fltId * fltSin + psPlant->fltIq * fltCos;
+
+    psIABC->f16A = MC_PlantAdcQuantize(fltIAlpha, psParams->fltIScale, psParams->ui16AdcBits);
+    psIABC->f16B = MC_PlantAdcQuantize(-0.5F * fltIAlpha + 0.8660254F * fltIBeta, psParams->fltIScale,
+                                       psParams->ui16AdcBits);
+    psIABC->f16C = MC_PlantAdcQuantize(-0.5F * fltIAlpha - 0.8660254F * fltIBeta, psParams->fltIScale,
+                                       psParams->ui16AdcBits);
+    *pf16UDcBus  = MC_PlantAdcQuantize(psParams->fltUDcBus, psParams->fltUDcBusScale, psParams->ui16AdcBits);
+}
+
+void MC_PlantGetQdc(const mc_plant_t *psPlant, mc_plant_qdc_t *psQdc)
+{
+    psQdc->i32Count      = psPlant->i32QdcCount;
+    psQdc->ui32Timer     = psPlant->ui32QdcTimer;
+    psQdc->ui32EdgeTimer = psPlant->ui32QdcEdgeTimer;
+}
+
+qmc_status_t MC_PlantSimRun(mc_plant_sim_t *psSim,
+                            const mcs_pmsm_foc_t *psFocTemplate,
+                            const mcs_speed_t *psSpeedTemplate,
+                            const mcs_pmsm_fw_t *psFwTemplate)
+{
+    qmc_status_t ret = kStatus_QMC_Ok;
+    const mc_plant_params_t *psParams;
+    const mc_plant_sim_run_t *psRun;
+    mcs_pmsm_foc_t *psFoc;
+    mcs_speed_t *psSpeed;
+    mcs_pmsm_fw_t *psFw;
+    mc_plant_step_metrics_t sMetrics = {UINT32_MAX, UINT32_MAX, UINT32_MAX, 0U, 0.0F, 0.0F, 0.0F, 0.0F};
+    mc_plant_cycles_t sFastCycles = {0U, UINT32_MAX, 0U, 0U};
+    mc_plant_cycles_t sSlowCycles = {0U, UINT32_MAX, 0U, 0U};
+    GMCLIB_3COOR_T_F16 sDutyApplied = {FRAC16(0.5), FRAC16(0.5), FRAC16(0.5)};
+    mc_plant_qdc_t sQdc, sQdcEdge;
+    uint32_t ui32SlowDiv, ui32CountsPerRev, ui32SteadyStart, ui32Start, ui32EdgeTime;
+    int32_t i32CountInRev;
+    float_t fltCountToSpeed, fltSpeedMax, fltY;
+
+    if ((NULL == psSim) || (NULL == psFocTemplate) || (NULL == psSpeedTemplate) || (NULL == psFwTemplate))
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    else if (!MC_PlantSimIsValid(psSim))
+    {
+        ret            = kStatus_QMC_ErrArgInvalid;
+        psSim->eStatus = ret;
+    }
+    else
+    {
+        psParams    = &psSim->sParams;
+        psRun       = &psSim->sRun;
+        ui32SlowDiv = (uint32_t)(psParams->fltPwmFreq / psParams->fltSlowLoopFreq + 0.5F);
+
+        /* controllers under test with cleared states */
+        psFoc   = &psSim->sFocPMSM;
+        psSpeed = &psSim->sSpeed;
+        psFw    = &psSim->sFieldWeak;
+        *psFoc   = *psFocTemplate;
+        *psSpeed = *psSpeedTemplate;
+        *psFw    = *psFwTemplate;
+
+        psFoc->sIDQReq.fltD           = 0.0F;
+        psFoc->sIDQReq.fltQ           = 0.0F;
+        psFoc->sUAlBeReq.fltAlpha     = 0.0F;
+        psFoc->sUAlBeReq.fltBeta      = 0.0F;
+        psFoc->sUDQReq.fltD           = 0.0F;
+        psFoc->sUDQReq.fltQ           = 0.0F;
+        psFoc->sIdPiParams.fltIAccK_1 = 0.0F;
+        psFoc->sIqPiParams.fltIAccK_1 = 0.0F;
+        psFoc->sIdPiParams.bLimFlag   = FALSE;
+        psFoc->sIqPiParams.bLimFlag   = FALSE;
+        psFoc->bIdPiStopInteg         = FALSE;
+        psFoc->bIqPiStopInteg         = FALSE;
+        psFoc->bOpenLoop              = FALSE;
+        psFoc->bPosExtOn              = TRUE;
+        psFoc->bCurrentLoopOn         = TRUE;
+        psFoc->fltSpeedElEst          = 0.0F;
+        psFoc->f16PosElEst            = 0;
+        psFoc->sDutyABC               = sDutyApplied;
+        AMCLIB_PMSMBemfObsrvDQInit_A32fff(&psFoc->sBemfObsrv);
+        AMCLIB_TrackObsrvInit_A32af(ACC32(0.0), &psFoc->sTo);
+        GDFLIB_FilterIIR1Init_FLT(&psFoc->sSpeedElEstFilt);
+        GDFLIB_FilterIIR1Init_FLT(&psFoc->sUDcBusFilter);
+        /* start with a settled DC bus filter like the application does after calibration */
+        psFoc->sUDcBusFilter.fltFltBfrX[0] = psParams->fltUDcBus;
+        psFoc->sUDcBusFilter.fltFltBfrY[0] = psParams->fltUDcBus;
+#if FEATURE_MC_FOC_PROFILING
+        MC_ProfileInit(&psSim->sProfile);
+        psFoc->psProfile = &psSim->sProfile;
+#endif
+
+        psSpeed->sSpeedRampParams.fltState   = 0.0F;
+        psSpeed->sSpeedPiParams.fltIAccK_1   = 0.0F;
+        psSpeed->sSpeedPiParams.bLimFlag     = FALSE;
+        psSpeed->bSpeedPiStopInteg           = FALSE;
+        psSpeed->fltSpeed                    = 0.0F;
+        psSpeed->fltSpeedFilt                = 0.0F;
+        psSpeed->fltSpeedRamp                = 0.0F;
+        psSpeed->fltSpeedCmd                 = psRun->fltStep;
+        psSpeed->fltIqReq                    = 0.0F;
+        psSpeed->bIqAccFwdOn                 = FALSE;
+        GDFLIB_FilterIIR1Init_FLT(&psSpeed->sSpeedFilter);
+        GDFLIB_FilterIIR1Init_FLT(&psSpeed->sIqFwdFilter);
+        PIControllerDesatInit(&psSpeed->sSpeedPiParamsDesat);
+
+        AMCLIB_CtrlFluxWkngInit_FLT(0.0F, &psFw->sFwCtrl);
+        psFw->sFwCtrl.pbStopIntegFlag = &psFw->bFwStopInteg;
+        psFw->bFwStopInteg            = FALSE;
+
+        MC_PlantInit(&psSim->sPlant, psParams);
+        if (kMC_PlantSimCurrentStep == psRun->eMode)
+        {
+            psSim->sPlant.bLocked = TRUE;
+            psFoc->sIDQReq.fltQ   = psRun->fltStep;
+        }
+        else
+        {
+            psSim->sPlant.fltLoadTorque = psRun->fltLoadTorque;
+        }
+
+        ui32CountsPerRev = 4U * psParams->ui32EncoderLines;
+        fltCountToSpeed  = MC_PLANT_2PI * (float_t)psParams->ui16PolePairs * psParams->fltQdcTimerFreq /
+                          (float_t)ui32CountsPerRev;
+        ui32SteadyStart  = psRun->ui32Steps - psRun->ui32Steps / 4U;
+        MC_PlantGetQdc(&psSim->sPlant, &sQdcEdge);
+
+        /* enable the cycle counter (without resetting it, it may be used elsewhere) */
+        DEBUG_ARM_CM_DEMCR |= 1U << 24U;
+        DEBUG_ARM_CM_DWT_CTRL |= 1U << 0U;
+
+        for (uint32_t ui32Step = 0U; ui32Step < psRun->ui32Steps; ui32Step++)
+        {
+            /* sensors at the start of the period */
+            MC_PlantGetAdc(&psSim->sPlant, &psFoc->sIABCFrac, &psFoc->f16UDcBus);
+            psFoc->sIABC.fltA    = MLIB_ConvSc_FLTsf(psFoc->sIABCFrac.f16A, psParams->fltIScale);
+            psFoc->sIABC.fltB    = MLIB_ConvSc_FLTsf(psFoc->sIABCFrac.f16B, psParams->fltIScale);
+            psFoc->sIABC.fltC    = MLIB_ConvSc_FLTsf(psFoc->sIABCFrac.f16C, psParams->fltIScale);
+            psFoc->fltUDcBus     = MLIB_ConvSc_FLTsf(psFoc->f16UDcBus, psParams->fltUDcBusScale);
+            psFoc->fltUDcBusFilt = GDFLIB_FilterIIR1_FLT(psFoc->fltUDcBus, &psFoc->sUDcBusFilter);
+
+            /* encoder electrical position, counter zero is aligned with the d axis */
+            MC_PlantGetQdc(&psSim->sPlant, &sQdc);
+            i32CountInRev = sQdc.i32Count % (int32_t)ui32CountsPerRev;
+            i32CountInRev += (i32CountInRev < 0) ? (int32_t)ui32CountsPerRev : 0;
+            psFoc->f16PosElExt = (frac16_t)(uint16_t)(
+                ((uint64_t)(uint32_t)i32CountInRev * psParams->ui16PolePairs * 65536U) / ui32CountsPerRev);
+
+            /* fast loop */
+            ui32Start = DEBUG_ARM_CM_DWT_CYCCNT;
+            MCS_PMSMFocCtrl(psFoc);
+            MC_PlantCyclesUpdate(&sFastCycles, DEBUG_ARM_CM_DWT_CYCCNT - ui32Start);
+
+            /* slow loop */
+            if ((kMC_PlantSimSpeedStep == psRun->eMode) && (0U == (ui32Step % ui32SlowDiv)))
+            {
+                /* counts over the time between their edges, without a new edge the speed is below one count
+                 * since the last edge */
+                if (sQdc.i32Count != sQdcEdge.i32Count)
+                {
+                    ui32EdgeTime      = sQdc.ui32EdgeTimer - sQdcEdge.ui32EdgeTimer;
+                    psSpeed->fltSpeed = (float_t)(sQdc.i32Count - sQdcEdge.i32Count) * fltCountToSpeed /
+                                        (float_t)((0U == ui32EdgeTime) ? 1U : ui32EdgeTime);
+                    sQdcEdge          = sQdc;
+                }
+                else
+                {
+                    fltSpeedMax = fltCountToSpeed / (float_t)(sQdc.ui32Timer - sQdcEdge.ui32EdgeTimer + 1U);
+                    psSpeed->fltSpeed =
+                        (psSpeed->fltSpeed > fltSpeedMax) ?
+                            fltSpeedMax :
+                            ((psSpeed->fltSpeed < -fltSpeedMax) ? -fltSpeedMax : psSpeed->fltSpeed);
+                }
+                psSpeed->fltSpeedFilt = GDFLIB_FilterIIR1_FLT(psSpeed->fltSpeed, &psSpeed->sSpeedFilter);
+                psSpeed->bIqPiLimFlag = psFoc->sIqPiParams.bLimFlag;
+
+                ui32Start = DEBUG_ARM_CM_DWT_CYCCNT;
+                MCS_PMSMFocCtrlSpeed(psSpeed);
+                MCS_PMSMFieldWeakening(psFw, psFoc, psSpeed);
+                MC_PlantCyclesUpdate(&sSlowCycles, DEBUG_ARM_CM_DWT_CYCCNT - ui32Start);
+            }
+
+            /* the previous duty cycles drive the period until the half cycle reload */
+            MC_PlantStep(&psSim->sPlant, &sDutyApplied);
+            sDutyApplied = psFoc->sDutyABC;
+            MC_PlantStep(&psSim->sPlant, &sDutyApplied);
+
+            /* response normalized to the step size */
+            fltY = (kMC_PlantSimCurrentStep == psRun->eMode) ?
+                       psSim->sPlant.fltIq :
+                       (float_t)psParams->ui16PolePairs * psSim->sPlant.fltSpeedMech;
+            fltY /= psRun->fltStep;
+
+            if ((UINT32_MAX == sMetrics.ui32Rise10) && (fltY >= 0.1F))
+            {
+                sMetrics.ui32Rise10 = ui32Step;
+            }
+            if ((UINT32_MAX == sMetrics.ui32Rise90) && (fltY >= 0.9F))
+            {
+                sMetrics.ui32Rise90 = ui32Step;
+            }
+            if (MLIB_Abs_FLT(fltY - 1.0F) > psRun->fltSettleBand)
+            {
+                sMetrics.ui32LastOutside = ui32Step;
+            }
+            sMetrics.fltPeak = (fltY > sMetrics.fltPeak) ? fltY : sMetrics.fltPeak;
+            if (ui32Step >= ui32SteadyStart)
+            {
+                if (0U == sMetrics.ui32SteadyCount)
+                {
+                    sMetrics.fltSteadyMin = fltY;
+                    sMetrics.fltSteadyMax = fltY;
+                }
+                sMetrics.fltSteadyMin = (fltY < sMetrics.fltSteadyMin) ? fltY : sMetrics.fltSteadyMin;
+                sMetrics.fltSteadyMax = (fltY > sMetrics.fltSteadyMax) ? fltY : sMetrics.fltSteadyMax;
+                sMetrics.fltSteadySum += fltY;
+                sMetrics.ui32SteadyCount++;
+            }
+        }
+
+        /* sample n is taken at the end of period n */
+        psSim->sResult.fltRiseTime =
+            (UINT32_MAX == sMetrics.ui32Rise90) ?
+                -1.0F :
+                (float_t)(sMetrics.ui32Rise90 - sMetrics.ui32Rise10) / psParams->fltPwmFreq;
+        psSim->sResult.fltOvershoot = (sMetrics.fltPeak > 1.0F) ? ((sMetrics.fltPeak - 1.0F) * 100.0F) : 0.0F;
+        if (UINT32_MAX == sMetrics.ui32LastOutside)
+        {
+            psSim->sResult.fltSettlingTime = 0.0F;
+        }
+        else if (sMetrics.ui32LastOutside == (psRun->ui32Steps - 1U))
+        {
+            psSim->sResult.fltSettlingTime = -1.0F;
+        }
+        else
+        {
+            psSim->sResult.fltSettlingTime = (float_t)(sMetrics.ui32LastOutside + 2U) / psParams->fltPwmFreq;
+        }
+        psSim->sResult.fltFinal  = sMetrics.fltSteadySum / (float_t)sMetrics.ui32SteadyCount * psRun->fltStep;
+        psSim->sResult.fltRipple = (sMetrics.fltSteadyMax - sMetrics.fltSteadyMin) * MLIB_Abs_FLT(psRun->fltStep);
+
+        psSim->sResult.ui32FastCyclesMin  = sFastCycles.ui32Min;
+        psSim->sResult.ui32FastCyclesMean = (uint32_t)(sFastCycles.ui64Sum / sFastCycles.ui32Count);
+        psSim->sResult.ui32FastCyclesMax  = sFastCycles.ui32Max;
+        psSim->sResult.ui32SlowCyclesMin  = (0U == sSlowCycles.ui32Count) ? 0U : sSlowCycles.ui32Min;
+        psSim->sResult.ui32SlowCyclesMean =
+            (0U == sSlowCycles.ui32Count) ? 0U : (uint32_t)(sSlowCycles.ui64Sum / sSlowCycles.ui32Count);
+        psSim->sResult.ui32SlowCyclesMax = sSlowCycles.ui32Max;
+        psSim->eStatus                   = ret;
+    }
+
+    return ret;
+}
+
+/*!
+ * @brief Checks the parameters and the experiment of a simulation context.
+ *
+ * @param psSim         The pointer of the simulation context
+ *
+ * @return TRUE if MC_PlantSimRun() can use them
+ */
+static bool_t MC_PlantSimIsValid(const mc_plant_sim_t *psSim)
+{
+    const mc_plant_params_t *psParams = &psSim->sParams;
+    const mc_plant_sim_run_t *psRun   = &psSim->sRun;
+
+    return (bool_t)((0.0F != psRun->fltStep) && (0U != psRun->ui32Steps) && (psRun->fltSettleBand > 0.0F) &&
+                    (psParams->fltSlowLoopFreq > 0.0F) && (psParams->fltPwmFreq >= psParams->fltSlowLoopFreq) &&
+                    (0U != psParams->ui16SubSteps) && (0U != psParams->ui32EncoderLines) &&
+                    (0U != psParams->ui16PolePairs) && (0U != psParams->ui16AdcBits) &&
+                    (psParams->ui16AdcBits <= 16U) && (psParams->fltIScale > 0.0F) &&
+                    (psParams->fltUDcBusScale > 0.0F) && (psParams->fltQdcTimerFreq > 0.0F) &&
+                    (psParams->fltLd > 0.0F) && (psParams->fltLq > 0.0F) &&
+                    (psParams->fltJ > 0.0F));
+}
+
+/*!
+ * @brief Adds one duration to the cycle statistics.
+ *
+ * @param psCycles      The pointer of the statistics
+ * @param ui32Cycles    Duration in core cycles
+ *
+ * @return None
+ */
+static void MC_PlantCyclesUpdate(mc_plant_cycles_t *psCycles, uint32_t ui32Cycles)
+{
+    psCycles->ui32Count++;
+    psCycles->ui64Sum += ui32Cycles;
+    psCycles->ui32Min = (ui32Cycles < psCycles->ui32Min) ? ui32Cycles : psCycles->ui32Min;
+    psCycles->ui32Max = (ui32Cycles > psCycles->ui32Max) ? ui32Cycles : psCycles->ui32Max;
+}
+
+/*!
+ * @brief Converts a value to a left aligned ADC result of the given resolution.
+ *
+ * @param fltVal        Value
+ * @param fltScale      Full scale of the converter
+ * @param ui16Bits      Resolution including the sign
+ *
+ * @return Result in frac16_t, saturated to the converter range
+ */
+static frac16_t MC_PlantAdcQuantize(float_t fltVal, float_t fltScale, uint16_t ui16Bits)
+{
+    const float_t fltLsb = (float_t)(1UL << (16U - ui16Bits));
+    float_t fltCode = fltVal / fltScale * 32768.0F / fltLsb;
+
+    /* round half away from zero to the nearest code */
+    fltCode = (float_t)(int32_t)((fltCode >= 0.0F) ? (fltCode + 0.5F) : (fltCode - 0.5F)) * fltLsb;
+    fltCode = (fltCode > 32767.0F) ? (32768.0F - fltLsb) : ((fltCode < -32768.0F) ? -32768.0F : fltCode);
+
+    return (frac16_t)(int32_t)fltCode;
+}
+
+#endif /* FEATURE_MC_PLANT_SIMULATION */
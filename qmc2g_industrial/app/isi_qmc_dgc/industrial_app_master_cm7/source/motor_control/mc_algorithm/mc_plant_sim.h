@@ -0,0 +1,225 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#ifndef MC_PLANT_SIM_H
+#define MC_PLANT_SIM_H
+
+#include "qmc_features_config.h"
+
+#if FEATURE_MC_PLANT_SIMULATION
+#include "api_qmc_common.h"
+#include "pmsm_control.h"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#if FEATURE_MC_PLANT_SIMULATION
+
+/*! @brief PMSM, inverter and sensor parameters of the simulated plant */
+typedef struct _mc_plant_params
+{
+    float_t fltRs;              /*!< [ohm] Phase resistance */
+    float_t fltLd;              /*!< [H] d-axis inductance */
+    float_t fltLq;              /*!< [H] q-axis inductance */
+    float_t fltFlux;            /*!< [Wb] Permanent magnet flux linkage */
+    float_t fltJ;               /*!< [kg.m^2] Inertia of rotor and load */
+    float_t fltB;               /*!< [N.m.s/rad] Viscous friction */
+    float_t fltUDcBus;          /*!< [V] DC bus voltage */
+    float_t fltDeadTime;        /*!< [s] Inverter dead time */
+    float_t fltPwmFreq;         /*!< [Hz] PWM frequency, the fast loop runs once per PWM period */
+    float_t fltSlowLoopFreq;    /*!< [Hz] Speed loop frequency, an integer fraction of the PWM frequency */
+    float_t fltIScale;          /*!< [A] Phase current ADC full scale */
+    float_t fltUDcBusScale;     /*!< [V] DC bus voltage ADC full scale */
+    float_t fltQdcTimerFreq;    /*!< [Hz] Clock of the QDC timer that captures the time of the last edge */
+    uint32_t ui32EncoderLines;  /*!< Encoder lines per mechanical revolution, the QDC counts four edges per line */
+    uint16_t ui16PolePairs;     /*!< Motor pole pairs */
+    uint16_t ui16AdcBits;       /*!< ADC resolution, at most 16 */
+    uint16_t ui16SubSteps;      /*!< Integration steps per half PWM period */
+} mc_plant_params_t;
+
+/*! @brief State of the simulated plant */
+typedef struct _mc_plant
+{
+    const mc_plant_params_t *psParams; /*!< Plant parameters */
+    float_t fltId;              /*!< [A] d-axis current */
+    float_t fltIq;              /*!< [A] q-axis current */
+    float_t fltSpeedMech;       /*!< [rad/s] Mechanical angular speed */
+    float_t fltPosMech;         /*!< [rad] Mechanical position within the revolution, [0, 2*pi) */
+    int32_t i32Rev;             /*!< Completed mechanical revolutions */
+    float_t fltLoadTorque;      /*!< [N.m] Load torque, positive values brake a positive speed */
+    bool_t bLocked;             /*!< Rotor is held at its position */
+    int32_t i32QdcCount;        /*!< QDC position counter */
+    uint32_t ui32QdcTimer;      /*!< QDC timer, free running */
+    uint32_t ui32QdcEdgeTimer;  /*!< QDC timer captured at the last counter edge */
+    float_t fltQdcTimerFrac;    /*!< Fraction of a QDC timer tick not yet counted */
+} mc_plant_t;
+
+/*! @brief Quadrature decoder readout, see MC_PlantGetQdc() */
+typedef struct _mc_plant_qdc
+{
+    int32_t i32Count;           /*!< Position counter, 4 * ui32EncoderLines per revolution, 0 at electrical position 0 */
+    uint32_t ui32Timer;         /*!< Timer at the readout */
+    uint32_t ui32EdgeTimer;     /*!< Timer captured at the last counter edge */
+} mc_plant_qdc_t;
+
+/*! @brief Quantity stepped by MC_PlantSimRun() */
+typedef enum _mc_plant_sim_mode
+{
+    kMC_PlantSimCurrentStep = 0U, /*!< Iq step with locked rotor, the current loop only */
+    kMC_PlantSimSpeedStep   = 1U, /*!< Speed step through the speed ramp, speed and current loop */
+} mc_plant_sim_mode_t;
+
+/*! @brief Step experiment, started from standstill with zero current */
+typedef struct _mc_plant_sim_run
+{
+    mc_plant_sim_mode_t eMode;  /*!< Stepped quantity */
+    float_t fltStep;            /*!< Step size, [A] Iq or [rad/s] electrical speed */
+    float_t fltLoadTorque;      /*!< [N.m] Load torque during the speed step */
+    float_t fltSettleBand;      /*!< Settling band relative to the step size, e.g. 0.02 */
+    uint32_t ui32Steps;         /*!< Duration in fast loop periods */
+} mc_plant_sim_run_t;
+
+/*!
+ * @brief Step response metrics and cycle counts of MC_PlantSimRun().
+ *
+ * Times are in seconds after the step. The steady state is the last quarter of the experiment.
+ */
+typedef struct _mc_plant_sim_result
+{
+    float_t fltRiseTime;        /*!< 10 % to 90 % rise time, negative if 90 % was not reached */
+    float_t fltOvershoot;       /*!< Peak above the step size, in percent of the step size */
+    float_t fltSettlingTime;    /*!< Last exit from the settling band, negative if not settled at the end */
+    float_t fltFinal;           /*!< Mean value in the steady state */
+    float_t fltRipple;          /*!< Peak to peak value in the steady state */
+    uint32_t ui32FastCyclesMin; /*!< MCS_PMSMFocCtrl() duration in core cycles */
+    uint32_t ui32FastCyclesMean;
+    uint32_t ui32FastCyclesMax;
+    uint32_t ui32SlowCyclesMin; /*!< MCS_PMSMFocCtrlSpeed() and MCS_PMSMFieldWeakening() cycles, speed step only */
+    uint32_t ui32SlowCyclesMean;
+    uint32_t ui32SlowCyclesMax;
+} mc_plant_sim_result_t;
+
+/*! @brief Plant simulation context */
+typedef struct _mc_plant_sim
+{
+    mc_plant_params_t sParams;  /*!< Plant parameters, initialized from m1_pmsm_appconfig.h */
+    mc_plant_sim_run_t sRun;    /*!< Next experiment */
+    mc_plant_sim_result_t sResult; /*!< Result of the last experiment */
+    qmc_status_t eStatus;       /*!< Status of the last experiment */
+    volatile bool_t bRunReq;    /*!< Set to request an experiment, cleared when it has finished */
+    mc_plant_t sPlant;          /*!< Plant state */
+    mcs_pmsm_foc_t sFocPMSM;    /*!< Private copy of the current loop under test */
+    mcs_speed_t sSpeed;         /*!< Private copy of the speed loop under test */
+    mcs_pmsm_fw_t sFieldWeak;   /*!< Private copy of the MTPA and field weakening under test */
+#if FEATURE_MC_FOC_PROFILING
+    mc_profile_t sProfile;      /*!< Stage profile of the simulated fast loop */
+#endif
+} mc_plant_sim_t;
+
+/*! @brief Plant simulation context of motor 1, exported for FreeMASTER */
+extern mc_plant_sim_t g_sMcPlantSim;
+
+#endif /* FEATURE_MC_PLANT_SIMULATION */
+
+#if FEATURE_MC_PLANT_SIMULATION
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Puts the plant to standstill at electrical position 0 with zero current.
+ *
+ * @param psPlant       The pointer of the plant
+ * @param psParams      Plant parameters, must stay valid while the plant is used
+ *
+ * @return None
+ */
+extern void MC_PlantInit(mc_plant_t *psPlant, const mc_plant_params_t *psParams);
+
+/*!
+ * @brief Advances the plant by half a PWM period.
+ *
+   The PWM reloads at half cycle, so the duty cycles written by a fast loop drive the second half of its period
+   and the first half of the next one. The inverter applies the duty cycles reduced by the dead time in the
+   direction of each phase current, the motor is integrated in the rotor frame with ui16SubSteps forward Euler
+   steps.
+
+ * @param psPlant       The pointer of the plant
+ * @param psDutyABC     Duty cycles applied during the half period
+ *
+ * @return None
+ */
+extern void MC_PlantStep(mc_plant_t *psPlant, const GMCLIB_3COOR_T_F16 *psDutyABC);
+
+/*!
+ * @brief Samples the phase currents and the DC bus voltage with the ADC resolution.
+ *
+ * @param psPlant       The pointer of the plant
+ * @param psIABC        Phase currents, full scale fltIScale
+ * @param pf16UDcBus    DC bus voltage, full scale fltUDcBusScale
+ *
+ * @return None
+ */
+extern void MC_PlantGetAdc(const mc_plant_t *psPlant, GMCLIB_3COOR_T_F16 *psIABC, frac16_t *pf16UDcBus);
+
+/*!
+ * @brief Reads the quadrature decoder position counter and its timers.
+ *
+ * @param psPlant       The pointer of the plant
+ * @param psQdc         Readout
+ *
+ * @return None
+ */
+extern void MC_PlantGetQdc(const mc_plant_t *psPlant, mc_plant_qdc_t *psQdc);
+
+/*!
+ * @brief Runs one step experiment of the real control code against the plant.
+ *
+   The current and speed loops are copied from the templates, so gains, limits and filters under test are the
+   ones of the running application, and their states are reset. The fast loop mirrors the encoder speed FOC of
+   the Spin sub-state: ADC readout, MCS_PMSMFocCtrl() with the encoder angle, and every
+   fltPwmFreq / fltSlowLoopFreq periods MCS_PMSMFocCtrlSpeed() and MCS_PMSMFieldWeakening() with the encoder
+   speed. The encoder speed is measured like the QDC driver does, counts over the captured time between their
+   edges, and filtered by the speed filter of the template.
+
+   A speed step above the base speed with a load torque gives one point of the speed and torque envelope,
+   fltFinal is the reached speed. With bFwOn and fltLqLdDiff of the template cleared, the d-axis current stays 0.
+
+   The experiment is blocking and is not real time; run it from a low priority task. Cycle counts include
+   preemption by interrupts, the minimum is the undisturbed duration.
+
+ * @param psSim             The pointer of the simulation context, sParams and sRun are inputs
+ * @param psFocTemplate     Current loop to test, usually the one of the motor
+ * @param psSpeedTemplate   Speed loop to test, usually the one of the motor
+ * @param psFwTemplate      MTPA and field weakening to test, usually the one of the motor
+ *
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid A pointer is NULL, the step size or the duration is zero, or sParams is
+ *                                   not usable.
+ * @retval kStatus_QMC_Ok The experiment finished and sResult is valid.
+ */
+extern qmc_status_t MC_PlantSimRun(mc_plant_sim_t *psSim,
+                                   const mcs_pmsm_foc_t *psFocTemplate,
+                                   const mcs_speed_t *psSpeedTemplate,
+                                   const mcs_pmsm_fw_t *psFwTemplate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEATURE_MC_PLANT_SIMULATION */
+
+#endif /* MC_PLANT_SIM_H */
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#include "mc_profile.h"
+
+#if FEATURE_MC_FOC_PROFILING
+
+#include <string.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/* a copy is interrupted at most by one fast loop of the motor, more retries indicate a blocked caller */
+#define MC_PROFILE_COPY_RETRIES (8U)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+mc_profile_t g_sMcProfile[MC_MAX_MOTORS];
+
+static const char *const s_pcProfileStageNames[kMC_ProfileStageCount] = {
+    "adcGet", "clarke", "observer", "pi", "parkInv", "dtComp", "svm", "pwmUpdate"};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void MC_ProfileInit(mc_profile_t *psProfile)
+{
+    (void)memset(psProfile, 0, sizeof(mc_profile_t));
+    for (uint32_t ui32Stage = 0U; ui32Stage < kMC_ProfileStageCount; ui32Stage++)
+    {
+        psProfile->sStage[ui32Stage].ui32Min = UINT32_MAX;
+    }
+
+    /* enable the cycle counter (without resetting it, it may be used elsewhere) */
+    DEBUG_ARM_CM_DEMCR |= 1U << 24U;
+    DEBUG_ARM_CM_DWT_CTRL |= 1U << 0U;
+}
+
+qmc_status_t MC_GetProfileStats(mc_motor_id_t eMotorId, mc_profile_stage_t eStage, mc_profile_stats_t *psStats)
+{
+    qmc_status_t ret = kStatus_QMC_ErrBusy;
+    const mc_profile_t *psProfile;
+    uint32_t ui32Seq;
+
+    if (NULL == psStats)
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    else if ((eMotorId >= MC_MAX_MOTORS) || (eStage >= kMC_ProfileStageCount))
+    {
+        ret = kStatus_QMC_ErrRange;
+    }
+    else
+    {
+        psProfile = &g_sMcProfile[eMotorId];
+        for (uint32_t ui32Try = 0U; (ui32Try < MC_PROFILE_COPY_RETRIES) && (kStatus_QMC_Ok != ret); ui32Try++)
+        {
+            ui32Seq = psProfile->ui32Seq;
+            __DMB();
+            *psStats = psProfile->sStage[eStage];
+            __DMB();
+            if (ui32Seq == psProfile->ui32Seq)
+            {
+                ret = kStatus_QMC_Ok;
+            }
+        }
+    }
+
+    return ret;
+}
+
+const char *MC_GetProfileStageName(mc_profile_stage_t eStage)
+{
+    return (eStage < kMC_ProfileStageCount) ? s_pcProfileStageNames[eStage] : NULL;
+}
+
+#endif /* FEATURE_MC_FOC_PROFILING */
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#ifndef MC_PROFILE_H
+#define MC_PROFILE_H
+
+#include "qmc_features_config.h"
+
+#if FEATURE_MC_FOC_PROFILING
+#include "api_motorcontrol.h"
+#include "utils/debug.h"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#if FEATURE_MC_FOC_PROFILING
+
+/*! @brief Fast loop stages measured by the profiling probes */
+typedef enum _mc_profile_stage
+{
+    kMC_ProfileAdcGet     = 0U, /*!< Phase current, DC bus and auxiliary ADC readout */
+    kMC_ProfileClarke     = 1U, /*!< Sine/cosine, Clarke and Park transformations at the observer angle */
+    kMC_ProfileObserver   = 2U, /*!< BEMF observer, tracking observer and speed filter */
+    kMC_ProfilePi         = 3U, /*!< Re-projection to an open loop/external angle and the D/Q current PI controllers */
+    kMC_ProfileParkInv    = 4U, /*!< Inverse Park transformation */
+    kMC_ProfileDTComp     = 5U, /*!< Dead-time compensation, only recorded while enabled */
+    kMC_ProfileSvm        = 6U, /*!< DC bus ripple elimination and space vector modulation */
+    kMC_ProfilePwmUpdate  = 7U, /*!< PWM duty cycle update */
+    kMC_ProfileStageCount = 8U
+} mc_profile_stage_t;
+
+/*! @brief Number of log2 histogram slots, slot 0: 0 cycles, slot n: [2^(n-1), 2^n) cycles, the last slot is open */
+#define MC_PROFILE_HIST_SLOTS (16U)
+
+/*! @brief Statistics of one fast loop stage, all durations in CM7 core cycles (DWT CYCCNT) */
+typedef struct _mc_profile_stats
+{
+    uint32_t ui32Count;                        /*!< Number of recorded samples */
+    uint32_t ui32Min;                          /*!< Shortest duration */
+    uint32_t ui32Max;                          /*!< Longest duration */
+    uint64_t ui64Sum;                          /*!< Sum of all durations, mean = ui64Sum / ui32Count */
+    uint32_t ui32HistLog2[MC_PROFILE_HIST_SLOTS]; /*!< log2 histogram of the durations */
+} mc_profile_stats_t;
+
+/*! @brief Fast loop profile of one motor, only written by the motor's fast loop */
+typedef struct _mc_profile
+{
+    mc_profile_stats_t sStage[kMC_ProfileStageCount]; /*!< Statistics indexed by mc_profile_stage_t */
+    uint32_t ui32Start;                        /*!< Cycle counter at the last MC_PROFILE_BEGIN() */
+    volatile uint32_t ui32Seq;                 /*!< Incremented after every update, see MC_GetProfileStats() */
+} mc_profile_t;
+
+/*!
+ * @brief Fast loop profiles of all motors, indexed by mc_motor_id_t.
+ *
+ * Exported for FreeMASTER; use MC_GetProfileStats() to obtain a consistent snapshot.
+ */
+extern mc_profile_t g_sMcProfile[MC_MAX_MOTORS];
+
+/*! @brief Starts the measurement of a stage */
+#define MC_PROFILE_BEGIN(psProfile) ((psProfile)->ui32Start = DEBUG_ARM_CM_DWT_CYCCNT)
+
+/*! @brief Ends the measurement of a stage started by MC_PROFILE_BEGIN() and records its duration */
+#define MC_PROFILE_END(psProfile, eStage) \
+    MC_ProfileUpdate((psProfile), (eStage), DEBUG_ARM_CM_DWT_CYCCNT - (psProfile)->ui32Start)
+
+#else
+
+#define MC_PROFILE_BEGIN(psProfile)
+#define MC_PROFILE_END(psProfile, eStage)
+
+#endif /* FEATURE_MC_FOC_PROFILING */
+
+#if FEATURE_MC_FOC_PROFILING
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Records the duration of one stage.
+ *
+ * Called through MC_PROFILE_END() from the motor's fast loop only.
+ *
+ * @param psProfile     The pointer of the motor's profile
+ * @param eStage        Measured stage
+ * @param ui32Cycles    Duration in core cycles
+ *
+ * @return None
+ */
+__attribute__((always_inline)) static inline void MC_ProfileUpdate(mc_profile_t *psProfile,
+                                                                   mc_profile_stage_t eStage,
+                                                                   uint32_t ui32Cycles)
+{
+    mc_profile_stats_t *psStats = &psProfile->sStage[eStage];
+    uint32_t ui32Slot = 32U - __CLZ(ui32Cycles);
+
+    psStats->ui32Count++;
+    psStats->ui64Sum += ui32Cycles;
+    psStats->ui32Min = (ui32Cycles < psStats->ui32Min) ? ui32Cycles : psStats->ui32Min;
+    psStats->ui32Max = (ui32Cycles > psStats->ui32Max) ? ui32Cycles : psStats->ui32Max;
+    psStats->ui32HistLog2[(ui32Slot < MC_PROFILE_HIST_SLOTS) ? ui32Slot : (MC_PROFILE_HIST_SLOTS - 1U)]++;
+    psProfile->ui32Seq++;
+}
+
+/*!
+ * @brief Clears the profile of one motor and enables the cycle counter.
+ *
+ * Must be called before the motor's fast loop uses the profile.
+ *
+ * @param psProfile     The pointer of the motor's profile
+ *
+ * @return None
+ */
+extern void MC_ProfileInit(mc_profile_t *psProfile);
+
+/*!
+ * @brief Copies the statistics of one stage of one motor.
+ *
+ * The fast loop may update the profile at any time; the copy is retried until it was not interrupted by an update.
+ *
+ * @param eMotorId      Motor
+ * @param eStage        Stage
+ * @param psStats       Output statistics
+ *
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrArgInvalid psStats is NULL.
+ * @retval kStatus_QMC_ErrRange eMotorId or eStage is out of range.
+ * @retval kStatus_QMC_ErrBusy No consistent copy could be taken.
+ * @retval kStatus_QMC_Ok The copy is consistent.
+ */
+extern qmc_status_t MC_GetProfileStats(mc_motor_id_t eMotorId, mc_profile_stage_t eStage, mc_profile_stats_t *psStats);
+
+/*!
+ * @brief Returns the name of a stage, e.g. for the diagnostic endpoint.
+ *
+ * @param eStage        Stage
+ *
+ * @return Name, or NULL if eStage is out of range
+ */
+extern const char *MC_GetProfileStageName(mc_profile_stage_t eStage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEATURE_MC_FOC_PROFILING */
+
+#endif /* MC_PROFILE_H */
@@ -15,6 +15,7 @@
  * Definitions
  ******************************************************************************/
 #define SPEED_PI_WITH_DESAT_GAIN	0  // 0: use RTCESL PI. 1: use PI with desaturation gain
+#define BSF_SECTIONS				4U /* second order sections of the band stop filter */
 extern int16_t w16ExeTime_slowloop;
 /*******************************************************************************
  * Prototypes
@@ -23,18 +24,23 @@ extern int16_t w16ExeTime_slowloop;
 /*******************************************************************************
  * Variables
  ******************************************************************************/
-/* dead-time compensation voltage table */
+/* default dead-time compensation voltage table, source of MCS_DTCompInit(psFocPMSM, NULL) */
 static float_t pfltUDtComp[DTCOMP_TABLE_SIZE] = DTCOMP_TABLE_DATA;
 
-/* dead-time compensation look-up table */
-static GFLIB_LUT1D_T_FLT sLUTUDtComp;
-
 RAM_FUNC_CRITICAL
 static void MCS_DTComp(GMCLIB_2COOR_ALBE_T_FLT *sUAlBeDTComp, 
                 GMCLIB_3COOR_T_FLT *sIABC,
                 float_t fltUDcBusFilt,
-                float_t fltPwrStgCharIRange,
-                float_t fltPwrStgCharLinCoeff);
+                const mcs_dtcomp_t *psDTComp);
+
+RAM_FUNC_CRITICAL
+static void MCS_SinCos(frac16_t f16Angle, GMCLIB_2COOR_SINCOS_T_FLT *psSinCos);
+
+RAM_FUNC_CRITICAL
+static void MCS_SpeedGainSched(mcs_speed_t *psSpeed);
+
+RAM_FUNC_CRITICAL
+static float_t MCS_MtpaId(const mcs_pmsm_fw_t *psFw, float_t fltIq);
 
 /*******************************************************************************
  * Code
@@ -51,6 +57,8 @@ static void MCS_DTComp(GMCLIB_2COOR_ALBE_T_FLT *sUAlBeDTComp,
  */
 RAM_FUNC_CRITICAL void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM)
 {
+    frac16_t f16PosElObsrv;
+
     /* pass electrical position from outside function if enabled else estimated
      * electrical position is selected */
     if (psFocPMSM->bPosExtOn)
@@ -61,8 +69,9 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM)
     /*********************************** Rotor position/speed observer update************************************/
     /* This observer is always running whenever MCS_PMSMFocCtrl is invoked, which is independent of other control */
     /* Position angle of the last PWM update */
-    psFocPMSM->sAnglePosEl.fltSin = GFLIB_Sin_FLTa((acc32_t)psFocPMSM->f16PosElEst);
-    psFocPMSM->sAnglePosEl.fltCos = GFLIB_Cos_FLTa((acc32_t)psFocPMSM->f16PosElEst);
+    MC_PROFILE_BEGIN(psFocPMSM->psProfile);
+    f16PosElObsrv = psFocPMSM->f16PosElEst;
+    MCS_SinCos(f16PosElObsrv, &psFocPMSM->sAnglePosEl);
 
     /* 3-phase to 2-phase transformation to stationary ref. frame */
     GMCLIB_Clark_FLT(&psFocPMSM->sIABC, &psFocPMSM->sIAlBe);
@@ -70,8 +79,10 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM)
     /* 2-phase to 2-phase transformation to rotary ref. frame */
     GMCLIB_Park_FLT(&psFocPMSM->sIAlBe, &psFocPMSM->sAnglePosEl, &psFocPMSM->sIDQ);
     GMCLIB_Park_FLT(&psFocPMSM->sUAlBeReq, &psFocPMSM->sAnglePosEl, &psFocPMSM->sUDQEst);
+    MC_PROFILE_END(psFocPMSM->psProfile, kMC_ProfileClarke);
 
     /* BEMF observer in DQ system */
+    MC_PROFILE_BEGIN(psFocPMSM->psProfile);
     psFocPMSM->acc32BemfErr = AMCLIB_PMSMBemfObsrvDQ_A32fff(&psFocPMSM->sIDQ, 
                                                             &psFocPMSM->sUDQEst, 
                                                             psFocPMSM->fltSpeedElEst, 
@@ -81,6 +92,7 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM)
 
     /* Speed estimation filter  */
     psFocPMSM->fltSpeedElEst =  GDFLIB_FilterIIR1_FLT(psFocPMSM->sTo.fltSpeed, &psFocPMSM->sSpeedElEstFilt);
+    MC_PROFILE_END(psFocPMSM->psProfile, kMC_ProfileObserver);
     /************************************************************************************************************/
 
     /* for open loop control enabled parallel running of observer and FOC
@@ -90,10 +102,11 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM)
      *    2. In closedloop control with encoder (using external position), DQ current is calculated
      *    3. In closedloop control without any position sensor, use the calculated DQ current from the observer directly
      *  */
-    if (psFocPMSM->bOpenLoop || psFocPMSM->bPosExtOn)
+    /* sin/cos and DQ current of the observer angle are reused when both angles are the same */
+    MC_PROFILE_BEGIN(psFocPMSM->psProfile);
+    if ((psFocPMSM->bOpenLoop || psFocPMSM->bPosExtOn) && (psFocPMSM->f16PosEl != f16PosElObsrv))
     {
-        psFocPMSM->sAnglePosEl.fltSin = GFLIB_Sin_FLTa((acc32_t)psFocPMSM->f16PosEl);
-        psFocPMSM->sAnglePosEl.fltCos = GFLIB_Cos_FLTa((acc32_t)psFocPMSM->f16PosEl);
+        MCS_SinCos(psFocPMSM->f16PosEl, &psFocPMSM->sAnglePosEl);
         GMCLIB_Park_FLT(&psFocPMSM->sIAlBe, &psFocPMSM->sAnglePosEl, &psFocPMSM->sIDQ);
     }
 
@@ -125,26 +138,77 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM)
         psFocPMSM->sUDQReq.fltQ =
             GFLIB_CtrlPIpAW_FLT(psFocPMSM->sIDQError.fltQ, &psFocPMSM->bIqPiStopInteg, &psFocPMSM->sIqPiParams);
     }
+    MC_PROFILE_END(psFocPMSM->psProfile, kMC_ProfilePi);
 
     /* 2-phase to 2-phase transformation to stationary ref. frame */
+    MC_PROFILE_BEGIN(psFocPMSM->psProfile);
     GMCLIB_ParkInv_FLT(&psFocPMSM->sUDQReq, &psFocPMSM->sAnglePosEl, &psFocPMSM->sUAlBeReq);
+    MC_PROFILE_END(psFocPMSM->psProfile, kMC_ProfileParkInv);
 
     /* dead-time compensation */
     psFocPMSM->sUAlBeDTComp = psFocPMSM->sUAlBeReq;
     if(psFocPMSM->bFlagDTComp)
     {
+        MC_PROFILE_BEGIN(psFocPMSM->psProfile);
         MCS_DTComp(&psFocPMSM->sUAlBeDTComp,
                    &psFocPMSM->sIABC,
                    psFocPMSM->fltUDcBusFilt,
-                   psFocPMSM->fltPwrStgCharIRange,
-                   psFocPMSM->fltPwrStgCharLinCoeff);
+                   &psFocPMSM->sDTComp);
+        MC_PROFILE_END(psFocPMSM->psProfile, kMC_ProfileDTComp);
     }
 
     /* DCBus ripple elimination */
+    MC_PROFILE_BEGIN(psFocPMSM->psProfile);
     GMCLIB_ElimDcBusRipFOC_F16ff(psFocPMSM->fltUDcBusFilt, &psFocPMSM->sUAlBeDTComp, &psFocPMSM->sUAlBeCompFrac);
 
     /* space vector modulation */
     psFocPMSM->ui16SectorSVM = GMCLIB_SvmStd_F16(&psFocPMSM->sUAlBeCompFrac, &psFocPMSM->sDutyABC);
+    MC_PROFILE_END(psFocPMSM->psProfile, kMC_ProfileSvm);
+}
+
+/*!
+ * @brief Sine and cosine of an electrical angle evaluated together.
+ *
+   One range reduction to [-pi/4, pi/4) is shared by both results, the sine is a 7th and the cosine
+   an 8th order Taylor polynomial in the common square of the reduced angle. The maximum absolute
+   error against the double precision libm over all 65536 angles is 3.4e-7.
+
+ * @param f16Angle      Angle, [-1, 1) corresponds to [-pi, pi)
+ * @param psSinCos      The pointer of the sine/cosine pair result
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void MCS_SinCos(frac16_t f16Angle, GMCLIB_2COOR_SINCOS_T_FLT *psSinCos)
+{
+    /* nearest multiple of pi/2 and the rest within [-pi/4, pi/4) */
+    uint16_t ui16Quadrant = (uint16_t)((uint16_t)f16Angle + 0x2000U) >> 14;
+    int16_t i16Rest = (int16_t)((uint16_t)f16Angle - (uint16_t)(ui16Quadrant << 14));
+    float_t fltX = (float_t)i16Rest * (FLOAT_PI / 32768.0F);
+    float_t fltX2 = fltX * fltX;
+    float_t fltSin, fltCos;
+
+    fltSin = fltX * (1.0F + fltX2 * (-1.0F / 6.0F + fltX2 * (1.0F / 120.0F + fltX2 * (-1.0F / 5040.0F))));
+    fltCos = 1.0F + fltX2 * (-0.5F + fltX2 * (1.0F / 24.0F + fltX2 * (-1.0F / 720.0F + fltX2 * (1.0F / 40320.0F))));
+
+    switch (ui16Quadrant)
+    {
+        case 0U:
+            psSinCos->fltSin = fltSin;
+            psSinCos->fltCos = fltCos;
+            break;
+        case 1U:
+            psSinCos->fltSin = fltCos;
+            psSinCos->fltCos = -fltSin;
+            break;
+        case 2U:
+            psSinCos->fltSin = -fltSin;
+            psSinCos->fltCos = -fltCos;
+            break;
+        default:
+            psSinCos->fltSin = -fltCos;
+            psSinCos->fltCos = fltSin;
+            break;
+    }
 }
 
 /*!
@@ -166,41 +230,13 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlSpeed(mcs_speed_t *psSpeed)
     /* Speed ramp generation */
     psSpeed->fltSpeedRamp = GFLIB_Ramp_FLT(psSpeed->fltSpeedCmd, &psSpeed->sSpeedRampParams);
 
-
+    /* Speed error calculation */
+    psSpeed->fltSpeedError = MLIB_Sub_FLT(psSpeed->fltSpeedRamp, psSpeed->fltSpeedFilt);
     /* Controller gain adjustment */
-    /*
-    if(MLIB_Abs_FLT(psSpeed->fltSpeedFilt) < 10.0F*M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF)
-    {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.0025F;
-    }
-    else if(MLIB_Abs_FLT(psSpeed->fltSpeedFilt) < 30.0F*M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF)
+    if(psSpeed->sGainSched.psTable != NULL)
     {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.014F;
+        MCS_SpeedGainSched(psSpeed);
     }
-    else if(MLIB_Abs_FLT(psSpeed->fltSpeedFilt) < 50.0F*M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF)
-    {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.0255F;
-    }
-    else if(MLIB_Abs_FLT(psSpeed->fltSpeedFilt) < 70.0F*M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF)
-    {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.037F;
-    }
-    else if(MLIB_Abs_FLT(psSpeed->fltSpeedFilt) < 90.0F*M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF)
-    {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.0485F;
-    }
-    else if(MLIB_Abs_FLT(psSpeed->fltSpeedFilt) < 100.0F*M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF)
-    {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.055F;
-    }
-    else
-    {
-    	psSpeed->sSpeedPiParams.fltPGain = 0.06F;
-    }
-    */
-
-    /* Speed error calculation */
-    psSpeed->fltSpeedError = MLIB_Sub_FLT(psSpeed->fltSpeedRamp, psSpeed->fltSpeedFilt);
     /* Desired current by the speed PI controller */
 #if SPEED_PI_WITH_DESAT_GAIN == 0
     psSpeed->fltIqController =
@@ -212,7 +248,15 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlSpeed(mcs_speed_t *psSpeed)
     /*   Iq feed forward */
     psSpeed->fltIqFwd = psSpeed->fltIqFwdGain * (psSpeed->fltSpeedRamp - psSpeed->fltSpeedRamp_1);
     psSpeed->fltIqFwdFilt = GDFLIB_FilterIIR1_FLT(psSpeed->fltIqFwd, &psSpeed->sIqFwdFilter);
-    fltTmp = psSpeed->fltIqController + psSpeed->fltIqFwdFilt;
+    if(psSpeed->bIqAccFwdOn)
+    {
+        /* the trajectory acceleration is known exactly, the ramp derivative would count it twice */
+        fltTmp = psSpeed->fltIqController + psSpeed->fltIqAccFwd;
+    }
+    else
+    {
+        fltTmp = psSpeed->fltIqController + psSpeed->fltIqFwdFilt;
+    }
 
 #if SPEED_PI_WITH_DESAT_GAIN == 1
     if(fltTmp > psSpeed->sSpeedPiParamsDesat.sCoeff.fltUpperLim)
@@ -245,6 +289,166 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlSpeed(mcs_speed_t *psSpeed)
     psSpeed->fltSpeedRamp_1 = psSpeed->fltSpeedRamp;
 }
 
+/*!
+ * @brief Speed PI gains from the gain schedule at the filtered speed.
+ *
+   The speed moves by a fraction of a segment between two slow loops, so the segment search starts at
+   the segment of the last call. The proportional term is kept continuous by moving the change of the
+   proportional gain into the integral state at the present speed error.
+
+ * @param psSpeed       The pointer of the PMSM speed structure, sGainSched.psTable is not NULL
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void MCS_SpeedGainSched(mcs_speed_t *psSpeed)
+{
+    mcs_speed_gain_sched_t *psSched = &psSpeed->sGainSched;
+    const mcs_speed_gain_point_t *psTable = psSched->psTable;
+    const mcs_speed_gain_point_t *psPoint;
+    float_t fltSpeedAbs = MLIB_Abs_FLT(psSpeed->fltSpeedFilt);
+    uint16_t ui16Seg = psSched->ui16Seg;
+    float_t fltPGain, fltIGain, fltFrac;
+
+    /* segment ui16Seg spans breakpoints ui16Seg and ui16Seg + 1 */
+    if(ui16Seg >= psSched->ui16Size)
+    {
+        ui16Seg = 0U;
+    }
+    while((ui16Seg > 0U) && (fltSpeedAbs < psTable[ui16Seg].fltSpeed))
+    {
+        ui16Seg--;
+    }
+    while(((uint16_t)(ui16Seg + 1U) < psSched->ui16Size) && (fltSpeedAbs >= psTable[ui16Seg + 1U].fltSpeed))
+    {
+        ui16Seg++;
+    }
+    psSched->ui16Seg = ui16Seg;
+
+    psPoint = &psTable[ui16Seg];
+    if(((uint16_t)(ui16Seg + 1U) >= psSched->ui16Size) || (fltSpeedAbs <= psPoint->fltSpeed))
+    {
+        /* held outside the table */
+        fltPGain = psPoint->fltPGain;
+        fltIGain = psPoint->fltIGain;
+    }
+    else
+    {
+        fltFrac = (fltSpeedAbs - psPoint[0].fltSpeed) / (psPoint[1].fltSpeed - psPoint[0].fltSpeed);
+        fltPGain = psPoint[0].fltPGain + fltFrac * (psPoint[1].fltPGain - psPoint[0].fltPGain);
+        fltIGain = psPoint[0].fltIGain + fltFrac * (psPoint[1].fltIGain - psPoint[0].fltIGain);
+    }
+
+    /* bumpless transfer, Kp_old * e + I_old = Kp_new * e + I_new */
+#if SPEED_PI_WITH_DESAT_GAIN == 0
+    psSpeed->sSpeedPiParams.fltIAccK_1 += (psSpeed->sSpeedPiParams.fltPGain - fltPGain) * psSpeed->fltSpeedError;
+    psSpeed->sSpeedPiParams.fltPGain = fltPGain;
+    psSpeed->sSpeedPiParams.fltIGain = fltIGain;
+#else
+    psSpeed->sSpeedPiParamsDesat.fltIntegral_1 +=
+        (psSpeed->sSpeedPiParamsDesat.sCoeff.fltPGain - fltPGain) * psSpeed->fltSpeedError;
+    psSpeed->sSpeedPiParamsDesat.sCoeff.fltPGain = fltPGain;
+    psSpeed->sSpeedPiParamsDesat.sCoeff.fltIGain = fltIGain;
+#endif
+}
+
+/*!
+ * @brief PMSM MTPA and field weakening, called in the slow loop after the speed control.
+ *
+   The MTPA d-axis current is evaluated as -2*(Lq-Ld)*Iq^2/(flux + sqrt(flux^2 + 4*(Lq-Ld)^2*Iq^2)), which is
+   the closed form without the division by Lq - Ld. The field weakening error is the margin of the q-axis
+   voltage to fltUqLimGain of its limit, less the filtered Iq control error; the controller output is limited
+   to <fltIdFwMin, 0>. fltIdFwMin = (w*Rs*(Lq-Ld)*Iq - w^2*Ld*flux)/(Rs^2 + w^2*Ld^2) minimizes the steady state
+   voltage vector at the electrical speed w, held within <fltIdMin, 0>.
+
+ * @param psFw          The pointer of the MTPA and field weakening structure
+ * @param psFocPMSM     The pointer of the PMSM FOC structure, its sIDQReq is set
+ * @param psSpeed       The pointer of the PMSM speed structure, after MCS_PMSMFocCtrlSpeed
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void MCS_PMSMFieldWeakening(mcs_pmsm_fw_t *psFw, mcs_pmsm_foc_t *psFocPMSM, mcs_speed_t *psSpeed)
+{
+    float_t fltIq = psSpeed->fltIqReq;
+    float_t fltSpeed = psSpeed->fltSpeedFilt;
+    float_t fltIdReq, fltIqMax, fltTmp;
+
+    /* Maximum torque per ampere, the reluctance torque of Lq > Ld needs a negative d-axis current */
+    psFw->fltIdMtpa = MCS_MtpaId(psFw, fltIq);
+
+    /* Field weakening by the q-axis voltage of the last current control */
+    if(psFw->bFwOn)
+    {
+        /* Below the d-axis current of the least voltage vector, the resistive voltage grows faster than the
+           induced voltage drops, dU^2/dId = 0 of the steady state voltage equations at the measured Iq */
+        fltTmp = fltSpeed * psFw->fltLd;
+        psFw->fltIdFwMin = (fltSpeed * psFw->fltRs * psFw->fltLqLdDiff * psFocPMSM->sIDQ.fltQ -
+                            fltTmp * fltSpeed * psFw->fltFlux) /
+                           (psFw->fltRs * psFw->fltRs + fltTmp * fltTmp);
+        if(psFw->fltIdFwMin < psFw->fltIdMin)
+        {
+            psFw->fltIdFwMin = psFw->fltIdMin;
+        }
+        else if(psFw->fltIdFwMin > 0.0F)
+        {
+            psFw->fltIdFwMin = 0.0F;
+        }
+        psFw->sFwCtrl.sFWPiParam.fltLowerLim = psFw->fltIdFwMin;
+
+        psFw->fltIdFw = AMCLIB_CtrlFluxWkng_FLT(psFocPMSM->sIDQError.fltQ, psFocPMSM->sUDQReq.fltQ,
+                                                psFw->fltUqLimGain * psFocPMSM->sIqPiParams.fltUpperLim, &psFw->sFwCtrl);
+    }
+    else
+    {
+        psFw->fltIdFw = 0.0F;
+    }
+
+    fltIdReq = (psFw->fltIdFw < psFw->fltIdMtpa) ? psFw->fltIdFw : psFw->fltIdMtpa;
+    if(fltIdReq < MLIB_Neg_FLT(psFw->fltIMax))
+    {
+        fltIdReq = MLIB_Neg_FLT(psFw->fltIMax);
+    }
+
+    /* The d-axis current has priority within the current vector limit */
+    fltIqMax = GFLIB_Sqrt_FLT(psFw->fltIMax * psFw->fltIMax - fltIdReq * fltIdReq);
+    if((fltIq > fltIqMax) || (fltIq < MLIB_Neg_FLT(fltIqMax)))
+    {
+        fltIq = (fltIq > 0.0F) ? fltIqMax : MLIB_Neg_FLT(fltIqMax);
+
+        /* MTPA of the limited Iq; its d-axis current is smaller, so the limited Iq stays within the vector limit */
+        psFw->fltIdMtpa = MCS_MtpaId(psFw, fltIq);
+        fltIdReq = (psFw->fltIdFw < psFw->fltIdMtpa) ? psFw->fltIdFw : psFw->fltIdMtpa;
+    }
+    psSpeed->sSpeedPiParams.fltUpperLim = fltIqMax;
+    psSpeed->sSpeedPiParams.fltLowerLim = MLIB_Neg_FLT(fltIqMax);
+    psSpeed->sSpeedPiParamsDesat.sCoeff.fltUpperLim = fltIqMax;
+    psSpeed->sSpeedPiParamsDesat.sCoeff.fltLowerLim = MLIB_Neg_FLT(fltIqMax);
+    psSpeed->fltIqReq = fltIq;
+
+    psFocPMSM->sIDQReq.fltD = fltIdReq;
+    psFocPMSM->sIDQReq.fltQ = fltIq;
+}
+
+/*!
+ * @brief MTPA d-axis current of a q-axis current, 0 without reluctance torque.
+
+ * @param psFw          The pointer of the MTPA and field weakening structure
+ * @param fltIq         q-axis current
+ *
+ * @return d-axis current
+ */
+RAM_FUNC_CRITICAL static float_t MCS_MtpaId(const mcs_pmsm_fw_t *psFw, float_t fltIq)
+{
+    float_t fltTmp;
+
+    if(psFw->fltLqLdDiff == 0.0F)
+    {
+        return 0.0F;
+    }
+    fltTmp = 2.0F * psFw->fltLqLdDiff * fltIq;
+    return MLIB_Neg_FLT(fltTmp * fltIq) /
+           (psFw->fltFlux + GFLIB_Sqrt_FLT(psFw->fltFlux * psFw->fltFlux + fltTmp * fltTmp));
+}
+
 /*!
  * @brief An 2nd order filter is used to realize trajectory. This function initializes the filter.
 
@@ -301,9 +505,11 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlPosition(mcs_position_t *psPosition)
 {
 	int32_t i32Tmp;
 	int64_t i64Tmp;
+	int64_t i64PosFilt_1;
 
 	if(psPosition->bIsRandomPosition == TRUE)
 	{
+		i64PosFilt_1 = psPosition->sCurveRef.sTrajFilter.i64Out;
 		psPosition->sCurveRef.i32Q16PosCmd = psPosition->i32Q16PosCmd;
 
 		/* Trajectory reference creation */
@@ -313,6 +519,12 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlPosition(mcs_position_t *psPosition)
 
 		/* Position loop */
 		psPosition->i32Q16PosRef = psPosition->sCurveRef.i32Q16PosFilt;
+
+		/* Speed and acceleration of the trajectory, the filter output increment keeps the 32 bits below Q16.16 */
+		i64Tmp = psPosition->sCurveRef.sTrajFilter.i64Out - i64PosFilt_1; /* Q16.48 revolutions per step */
+		psPosition->fltSpeedTraj = (float_t)i64Tmp * ((float_t)psPosition->i32PosLoopFreq * (1.0F / 281474976710656.0F)) *
+		                           psPosition->fltFreqToAngularSpeedCoeff;
+		psPosition->fltAccFwd = (psPosition->fltSpeedTraj - psPosition->fltSpeedTraj_1) * (float_t)psPosition->i32PosLoopFreq;
 	}
 	else
 	{
@@ -335,12 +547,24 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlPosition(mcs_position_t *psPosition)
 	psPosition->fltSpeedController = MLIB_ConvSc_FLTsf(psPosition->f16SpeedController, psPosition->fltFracToAngularSpeedCoeff);
 
 	/* Speed reference feed forward */
-	i32Tmp = psPosition->i32Q16PosRef - psPosition->i32Q16PosRef_1; /* Get revolution deviation */
-	i64Tmp = (int64_t)i32Tmp * psPosition->i32PosLoopFreq; /* Q16.16 * Q32.0 = Q48.16, get the derivative of position reference against time: i64Tmp represents mechanical frequency here */
-	i32Tmp = i64Tmp>>1; /* Q48.16 -> Q17.15 */
-	psPosition->fltSpeedFwdNoGain = MLIB_ConvSc_FLTaf(i32Tmp, psPosition->fltFreqToAngularSpeedCoeff);
+	if(psPosition->bIsRandomPosition == TRUE)
+	{
+		psPosition->fltSpeedFwdNoGain = psPosition->fltSpeedTraj;
+	}
+	else
+	{
+		i32Tmp = psPosition->i32Q16PosRef - psPosition->i32Q16PosRef_1; /* Get revolution deviation */
+		i64Tmp = (int64_t)i32Tmp * psPosition->i32PosLoopFreq; /* Q16.16 * Q32.0 = Q48.16, get the derivative of position reference against time: i64Tmp represents mechanical frequency here */
+		i32Tmp = i64Tmp>>1; /* Q48.16 -> Q17.15 */
+		psPosition->fltSpeedFwdNoGain = MLIB_ConvSc_FLTaf(i32Tmp, psPosition->fltFreqToAngularSpeedCoeff);
+		psPosition->fltSpeedTraj = psPosition->fltSpeedFwdNoGain;
+		psPosition->fltAccFwd = 0.0F;
+	}
 	psPosition->fltSpeedFwd = psPosition->fltSpeedFwdNoGain * psPosition->fltGainSpeedFwd;
 
+	/* Current reference feed forward, torque to accelerate the inertia along the trajectory */
+	psPosition->fltIqAccFwd = psPosition->fltAccFwd * psPosition->fltGainAccFwd;
+
 	psPosition->fltSpeedRef = psPosition->fltSpeedFwd + psPosition->fltSpeedController;
     if(psPosition->fltSpeedRef > (psPosition->fltSpeedRefLim * psPosition->fltRpmToAngularSpeedCoeff))
     {
@@ -353,6 +577,7 @@ RAM_FUNC_CRITICAL void MCS_PMSMFocCtrlPosition(mcs_position_t *psPosition)
 
     /* Store historical data */
 	psPosition->i32Q16PosRef_1 = psPosition->i32Q16PosRef;
+	psPosition->fltSpeedTraj_1 = psPosition->fltSpeedTraj;
 }
 
 /*!
@@ -451,61 +676,236 @@ RAM_FUNC_CRITICAL void MCS_PMSMScalarCtrl(mcs_pmsm_scalar_ctrl_t *psScalarPMSM)
                                                         &psScalarPMSM->sFreqIntegrator);    
 }
 
-/******************************************************************************
-@brief   Dead-time compensation using LUT wit interpolation
+/*!
+ * @brief Online phase resistance and flux linkage estimator initialization.
+ *
+ * @param psParamEst    The pointer of the estimator structure, sCoeff is set
+ *
+ * @return None
+ */
+void MCS_PMSMParamEstInit(mcs_param_est_t *psParamEst)
+{
+    const mcs_param_est_coeff_t *psCoeff = &psParamEst->sCoeff;
+
+    psParamEst->fltRs = psCoeff->fltRsNom;
+    psParamEst->fltFlux = psCoeff->fltFluxNom;
+    psParamEst->fltBemfNom = psCoeff->fltFluxNom * psCoeff->fltSpeedNom;
+
+    /* no confidence in the nominal values beyond the bound */
+    psParamEst->fltP11 = 0.5F * psCoeff->fltCovMax;
+    psParamEst->fltP12 = 0.0F;
+    psParamEst->fltP22 = 0.5F * psCoeff->fltCovMax;
+    psParamEst->fltErr = 0.0F;
+
+    MCS_PMSMParamEstRestart(psParamEst);
+}
+
+/*!
+ * @brief Online phase resistance and flux linkage estimator restart.
+ *
+ * @param psParamEst    The pointer of the estimator structure
+ *
+ * @return None
+ */
+void MCS_PMSMParamEstRestart(mcs_param_est_t *psParamEst)
+{
+    psParamEst->sUqFilt.fltLambda = psParamEst->sCoeff.fltFiltLambda;
+    psParamEst->sIqFilt.fltLambda = psParamEst->sCoeff.fltFiltLambda;
+    psParamEst->sSpeedFilt.fltLambda = psParamEst->sCoeff.fltFiltLambda;
+    GDFLIB_FilterMAInit_FLT(0.0F, &psParamEst->sUqFilt);
+    GDFLIB_FilterMAInit_FLT(0.0F, &psParamEst->sIqFilt);
+    GDFLIB_FilterMAInit_FLT(0.0F, &psParamEst->sSpeedFilt);
+    psParamEst->sIqAvgFilt.fltLambda = psParamEst->sCoeff.fltExcitLambda;
+    psParamEst->sSpeedAvgFilt.fltLambda = psParamEst->sCoeff.fltExcitLambda;
+    GDFLIB_FilterMAInit_FLT(0.0F, &psParamEst->sIqAvgFilt);
+    GDFLIB_FilterMAInit_FLT(0.0F, &psParamEst->sSpeedAvgFilt);
+    psParamEst->ui16Cnt = 0U;
+    psParamEst->bExcited = FALSE;
+}
+
+/*!
+ * @brief Online phase resistance and flux linkage estimator, called in the slow loop.
+ *
+   The regression is y = Rs * iq + Ebemf * w / wnom with y = uq - w*Ld*id, all inputs filtered alike so
+   the relation holds between the averages. The inductive voltage of the q-axis current change is left
+   out, it is small against the resistive voltage at the filter bandwidth. Ebemf is the BEMF at wnom,
+   which keeps both unknowns in the same range and the single precision covariance well conditioned.
 
-@param   N/A
+ * @param psParamEst    The pointer of the estimator structure
+ * @param psFocPMSM     The pointer of the PMSM FOC structure, in sensorless closed loop
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void MCS_PMSMParamEst(mcs_param_est_t *psParamEst, mcs_pmsm_foc_t *psFocPMSM)
+{
+    const mcs_param_est_coeff_t *psCoeff = &psParamEst->sCoeff;
+    float_t fltSpeed = psFocPMSM->fltSpeedElEst;
+    float_t fltY, fltIq, fltW, fltIqAvg, fltWAvg;
+    float_t fltPPhi1, fltPPhi2, fltK1, fltK2, fltTmp;
+
+    /* the observer voltages and currents are in the same, estimated frame */
+    fltY = GDFLIB_FilterMA_FLT(psFocPMSM->sUDQEst.fltQ - fltSpeed * psCoeff->fltLd * psFocPMSM->sIDQ.fltD,
+                               &psParamEst->sUqFilt);
+    fltIq = GDFLIB_FilterMA_FLT(psFocPMSM->sIDQ.fltQ, &psParamEst->sIqFilt);
+    fltW = GDFLIB_FilterMA_FLT(fltSpeed / psCoeff->fltSpeedNom, &psParamEst->sSpeedFilt);
+
+    if (psParamEst->ui16Cnt < psCoeff->ui16Settle)
+    {
+        psParamEst->ui16Cnt++;
+    }
+    if ((psParamEst->ui16Cnt >= psCoeff->ui16Settle) &&
+        (MLIB_Abs_FLT(fltW * psCoeff->fltSpeedNom) >= psCoeff->fltSpeedMin))
+    {
+        psParamEst->ui16Cnt = psCoeff->ui16Settle - psCoeff->ui16Decim;
+        psParamEst->fltErr = fltY - psParamEst->fltRs * fltIq - psParamEst->fltBemfNom * fltW;
+
+        /* sine of the angle between the regressor and its recent average */
+        fltIqAvg = GDFLIB_FilterMA_FLT(fltIq, &psParamEst->sIqAvgFilt);
+        fltWAvg = GDFLIB_FilterMA_FLT(fltW, &psParamEst->sSpeedAvgFilt);
+        fltTmp = fltIq * fltWAvg - fltW * fltIqAvg;
+        psParamEst->bExcited = (bool_t)(fltTmp * fltTmp >= psCoeff->fltExcitMin * psCoeff->fltExcitMin *
+                                        (fltIq * fltIq + fltW * fltW) * (fltIqAvg * fltIqAvg + fltWAvg * fltWAvg));
+    }
+    else
+    {
+        psParamEst->bExcited = FALSE;
+    }
 
-@return  N/A
-******************************************************************************/
+    if (psParamEst->bExcited)
+    {
+        /* recursive least squares, regressor (iq, w) */
+        fltPPhi1 = psParamEst->fltP11 * fltIq + psParamEst->fltP12 * fltW;
+        fltPPhi2 = psParamEst->fltP12 * fltIq + psParamEst->fltP22 * fltW;
+        fltTmp = 1.0F / (psCoeff->fltForget + fltIq * fltPPhi1 + fltW * fltPPhi2);
+        fltK1 = fltPPhi1 * fltTmp;
+        fltK2 = fltPPhi2 * fltTmp;
+        psParamEst->fltRs += fltK1 * psParamEst->fltErr;
+        psParamEst->fltBemfNom += fltK2 * psParamEst->fltErr;
+
+        fltTmp = 1.0F / psCoeff->fltForget;
+        psParamEst->fltP11 = (psParamEst->fltP11 - fltK1 * fltPPhi1) * fltTmp;
+        psParamEst->fltP12 = (psParamEst->fltP12 - fltK1 * fltPPhi2) * fltTmp;
+        psParamEst->fltP22 = (psParamEst->fltP22 - fltK2 * fltPPhi2) * fltTmp;
+
+        /* the forgetting grows the covariance in the directions the recent regressors did not excite */
+        fltTmp = psParamEst->fltP11 + psParamEst->fltP22;
+        if (fltTmp > psCoeff->fltCovMax)
+        {
+            fltTmp = psCoeff->fltCovMax / fltTmp;
+            psParamEst->fltP11 *= fltTmp;
+            psParamEst->fltP12 *= fltTmp;
+            psParamEst->fltP22 *= fltTmp;
+        }
+
+        psParamEst->fltRs = GFLIB_Limit_FLT(psParamEst->fltRs, psCoeff->fltRsMin, psCoeff->fltRsMax);
+        psParamEst->fltFlux = GFLIB_Limit_FLT(psParamEst->fltBemfNom / psCoeff->fltSpeedNom, psCoeff->fltFluxMin,
+                                              psCoeff->fltFluxMax);
+        psParamEst->fltBemfNom = psParamEst->fltFlux * psCoeff->fltSpeedNom;
+
+        if (psCoeff->bObsrvUpdate)
+        {
+            /* same discretization as the Mx_I_SCALE, Mx_U_SCALE, Mx_E_SCALE and Mx_WI_SCALE macros */
+            fltTmp = 1.0F / (psCoeff->fltLd + psCoeff->fltTs * psParamEst->fltRs);
+            psFocPMSM->sBemfObsrv.fltIGain = psCoeff->fltLd * fltTmp;
+            psFocPMSM->sBemfObsrv.fltUGain = psCoeff->fltTs * fltTmp;
+            psFocPMSM->sBemfObsrv.fltEGain = psCoeff->fltTs * fltTmp;
+            psFocPMSM->sBemfObsrv.fltWIGain = psCoeff->fltLq * psCoeff->fltTs * fltTmp;
+        }
+    }
+}
+
+/*!
+ * @brief Dead-time compensation table initialization.
+ *
+ * This function builds the motor's dead-time compensation table from a power stage
+ * characteristic of DTCOMP_TABLE_SIZE points spread uniformly over
+ * <-fltPwrStgCharIRange, fltPwrStgCharIRange>, extended by fltPwrStgCharLinCoeff outside.
+ *
+ * @param psFocPMSM     The pointer of the PMSM FOC structure
+ * @param pfltUErr      Error voltages related to DC bus, NULL selects the char_pwrstg.h table
+ *
+ * @return None
+ */
+void MCS_DTCompInit(mcs_pmsm_foc_t *psFocPMSM, const float_t *pfltUErr)
+{
+    mcs_dtcomp_t *psDTComp = &psFocPMSM->sDTComp;
+    float_t fltIStep;
+    float_t fltSlopeOut;
+    uint16_t ui16Seg;
+
+    if (NULL == pfltUErr)
+    {
+        pfltUErr = pfltUDtComp;
+    }
+
+    /* grid position x = (i + IRange) * IToGrid, table point k lies at x = k */
+    fltIStep = (2.0F * psFocPMSM->fltPwrStgCharIRange) / (float_t)(DTCOMP_TABLE_SIZE - 1);
+    psDTComp->fltIOffset = psFocPMSM->fltPwrStgCharIRange;
+    psDTComp->fltIToGrid = 1.0F / fltIStep;
+
+    /* linear extension below the range continues from the first table point */
+    fltSlopeOut = psFocPMSM->fltPwrStgCharLinCoeff * fltIStep;
+    psDTComp->sSeg[0].fltOffset = pfltUErr[0];
+    psDTComp->sSeg[0].fltSlope = fltSlopeOut;
+
+    /* segment k interpolates between table points k-1 and k */
+    for (ui16Seg = 1U; ui16Seg < DTCOMP_TABLE_SIZE; ui16Seg++)
+    {
+        psDTComp->sSeg[ui16Seg].fltSlope = pfltUErr[ui16Seg] - pfltUErr[ui16Seg - 1U];
+        psDTComp->sSeg[ui16Seg].fltOffset = pfltUErr[ui16Seg - 1U] -
+                                            (float_t)(ui16Seg - 1U) * psDTComp->sSeg[ui16Seg].fltSlope;
+    }
+
+    /* linear extension above the range is symmetrical to the one below */
+    psDTComp->sSeg[DTCOMP_TABLE_SIZE].fltOffset = -pfltUErr[0] - (float_t)(DTCOMP_TABLE_SIZE - 1) * fltSlopeOut;
+    psDTComp->sSeg[DTCOMP_TABLE_SIZE].fltSlope = fltSlopeOut;
+}
+
+/*!
+ * @brief Dead-time compensation error voltage of one phase.
+ *
+ * The grid position is saturated before the segment is selected, so all three phases
+ * take the same branch-free path whether the current is inside the range or not.
+ *
+ * @param psDTComp      The pointer of the dead-time compensation table
+ * @param fltI          Phase current [A]
+ *
+ * @return Error voltage related to DC bus
+ */
+RAM_FUNC_CRITICAL static inline float_t MCS_DTCompErr(const mcs_dtcomp_t *psDTComp, float_t fltI)
+{
+    const mcs_dtcomp_seg_t *psSeg;
+    float_t fltX;
+    float_t fltXSat;
+
+    fltX = (fltI + psDTComp->fltIOffset) * psDTComp->fltIToGrid;
+    fltXSat = (fltX < -1.0F) ? -1.0F : fltX;
+    fltXSat = (fltXSat > (float_t)(DTCOMP_TABLE_SIZE - 1)) ? (float_t)(DTCOMP_TABLE_SIZE - 1) : fltXSat;
+    psSeg = &psDTComp->sSeg[(uint32_t)(fltXSat + 1.0F)];
+
+    return psSeg->fltOffset + fltX * psSeg->fltSlope;
+}
+
+/*!
+ * @brief Dead-time compensation using the motor's precomputed interpolation table
+ *
+ * @param sUAlBeDTComp  The pointer of the Alpha/Beta voltage to be compensated
+ * @param sIABC         The pointer of the measured 3-phase current
+ * @param fltUDcBusFilt Filtered DC bus voltage
+ * @param psDTComp      The pointer of the dead-time compensation table
+ *
+ * @return None
+ */
 RAM_FUNC_CRITICAL static void MCS_DTComp(GMCLIB_2COOR_ALBE_T_FLT *sUAlBeDTComp,
                 GMCLIB_3COOR_T_FLT *sIABC,
                 float_t fltUDcBusFilt,
-                float_t fltPwrStgCharIRange,
-                float_t fltPwrStgCharLinCoeff)
+                const mcs_dtcomp_t *psDTComp)
 {
     register GMCLIB_3COOR_T_FLT sUABCErr;
-    register float_t            fltUerrMax;
-    register int16_t            i16CurrSign;
-
-    /* maximal error voltage */
-    fltUerrMax = *pfltUDtComp;
-
-    /* compensate phase A */
-    i16CurrSign = (sIABC->fltA > fltPwrStgCharIRange) - 
-                  (sIABC->fltA < -fltPwrStgCharIRange);
-    if (!i16CurrSign)
-        sUABCErr.fltA = GFLIB_Lut1D_FLT(sIABC->fltA, 
-                                           pfltUDtComp, 
-                                           &sLUTUDtComp);
-    else
-        sUABCErr.fltA = i16CurrSign * 
-            ((MLIB_Abs_FLT(sIABC->fltA) - fltPwrStgCharIRange) * 
-             fltPwrStgCharLinCoeff - fltUerrMax);
-
-    /* compensate phase B */
-    i16CurrSign = (sIABC->fltB > fltPwrStgCharIRange) - 
-                  (sIABC->fltB < -fltPwrStgCharIRange);
-    if (!i16CurrSign)
-        sUABCErr.fltB = GFLIB_Lut1D_FLT(sIABC->fltB,
-                                           pfltUDtComp, 
-                                           &sLUTUDtComp);
-    else
-        sUABCErr.fltB = i16CurrSign * 
-          ((MLIB_Abs_FLT(sIABC->fltB) - fltPwrStgCharIRange) * 
-           fltPwrStgCharLinCoeff - fltUerrMax);
-
-    /* compensate phase C */
-    i16CurrSign = (sIABC->fltC > fltPwrStgCharIRange) - 
-                  (sIABC->fltC < -fltPwrStgCharIRange);
-    if (!i16CurrSign)
-        sUABCErr.fltC = GFLIB_Lut1D_FLT(sIABC->fltC, 
-                                           pfltUDtComp, 
-                                           &sLUTUDtComp);
-    else
-        sUABCErr.fltC = i16CurrSign * 
-          ((MLIB_Abs_FLT(sIABC->fltC) - fltPwrStgCharIRange) * 
-           fltPwrStgCharLinCoeff - fltUerrMax);
+
+    sUABCErr.fltA = MCS_DTCompErr(psDTComp, sIABC->fltA);
+    sUABCErr.fltB = MCS_DTCompErr(psDTComp, sIABC->fltB);
+    sUABCErr.fltC = MCS_DTCompErr(psDTComp, sIABC->fltC);
 
     /* add compensation voltages */
     sUAlBeDTComp->fltAlpha += (0.333333333333F) * fltUDcBusFilt * 
@@ -516,36 +916,44 @@ RAM_FUNC_CRITICAL static void MCS_DTComp(GMCLIB_2COOR_ALBE_T_FLT *sUAlBeDTComp,
                               (sUABCErr.fltB - sUABCErr.fltC);
 }
 
+/*!
+ * @brief    One second order section of the band stop filter in transposed direct form II.
+
+ * @param  psSOS  The pointer of the section
+ * @param  fltIn  Input data
+ * @return Section output
+ */
+RAM_FUNC_CRITICAL static inline float_t BSF_SectionUpdate(IIR2_T *psSOS, float_t fltIn)
+{
+	float_t fltOut;
+
+	/* only the output is on the path to the next section, the state updates overlap with it */
+	fltOut = psSOS->fltB0 * fltIn + psSOS->fltS1;
+	psSOS->fltS1 = psSOS->fltB1 * fltIn - psSOS->fltA1 * fltOut + psSOS->fltS2;
+	psSOS->fltS2 = psSOS->fltB2 * fltIn - psSOS->fltA2 * fltOut;
+
+	return fltOut;
+}
+
 /*!
  * @brief    An 8th order Band Stop Filter, which is realized by 4 Second Order Series(SOS).
             This function updates the filter.
 
+            The sections are unrolled and the section and output scales are folded into the
+            b coefficients by BSF_init, so one multiply-add per section is on the critical path.
+
  * @param  ptr   The pointer of the filter structure
  * @param  fltIn  Input data
  * @return Filter result
  */
 RAM_FUNC_CRITICAL float_t BSF_update(FILTER_T *ptr, float_t fltIn)
 {
-	uint16_t ui16Index;
 	float_t fltTmp;
 
-	/* 1st IIR2 */
-	ptr->sSOS_array[0].fltIn = ptr->sSOS_array[0].sCoeff.fltScale * fltIn;
-	ptr->sSOS_array[0].fltW0 = ptr->sSOS_array[0].fltIn - ptr->sSOS_array[0].sCoeff.fltA1 * ptr->sSOS_array[0].fltW1 - ptr->sSOS_array[0].sCoeff.fltA2 * ptr->sSOS_array[0].fltW2; /* input*scale + a1*w1 + a2*w2 */
-	ptr->sSOS_array[0].fltOut = ptr->sSOS_array[0].sCoeff.fltB0 * ptr->sSOS_array[0].fltW0 + ptr->sSOS_array[0].sCoeff.fltB1 * ptr->sSOS_array[0].fltW1 + ptr->sSOS_array[0].sCoeff.fltB2 * ptr->sSOS_array[0].fltW2; /* b0*w0 + b1*w1 + b2*w2 */
-	ptr->sSOS_array[0].fltW2 = ptr->sSOS_array[0].fltW1;
-	ptr->sSOS_array[0].fltW1 = ptr->sSOS_array[0].fltW0; /* update states */
-
-	for(ui16Index = 0; ui16Index <=2; ui16Index++ )
-	{
-		ptr->sSOS_array[ui16Index+1].fltIn = ptr->sSOS_array[ui16Index+1].sCoeff.fltScale * ptr->sSOS_array[ui16Index].fltOut;
-		ptr->sSOS_array[ui16Index+1].fltW0 = ptr->sSOS_array[ui16Index+1].fltIn - ptr->sSOS_array[ui16Index+1].sCoeff.fltA1 * ptr->sSOS_array[ui16Index+1].fltW1 - ptr->sSOS_array[ui16Index+1].sCoeff.fltA2 * ptr->sSOS_array[ui16Index+1].fltW2; /* input*scale + a1*w1 + a2*w2 */
-		ptr->sSOS_array[ui16Index+1].fltOut = ptr->sSOS_array[ui16Index+1].sCoeff.fltB0 * ptr->sSOS_array[ui16Index+1].fltW0 + ptr->sSOS_array[ui16Index+1].sCoeff.fltB1 * ptr->sSOS_array[ui16Index+1].fltW1 + ptr->sSOS_array[ui16Index+1].sCoeff.fltB2 * ptr->sSOS_array[ui16Index+1].fltW2; /* b0*w0 + b1*w1 + b2*w2 */
-		ptr->sSOS_array[ui16Index+1].fltW2 = ptr->sSOS_array[ui16Index+1].fltW1;
-		ptr->sSOS_array[ui16Index+1].fltW1 = ptr->sSOS_array[ui16Index+1].fltW0; /* update states */
-	}
-
-	fltTmp = ptr->sSOS_array[3].fltOut * ptr->fltOutScale;
+	fltTmp = BSF_SectionUpdate(&ptr->sSOS_array[0], fltIn);
+	fltTmp = BSF_SectionUpdate(&ptr->sSOS_array[1], fltTmp);
+	fltTmp = BSF_SectionUpdate(&ptr->sSOS_array[2], fltTmp);
+	fltTmp = BSF_SectionUpdate(&ptr->sSOS_array[3], fltTmp);
 
 	return fltTmp;
 }
@@ -554,18 +962,30 @@ RAM_FUNC_CRITICAL float_t BSF_update(FILTER_T *ptr, float_t fltIn)
  * @brief    An 8th order Band Stop Filter, which is realized by 4 Second Order Series(SOS).
             This function initializes the internal states of the filter.
 
- * @param  fltIn  Input data
+ * @param  ptr   The pointer of the filter structure
  * @return non
  */
 void BSF_init(FILTER_T *ptr)
 {
 	uint16_t ui16Index;
+	float_t fltScale;
+	IIR2_T *psSOS;
 
-	for(ui16Index = 0; ui16Index <= 4; ui16Index++)
+	for(ui16Index = 0; ui16Index < BSF_SECTIONS; ui16Index++)
 	{
-		ptr->sSOS_array[ui16Index].fltW0 = 0;
-		ptr->sSOS_array[ui16Index].fltW1 = 0;
-		ptr->sSOS_array[ui16Index].fltW2 = 0;
+		psSOS = &ptr->sSOS_array[ui16Index];
+		fltScale = psSOS->sCoeff.fltScale;
+		if(ui16Index == (BSF_SECTIONS - 1U))
+		{
+			fltScale *= ptr->fltOutScale;
+		}
+		psSOS->fltB0 = psSOS->sCoeff.fltB0 * fltScale;
+		psSOS->fltB1 = psSOS->sCoeff.fltB1 * fltScale;
+		psSOS->fltB2 = psSOS->sCoeff.fltB2 * fltScale;
+		psSOS->fltA1 = psSOS->sCoeff.fltA1;
+		psSOS->fltA2 = psSOS->sCoeff.fltA2;
+		psSOS->fltS1 = 0;
+		psSOS->fltS2 = 0;
 	}
 }
 
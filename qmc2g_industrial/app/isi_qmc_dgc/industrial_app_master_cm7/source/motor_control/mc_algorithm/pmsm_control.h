@@ -12,6 +12,7 @@
 #define PMSM_CONTROL_H
 
 #include "char_pwrstg.h"
+#include "mc_profile.h"
 #include "gflib_FP.h"
 #include "gmclib_FP.h"
 #include "gdflib_FP.h"
@@ -69,7 +70,7 @@ typedef struct trajectory_filter
  *                                     1 + a1*z^-1 + a2*z^-2
  *
  *  Scale is a gain for this SOS
- *  w0, w1 and w2 are internal states of an SOS
+ *  The SOS is computed in transposed direct form II, s1 and s2 are its internal states
  *
  * */
 
@@ -86,11 +87,14 @@ typedef struct
 typedef struct
 {
 	IIR2_COEFF_T sCoeff;
-	float_t fltW0;
-	float_t fltW1;
-	float_t fltW2;
-	float_t fltIn;
-	float_t fltOut;
+	/* Run-time coefficients in the order of use, the b's include the scales. Set by BSF_init */
+	float_t fltB0;
+	float_t fltB1;
+	float_t fltA1;
+	float_t fltB2;
+	float_t fltA2;
+	float_t fltS1;
+	float_t fltS2;
 }IIR2_T;
 
 typedef struct
@@ -108,6 +112,21 @@ typedef struct mcs_alignment_a1
     frac16_t f16PosAlign;   /* Position for alignment */
 } mcs_alignment_t;       /* PMSM simple two-step Ud voltage alignment */
 
+/*! @brief mcs dead-time compensation segment, error voltage = fltOffset + x * fltSlope */
+typedef struct mcs_dtcomp_seg_a1
+{
+    float_t fltOffset;      /* Segment error voltage at grid position 0 [-] */
+    float_t fltSlope;       /* Segment error voltage change per grid step [-] */
+} mcs_dtcomp_seg_t;
+
+/*! @brief mcs dead-time compensation structure, uniform current grid over <-fltPwrStgCharIRange, fltPwrStgCharIRange> */
+typedef struct mcs_dtcomp_a1
+{
+    mcs_dtcomp_seg_t sSeg[DTCOMP_TABLE_SIZE + 1]; /* Segment 0 below range, 1..SIZE-1 inside, SIZE above range */
+    float_t fltIOffset;                         /* Current offset of the grid origin [A] */
+    float_t fltIToGrid;                         /* Grid steps per ampere [1/A] */
+} mcs_dtcomp_t;
+
 /*! @brief mcs foc structure */
 typedef struct mcs_pmsm_foc_a1
 {
@@ -143,12 +162,16 @@ typedef struct mcs_pmsm_foc_a1
     float_t fltUDcBusFilt;                      /* Filtered DC bus voltage */
     float_t fltPwrStgCharIRange;                /* Power Stage characteristic current range */
     float_t fltPwrStgCharLinCoeff;              /* Power Stage characteristic linear coefficient */
+    mcs_dtcomp_t sDTComp;                       /* Dead-time compensation table built by MCS_DTCompInit */
     bool_t bCurrentLoopOn;                      /* Flag enabling calculation of current control loop */
     bool_t bPosExtOn;                           /* Flag enabling use of electrical position passed from other functions */
     bool_t bOpenLoop;                           /* Position estimation loop is open */
     bool_t bIdPiStopInteg;                      /* Id PI controller manual stop integration */
     bool_t bIqPiStopInteg;                      /* Iq PI controller manual stop integration */
     bool_t bFlagDTComp;                         /* Enable/disable dead-time compensation flag */
+#if FEATURE_MC_FOC_PROFILING
+    mc_profile_t *psProfile;                    /* Fast loop stage profile of the motor */
+#endif
 } mcs_pmsm_foc_t;
 
 /*! @brief mcs scalar structure */
@@ -165,6 +188,22 @@ typedef struct mcs_pmsm_scalar_ctrl_a1
     float_t fltVHzGain;                         /* VHz_factor constant gain for scalar control */
 } mcs_pmsm_scalar_ctrl_t;
 
+/*! @brief Breakpoint of the speed PI gain schedule */
+typedef struct mcs_speed_gain_point_a1
+{
+    float_t fltSpeed;                           /* [rad/s] Electrical speed magnitude of the breakpoint */
+    float_t fltPGain;                           /* Speed PI proportional gain at fltSpeed */
+    float_t fltIGain;                           /* Speed PI integral gain at fltSpeed */
+} mcs_speed_gain_point_t;
+
+/*! @brief Speed PI gain schedule, see MCS_PMSMFocCtrlSpeed */
+typedef struct mcs_speed_gain_sched_a1
+{
+    const mcs_speed_gain_point_t *psTable;      /* Breakpoints in ascending speed, NULL keeps the gains constant */
+    uint16_t ui16Size;                          /* Number of breakpoints */
+    uint16_t ui16Seg;                           /* Segment of the last lookup, where the next search starts */
+} mcs_speed_gain_sched_t;
+
 /*! @brief mcs scalar structure */
 typedef struct mcs_speed_a1
 {
@@ -187,8 +226,29 @@ typedef struct mcs_speed_a1
     bool_t bIqPiLimFlag;			/* Saturation flag of Iq controller */
 
     GDFLIB_FILTER_IIR1_T_FLT sIqFwdFilter;
+    mcs_speed_gain_sched_t sGainSched;          /* Speed PI gains over the filtered speed */
+    float_t fltIqAccFwd;                        /* [A], acceleration feed forward current from the position trajectory */
+    bool_t bIqAccFwdOn;                         /* fltIqAccFwd replaces the feed forward from the speed ramp */
 } mcs_speed_t;
 
+/*! @brief mcs MTPA and field weakening structure, see MCS_PMSMFieldWeakening */
+typedef struct mcs_pmsm_fw_a1
+{
+    AMCLIB_CTRL_FLUX_WKNG_T_FLT sFwCtrl;        /* Voltage feedback field weakening controller, its output is the d-axis current */
+    float_t fltRs;                              /* [ohm] Phase resistance */
+    float_t fltLd;                              /* [H] d-axis inductance */
+    float_t fltFlux;                            /* [Wb] Permanent magnet flux linkage, positive */
+    float_t fltLqLdDiff;                        /* [H] Lq - Ld, the MTPA is off at 0 */
+    float_t fltUqLimGain;                       /* Part of the q-axis voltage limit kept by the field weakening */
+    float_t fltIdMin;                           /* [A] Lowest field weakening d-axis current */
+    float_t fltIMax;                            /* [A] Current vector limit, the speed controller output limits follow from it */
+    float_t fltIdMtpa;                          /* [A] MTPA d-axis current of the required Iq */
+    float_t fltIdFw;                            /* [A] Field weakening d-axis current */
+    float_t fltIdFwMin;                         /* [A] d-axis current of the least voltage at the speed and Iq */
+    bool_t bFwStopInteg;                        /* Field weakening controller stop integration */
+    bool_t bFwOn;                               /* Field weakening enabled */
+} mcs_pmsm_fw_t;
+
 /*! @brief mcs position structure */
 typedef struct mcs_trajectory_a1
 {
@@ -225,6 +285,13 @@ typedef struct mcs_position_a1
 	float_t     fltFracToAngularSpeedCoeff; /* a coefficient to convert fractional frequency to electrical angular speed */
     float_t     fltRpmToAngularSpeedCoeff;  /* a coefficient to convert mechanical speed in RPM to electrical angular speed */
 
+	/* Acceleration feed forward related */
+	float_t		fltSpeedTraj;		  /* [rad/s], electrical angular speed of the trajectory filter output */
+	float_t		fltSpeedTraj_1;
+	float_t		fltAccFwd;			  /* [rad/s^2], electrical angular acceleration of the trajectory filter output */
+	float_t		fltGainAccFwd;		  /* [A.s^2/rad], Iq per electrical angular acceleration (inertia constant), 0 disables */
+	float_t		fltIqAccFwd;		  /* [A], acceleration feed forward current to the current loop */
+
 	/* Position control block output */
 	float_t		fltSpeedRef;		  /* Speed command, electrical angular speed */
 
@@ -266,7 +333,51 @@ typedef struct mcs_pmsm_startup_a1
     uint16_t ui16TimeStartUpFreeWheel; 		    /* Free-wheel duration if start-up aborted by user input (required zero speed) */
     bool_t bOpenLoop;                           /* Position estimation loop is open */
     bool_t bMergeFlag;                          /* Indicate whether enable merge when openloop speed is larger than catchup speed */
-} mcs_pmsm_startup_t; 
+} mcs_pmsm_startup_t;
+
+/*! @brief Settings of the online resistance and flux estimator */
+typedef struct mcs_param_est_coeff_a1
+{
+    float_t fltRsNom;                           /* [ohm] Phase resistance at start, also the observer design value */
+    float_t fltRsMin;                           /* [ohm] Lower bound of the estimated resistance */
+    float_t fltRsMax;                           /* [ohm] Upper bound of the estimated resistance */
+    float_t fltFluxNom;                         /* [Wb] Permanent magnet flux linkage at start */
+    float_t fltFluxMin;                         /* [Wb] Lower bound of the estimated flux linkage */
+    float_t fltFluxMax;                         /* [Wb] Upper bound of the estimated flux linkage */
+    float_t fltLd;                              /* [H] d-axis inductance */
+    float_t fltLq;                              /* [H] q-axis inductance */
+    float_t fltTs;                              /* [s] Fast loop period, the sample time of the BEMF observer */
+    float_t fltSpeedNom;                        /* [rad/s] Electrical speed that scales the flux in the regression */
+    float_t fltSpeedMin;                        /* [rad/s] Electrical speed below which the estimates are held */
+    float_t fltFiltLambda;                      /* Input moving average filter coefficient, 1/window in slow loops */
+    float_t fltForget;                          /* Forgetting factor of the least squares per update */
+    float_t fltCovMax;                          /* Bound of the covariance trace */
+    float_t fltExcitLambda;                     /* Regressor average filter coefficient, 1/window in updates */
+    float_t fltExcitMin;                        /* Sine of the least angle between the regressor and its average */
+    uint16_t ui16Settle;                        /* Slow loops after a restart before the first update */
+    uint16_t ui16Decim;                         /* Slow loops per update */
+    bool_t bObsrvUpdate;                        /* Write the estimated resistance into the BEMF observer gains */
+} mcs_param_est_coeff_t;
+
+/*! @brief Online resistance and flux estimator, see MCS_PMSMParamEst */
+typedef struct mcs_param_est_a1
+{
+    mcs_param_est_coeff_t sCoeff;               /* Settings */
+    GDFLIB_FILTER_MA_T_FLT sUqFilt;             /* q-axis voltage less the d-axis cross coupling */
+    GDFLIB_FILTER_MA_T_FLT sIqFilt;             /* q-axis current */
+    GDFLIB_FILTER_MA_T_FLT sSpeedFilt;          /* Electrical speed relative to fltSpeedNom */
+    GDFLIB_FILTER_MA_T_FLT sIqAvgFilt;          /* Average of the filtered q-axis current over the updates */
+    GDFLIB_FILTER_MA_T_FLT sSpeedAvgFilt;       /* Average of the filtered relative speed over the updates */
+    float_t fltRs;                              /* [ohm] Estimated phase resistance */
+    float_t fltFlux;                            /* [Wb] Estimated permanent magnet flux linkage */
+    float_t fltBemfNom;                         /* [V] Estimated BEMF at fltSpeedNom, the regressed flux */
+    float_t fltP11;                             /* Covariance of the estimates, resistance */
+    float_t fltP12;                             /* Covariance of the estimates, cross term */
+    float_t fltP22;                             /* Covariance of the estimates, BEMF */
+    float_t fltErr;                             /* [V] Prediction error of the last update */
+    uint16_t ui16Cnt;                           /* Slow loops since the last update or the restart */
+    bool_t bExcited;                            /* The last update was applied */
+} mcs_param_est_t;
 
 
 
@@ -297,6 +408,9 @@ extern void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM);
  * @brief PMSM field oriented speed control.
  *
  * This function is used to compute PMSM field oriented speed control.
+ * With a gain schedule in sGainSched, the PI gains are interpolated over the filtered speed magnitude and
+ * held at the first and last breakpoint outside the table. A change of the proportional gain is moved into
+ * the integral state, so the controller output does not step when the gains change.
  *
  * @param psSpeed       The pointer of the PMSM speed structure
  *
@@ -304,11 +418,34 @@ extern void MCS_PMSMFocCtrl(mcs_pmsm_foc_t *psFocPMSM);
  */
 
 extern void MCS_PMSMFocCtrlSpeed(mcs_speed_t *psSpeed);
+
+/*!
+ * @brief PMSM MTPA and field weakening, called in the slow loop after the speed control.
+ *
+ * The MTPA d-axis current of the required Iq is (flux - sqrt(flux^2 + 4*(Lq-Ld)^2*Iq^2))/(2*(Lq-Ld)). The
+ * field weakening controller lowers the d-axis current when the q-axis voltage of the current controller
+ * approaches fltUqLimGain of its limit, which is the part of the DC bus voltage left by the d-axis voltage,
+ * down to fltIdMin or to the d-axis current of the least voltage vector, below which a lower d-axis current
+ * costs more resistive voltage than it saves induced voltage.
+ * The lower of both d-axis currents is required, and the Iq request and the speed controller output limits
+ * are reduced so the current vector stays within fltIMax. With the MTPA and the field weakening off, the
+ * d-axis current is 0 and Iq is limited to fltIMax.
+ *
+ * @param psFw          The pointer of the MTPA and field weakening structure
+ * @param psFocPMSM     The pointer of the PMSM FOC structure, its sIDQReq is set
+ * @param psSpeed       The pointer of the PMSM speed structure, after MCS_PMSMFocCtrlSpeed
+ *
+ * @return None
+ */
+extern void MCS_PMSMFieldWeakening(mcs_pmsm_fw_t *psFw, mcs_pmsm_foc_t *psFocPMSM, mcs_speed_t *psSpeed);
    
 /*!
  * @brief PMSM field oriented position control.
  *
    This function is used to compute PMSM field oriented position control.
+   With the trajectory filter, the speed feed forward is the exact increment of the filter output and the
+   acceleration feed forward fltIqAccFwd is its change scaled by fltGainAccFwd. Without it, the speed feed
+   forward is the difference of the position command and there is no acceleration feed forward.
 
  * @param psPosition       The pointer of the PMSM position structure
  *
@@ -328,6 +465,20 @@ extern void MCS_PMSMFocCtrlPosition(mcs_position_t *psPosition);
 
 extern void MCS_PMSMAlignment(mcs_alignment_t *psAlignment);
 
+/*!
+ * @brief Dead-time compensation table initialization.
+ *
+ * This function builds the motor's dead-time compensation table from a power stage
+ * characteristic of DTCOMP_TABLE_SIZE points spread uniformly over
+ * <-fltPwrStgCharIRange, fltPwrStgCharIRange>, extended by fltPwrStgCharLinCoeff outside.
+ *
+ * @param psFocPMSM     The pointer of the PMSM FOC structure
+ * @param pfltUErr      Error voltages related to DC bus, NULL selects the char_pwrstg.h table
+ *
+ * @return None
+ */
+extern void MCS_DTCompInit(mcs_pmsm_foc_t *psFocPMSM, const float_t *pfltUErr);
+
 /*!
  * @brief PMSM Open Loop Start-up
  *
@@ -352,6 +503,48 @@ extern void MCS_PMSMOpenLoopStartUp(mcs_pmsm_startup_t *psStartUp);
 
 extern void MCS_PMSMScalarCtrl(mcs_pmsm_scalar_ctrl_t *psScalarPMSM);
 
+/*!
+ * @brief Online phase resistance and flux linkage estimator initialization.
+ *
+ * Sets the estimates to the nominal values of sCoeff, the covariance to its bound and restarts the
+ * input filters, see MCS_PMSMParamEstRestart.
+ *
+ * @param psParamEst    The pointer of the estimator structure, sCoeff is set
+ *
+ * @return None
+ */
+extern void MCS_PMSMParamEstInit(mcs_param_est_t *psParamEst);
+
+/*!
+ * @brief Online phase resistance and flux linkage estimator restart.
+ *
+ * Clears the input filters and holds the updates for sCoeff.ui16Settle slow loops, the estimates and the
+ * covariance are kept. Call it when the FOC is restarted.
+ *
+ * @param psParamEst    The pointer of the estimator structure
+ *
+ * @return None
+ */
+extern void MCS_PMSMParamEstRestart(mcs_param_est_t *psParamEst);
+
+/*!
+ * @brief Online phase resistance and flux linkage estimator, called in the slow loop.
+ *
+   The steady state q-axis voltage equation uq - w*Ld*id = Rs*iq + w*flux is regressed by recursive least
+   squares with a forgetting factor on the voltage and current in the frame of the BEMF observer, averaged
+   by moving average filters. The two unknowns are only separable when iq and the speed change relative to
+   each other, so an update is applied only while the regressor (iq, w) points away from its recent average
+   by more than sCoeff.fltExcitMin; at a steady operating point the estimates are held. The estimates are
+   limited to their bounds and held below sCoeff.fltSpeedMin. With sCoeff.bObsrvUpdate, the BEMF observer
+   is rediscretized with the estimated resistance after each applied update.
+
+ * @param psParamEst    The pointer of the estimator structure
+ * @param psFocPMSM     The pointer of the PMSM FOC structure, in sensorless closed loop
+ *
+ * @return None
+ */
+extern void MCS_PMSMParamEst(mcs_param_est_t *psParamEst, mcs_pmsm_foc_t *psFocPMSM);
+
 /*!
  * @brief An 2nd order filter is used to realize trajectory. This function initializes the filter.
 
@@ -365,6 +558,9 @@ extern void trajectoryFilterInit(trajectory_filter_t *this);
  * @brief PMSM field oriented position control.
  *
    This function is used to compute PMSM field oriented position control.
+   With the trajectory filter, the speed feed forward is the exact increment of the filter output and the
+   acceleration feed forward fltIqAccFwd is its change scaled by fltGainAccFwd. Without it, the speed feed
+   forward is the difference of the position command and there is no acceleration feed forward.
 
  * @param psPosition       The pointer of the PMSM position structure
  *
@@ -380,13 +576,14 @@ extern void MCS_PMSMFocCtrlPosition(mcs_position_t *psPosition);
  * @param  fltIn  Input data
  * @return Filter result
  */
-extern float_t BSF_update(FILTER_T *ptr, float_t f16In);
+extern float_t BSF_update(FILTER_T *ptr, float_t fltIn);
 
 /*!
  * @brief    An 8th order Band Stop Filter, which is realized by 4 Second Order Series(SOS).
-            This function initializes the internal states of the filter.
+            This function initializes the internal states of the filter and derives the run-time
+            coefficients from sCoeff and fltOutScale, call it again after changing them.
 
- * @param  fltIn  Input data
+ * @param  ptr   The pointer of the filter structure
  * @return non
  */
 extern void BSF_init(FILTER_T *ptr);
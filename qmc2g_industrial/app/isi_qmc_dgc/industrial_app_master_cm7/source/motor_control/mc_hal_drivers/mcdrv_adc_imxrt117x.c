@@ -20,6 +20,67 @@
  * Code
  ******************************************************************************/
 
+/*!
+ * @brief Builds the per sector table of the fast loop from the settings of the sector pairs
+ *
+ * @param this   Pointer to the current object
+ *
+ * @return none
+ */
+static void MCDRV_Curr3Ph2ShSectorSet(mcdrv_adc_t *this)
+{
+	uint16_t ui16Sector;
+	curr_sector_t *psSector;
+
+	for(ui16Sector = 1; ui16Sector <= SVM_SECTORS; ui16Sector++)
+	{
+		psSector = &this->sSector[ui16Sector - 1];
+		switch(ui16Sector)
+		{
+			case 2:
+			case 3:
+				/* direct sensing of phase A and C, calculation of B */
+				psSector->pui16RsltReg[0] = this->sCurrSec23.pui16RsltRegPhaA;
+				psSector->pui16RsltReg[1] = this->sCurrSec23.pui16RsltRegPhaC;
+				psSector->ui16Offset[0] = this->sCurrSec23.ui16OffsetPhaA;
+				psSector->ui16Offset[1] = this->sCurrSec23.ui16OffsetPhaC;
+				psSector->ui8Pha[0] = 0;
+				psSector->ui8Pha[1] = 2;
+				psSector->ui8Pha[2] = 1;
+				psSector->sChainWrite[0].ui32Csel0 = ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec23.ui16ADC1Seg0CmdNum);
+				psSector->sChainWrite[1].ui32Csel0 = ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec23.ui16ADC2Seg0CmdNum);
+				break;
+			case 4:
+			case 5:
+				/* direct sensing of phase A and B, calculation of C */
+				psSector->pui16RsltReg[0] = this->sCurrSec45.pui16RsltRegPhaA;
+				psSector->pui16RsltReg[1] = this->sCurrSec45.pui16RsltRegPhaB;
+				psSector->ui16Offset[0] = this->sCurrSec45.ui16OffsetPhaA;
+				psSector->ui16Offset[1] = this->sCurrSec45.ui16OffsetPhaB;
+				psSector->ui8Pha[0] = 0;
+				psSector->ui8Pha[1] = 1;
+				psSector->ui8Pha[2] = 2;
+				psSector->sChainWrite[0].ui32Csel0 = ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec45.ui16ADC1Seg0CmdNum);
+				psSector->sChainWrite[1].ui32Csel0 = ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec45.ui16ADC2Seg0CmdNum);
+				break;
+			default:
+				/* direct sensing of phase B and C, calculation of A */
+				psSector->pui16RsltReg[0] = this->sCurrSec16.pui16RsltRegPhaB;
+				psSector->pui16RsltReg[1] = this->sCurrSec16.pui16RsltRegPhaC;
+				psSector->ui16Offset[0] = this->sCurrSec16.ui16OffsetPhaB;
+				psSector->ui16Offset[1] = this->sCurrSec16.ui16OffsetPhaC;
+				psSector->ui8Pha[0] = 1;
+				psSector->ui8Pha[1] = 2;
+				psSector->ui8Pha[2] = 0;
+				psSector->sChainWrite[0].ui32Csel0 = ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec16.ui16ADC1Seg0CmdNum);
+				psSector->sChainWrite[1].ui32Csel0 = ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec16.ui16ADC2Seg0CmdNum);
+				break;
+		}
+		psSector->sChainWrite[0].pui32ChainReg = &ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0;
+		psSector->sChainWrite[1].pui32ChainReg = &ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0;
+	}
+}
+
 /*!
  * @brief Reads and calculates 3 phase samples based on SVM sector
  *
@@ -31,53 +92,43 @@ RAM_FUNC_CRITICAL bool_t MCDRV_Curr3Ph2ShGet(mcdrv_adc_t *this)
 {
 	bool_t bStatusPass = FALSE;
 	GMCLIB_3COOR_T_F16 sIABCtemp;
+	const curr_sector_t *psSector;
+	uint32_t ui32Sector;
+	frac16_t f16IPha[3];
 
     int16_t i16Rslt0;
     int16_t i16Rslt1;
 
-    switch (*this->pui16SVMSector)
+    ui32Sector = (uint32_t)(*this->pui16SVMSector) - 1U;
+
+    if(ui32Sector < SVM_SECTORS)
     {
-        case 2:
-        case 3:
-            /* direct sensing of phase A and C, calculation of B */
-        	i16Rslt0 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(this->sCurrSec23.pui16RsltRegPhaA))<<3);
-        	i16Rslt1 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(this->sCurrSec23.pui16RsltRegPhaC))<<3);
-            sIABCtemp.f16A = MLIB_Sub_F16(i16Rslt0, this->sCurrSec23.ui16OffsetPhaA)<<1;
-            sIABCtemp.f16C = MLIB_Sub_F16(i16Rslt1, this->sCurrSec23.ui16OffsetPhaC)<<1;
-            sIABCtemp.f16B = MLIB_Neg_F16(MLIB_AddSat_F16(sIABCtemp.f16A, sIABCtemp.f16C));
-            bStatusPass = TRUE;
-            break;
-        case 4:
-        case 5:
-            /* direct sensing of phase A and B, calculation of C */
-        	i16Rslt0 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(this->sCurrSec45.pui16RsltRegPhaA))<<3);
-        	i16Rslt1 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(this->sCurrSec45.pui16RsltRegPhaB))<<3);
-            sIABCtemp.f16A = MLIB_Sub_F16(i16Rslt0, this->sCurrSec45.ui16OffsetPhaA)<<1;
-            sIABCtemp.f16B = MLIB_Sub_F16(i16Rslt1, this->sCurrSec45.ui16OffsetPhaB)<<1;
-            sIABCtemp.f16C = MLIB_Neg_F16(MLIB_AddSat_F16(sIABCtemp.f16A, sIABCtemp.f16B));
-            bStatusPass = TRUE;
-            break;
-        case 1:
-        case 6:
-            /* direct sensing of phase B and C, calculation of A */
-        	i16Rslt0 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(this->sCurrSec16.pui16RsltRegPhaB))<<3);
-        	i16Rslt1 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(this->sCurrSec16.pui16RsltRegPhaC))<<3);
-            sIABCtemp.f16B = MLIB_Sub_F16(i16Rslt0, this->sCurrSec16.ui16OffsetPhaB)<<1;
-            sIABCtemp.f16C = MLIB_Sub_F16(i16Rslt1, this->sCurrSec16.ui16OffsetPhaC)<<1;
-            sIABCtemp.f16A = MLIB_Neg_F16(MLIB_AddSat_F16(sIABCtemp.f16B, sIABCtemp.f16C));
-            bStatusPass = TRUE;
-            break;
-        default:
-		#ifndef QMC1G
-			sIABCtemp.f16A = this->psIABC->f16A;
-			sIABCtemp.f16B = this->psIABC->f16B;
-			sIABCtemp.f16C = this->psIABC->f16C;
-		#else
-			sIABCtemp.f16A = -this->psIABC->f16A;
-			sIABCtemp.f16B = -this->psIABC->f16B;
-			sIABCtemp.f16C = -this->psIABC->f16C;
-		#endif
-        	break;
+        /* direct sensing of two phases, calculation of the third one, as selected by the sector */
+        psSector = &this->sSector[ui32Sector];
+        i16Rslt0 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(psSector->pui16RsltReg[0]))<<3);
+        i16Rslt1 = MLIB_Mul_F16as(this->a32Gain, (frac16_t)(*(psSector->pui16RsltReg[1]))<<3);
+        i16Rslt0 = MLIB_Sub_F16(i16Rslt0, psSector->ui16Offset[0])<<1;
+        i16Rslt1 = MLIB_Sub_F16(i16Rslt1, psSector->ui16Offset[1])<<1;
+        f16IPha[psSector->ui8Pha[0]] = i16Rslt0;
+        f16IPha[psSector->ui8Pha[1]] = i16Rslt1;
+        f16IPha[psSector->ui8Pha[2]] = MLIB_Neg_F16(MLIB_AddSat_F16(i16Rslt0, i16Rslt1));
+
+        sIABCtemp.f16A = f16IPha[0];
+        sIABCtemp.f16B = f16IPha[1];
+        sIABCtemp.f16C = f16IPha[2];
+        bStatusPass = TRUE;
+    }
+    else
+    {
+	#ifndef QMC1G
+		sIABCtemp.f16A = this->psIABC->f16A;
+		sIABCtemp.f16B = this->psIABC->f16B;
+		sIABCtemp.f16C = this->psIABC->f16C;
+	#else
+		sIABCtemp.f16A = -this->psIABC->f16A;
+		sIABCtemp.f16B = -this->psIABC->f16B;
+		sIABCtemp.f16C = -this->psIABC->f16C;
+	#endif
     }
     
     /* pass measured phase currents to the main module structure */
@@ -324,6 +375,8 @@ bool_t MCDRV_Curr3Ph2ShChanAssignInit(mcdrv_adc_t *this)
     }
 
 
+    MCDRV_Curr3Ph2ShSectorSet(this);
+
     /* DC bus voltage and auxiliary signal assignment */
     if(this->psChannelAssignment->sLPADC1VDcb.ui16ChanNum != NOT_EXIST)
     {
@@ -377,46 +430,21 @@ bool_t MCDRV_Curr3Ph2ShChanAssignInit(mcdrv_adc_t *this)
 RAM_FUNC_CRITICAL bool_t MCDRV_Curr3Ph2ShChanAssign(mcdrv_adc_t *this)
 {
 	bool_t bStatusPass = FALSE;
-    
-    switch (*this->pui16SVMSector)
-    {
-        /* direct sensing of phases A and C */
-        case 2:
-        case 3:
-        	ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0 &= ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK;
-        	ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0 &= ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK;
+	const curr_sector_t *psSector;
+	uint32_t ui32Sector;
 
-        	ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0 |= ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec23.ui16ADC1Seg0CmdNum);
-        	ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0 |= ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec23.ui16ADC2Seg0CmdNum);
-        	bStatusPass = TRUE;
-            break;
+	ui32Sector = (uint32_t)(*this->pui16SVMSector) - 1U;
 
-        /* direct sensing of phases A and B  */
-        case 4:
-        case 5:
-        	ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0 &= ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK;
-        	ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0 &= ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK;
-
-        	ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0 |= ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec45.ui16ADC1Seg0CmdNum);
-        	ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0 |= ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec45.ui16ADC2Seg0CmdNum);
-        	bStatusPass = TRUE;
-            break;
-
-        /* direct sensing of phases B and C */
-        case 1:
-        case 6:
-        	ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0 &= ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK;
-        	ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0 &= ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK;
+	if(ui32Sector < SVM_SECTORS)
+	{
+		/* select the commands of the phases to sense in the sector, one read-modify-write per trigger */
+		psSector = &this->sSector[ui32Sector];
+		*psSector->sChainWrite[0].pui32ChainReg = (*psSector->sChainWrite[0].pui32ChainReg & ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK) | psSector->sChainWrite[0].ui32Csel0;
+		*psSector->sChainWrite[1].pui32ChainReg = (*psSector->sChainWrite[1].pui32ChainReg & ~ADC_ETC_TRIGn_CHAIN_1_0_CSEL0_MASK) | psSector->sChainWrite[1].ui32Csel0;
+		bStatusPass = TRUE;
+	}
 
-        	ADC_ETC->TRIG[this->ui8MotorNum-1].TRIGn_CHAIN_1_0 |= ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec16.ui16ADC1Seg0CmdNum);
-        	ADC_ETC->TRIG[this->ui8MotorNum-1+4].TRIGn_CHAIN_1_0 |= ADC_ETC_TRIGn_CHAIN_1_0_CSEL0(this->sCurrSec16.ui16ADC2Seg0CmdNum);
-        	bStatusPass = TRUE;
-            break;
-        default:
-        	break;
-    }
-    
-    return (bStatusPass);
+	return (bStatusPass);
 }
 
 /*!
@@ -459,6 +487,7 @@ RAM_FUNC_CRITICAL void MCDRV_Curr3Ph2ShCalibInit(mcdrv_adc_t *this)
     GDFLIB_FilterMAInit_F16((frac16_t)0, &this->sCurrSec45.sFiltPhaA);
     GDFLIB_FilterMAInit_F16((frac16_t)0, &this->sCurrSec45.sFiltPhaB);
 
+    MCDRV_Curr3Ph2ShSectorSet(this);
 }
 
 /*!
@@ -533,6 +562,7 @@ RAM_FUNC_CRITICAL void MCDRV_Curr3Ph2ShCalibSet(mcdrv_adc_t *this)
     this->sCurrSec45.ui16OffsetPhaA = this->sCurrSec45.ui16CalibPhaA;
     this->sCurrSec45.ui16OffsetPhaB = this->sCurrSec45.ui16CalibPhaB;
 
+    MCDRV_Curr3Ph2ShSectorSet(this);
 }
 
 /*!
@@ -19,6 +19,7 @@
  ******************************************************************************/
 #define NOT_EXIST      0xFFFF
 #define CALIB_MA_NUM   8 // Moving average filter number for phase current offsets
+#define SVM_SECTORS    6 // SVM sectors 1..6
 
 
 typedef struct channel_info
@@ -89,6 +90,20 @@ typedef struct pha_ab
     uint16_t ui16ADC2Seg0CmdNum;
 } pha_ab_t;
 
+typedef struct chain_write
+{
+	uint32_t volatile *pui32ChainReg;	/* ADC_ETC TRIGn_CHAIN_1_0 register */
+	uint32_t ui32Csel0;					/* CSEL0 field to write */
+}chain_write_t;
+
+typedef struct curr_sector
+{
+	uint16_t const volatile *pui16RsltReg[2];	/* result registers of the two sensed phases */
+	uint16_t ui16Offset[2];						/* offsets of the two sensed phases */
+	uint8_t  ui8Pha[3];							/* phases (0 A, 1 B, 2 C) of the two sensed results and of the calculated one */
+	chain_write_t sChainWrite[2];				/* ADC1 and ADC2 segment 0 command selection for the next sampling */
+}curr_sector_t;
+
 typedef struct mcdrv_adc
 {
 	GMCLIB_3COOR_T_F16 *psIABC; /* pointer to the 3-phase currents */
@@ -97,6 +112,7 @@ typedef struct mcdrv_adc
     pha_bc_t sCurrSec16;        /* ADC setting for SVM sectors 1&6 */
     pha_ac_t sCurrSec23;        /* ADC setting for SVM sectors 2&3 */
     pha_ab_t sCurrSec45;        /* ADC setting for SVM sectors 4&5 */
+    curr_sector_t sSector[SVM_SECTORS]; /* sCurrSec16/23/45 by SVM sector 1..6, for the fast loop */
 
     uint16_t const volatile *pui16RsltRegVDcb; /* DCB voltage result register */
 
@@ -17,15 +17,137 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+#define QDC_RECIP_SEED_BITS		8U	/* Bits of the normalized period below its leading one that index the reciprocal seed */
+#define QDC_RECIP_SEED_SIZE		(1U << QDC_RECIP_SEED_BITS)
 
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 
+/* Seeds of the period reciprocal, 2^30 / the normalized period in the middle of each segment */
+static uint16_t s_ui16QdcRecipSeed[QDC_RECIP_SEED_SIZE];
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
 
+/*!
+ * @brief Calculate 2^46 / ui32Norm for a normalized period in [2^15, 2^16), without a division.
+ *
+ *        The table seed is accurate to 2^-9 and each Newton step x = x + x * (1 - Norm * x) doubles the accurate
+ *        bits, so the result is accurate to the 2^-30 resolution of the Q2.30 result.
+ *
+ * @param ui32Norm   Period shifted left until bit 15 is set
+ *
+ * @return Reciprocal in Q2.30, in (1, 2]
+ */
+RAM_FUNC_CRITICAL static inline uint32_t MCDRV_QdcPeriodRecip(uint32_t ui32Norm)
+{
+	uint32_t ui32Recip;
+	int32_t i32Err;
+
+	ui32Recip = (uint32_t)s_ui16QdcRecipSeed[(ui32Norm >> (15U - QDC_RECIP_SEED_BITS)) & (QDC_RECIP_SEED_SIZE - 1U)] << 16;
+
+	/* The residual 1 - Norm * x is Q2.46, it fits in 32 bits after dropping 12 bits once x is accurate to 2^-9 */
+	i32Err = (int32_t)((((int64_t)1 << 46) - (int64_t)((uint64_t)ui32Norm * ui32Recip)) >> 12);
+	ui32Recip += (int32_t)(((int64_t)ui32Recip * i32Err) >> 34);
+	i32Err = (int32_t)((((int64_t)1 << 46) - (int64_t)((uint64_t)ui32Norm * ui32Recip)) >> 12);
+	ui32Recip += (int32_t)(((int64_t)ui32Recip * i32Err) >> 34);
+
+	return ui32Recip;
+}
+
+/*!
+ * @brief Calculate i16Counts * f32SpeedCalConst / ui16Period as Q1.31 speed, without a division.
+ *
+ *        For any positive f32SpeedCalConst and |i32Counts| <= 2^15 the result is never above the exact quotient and
+ *        less than 7.1 LSB of Q1.31 below it: up to 4 LSB from truncating the per-tick constant, 2.1 LSB from the
+ *        reciprocal and 1 LSB from the final truncation. The 64-bit division it replaces truncated to Q5.27 and was
+ *        off by up to 16 LSB. Like the division, results out of the Q1.31 range wrap.
+ *
+ * @param this       Pointer to the current object
+ * @param i32Counts  Position counter difference
+ * @param ui16Period Time of i32Counts in QDC timer ticks, 0 gives speed 0
+ *
+ * @return Speed in Q1.31
+ */
+RAM_FUNC_CRITICAL static inline frac32_t MCDRV_QdcSpeedCal(qdc_block_t *this, int32_t i32Counts, uint16_t ui16Period)
+{
+	uint32_t ui32Shift;
+	uint32_t ui32Counts;
+	uint64_t ui64CalConstPerTick;
+	frac32_t f32Speed = 0;
+
+	if(ui16Period != 0U)
+	{
+		/* Normalize the period to [2^15, 2^16), C / Period = C * 2^Shift * Recip / 2^46 */
+		ui32Shift = __CLZ((uint32_t)ui16Period) - 16U;
+		ui64CalConstPerTick = ((uint64_t)(uint32_t)this->sSpeed.f32SpeedCalConst * MCDRV_QdcPeriodRecip((uint32_t)ui16Period << ui32Shift)) >> (29U - ui32Shift); /* Q5.27 with 17 more fractional bits */
+
+		ui32Counts = (i32Counts < 0) ? (uint32_t)(-i32Counts) : (uint32_t)i32Counts;
+		f32Speed = (frac32_t)((ui32Counts * ui64CalConstPerTick) >> 13); /* Q5.44 -> Q1.31 */
+		if(i32Counts < 0)
+		{
+			f32Speed = -f32Speed;
+		}
+	}
+
+	return f32Speed;
+}
+
+/*!
+ * @brief Extrapolate the last measured speed to the present in the low speed region.
+ *
+ *        A measurement is the mean speed over its period, so it belongs to the middle of the period. The acceleration
+ *        is taken against the measurement two edges earlier, which was measured on the same quadrature phase, so
+ *        a phase error of the encoder signals cancels. Only single count measurements are extrapolated, by at most
+ *        the distance to that earlier measurement; the speed does not cross zero.
+ *
+ * @param this        Pointer to the current object
+ * @param ui16Elapsed Time since the last edge in QDC timer ticks
+ *
+ * @return Speed in Q1.31
+ */
+RAM_FUNC_CRITICAL static inline frac32_t MCDRV_QdcSpeedInterp(qdc_block_t *this, uint16_t ui16Elapsed)
+{
+	uint32_t ui32Span;
+	uint32_t ui32Shift;
+	uint64_t ui64Ratio;
+	int64_t i64Speed;
+	frac32_t f32Speed = this->sSpeed.f32SpeedMeas;
+
+	/* Half the distance between the middle of the last period and the middle of the period two edges earlier */
+	ui32Span = ((uint32_t)this->sSpeed.ui16Period_1 + 2U * this->sSpeed.ui16Period_2 + this->sSpeed.ui16Period_3) >> 2;
+
+	if((ui32Span != 0U) && (this->sSpeed.f32SpeedMeas_2 != 0) && ((this->sSpeed.i16PosDiff == 1) || (this->sSpeed.i16PosDiff == -1)))
+	{
+		/* Half the distance from the middle of the last period to now, over ui32Span, Q16 */
+		ui32Shift = __CLZ(ui32Span) - 16U;
+		ui64Ratio = ((uint64_t)(((uint32_t)ui16Elapsed + (this->sSpeed.ui16Period_1 >> 1)) >> 1) * MCDRV_QdcPeriodRecip(ui32Span << ui32Shift)) >> (30U - ui32Shift);
+		if(ui64Ratio > (1UL << 16))
+		{
+			ui64Ratio = 1UL << 16;
+		}
+
+		i64Speed = (int64_t)this->sSpeed.f32SpeedMeas + ((((int64_t)this->sSpeed.f32SpeedMeas - this->sSpeed.f32SpeedMeas_2) * (int64_t)ui64Ratio) >> 16);
+		if((i64Speed ^ (int64_t)this->sSpeed.f32SpeedMeas) < 0)
+		{
+			i64Speed = 0;
+		}
+		else if(i64Speed > INT32_MAX)
+		{
+			i64Speed = INT32_MAX;
+		}
+		else if(i64Speed < -INT32_MAX)
+		{
+			i64Speed = -INT32_MAX;
+		}
+		f32Speed = (frac32_t)i64Speed;
+	}
+
+	return f32Speed;
+}
+
 /*!
  * @brief When initial rotor position has been identified:
 
@@ -132,6 +254,8 @@ RAM_FUNC_CRITICAL void MCDRV_GetRotorCurrentRev(qdc_block_t *this)
 bool_t MCDRV_QdcInit(qdc_block_t *this)
 {
 	bool_t bStatusPass = FALSE;
+	uint16_t ui16Index;
+	uint32_t ui32Mid;
 
 	switch(this->ui8MotorNum)
 	{
@@ -170,6 +294,13 @@ bool_t MCDRV_QdcInit(qdc_block_t *this)
 	this->ui32Mod = 4*this->ui16Line-1;
     this->bPosAbsoluteFlag = FALSE;
 
+	/* Same seeds for all motors */
+	for(ui16Index = 0; ui16Index < QDC_RECIP_SEED_SIZE; ui16Index++)
+	{
+		ui32Mid = 0x8000UL + ((uint32_t)ui16Index << (15U - QDC_RECIP_SEED_BITS)) + (1UL << (14U - QDC_RECIP_SEED_BITS));
+		s_ui16QdcRecipSeed[ui16Index] = (uint16_t)(((1UL << 30) + (ui32Mid >> 1)) / ui32Mid);
+	}
+
 	return bStatusPass;
 }
 
@@ -189,6 +320,11 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
 	this->sSpeed.i8SpeedSign_1 = 0;
 	this->sSpeed.ui16Period = 0;
 	this->sSpeed.ui16Period_1 = 0;
+	this->sSpeed.ui16Period_2 = 0;
+	this->sSpeed.ui16Period_3 = 0;
+	this->sSpeed.f32SpeedMeas = 0;
+	this->sSpeed.f32SpeedMeas_1 = 0;
+	this->sSpeed.f32SpeedMeas_2 = 0;
 	this->sSpeed.i16PosDiff = 0;
 	this->sSpeed.i32Position = 0;
 	this->sSpeed.i32Position_1 = 0;
@@ -201,6 +337,7 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
 		this->sSpeed.sQDCSpeedFilter.sFltCoeff.f32A1 = M1_QDC_SPEED_FILTER_IIR_A1_FRAC;
 		this->sSpeed.f32SpeedCalConst = M1_SPEED_CAL_CONST;
 		this->sSpeed.fltSpeedFrac16ToAngularCoeff = M1_SPEED_FRAC_TO_ANGULAR_COEFF;
+		this->sSpeed.bLowSpeedInterp = M1_QDC_SPEED_LOW_SPEED_INTERP;
 		bStatusPass = TRUE;
 		break;
 	case MOTOR_2:
@@ -209,6 +346,7 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
 		this->sSpeed.sQDCSpeedFilter.sFltCoeff.f32A1 = M2_QDC_SPEED_FILTER_IIR_A1_FRAC;
 		this->sSpeed.f32SpeedCalConst = M2_SPEED_CAL_CONST;
 		this->sSpeed.fltSpeedFrac16ToAngularCoeff = M2_SPEED_FRAC_TO_ANGULAR_COEFF;
+		this->sSpeed.bLowSpeedInterp = M2_QDC_SPEED_LOW_SPEED_INTERP;
 		bStatusPass = TRUE;
 		break;
 	case MOTOR_3:
@@ -217,6 +355,7 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
 		this->sSpeed.sQDCSpeedFilter.sFltCoeff.f32A1 = M3_QDC_SPEED_FILTER_IIR_A1_FRAC;
 		this->sSpeed.f32SpeedCalConst = M3_SPEED_CAL_CONST;
 		this->sSpeed.fltSpeedFrac16ToAngularCoeff = M3_SPEED_FRAC_TO_ANGULAR_COEFF;
+		this->sSpeed.bLowSpeedInterp = M3_QDC_SPEED_LOW_SPEED_INTERP;
 		bStatusPass = TRUE;
 		break;
 	case MOTOR_4:
@@ -225,6 +364,7 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
 		this->sSpeed.sQDCSpeedFilter.sFltCoeff.f32A1 = M4_QDC_SPEED_FILTER_IIR_A1_FRAC;
 		this->sSpeed.f32SpeedCalConst = M4_SPEED_CAL_CONST;
 		this->sSpeed.fltSpeedFrac16ToAngularCoeff = M4_SPEED_FRAC_TO_ANGULAR_COEFF;
+		this->sSpeed.bLowSpeedInterp = M4_QDC_SPEED_LOW_SPEED_INTERP;
 		bStatusPass = TRUE;
 		break;
 	default:
@@ -241,6 +381,7 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
 /*!
  * @brief Calculate rotor speed by QDC enhanced M/T speed measurement feature.
  *        The speed is stored in sSpeed.f16SpeedFilt(Q1.15,filtered), sSpeed.fltSpeed(float,filtered) and sSpeed.f32Speed(Q1.31, not filtered).
+ *        Counts over period are calculated with a Newton refined reciprocal of the period, no division is used.
  *
  * @param this   Pointer to the current object
  *
@@ -248,7 +389,7 @@ RAM_FUNC_CRITICAL bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this)
  */
 RAM_FUNC_CRITICAL void MCDRV_QdcSpeedCalUpdate(qdc_block_t *this)
 {
-	int64_t i64Numerator;
+	frac32_t f32SpeedBound;
 
 	/* Read POSDH, POSDPERH and LASTEDGEH */
 	this->ui16Dummy = this->pQDC_base->POSD;
@@ -262,6 +403,8 @@ RAM_FUNC_CRITICAL void MCDRV_QdcSpeedCalUpdate(qdc_block_t *this)
 		/* Shaft is moving during speed measurement interval */
 		this->sSpeed.i16PosDiff = this->sSpeed.i16POSDH;
 		this->sSpeed.ui16Period = this->sSpeed.ui16POSDPERH;
+		this->sSpeed.ui16Period_3 = this->sSpeed.ui16Period_2;
+		this->sSpeed.ui16Period_2 = this->sSpeed.ui16Period_1;
 		this->sSpeed.ui16Period_1 = this->sSpeed.ui16Period;
 
 		if(this->sSpeed.i16PosDiff > 0)
@@ -276,14 +419,27 @@ RAM_FUNC_CRITICAL void MCDRV_QdcSpeedCalUpdate(qdc_block_t *this)
 		if(this->sSpeed.i8SpeedSign == this->sSpeed.i8SpeedSign_1)
 		{
 			/* Calculate speed */
-			i64Numerator = ((int64_t)(this->sSpeed.i16PosDiff) * this->sSpeed.f32SpeedCalConst); /* Q16.0 * Q5.27 = Q21.27 */
-			this->sSpeed.f32Speed = (i64Numerator / (uint32_t)(this->sSpeed.ui16Period))<<4; /* Q5.27 -> Q1.31 */
+			this->sSpeed.f32Speed = MCDRV_QdcSpeedCal(this, this->sSpeed.i16PosDiff, this->sSpeed.ui16Period);
 		}
 		else
 		{
 			this->sSpeed.f32Speed = 0;
 		}
 		this->sSpeed.i8SpeedSign_1 = this->sSpeed.i8SpeedSign;
+
+		if(this->sSpeed.bLowSpeedInterp)
+		{
+			this->sSpeed.f32SpeedMeas_2 = this->sSpeed.f32SpeedMeas_1;
+			this->sSpeed.f32SpeedMeas_1 = this->sSpeed.f32SpeedMeas;
+			this->sSpeed.f32SpeedMeas = this->sSpeed.f32Speed;
+			if(this->sSpeed.f32Speed == 0)
+			{
+				/* Direction changed, nothing to extrapolate from */
+				this->sSpeed.f32SpeedMeas_1 = 0;
+				this->sSpeed.f32SpeedMeas_2 = 0;
+			}
+			this->sSpeed.f32Speed = MCDRV_QdcSpeedInterp(this, this->sSpeed.ui16LASTEDGEH);
+		}
 	}
 	else
 	{
@@ -295,24 +451,31 @@ RAM_FUNC_CRITICAL void MCDRV_QdcSpeedCalUpdate(qdc_block_t *this)
 			/* Shaft hasn't been moving for a long time */
 			this->sSpeed.f32Speed = 0;
 			this->sSpeed.i8SpeedSign_1 = this->sSpeed.i8SpeedSign;
+			this->sSpeed.f32SpeedMeas = 0;
+			this->sSpeed.f32SpeedMeas_1 = 0;
+			this->sSpeed.f32SpeedMeas_2 = 0;
 		}
-		else
+		else if(this->sSpeed.bLowSpeedInterp)
 		{
-			/* Speed estimation in low speed region */
+			/* Speed interpolation in low speed region, limited by one count since the last edge once that is longer than the last period */
+			this->sSpeed.f32Speed = MCDRV_QdcSpeedInterp(this, this->sSpeed.ui16Period);
 			if(this->sSpeed.ui16Period > this->sSpeed.ui16Period_1)
 			{
-				if(this->sSpeed.i8SpeedSign > 0)
+				f32SpeedBound = MCDRV_QdcSpeedCal(this, this->sSpeed.i8SpeedSign, this->sSpeed.ui16Period);
+				if(MLIB_Abs_F32(f32SpeedBound) < MLIB_Abs_F32(this->sSpeed.f32Speed))
 				{
-					i64Numerator = ((int64_t)(1) * this->sSpeed.f32SpeedCalConst);
-					this->sSpeed.f32Speed = (i64Numerator / (uint32_t)(this->sSpeed.ui16Period))<<4;
-				}
-				else
-				{
-					i64Numerator = ((int64_t)(-1) * this->sSpeed.f32SpeedCalConst);
-					this->sSpeed.f32Speed = (i64Numerator / (uint32_t)(this->sSpeed.ui16Period))<<4;
+					this->sSpeed.f32Speed = f32SpeedBound;
 				}
 			}
 		}
+		else
+		{
+			/* Speed estimation in low speed region */
+			if(this->sSpeed.ui16Period > this->sSpeed.ui16Period_1)
+			{
+				this->sSpeed.f32Speed = MCDRV_QdcSpeedCal(this, this->sSpeed.i8SpeedSign, this->sSpeed.ui16Period);
+			}
+		}
 	}
 
 	this->sSpeed.f16SpeedFilt = GDFLIB_FilterIIR1_F16(MLIB_Conv_F16l(this->sSpeed.f32Speed), &this->sSpeed.sQDCSpeedFilter);
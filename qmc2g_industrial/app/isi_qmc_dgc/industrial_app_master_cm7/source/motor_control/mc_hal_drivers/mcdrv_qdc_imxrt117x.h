@@ -51,6 +51,13 @@ typedef struct qdc_speed
 	float_t  fltSpeedFrac16ToAngularCoeff;
 
 	float_t fltSpeed;		// float type, electrical angular speed
+	/* Low speed interpolation */
+	bool_t   bLowSpeedInterp;  // Extrapolate single count measurements to the present with the measured acceleration
+	uint16_t ui16Period_2;     // Time durations of the two measurements before the last one
+	uint16_t ui16Period_3;
+	frac32_t f32SpeedMeas;     // Last measured speed and the two before, 0 when not valid
+	frac32_t f32SpeedMeas_1;
+	frac32_t f32SpeedMeas_2;
 	int32_t i32Position;
 	int32_t i32Position_1;
 }qdc_speed_t;
@@ -125,6 +132,7 @@ extern bool_t MCDRV_QdcSpeedCalInit(qdc_block_t *this);
 /*!
  * @brief Calculate rotor speed by QDC enhanced M/T speed measurement feature.
  *        The speed is stored in sSpeed.f16SpeedFilt(Q1.15,filtered), sSpeed.fltSpeed(float,filtered) and sSpeed.f32Speed(Q1.31, not filtered).
+ *        Counts over period are calculated with a Newton refined reciprocal of the period, no division is used.
  *
  * @param this   Pointer to the current object
  *
@@ -300,6 +300,25 @@ typedef struct
     float_t                     fltCalibrationSpeedReq; /* Required motor speed during calibration */
 }mid_calib_hall_t;    
 
+/* MID controller tuning structure */
+typedef struct
+{
+    float_t                     fltCurFreq;             /* Required current loop natural frequency [Hz], zero disables the tuning */
+    float_t                     fltCurAtt;              /* Required current loop damping */
+    float_t                     fltCurLoopTs;           /* Current loop sample time [s] */
+    float_t                     fltSpeedFreq;           /* Required speed loop natural frequency [Hz], zero disables the tuning */
+    float_t                     fltSpeedAtt;            /* Required speed loop damping */
+    float_t                     fltSpeedLoopTs;         /* Speed loop sample time [s] */
+    float_t                     fltDKpGain;             /* Calculated d-axis current controller proportional gain */
+    float_t                     fltDKiGain;             /* Calculated d-axis current controller integral gain */
+    float_t                     fltQKpGain;             /* Calculated q-axis current controller proportional gain */
+    float_t                     fltQKiGain;             /* Calculated q-axis current controller integral gain */
+    float_t                     fltSpeedPGain;          /* Calculated speed controller proportional gain */
+    float_t                     fltSpeedIGain;          /* Calculated speed controller integral gain */
+    uint16_t                    ui16CurDone;            /* Current controller gains were calculated from the measured Rs, Ld and Lq */
+    uint16_t                    ui16SpeedDone;          /* Speed controller gains were calculated from the measured inertia constant */
+}mid_tune_t;
+
 /* measurement global structure */
 typedef struct
 {
@@ -312,6 +331,7 @@ typedef struct
     mid_get_pp_t     sMIDPp;         /* Structure for MID_getPp() */
     mid_get_mech_t   sMIDMech;       /* Structure for MID_getMech() */
     mid_calib_hall_t sMIDHall;       /* Structure for MID_calibHall() */
+    mid_tune_t       sMIDTune;       /* Controller gains calculated from the measured parameters */
 
     uint16_t    ui16EnableMeasurement;  /* Enables measurement in superior machine */
 
@@ -60,6 +60,9 @@ static void MID_TransMech2Stop(void);
 static void MID_TransPp2Stop(void);
 static void MID_TransAll2Stop(void);
 
+static void MID_TuneCurrentCtrl(void);
+static void MID_TuneSpeedCtrl(void);
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -400,6 +403,9 @@ static void MID_TransStart2Rs(void)
     g_sMID.sMIDRs.pfltIdReq  = g_sMID.sIO.pfltIdReq;
     g_sMID.sMIDRs.pfltUdReq  = g_sMID.sIO.pfltUdReq;
     g_sMID.sMIDRs.pfltIdfbck = g_sMID.sIO.pfltId;
+
+    /* Current controller gains of a previous measurement are no longer valid */
+    g_sMID.sMIDTune.ui16CurDone = FALSE;
     
     /* acknowledge that the state machine can proceed into RS state */
     g_sMIDCtrl.uiCtrl |= MID_SM_CTRL_RS_ACK;
@@ -447,6 +453,9 @@ static void MID_TransStart2Mech(void)
     g_sMID.sMIDMech.pf16PosElExt  = g_sMID.sIO.pf16PosElExt;
 
     g_sMID.sMIDMech.ui16Active    = FALSE;
+
+    /* Speed controller gains of a previous measurement are no longer valid */
+    g_sMID.sMIDTune.ui16SpeedDone = FALSE;
     
     /* Acknowledge that the system can proceed into the STOP state */
     g_sMIDCtrl.uiCtrl |= MID_SM_CTRL_MECH_ACK;
@@ -548,6 +557,9 @@ static void MID_TransLd2Lq(void)
 static void MID_TransLq2Ke(void)
 {
     /* Type the code to do when going from the LS to the STOP state */
+
+    /* Rs, Ld and Lq are known, calculate the current controller gains */
+    MID_TuneCurrentCtrl();
   
     /* Init pointers */
     g_sMID.sMIDKe.pf16PosEl        = g_sMID.sIO.pf16PosElExt;
@@ -605,6 +617,9 @@ static void MID_TransMech2Stop(void)
 {
     /* Type the code to do when going from the LS to the STOP state */
 
+    /* Inertia constant is known, calculate the speed controller gains */
+    MID_TuneSpeedCtrl();
+
     /* Acknowledge that the system can proceed into the STOP state */
     g_sMIDCtrl.uiCtrl |= MID_SM_CTRL_STOP_ACK;
 }
@@ -644,3 +659,72 @@ static void MID_TransAll2Stop(void)
     g_sMIDCtrl.uiCtrl |= MID_SM_CTRL_STOP_ACK;
 }
 
+/*!
+ * @brief Calculates the d/q current PI controller gains from measured Rs, Ld and Lq
+ *
+ * The current loop plant is 1/(R + s*L); placing the closed loop poles at the
+ * required natural frequency w and damping z gives Kp = 2*z*w*L - R and
+ * Ki = w^2*L*Ts (integral gain per sample of the current loop).
+ *
+ * @param void  No input parameter
+ *
+ * @return None
+ */
+static void MID_TuneCurrentCtrl(void)
+{
+    float_t fltW;
+
+    g_sMID.sMIDTune.ui16CurDone = FALSE;
+
+    /* Tuning disabled or measured parameters not trustworthy */
+    if((g_sMID.sMIDTune.fltCurFreq <= 0.0F) || (g_sMID.sMIDTune.fltCurLoopTs <= 0.0F) ||
+       (g_sMID.sMIDLs.fltLd <= 0.0F) || (g_sMID.sMIDLs.fltLq <= 0.0F) || (g_sMID.sMIDRs.fltRs < 0.0F) ||
+       ((g_sMID.ui16WarnMID & (MID_WARN_RS_OUT_OF_RANGE | MID_WARN_LS_OUT_OF_RANGE)) != 0U))
+        return;
+
+    fltW = 2.0F * FLOAT_PI * g_sMID.sMIDTune.fltCurFreq;
+
+    g_sMID.sMIDTune.fltDKpGain = 2.0F * g_sMID.sMIDTune.fltCurAtt * fltW * g_sMID.sMIDLs.fltLd - g_sMID.sMIDRs.fltRs;
+    g_sMID.sMIDTune.fltQKpGain = 2.0F * g_sMID.sMIDTune.fltCurAtt * fltW * g_sMID.sMIDLs.fltLq - g_sMID.sMIDRs.fltRs;
+    g_sMID.sMIDTune.fltDKiGain = fltW * fltW * g_sMID.sMIDLs.fltLd * g_sMID.sMIDTune.fltCurLoopTs;
+    g_sMID.sMIDTune.fltQKiGain = fltW * fltW * g_sMID.sMIDLs.fltLq * g_sMID.sMIDTune.fltCurLoopTs;
+
+    /* The resistance alone already exceeds the required bandwidth, no proportional part needed */
+    if(g_sMID.sMIDTune.fltDKpGain < 0.0F)
+        g_sMID.sMIDTune.fltDKpGain = 0.0F;
+    if(g_sMID.sMIDTune.fltQKpGain < 0.0F)
+        g_sMID.sMIDTune.fltQKpGain = 0.0F;
+
+    g_sMID.sMIDTune.ui16CurDone = TRUE;
+}
+
+/*!
+ * @brief Calculates the speed PI controller gains from the measured inertia constant
+ *
+ * The inertia constant Kj is the Iq needed to accelerate with 1 rad/s^2, so the speed
+ * plant is 1/(s*Kj). Placing the closed loop poles at the required natural frequency w
+ * and damping z gives Kp = 2*z*w*Kj and Ki = w^2*Kj*Ts (per sample of the speed loop).
+ *
+ * @param void  No input parameter
+ *
+ * @return None
+ */
+static void MID_TuneSpeedCtrl(void)
+{
+    float_t fltW;
+
+    g_sMID.sMIDTune.ui16SpeedDone = FALSE;
+
+    /* Tuning disabled or measurement not finished */
+    if((g_sMID.sMIDTune.fltSpeedFreq <= 0.0F) || (g_sMID.sMIDTune.fltSpeedLoopTs <= 0.0F) ||
+       (g_sMID.sMIDMech.fltInertiaConst <= 0.0F) || ((g_sMID.ui16FaultMID & MID_FAULT_MECH_TIMEOUT) != 0U))
+        return;
+
+    fltW = 2.0F * FLOAT_PI * g_sMID.sMIDTune.fltSpeedFreq;
+
+    g_sMID.sMIDTune.fltSpeedPGain = 2.0F * g_sMID.sMIDTune.fltSpeedAtt * fltW * g_sMID.sMIDMech.fltInertiaConst;
+    g_sMID.sMIDTune.fltSpeedIGain = fltW * fltW * g_sMID.sMIDMech.fltInertiaConst * g_sMID.sMIDTune.fltSpeedLoopTs;
+
+    g_sMID.sMIDTune.ui16SpeedDone = TRUE;
+}
+
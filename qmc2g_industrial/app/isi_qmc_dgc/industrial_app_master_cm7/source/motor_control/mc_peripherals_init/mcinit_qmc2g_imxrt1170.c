@@ -28,7 +28,32 @@ mcdrv_pwm3ph_pwma_t g_sM1Pwm3ph,g_sM2Pwm3ph,g_sM3Pwm3ph,g_sM4Pwm3ph;
  * Code
  ******************************************************************************/
 
+/*!
+ * @brief Converts a phase within the PWM1 period to a PWM1 compare value.
+ *
+ * @param i16Init   PWM1 counter initial value
+ * @param i16Val1   PWM1 counter final value
+ * @param fltPhase  Phase as a fraction of the PWM period, <0.0, 1.0)
+ * @param i16Delay  Additional delay in counter ticks, may be negative
+ *
+ * @return Compare value wrapped into <i16Init, i16Val1>
+ */
+static int16_t eFlexPWM1_PhaseToCompare(int16_t i16Init, int16_t i16Val1, float_t fltPhase, int16_t i16Delay)
+{
+	int32_t i32Period = (int32_t)i16Val1 - (int32_t)i16Init + 1;
+	int32_t i32Cmp = (int32_t)i16Init + (int32_t)(fltPhase*(float_t)i32Period) + (int32_t)i16Delay;
 
+	if(i32Cmp > (int32_t)i16Val1)
+	{
+		i32Cmp -= i32Period;
+	}
+	else if(i32Cmp < (int32_t)i16Init)
+	{
+		i32Cmp += i32Period;
+	}
+
+	return (int16_t)i32Cmp;
+}
 
 /*!
  * @brief eFlexPWM1 initialization which controls Motor1. Synchronization with eFlexPWM2~4 and ADC_ETC are implemented here as well. Hal driver is initialized in the end.
@@ -125,9 +150,9 @@ static void eFlexPWM1_init(void)
 #endif
 
 	/* PWM2, PWM3 and PWM4 synchronization */
-	PWM1->SM[3].VAL4 = (int16_t)(PWM1->SM[3].INIT)/2;  // 1/4 PWM period
-	PWM1->SM[3].VAL5 = 0;                   // 1/2 PWM period
-	PWM1->SM[0].VAL4 = PWM1->SM[0].VAL1/2;  // 3/4 PWM period
+	PWM1->SM[3].VAL4 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M2_PWM_PHASE_OFFSET, 0);
+	PWM1->SM[3].VAL5 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M3_PWM_PHASE_OFFSET, 0);
+	PWM1->SM[0].VAL4 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M4_PWM_PHASE_OFFSET, 0);
 	PWM1->SM[0].TCTRL = 0;
 	PWM1->SM[1].TCTRL = 0;
 	PWM1->SM[2].TCTRL = 0;
@@ -141,14 +166,7 @@ static void eFlexPWM1_init(void)
 #else
 	i16Tmp = (int16_t)(((float_t)M1_ADC_TRIGGER_DELAY - M1_ADC_AVERAGE_TIME*0.5f)*BOARD_BOOTCLOCKRUN_BUS_CLK_ROOT/1000000);
 #endif
-	if(i16Tmp >= 0) // Setup ADC triggering point
-	{
-		PWM1->SM[0].VAL5 = PWM1->SM[0].INIT + i16Tmp;
-	}
-	else
-	{
-		PWM1->SM[0].VAL5 = PWM1->SM[0].VAL1 + i16Tmp;
-	}
+	PWM1->SM[0].VAL5 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M1_PWM_PHASE_OFFSET, i16Tmp); // Setup ADC triggering point
 	PWM1->SM[0].TCTRL |= PWM_TCTRL_OUT_TRIG_EN(0x20); // Use VAL5 of SM0 for trigger point - M1 voltage and currents
 	PWM1->SM[0].INTEN = PWM_INTEN_CMPIE(0x20); // for debug
 
@@ -157,7 +175,7 @@ static void eFlexPWM1_init(void)
 #else
 	i16Tmp = (int16_t)(((float_t)M2_ADC_TRIGGER_DELAY - M2_ADC_AVERAGE_TIME*0.5f)*BOARD_BOOTCLOCKRUN_BUS_CLK_ROOT/1000000);
 #endif
-	PWM1->SM[1].VAL4 = (int16_t)(PWM1->SM[0].INIT)/2 + i16Tmp;
+	PWM1->SM[1].VAL4 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M2_PWM_PHASE_OFFSET, i16Tmp);
 	PWM1->SM[1].TCTRL |= PWM_TCTRL_OUT_TRIG_EN(0x10); // Use VAL4 of SM1 for trigger point - M2 voltage and currents
 	PWM1->SM[1].INTEN = PWM_INTEN_CMPIE(0x10); // for debug
 
@@ -166,7 +184,7 @@ static void eFlexPWM1_init(void)
 #else
 	i16Tmp = (int16_t)(((float_t)M3_ADC_TRIGGER_DELAY - M3_ADC_AVERAGE_TIME*0.5f)*BOARD_BOOTCLOCKRUN_BUS_CLK_ROOT/1000000);
 #endif
-	PWM1->SM[1].VAL5 = PWM1->SM[0].VAL0 + i16Tmp;
+	PWM1->SM[1].VAL5 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M3_PWM_PHASE_OFFSET, i16Tmp);
 	PWM1->SM[1].TCTRL |= PWM_TCTRL_OUT_TRIG_EN(0x20); // Use VAL5 of SM1 for trigger point - M3 voltage and currents
 	PWM1->SM[1].INTEN |= PWM_INTEN_CMPIE(0x20); // for debug
 
@@ -175,7 +193,7 @@ static void eFlexPWM1_init(void)
 #else
 	i16Tmp = (int16_t)(((float_t)M4_ADC_TRIGGER_DELAY - M4_ADC_AVERAGE_TIME*0.5f)*BOARD_BOOTCLOCKRUN_BUS_CLK_ROOT/1000000);
 #endif
-	PWM1->SM[2].VAL4 = PWM1->SM[0].VAL1/2 + i16Tmp;
+	PWM1->SM[2].VAL4 = eFlexPWM1_PhaseToCompare(PWM1->SM[0].INIT, PWM1->SM[0].VAL1, M4_PWM_PHASE_OFFSET, i16Tmp);
 	PWM1->SM[2].TCTRL |= PWM_TCTRL_OUT_TRIG_EN(0x10); // Use VAL4 of SM2 for trigger point - M4 voltage and currents
 	PWM1->SM[2].INTEN = PWM_INTEN_CMPIE(0x10); // for debug
 
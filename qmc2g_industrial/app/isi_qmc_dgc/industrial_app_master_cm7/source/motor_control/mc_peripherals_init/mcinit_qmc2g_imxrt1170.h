@@ -75,6 +75,21 @@ typedef struct app_ver
 #define MOTOR_3	   3
 #define MOTOR_4	   4
 
+/******************************************************************************
+ * PWM phase alignment of motors 2~4 to motor 1
+ *
+ * eFlexPWM2~4 are started by PWM1 compare events and each motor's ADC_ETC trigger
+ * is placed at the same offset, so sampling stays at the start of its own PWM
+ * period. Offsets are fractions of the PWM period in <0.0, 1.0); keep the spacing
+ * larger than the ADC conversion and fast loop time so the four fast loops do not
+ * queue behind each other. All four motors must run at the same PWM frequency.
+ ******************************************************************************/
+#define MC_PWM_PHASE_STEP         (0.25F)                      /* Inter-module phase offset, evenly spread by default */
+#define M1_PWM_PHASE_OFFSET       (0.0F)                       /* PWM1 is the reference */
+#define M2_PWM_PHASE_OFFSET       (1.0F * MC_PWM_PHASE_STEP)   /* PWM2 start within the PWM1 period */
+#define M3_PWM_PHASE_OFFSET       (2.0F * MC_PWM_PHASE_STEP)   /* PWM3 start within the PWM1 period */
+#define M4_PWM_PHASE_OFFSET       (3.0F * MC_PWM_PHASE_STEP)   /* PWM4 start within the PWM1 period */
+
 
 /******************************************************************************
  * Clock & PWM definition for motor 1
@@ -14,14 +14,8 @@
 #include "sm_ref_sol_comm.h"
 #include "m2_pmsm_appconfig.h"
 #include "state_machine.h"
+#include "sm_ref_sol.h"
 
-/*******************************************************************************
- * Definitions
- ******************************************************************************/
-
-#define MCAT_SENSORLESS_CTRL 0 /* Sensorless control flag */
-#define MCAT_ENC_CTRL 1 /* Position quadrature encoder control flag */
-   
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -0,0 +1,2663 @@
+/*
+ * Copyright 2022-2023 NXP 
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#include "sm_ref_sol.h"
+#include "mid_sm_states.h"
+#include "api_fault.h"
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define MX_SVM_SECTOR_DEFAULT (2) /* default SVM sector */
+
+#define FREQ_CUR_SCALE_MX 2000.0 /* [Hz], frequency scale for current command in bandwidth test */
+#define FREQ_SCALE_MX     200.0  /* [Hz], frequency scale for speed command in bandwidth test */
+#define FREQ_POS_SCALE_MX 200.0  /* [Hz], frequency scale for position command in bandwidth test */
+
+#if (DTCOMP_TABLE_SIZE != MID_CHAR_CURRENT_POINT_NUMBERS)
+#error "Dead-time compensation table size must match the number of measured power stage characteristic points"
+#endif
+
+/*! @brief Pointer to run sub-state function */
+typedef void (*pfcn_void_pmotor)(sm_ref_sol_motor_t *const psMotor);
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+/* State and transition functions for the sub-state machine in Run state of main state machine */
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunCalibFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunMeasureFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunReadyFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunAlignFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunStartupFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunSpinFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL   
+static void Mx_StateRunFreewheelFast(sm_ref_sol_motor_t *const psMotor);
+
+RAM_FUNC_CRITICAL
+static void Mx_StateRunCalibSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_StateRunMeasureSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_StateRunReadySlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_StateRunAlignSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_StateRunStartupSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_StateRunSpinSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_StateRunFreewheelSlow(sm_ref_sol_motor_t *const psMotor);
+
+RAM_FUNC_CRITICAL
+static void Mx_TransRunCalibReady(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_TransRunCalibMeasure(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL 
+static void Mx_TransRunMeasureReady(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL 
+static void Mx_TransRunReadyAlign(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_TransRunAlignStartup(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL 
+static void Mx_TransRunAlignReady(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_TransRunAlignSpin(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_TransRunStartupSpin(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL 
+static void Mx_TransRunStartupFreewheel(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL 
+static void Mx_TransRunSpinFreewheel(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_TransRunFreewheelReady(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_TransRunReadySpin(sm_ref_sol_motor_t *const psMotor);
+
+RAM_FUNC_CRITICAL 
+static void Mx_ClearFOCVariables(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL
+static void Mx_SetCtrlGains(sm_ref_sol_motor_t *const psMotor);
+
+RAM_FUNC_CRITICAL
+static void Mx_FaultDetection(sm_ref_sol_motor_t *const psMotor);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*! @brief Application sub-state function field - fast, shared by all motors */
+static pfcn_void_pmotor s_STATE_RUN_TABLE_FAST[7] = {Mx_StateRunCalibFast, Mx_StateRunReadyFast,
+                                                     Mx_StateRunAlignFast, Mx_StateRunStartupFast,
+                                                     Mx_StateRunSpinFast,  Mx_StateRunFreewheelFast,
+                                                     Mx_StateRunMeasureFast};
+
+/*! @brief Application sub-state function field - slow, shared by all motors */
+static pfcn_void_pmotor s_STATE_RUN_TABLE_SLOW[7] = {Mx_StateRunCalibSlow, Mx_StateRunReadySlow,
+                                                     Mx_StateRunAlignSlow, Mx_StateRunStartupSlow,
+                                                     Mx_StateRunSpinSlow,  Mx_StateRunFreewheelSlow,
+                                                     Mx_StateRunMeasureSlow};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/*!
+ * @brief Fault state called in fast state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateFaultFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* read ADC results (ADC triggered by HW trigger from PDB) */
+    /* get all adc samples - DC-bus voltage, current, bemf and aux sample */
+	MCDRV_Curr3Ph2ShGet(psMotor->psAdcSensor);
+	MCDRV_VoltDcBusGet(psMotor->psAdcSensor);
+	MCDRV_AuxValGet(psMotor->psAdcSensor);
+
+    /* get rotor position and speed from quadrature encoder sensor */
+	if(psMotor->psQdcSensor->bPosAbsoluteFlag == TRUE)
+	{
+		MCDRV_GetRotorCurrentPos(psMotor->psQdcSensor);
+		MCDRV_GetRotorCurrentRev(psMotor->psQdcSensor);
+		psDrive->f16PosElEnc = psMotor->psQdcSensor->f16PosElec;
+	}
+	MCDRV_QdcToSpeedCalUpdate(psMotor->psQdcSensor); // Update speed from tracking observer in fast loop
+
+    /* convert voltages from fractional measured values to float */
+    psDrive->sFocPMSM.fltUDcBus = 
+        MLIB_ConvSc_FLTsf(psDrive->sFocPMSM.f16UDcBus, *psMotor->pfltDCBvoltageScale);
+
+    /* Sampled DC-Bus voltage filter */
+    psDrive->sFocPMSM.fltUDcBusFilt =
+        GDFLIB_FilterIIR1_FLT(psDrive->sFocPMSM.fltUDcBus, &psDrive->sFocPMSM.sUDcBusFilter);
+
+//    /* Braking resistor control */
+//    if(psDrive->sFocPMSM.fltUDcBusFilt > psDrive->sFaultThresholds.fltUDcBusTrip)
+//        Mx_BRAKE_SET();
+//    else
+//        Mx_BRAKE_CLEAR();
+
+    /* Disable user application switch */
+    *psMotor->pbSwitchAppOnOff = FALSE;
+
+    /* PWM peripheral update */
+    MCDRV_eFlexPwm3PhDutyUpdate(psMotor->psPwm3ph);
+
+    /* Detects faults */
+    Mx_FaultDetection(psMotor);
+
+    /* clear recorded fault state manually from FreeMASTER */
+    if(psDrive->bFaultClearMan)
+    {
+        /* Clear fault state */
+        psDrive->bFaultClearMan = FALSE;
+        psDrive->sFaultIdCaptured = 0;
+    }
+}
+
+/*!
+ * @brief State initialization routine called in fast state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateInitFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+
+	/* Type the code to do when in the INIT state */
+    psDrive->sFocPMSM.sIdPiParams.fltPGain = MID_KP_GAIN;
+    psDrive->sFocPMSM.sIdPiParams.fltIGain = MID_KI_GAIN;
+    psDrive->sFocPMSM.sIdPiParams.fltInErrK_1 = 0.0F;
+    psDrive->sFocPMSM.sIdPiParams.bLimFlag = FALSE;
+
+    psDrive->sFocPMSM.sIqPiParams.fltPGain = MID_KP_GAIN;
+    psDrive->sFocPMSM.sIqPiParams.fltIGain = MID_KI_GAIN;
+    psDrive->sFocPMSM.sIqPiParams.fltInErrK_1 = 0.0F;
+    psDrive->sFocPMSM.sIqPiParams.bLimFlag = FALSE;
+  
+    /* PMSM FOC params */
+    psDrive->sFocPMSM.sIdPiParams.fltPGain = psConfig->fltDKpGain;
+    psDrive->sFocPMSM.sIdPiParams.fltIGain = psConfig->fltDKiGain;
+    psDrive->sFocPMSM.sIdPiParams.fltUpperLim = psConfig->fltUMax;
+    psDrive->sFocPMSM.sIdPiParams.fltLowerLim = -psConfig->fltUMax;
+
+    psDrive->sFocPMSM.sIqPiParams.fltPGain = psConfig->fltQKpGain;
+    psDrive->sFocPMSM.sIqPiParams.fltIGain = psConfig->fltQKiGain;
+    psDrive->sFocPMSM.sIqPiParams.fltUpperLim = psConfig->fltUMax;
+    psDrive->sFocPMSM.sIqPiParams.fltLowerLim = -psConfig->fltUMax;
+
+    psDrive->sFocPMSM.ui16SectorSVM = MX_SVM_SECTOR_DEFAULT;
+    psDrive->sFocPMSM.fltDutyCycleLimit = psConfig->fltCloopLimit;
+    
+    /* disable dead-time compensation */
+    psDrive->sFocPMSM.bFlagDTComp = FALSE;
+
+    psDrive->sFocPMSM.fltUDcBus = 0.0F;
+    psDrive->sFocPMSM.fltUDcBusFilt = 0.0F;
+    psDrive->sFocPMSM.sUDcBusFilter.sFltCoeff = psConfig->sUDcBusFiltCoeff;
+    /* Filter init not to enter to fault */
+    psDrive->sFocPMSM.sUDcBusFilter.fltFltBfrX[0] = 
+        (psConfig->sFaultThresholds.fltUDcBusUnder / 2.0F) + (psConfig->sFaultThresholds.fltUDcBusOver / 2.0F);
+    psDrive->sFocPMSM.sUDcBusFilter.fltFltBfrY[0] =
+        (psConfig->sFaultThresholds.fltUDcBusUnder / 2.0F) + (psConfig->sFaultThresholds.fltUDcBusOver / 2.0F);
+
+
+    psDrive->sAlignment.fltUdReq = psConfig->fltAlignVoltage;
+    psDrive->sAlignment.ui16Time = psConfig->ui16AlignDuration;
+
+    /* Position and speed observer */
+    psDrive->sFocPMSM.sTo.fltPGain = psConfig->fltToKpGain;
+    psDrive->sFocPMSM.sTo.fltIGain = psConfig->fltToKiGain;
+    psDrive->sFocPMSM.sTo.fltThGain = psConfig->fltToThGain;
+
+    psDrive->sFocPMSM.sBemfObsrv.fltIGain = psConfig->fltBemfIGain;
+    psDrive->sFocPMSM.sBemfObsrv.fltUGain = psConfig->fltBemfUGain;
+    psDrive->sFocPMSM.sBemfObsrv.fltEGain = psConfig->fltBemfEGain;
+    psDrive->sFocPMSM.sBemfObsrv.fltWIGain = psConfig->fltBemfWIGain;
+    psDrive->sFocPMSM.sBemfObsrv.sCtrl.fltPGain = psConfig->fltBemfKpGain;
+    psDrive->sFocPMSM.sBemfObsrv.sCtrl.fltIGain = psConfig->fltBemfKiGain;
+
+    psDrive->sFocPMSM.sSpeedElEstFilt.sFltCoeff = psConfig->sSpeedElEstFiltCoeff;
+    GDFLIB_FilterIIR1Init_FLT(&psDrive->sFocPMSM.sSpeedElEstFilt);
+
+    /* Online resistance and flux estimation, the observer gains above are its nominal point */
+    psDrive->sParamEst.sCoeff = psConfig->sParamEstCoeff;
+    MCS_PMSMParamEstInit(&psDrive->sParamEst);
+    
+    /* Speed params */
+    psDrive->sSpeed.sSpeedPiParams.fltPGain = psConfig->fltSpeedPGain;
+    psDrive->sSpeed.sSpeedPiParams.fltIGain = psConfig->fltSpeedIGain;
+    psDrive->sSpeed.sSpeedPiParams.fltUpperLim = psConfig->fltSpeedUpperLim;
+    psDrive->sSpeed.sSpeedPiParams.fltLowerLim = psConfig->fltSpeedLowerLim;
+
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltPGain = psConfig->fltSpeedPGain;
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltIGain = psConfig->fltSpeedIGain;
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltDesatGain = psConfig->fltSpeedDesatGain;
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltUpperLim = psConfig->fltSpeedUpperLim;
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltLowerLim = psConfig->fltSpeedLowerLim;
+
+    /* gain schedule is selected with the position sensor at start */
+    psDrive->sSpeed.sGainSched.psTable = NULL;
+    psDrive->sSpeed.sGainSched.ui16Size = psConfig->ui16SpeedGainTableSize;
+    psDrive->sSpeed.sGainSched.ui16Seg = 0U;
+
+    psDrive->sSpeed.sSpeedRampParams.fltRampUp = psConfig->fltSpeedRampUp;
+    psDrive->sSpeed.sSpeedRampParams.fltRampDown = psConfig->fltSpeedRampDown;
+
+    psDrive->sSpeed.sSpeedFilter.sFltCoeff = psConfig->sSpeedFiltCoeff;
+    GDFLIB_FilterIIR1Init_FLT(&psDrive->sSpeed.sSpeedFilter);
+
+    psDrive->sSpeed.sIqFwdFilter.sFltCoeff = psConfig->sIqFwdFiltCoeff;
+    GDFLIB_FilterIIR1Init_FLT(&psDrive->sSpeed.sIqFwdFilter);
+
+    psDrive->sSpeed.fltSpeedCmd = 0.0F;
+    
+    psDrive->sSpeed.fltIqFwdGain = psConfig->fltIqFwdGain;
+
+    /* MTPA and field weakening params, the motor data are shared with the parameter estimator */
+    psDrive->sFieldWeak.fltRs = psConfig->sParamEstCoeff.fltRsNom;
+    psDrive->sFieldWeak.fltLd = psConfig->sParamEstCoeff.fltLd;
+    psDrive->sFieldWeak.fltFlux = psConfig->sParamEstCoeff.fltFluxNom;
+    psDrive->sFieldWeak.fltLqLdDiff = psConfig->fltMtpaLqLdDiff;
+    psDrive->sFieldWeak.fltUqLimGain = psConfig->fltFwUqLimGain;
+    psDrive->sFieldWeak.fltIdMin = psConfig->fltFwIdMin;
+    psDrive->sFieldWeak.fltIMax = psConfig->fltSpeedUpperLim;
+    psDrive->sFieldWeak.bFwOn = psConfig->bFwOn;
+    psDrive->sFieldWeak.sFwCtrl.sFWPiParam.fltPGain = psConfig->fltFwKpGain;
+    psDrive->sFieldWeak.sFwCtrl.sFWPiParam.fltIGain = psConfig->fltFwKiGain;
+    psDrive->sFieldWeak.sFwCtrl.sFWPiParam.fltUpperLim = 0.0F;
+    psDrive->sFieldWeak.sFwCtrl.sFWPiParam.fltLowerLim = psConfig->fltFwIdMin;
+    psDrive->sFieldWeak.sFwCtrl.sIqErrIIR1Param.sFltCoeff = psConfig->sFwIqErrFiltCoeff;
+    psDrive->sFieldWeak.sFwCtrl.fltIGainUgain = psConfig->fltFwUToIdGain;
+    psDrive->sFieldWeak.sFwCtrl.pbStopIntegFlag = &psDrive->sFieldWeak.bFwStopInteg;
+    psDrive->sFieldWeak.bFwStopInteg = FALSE;
+    AMCLIB_CtrlFluxWkngInit_FLT(0.0F, &psDrive->sFieldWeak.sFwCtrl);
+
+    /* Position params */
+    psDrive->sPosition.sCurveRef.sPosRamp.f32State = 0;
+    psDrive->sPosition.f16SpeedController = 0;
+    psDrive->sPosition.fltSpeedFwd = 0;
+    psDrive->sPosition.fltSpeedFwdNoGain = 0;
+    psDrive->sPosition.fltSpeedRef = 0;
+    psDrive->sPosition.sCurveRef.i32Q16PosCmd = 0;
+    psDrive->sPosition.sCurveRef.i32Q16PosRamp = 0;
+    psDrive->sPosition.sCurveRef.i32Q16PosFilt = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.f32W = psConfig->f32TrajFilterW;
+    psDrive->sPosition.f16SpeedRefLim = psConfig->f16SpeedRefLim;
+    psDrive->sPosition.fltSpeedRefLim = psConfig->fltSpeedRefLim;
+    psDrive->sPosition.sCurveRef.sPosRamp.f32RampUp = psConfig->f32PosRampUp;
+    psDrive->sPosition.sCurveRef.sPosRamp.f32RampDown = psConfig->f32PosRampDown;
+    psDrive->sPosition.a32PosGain = psConfig->a32PosGain;
+    psDrive->sPosition.i32PosLoopFreq = psConfig->ui16SlowCtrlLoopFreq;
+    psDrive->sPosition.fltFreqToAngularSpeedCoeff = psConfig->fltFreqToAngularSpeedCoeff;
+    psDrive->sPosition.fltFracToAngularSpeedCoeff = psConfig->fltFracToAngularSpeedCoeff;
+    psDrive->sPosition.fltRpmToAngularSpeedCoeff = psConfig->fltRpmToAngularSpeedCoeff;
+    psDrive->sPosition.fltGainSpeedFwd = psConfig->fltGainSpeedFwd;
+    psDrive->sPosition.fltGainAccFwd = psConfig->fltGainAccFwd;
+    psDrive->sPosition.fltSpeedTraj = 0.0F;
+    psDrive->sPosition.fltSpeedTraj_1 = 0.0F;
+    psDrive->sPosition.fltIqAccFwd = 0.0F;
+    psDrive->sSpeed.fltIqAccFwd = 0.0F;
+    psDrive->sSpeed.bIqAccFwdOn = FALSE;
+	trajectoryFilterInit(&psDrive->sPosition.sCurveRef.sTrajFilter);
+
+	psDrive->sPosition.sNotchFilter.sSOS_array[0].sCoeff.fltA1 = SOS0_A1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[0].sCoeff.fltA2 = SOS0_A2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[0].sCoeff.fltB0 = SOS0_B0;
+	psDrive->sPosition.sNotchFilter.sSOS_array[0].sCoeff.fltB1 = SOS0_B1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[0].sCoeff.fltB2 = SOS0_B2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[0].sCoeff.fltScale = SOS0_SCALE;
+
+	psDrive->sPosition.sNotchFilter.sSOS_array[1].sCoeff.fltA1 = SOS1_A1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[1].sCoeff.fltA2 = SOS1_A2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[1].sCoeff.fltB0 = SOS1_B0;
+	psDrive->sPosition.sNotchFilter.sSOS_array[1].sCoeff.fltB1 = SOS1_B1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[1].sCoeff.fltB2 = SOS1_B2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[1].sCoeff.fltScale = SOS1_SCALE;
+
+	psDrive->sPosition.sNotchFilter.sSOS_array[2].sCoeff.fltA1 = SOS2_A1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[2].sCoeff.fltA2 = SOS2_A2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[2].sCoeff.fltB0 = SOS2_B0;
+	psDrive->sPosition.sNotchFilter.sSOS_array[2].sCoeff.fltB1 = SOS2_B1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[2].sCoeff.fltB2 = SOS2_B2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[2].sCoeff.fltScale = SOS2_SCALE;
+
+	psDrive->sPosition.sNotchFilter.sSOS_array[3].sCoeff.fltA1 = SOS3_A1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[3].sCoeff.fltA2 = SOS3_A2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[3].sCoeff.fltB0 = SOS3_B0;
+	psDrive->sPosition.sNotchFilter.sSOS_array[3].sCoeff.fltB1 = SOS3_B1;
+	psDrive->sPosition.sNotchFilter.sSOS_array[3].sCoeff.fltB2 = SOS3_B2;
+	psDrive->sPosition.sNotchFilter.sSOS_array[3].sCoeff.fltScale = SOS3_SCALE;
+
+	psDrive->sPosition.sNotchFilter.fltOutScale = OUTPUT_SCALE;
+	BSF_init(&psDrive->sPosition.sNotchFilter);
+
+    /* Scalar control params */
+    psDrive->sScalarCtrl.fltVHzGain = psConfig->fltVHzGain;
+    psDrive->sScalarCtrl.sFreqRampParams.fltRampUp = psConfig->fltScalarRampUp;
+    psDrive->sScalarCtrl.sFreqRampParams.fltRampDown = psConfig->fltScalarRampDown;
+    psDrive->sScalarCtrl.sFreqIntegrator.a32Gain = psConfig->a32ScalarIntegGain;
+    psDrive->sScalarCtrl.fltFreqMax = psConfig->fltFreqMax;
+    
+    /* Open loop start up */
+    psDrive->sStartUp.sSpeedIntegrator.a32Gain = psConfig->a32ScalarIntegGain;
+    psDrive->sStartUp.f16CoeffMerging = psConfig->f16CoeffMerging;
+    psDrive->sStartUp.fltSpeedCatchUp = psConfig->fltSpeedCatchUp;
+    psDrive->sStartUp.fltCurrentStartup = psConfig->fltCurrentStartup;
+    psDrive->sStartUp.sSpeedRampOpenLoopParams.fltRampUp = psConfig->fltOpenLoopRampInc;
+    psDrive->sStartUp.sSpeedRampOpenLoopParams.fltRampDown = psConfig->fltOpenLoopRampInc;
+    psDrive->sStartUp.fltSpeedMax = psConfig->fltSpeedMax;
+    psDrive->sStartUp.bOpenLoop = TRUE;
+
+    /* MCAT cascade control variables */
+    psDrive->sMCATctrl.sIDQReqMCAT.fltD = 0.0F;
+    psDrive->sMCATctrl.sIDQReqMCAT.fltQ = 0.0F;
+    psDrive->sMCATctrl.sUDQReqMCAT.fltD = 0.0F;
+    psDrive->sMCATctrl.sUDQReqMCAT.fltQ = 0.0F;
+    psDrive->sMCATctrl.ui16PospeSensor = MCAT_ENC_CTRL;
+
+    /* Timing control and general variables */
+    psDrive->ui16CounterState = 0U;
+    psDrive->ui16TimeFullSpeedFreeWheel = psConfig->ui16TimeFullSpeedFreeWheel;
+    psDrive->ui16TimeCalibration = psConfig->ui16TimeCalibration;
+    psDrive->ui16TimeFaultRelease = psConfig->ui16TimeFaultRelease;
+    *psMotor->pbSwitchAppOnOff = FALSE;
+    /* Default MCAT control mode after reset */
+    psDrive->eControl = kControlMode_SpeedFOC;
+
+    /* fault set to init states */
+    FAULT_CLEAR_ALL(psDrive->sFaultIdCaptured);
+    FAULT_CLEAR_ALL(psDrive->sFaultIdPending);
+
+    /* fault thresholds */
+    psDrive->sFaultThresholds = psConfig->sFaultThresholds;
+
+    /* fault blocked rotor filter */
+    psMotor->psBlockedRotorUqFilt->fltLambda = psConfig->fltBlockedRotorLambda;
+
+    /* Defined scaling for FreeMASTER */
+    *psMotor->pfltVoltageScale = psConfig->fltUMax;
+    *psMotor->pfltCurrentScale = psConfig->fltIMax;
+    *psMotor->pfltDCBvoltageScale = psConfig->fltUDcBusMax;
+    *psMotor->pfltSpeedScale = psConfig->fltNMax;
+    *psMotor->pfltSpeedAngularScale = psConfig->fltSpeedAngularScale;
+
+    /* Application timing */
+    psDrive->ui16FastCtrlLoopFreq = psConfig->ui16FastCtrlLoopFreq;
+    psDrive->ui16SlowCtrlLoopFreq = psConfig->ui16SlowCtrlLoopFreq;
+    
+    /* Power Stage characteristic data */
+    psDrive->sFocPMSM.fltPwrStgCharIRange = DTCOMP_I_RANGE;
+    psDrive->sFocPMSM.fltPwrStgCharLinCoeff = DTCOMP_LINCOEFF;
+    MCS_DTCompInit(&psDrive->sFocPMSM, NULL);
+
+#if FEATURE_MC_FOC_PROFILING
+    /* Fast loop stage profile */
+    psDrive->sFocPMSM.psProfile = &g_sMcProfile[psMotor->eMotorId];
+    MC_ProfileInit(psDrive->sFocPMSM.psProfile);
+#endif
+
+    /* Clear rest of variables  */
+    Mx_ClearFOCVariables(psMotor);
+
+    /* Init sensors/actuators pointers */
+    /* For PWM driver */
+    psMotor->psPwm3ph->psDutyABC         = &(psDrive->sFocPMSM.sDutyABC);
+    /* For ADC driver */
+    psMotor->psAdcSensor->pf16UDcBus     = &(psDrive->sFocPMSM.f16UDcBus);
+    psMotor->psAdcSensor->psIABC         = &(psDrive->sFocPMSM.sIABCFrac);
+    psMotor->psAdcSensor->pui16SVMSector = &(psDrive->sFocPMSM.ui16SectorSVM);
+    psMotor->psAdcSensor->pui16AuxChan   = &(psDrive->f16AdcAuxSample);
+    /* For QDC driver */
+    psMotor->psQdcSensor->sSpeed.sQDCSpeedFilter.sFltCoeff = psConfig->sQdcSpeedFiltCoeff;
+    MCDRV_QdcSpeedCalInit(psMotor->psQdcSensor);
+    MCDRV_QdcToSpeedCalInit(psMotor->psQdcSensor);
+
+    /* INIT_DONE command */
+    psMotor->psCtrl->uiCtrl |= SM_CTRL_INIT_DONE;
+}
+
+/*!
+ * @brief Stop state routine called in fast state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateStopFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    uint8_t ui8MotorsFaultStatus = 0;
+
+	/* get all adc samples - DC-bus voltage, current, bemf and aux sample */
+	MCDRV_VoltDcBusGet(psMotor->psAdcSensor);
+	MCDRV_AuxValGet(psMotor->psAdcSensor);
+	MCDRV_Curr3Ph2ShGet(psMotor->psAdcSensor);
+
+    /* get rotor position and speed from quadrature encoder sensor */
+	if(psMotor->psQdcSensor->bPosAbsoluteFlag == TRUE)
+	{
+		MCDRV_GetRotorCurrentPos(psMotor->psQdcSensor);
+		MCDRV_GetRotorCurrentRev(psMotor->psQdcSensor);
+		psDrive->f16PosElEnc = psMotor->psQdcSensor->f16PosElec;
+	}
+	MCDRV_QdcToSpeedCalUpdate(psMotor->psQdcSensor); // Update speed from tracking observer in fast loop
+
+    /* convert voltages from fractional measured values to float */
+    psDrive->sFocPMSM.fltUDcBus = 
+        MLIB_ConvSc_FLTsf(psDrive->sFocPMSM.f16UDcBus, *psMotor->pfltDCBvoltageScale);
+
+    /* Sampled DC-Bus voltage filter */
+    psDrive->sFocPMSM.fltUDcBusFilt =
+        GDFLIB_FilterIIR1_FLT(psDrive->sFocPMSM.fltUDcBus, &psDrive->sFocPMSM.sUDcBusFilter);
+
+    /* If the user switches on */
+    if(*psMotor->pbSwitchAppOnOff != 0)
+    {
+    	for(mc_motor_id_t eMotor = kMC_Motor1; eMotor < MC_MAX_MOTORS; eMotor++)
+    	{
+    		if(eMotor == psMotor->eMotorId)
+    		{
+    			continue;
+    		}
+    		if(FAULT_GetImmediateStopConfiguration_fromISR(eMotor, psMotor->eMotorId) == true)
+    		{
+    			if(FAULT_GetMotorFault_fromISR(eMotor) != (kMC_NoFaultMC|kMC_NoFaultBS))
+    			{
+    				ui8MotorsFaultStatus |= 1<<eMotor;
+    			}
+    		}
+    	}
+
+    	if(ui8MotorsFaultStatus == 0)
+    	{
+
+            /* Set the switch on */
+            *psMotor->pbSwitchAppOnOff = TRUE;
+
+            /* Start command */
+            psMotor->psCtrl->uiCtrl |= SM_CTRL_START;
+
+    	}
+    	else
+    	{
+    		*psMotor->pbSwitchAppOnOff = FALSE;
+    	}
+    }
+
+    /* Braking resistor control */
+//    if(psDrive->sFocPMSM.fltUDcBusFilt > psDrive->sFaultThresholds.fltUDcBusTrip)
+//        Mx_BRAKE_SET();
+//    else
+//        Mx_BRAKE_CLEAR();
+
+    Mx_FaultDetection(psMotor);
+
+    /* If a fault occurred */
+    if (psDrive->sFaultIdPending)
+    {
+        /* Switches to the FAULT state */
+        psMotor->psCtrl->uiCtrl |= SM_CTRL_FAULT;
+    }
+
+    /* clear recorded fault state manually from FreeMASTER */
+    if(psDrive->bFaultClearMan)
+    {
+        /* Clear fault state */
+        psDrive->bFaultClearMan = FALSE;
+        psDrive->sFaultIdCaptured = 0;
+    }
+
+}
+
+/*!
+ * @brief Run state routine called in fast state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateRunFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* get all adc samples - DC-bus voltage, current, bemf and aux sample */
+    MC_PROFILE_BEGIN(psDrive->sFocPMSM.psProfile);
+	MCDRV_Curr3Ph2ShGet(psMotor->psAdcSensor);
+	MCDRV_VoltDcBusGet(psMotor->psAdcSensor);
+	MCDRV_AuxValGet(psMotor->psAdcSensor);
+    MC_PROFILE_END(psDrive->sFocPMSM.psProfile, kMC_ProfileAdcGet);
+    
+    /* get position and speed from quadrature encoder sensor */
+	if(psMotor->psQdcSensor->bPosAbsoluteFlag == TRUE)
+	{
+		MCDRV_GetRotorCurrentPos(psMotor->psQdcSensor);
+		MCDRV_GetRotorCurrentRev(psMotor->psQdcSensor);
+		psDrive->f16PosElEnc = psMotor->psQdcSensor->f16PosElec;
+	}
+	MCDRV_QdcToSpeedCalUpdate(psMotor->psQdcSensor); // Update speed from tracking observer in fast loop
+     
+
+    /* If the user switches off */
+    if (!*psMotor->pbSwitchAppOnOff)
+    {
+        /* Stop command */
+        psMotor->psCtrl->uiCtrl |= SM_CTRL_STOP;
+        
+        psDrive->sPosition.sCurveRef.i32Q16PosCmd = 0;
+        psDrive->sPosition.i32Q16PosRef = 0;
+        psDrive->sPosition.i32Q16PosRef_1 = 0;
+        psDrive->sPosition.fltSpeedFwd = 0;
+        psDrive->sPosition.sCurveRef.i32Q16PosFilt = 0;
+        psDrive->sPosition.i32Q16PosFdbk = 0;
+            
+    }
+
+    /* detect fault */
+    Mx_FaultDetection(psMotor);
+
+    /* If a fault occurred */
+    if (psDrive->sFaultIdPending != 0)
+    {
+        /* Switches to the FAULT state */
+        psMotor->psCtrl->uiCtrl |= SM_CTRL_FAULT;
+    }
+
+    /* convert phase currents from fractional measured values to float */
+    psDrive->sFocPMSM.sIABC.fltA = MLIB_ConvSc_FLTsf(psDrive->sFocPMSM.sIABCFrac.f16A, *psMotor->pfltCurrentScale);
+    psDrive->sFocPMSM.sIABC.fltB = MLIB_ConvSc_FLTsf(psDrive->sFocPMSM.sIABCFrac.f16B, *psMotor->pfltCurrentScale);
+    psDrive->sFocPMSM.sIABC.fltC = MLIB_ConvSc_FLTsf(psDrive->sFocPMSM.sIABCFrac.f16C, *psMotor->pfltCurrentScale);
+
+    /* convert voltages from fractional measured values to float */
+    psDrive->sFocPMSM.fltUDcBus = 
+        MLIB_ConvSc_FLTsf(psDrive->sFocPMSM.f16UDcBus, *psMotor->pfltDCBvoltageScale);
+
+    /* Sampled DC-Bus voltage filter */
+    psDrive->sFocPMSM.fltUDcBusFilt =
+        GDFLIB_FilterIIR1_FLT(psDrive->sFocPMSM.fltUDcBus, &psDrive->sFocPMSM.sUDcBusFilter);
+
+//    /* Braking resistor control */
+//    if(psDrive->sFocPMSM.fltUDcBusFilt > psDrive->sFaultThresholds.fltUDcBusTrip)
+//        Mx_BRAKE_SET();
+//    else
+//        Mx_BRAKE_CLEAR();
+
+    /* Run sub-state function */
+    s_STATE_RUN_TABLE_FAST[*psMotor->peStateRun](psMotor);
+
+    /* PWM peripheral update */
+    MC_PROFILE_BEGIN(psDrive->sFocPMSM.psProfile);
+    MCDRV_eFlexPwm3PhDutyUpdate(psMotor->psPwm3ph);
+    MC_PROFILE_END(psDrive->sFocPMSM.psProfile, kMC_ProfilePwmUpdate);
+
+    /* set current sensor for  sampling */
+    MCDRV_Curr3Ph2ShChanAssign(psMotor->psAdcSensor);
+
+    /* clear recorded fault state manually from FreeMASTER */
+    if(psDrive->bFaultClearMan)
+    {
+        /* Clear fault state */
+        psDrive->bFaultClearMan = FALSE;
+        psDrive->sFaultIdCaptured = 0;
+    }
+#if FEATURE_MC_LOOP_BANDWIDTH_TEST_ENABLE
+    /* Speed loop bandwidth test - for debug only */
+    if(*psMotor->sLoopTest.pui16SinSpeedCmdSwitch == 1)
+    {
+    	*psMotor->sLoopTest.pf32Angle += MLIB_Mul_F32(FRAC32(2.0*FREQ_SCALE_MX/psMotor->psConfig->fltFastLoopFreq), *psMotor->sLoopTest.pf32FreqIn);
+    	*psMotor->sLoopTest.pfltSin = GFLIB_Sin_FLTa((acc32_t)MLIB_Conv_F16l(*psMotor->sLoopTest.pf32Angle));
+    	*psMotor->sLoopTest.pfltSpeedCmdTest = *psMotor->sLoopTest.pfltSin * *psMotor->sLoopTest.pfltSpeedCmdAmplitude;
+    }
+
+    /* Current loop bandwidth test - for debug only */
+    if(*psMotor->sLoopTest.pui16SinCurrentCmdSwitch == 1)
+    {
+    	*psMotor->sLoopTest.pf32AngleCur += MLIB_Mul_F32(FRAC32(2.0*FREQ_CUR_SCALE_MX/psMotor->psConfig->fltFastLoopFreq), *psMotor->sLoopTest.pf32FreqInCur);
+    	*psMotor->sLoopTest.pfltSinCur = GFLIB_Sin_FLTa((acc32_t)MLIB_Conv_F16l(*psMotor->sLoopTest.pf32AngleCur));
+    	*psMotor->sLoopTest.pfltCurrentCmdTest = *psMotor->sLoopTest.pfltSinCur * *psMotor->sLoopTest.pfltCurrentCmdAmplitude;
+    }
+
+    /* Position loop bandwidth test - For debug only */
+    if(*psMotor->sLoopTest.pui16SinPosCmdSwitch == 1)
+    {
+      	*psMotor->sLoopTest.pf32AnglePos += MLIB_Mul_F32(FRAC32(2.0*FREQ_POS_SCALE_MX/psMotor->psConfig->fltFastLoopFreq), *psMotor->sLoopTest.pf32FreqInPos);
+       	*psMotor->sLoopTest.pf16SinPos = GFLIB_Sin_F16(MLIB_Conv_F16l(*psMotor->sLoopTest.pf32AnglePos));
+       	*psMotor->sLoopTest.pi32Q16PosCmdTest = ((int64_t)*psMotor->sLoopTest.pf16SinPos * *psMotor->sLoopTest.pi32Q16PosCmdAmplitude)>>15; // Q1.15 * Q16.16 = Q17.31 => Q16.16
+    }
+#endif
+}
+
+/*!
+ * @brief Fault state routine called in slow state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateFaultSlow(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+	// Get speed from QDC M/T method in slow loop
+	MCDRV_QdcSpeedCalUpdate(psMotor->psQdcSensor);
+
+	/* after fault condition ends wait defined time to clear fault state */
+    if (!FAULT_ANY(psDrive->sFaultIdPending))
+    {
+        if (--psDrive->ui16CounterState == 0)
+        {
+            /* Clear fault state */
+            psMotor->psCtrl->uiCtrl |= SM_CTRL_FAULT_CLEAR;
+        }
+    }
+    else
+    {
+        psDrive->ui16CounterState = psDrive->ui16TimeFaultRelease;
+    }
+}
+
+/*!
+ * @brief Fault state routine called in slow state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateInitSlow(sm_ref_sol_motor_t *const psMotor)
+{
+}
+
+/*!
+ * @brief Stop state routine called in slow state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateStopSlow(sm_ref_sol_motor_t *const psMotor)
+{
+	// Get speed from QDC M/T method in slow loop
+	MCDRV_QdcSpeedCalUpdate(psMotor->psQdcSensor);
+	MCDRV_GetRotorDeltaRev(psMotor->psQdcSensor);
+}
+
+/*!
+ * @brief Run state routine called in slow state machine
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_StateRunSlow(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+	// Get speed from QDC M/T method in slow loop
+	MCDRV_QdcSpeedCalUpdate(psMotor->psQdcSensor);
+
+	/* Run sub-state function */
+    s_STATE_RUN_TABLE_SLOW[*psMotor->peStateRun](psMotor);
+
+    psDrive->eControl_1 = psDrive->eControl;
+}
+
+/*!
+ * @brief Transition from Fault to Stop state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_TransFaultStop(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    fault_source_t motorFaults = 0;
+	/* Type the code to do when going from the FAULT to the INIT state */
+//    FAULT_CLEAR_ALL(psDrive->sFaultIdCaptured);
+
+    /* Clear all FOC variables, init filters, etc. */
+    Mx_ClearFOCVariables(psMotor);
+
+    motorFaults = kMC_NoFaultMC|psMotor->eMotorId;
+
+    FAULT_RaiseFaultEvent_fromISR(motorFaults);
+}
+
+/*!
+ * @brief Transition from Init to Fault state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_TransInitFault(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* type the code to do when going from the INIT to the FAULT state */
+    /* disable PWM outputs */
+	MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+    psDrive->ui16CounterState = psDrive->ui16TimeFaultRelease;
+
+    psDrive->sSpeed.fltSpeedCmd = 0.0F;
+}
+
+/*!
+ * @brief Transition from Init to Stop state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_TransInitStop(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* type the code to do when going from the INIT to the STOP state */
+    /* disable PWM outputs */
+	MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+
+    /* Enable Open loop start up */
+    psDrive->sStartUp.bOpenLoop = TRUE;
+}
+
+/*!
+ * @brief Transition from Stop to Fault state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_TransStopFault(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    fault_source_t motorFaults = 0;
+	/* type the code to do when going from the STOP to the FAULT state */
+    /* load the fault release time to counter */
+    psDrive->ui16CounterState = psDrive->ui16TimeFaultRelease;
+
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_I_DCBUS_OVER))
+    {
+    	motorFaults |=  kMC_OverCurrent;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_U_DCBUS_UNDER))
+    {
+    	motorFaults |=  kMC_UnderDcBusVoltage;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_U_DCBUS_OVER))
+    {
+    	motorFaults |=  kMC_OverDcBusVoltage;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_LOAD_OVER))
+    {
+    	motorFaults |=  kMC_OverLoad;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_SPEED_OVER))
+    {
+    	motorFaults |=  kMC_OverSpeed;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_ROTOR_BLOCKED))
+    {
+    	motorFaults |=  kMC_RotorBlocked;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_OC))
+    {
+    	motorFaults |=  kMC_GD3000_OverCurrent;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_OT))
+    {
+    	motorFaults |=  kMC_GD3000_OverTemperature;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_VLS_UV))
+    {
+    	motorFaults |=  kMC_GD3000_LowVLS;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_PHASE_ERR))
+    {
+    	motorFaults |=  kMC_GD3000_PhaseError;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_DESAT))
+    {
+    	motorFaults |=  kMC_GD3000_Desaturation;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_IN_RESET))
+    {
+    	motorFaults |=  kMC_GD3000_Reset;
+    }
+    motorFaults = (motorFaults)|psMotor->eMotorId;
+
+    FAULT_RaiseFaultEvent_fromISR(motorFaults);
+}
+
+/*!
+ * @brief Transition from Stop to Run state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_TransStopRun(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* type the code to do when going from the STOP to the RUN state */
+    /* 50% duty cycle */
+    psDrive->sFocPMSM.sDutyABC.f16A = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16B = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16C = FRAC16(0.5);
+
+    /* PWM duty cycles calculation and update */
+    MCDRV_eFlexPwm3PhDutyUpdate(psMotor->psPwm3ph);
+
+    /* Clear offset filters */
+    MCDRV_Curr3Ph2ShCalibInit(psMotor->psAdcSensor);
+
+    /* Enable PWM output */
+//    MCDRV_eFlexPwm3PhOutEnable(psMotor->psPwm3ph);
+
+    /* pass calibration routine duration to state counter*/
+    psDrive->ui16CounterState = psDrive->ui16TimeCalibration;
+
+    /* Calibration sub-state when transition to RUN */
+    *psMotor->peStateRun = kRunState_Calib;
+
+    /* Acknowledge that the system can proceed into the RUN state */
+    psMotor->psCtrl->uiCtrl |= SM_CTRL_RUN_ACK;
+}
+
+/*!
+ * @brief Transition from Run to Fault state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+
+RAM_FUNC_CRITICAL void Mx_TransRunFault(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    fault_source_t motorFaults = 0;
+	/* type the code to do when going from the RUN to the FAULT state */
+    /* disable PWM output */
+	MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+    psDrive->ui16CounterState = psDrive->ui16TimeFaultRelease;
+
+    /* clear over load flag */
+    psDrive->sSpeed.bSpeedPiStopInteg = FALSE;
+
+    psDrive->sSpeed.fltSpeedCmd = 0.0F;
+    psDrive->sScalarCtrl.fltFreqCmd = 0.0F;
+    psDrive->sScalarCtrl.sUDQReq.fltQ = 0.0F;
+    psDrive->sMCATctrl.sUDQReqMCAT.fltQ = 0.0F;
+    psDrive->sMCATctrl.sUDQReqMCAT.fltD = 0.0F;
+    psDrive->sMCATctrl.sIDQReqMCAT.fltQ = 0.0F;
+    psDrive->sMCATctrl.sIDQReqMCAT.fltD = 0.0F;
+
+    /* Clear actual speed values */
+    psDrive->sScalarCtrl.fltFreqRamp = 0.0F;
+    psDrive->sSpeed.fltSpeed = 0.0F;
+    psDrive->sSpeed.fltSpeedFilt = 0.0F;
+
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_I_DCBUS_OVER))
+    {
+    	motorFaults |=  kMC_OverCurrent;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_U_DCBUS_UNDER))
+    {
+    	motorFaults |=  kMC_UnderDcBusVoltage;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_U_DCBUS_OVER))
+    {
+    	motorFaults |=  kMC_OverDcBusVoltage;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_LOAD_OVER))
+    {
+    	motorFaults |=  kMC_OverLoad;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_SPEED_OVER))
+    {
+    	motorFaults |=  kMC_OverSpeed;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_ROTOR_BLOCKED))
+    {
+    	motorFaults |=  kMC_RotorBlocked;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_OC))
+    {
+    	motorFaults |=  kMC_GD3000_OverCurrent;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_OT))
+    {
+    	motorFaults |=  kMC_GD3000_OverTemperature;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_VLS_UV))
+    {
+    	motorFaults |=  kMC_GD3000_LowVLS;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_PHASE_ERR))
+    {
+    	motorFaults |=  kMC_GD3000_PhaseError;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_DESAT))
+    {
+    	motorFaults |=  kMC_GD3000_Desaturation;
+    }
+    if(psDrive->sFaultIdPending &  (1ul<<FAULT_GD3000_IN_RESET))
+    {
+    	motorFaults |=  kMC_GD3000_Reset;
+    }
+    motorFaults = (motorFaults)|psMotor->eMotorId;
+    FAULT_RaiseFaultEvent_fromISR(motorFaults);
+}
+
+/*!
+ * @brief Transition from Run to Stop state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void Mx_TransRunStop(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* type the code to do when going from the RUN to the STOP state */
+    /* disable PWM outputs */
+	MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+
+    psDrive->sSpeed.fltSpeedCmd = 0.0F;
+    psDrive->sScalarCtrl.fltFreqCmd = 0.0F;
+    psDrive->sScalarCtrl.sUDQReq.fltQ = 0.0F;
+    psDrive->sMCATctrl.sUDQReqMCAT.fltQ = 0.0F;
+    psDrive->sMCATctrl.sUDQReqMCAT.fltD = 0.0F;
+    psDrive->sMCATctrl.sIDQReqMCAT.fltQ = 0.0F;
+    psDrive->sMCATctrl.sIDQReqMCAT.fltD = 0.0F;
+
+    Mx_ClearFOCVariables(psMotor);
+
+    /* Acknowledge that the system can proceed into the STOP state */
+    psMotor->psCtrl->uiCtrl |= SM_CTRL_STOP_ACK;
+}
+
+/*!
+ * @brief Calibration process called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunCalibFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when in the RUN CALIB sub-state
+       performing ADC offset calibration */
+
+    /* call offset measurement */
+	MCDRV_Curr3Ph2ShCalib(psMotor->psAdcSensor);
+
+    /* change SVM sector in range <1;6> to measure all AD channel mapping combinations */
+    if (++psDrive->sFocPMSM.ui16SectorSVM > 6)
+        psDrive->sFocPMSM.ui16SectorSVM = 1;
+}
+
+/*!
+ * @brief Motor identification process called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+
+RAM_FUNC_CRITICAL static void Mx_StateRunMeasureFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    mid_sm_app_state_t eMIDStatePrev;
+
+    /* Set zero position at all measurements */
+    if((g_sMIDCtrl.eState == kMID_Ld) || (g_sMIDCtrl.eState == kMID_Lq) || (g_sMIDCtrl.eState == kMID_Start) || (g_sMIDCtrl.eState == kMID_Rs) || (g_sMIDCtrl.eState == kMID_PwrStgCharact))
+    {
+        /* Zero position is needed for RL measurement */
+        psDrive->sFocPMSM.f16PosEl = FRAC16(0.0);
+
+        psDrive->sFocPMSM.sAnglePosEl.fltSin = 0.0F;
+        psDrive->sFocPMSM.sAnglePosEl.fltCos = 1.0F;
+    }
+    
+    /* turn on dead-time compensation in case of Rs measurement */
+    psDrive->sFocPMSM.bFlagDTComp = (g_sMIDCtrl.eState == kMID_Rs);
+    
+    /* Perform current transformations if voltage control will be done.
+     * At other measurements it is done in a current loop calculation */
+    if((g_sMIDCtrl.eState == kMID_Ld) || (g_sMIDCtrl.eState == kMID_Lq))
+    {
+        /* Current transformations */
+        GMCLIB_Clark_FLT(&psDrive->sFocPMSM.sIABC, &psDrive->sFocPMSM.sIAlBe);
+        GMCLIB_Park_FLT(&psDrive->sFocPMSM.sIAlBe, &psDrive->sFocPMSM.sAnglePosEl, &psDrive->sFocPMSM.sIDQ);
+    }
+    
+    /* If electrical parameters are being measured, put external position to FOC */
+    if(g_sMIDCtrl.eState == kMID_Mech)
+    {
+        psDrive->sFocPMSM.bPosExtOn = (g_sMID.sMIDMech.eState == kMID_MechStartUp);
+        psDrive->sFocPMSM.bOpenLoop = g_sMID.sMIDMech.sStartup.bOpenLoop;
+    }
+    else
+        psDrive->sFocPMSM.bPosExtOn = TRUE;
+
+    /* Motor parameters measurement state machine */
+    eMIDStatePrev = g_sMIDCtrl.eState;
+    MID_SM_StateMachine(&g_sMIDCtrl);
+
+    /* Load a completed power stage characteristic into this motor's dead-time compensation table */
+    if((eMIDStatePrev == kMID_PwrStgCharact) && (g_sMIDCtrl.eState == kMID_Stop) && (g_sMID.ui16FaultMID == 0U) &&
+       (g_sMID.sMIDPwrStgChar.ui16LUTIndex >= MID_CHAR_CURRENT_POINT_NUMBERS) && (g_sMID.sMIDPwrStgChar.fltIdCalib > 0.0F))
+    {
+        psDrive->sFocPMSM.fltPwrStgCharIRange = g_sMID.sMIDPwrStgChar.fltIdCalib;
+        MCS_DTCompInit(&psDrive->sFocPMSM, g_sMID.sMIDPwrStgChar.fltUdErrorLookUp);
+    }
+
+    /* A completed mechanical measurement gives the inertia of the position acceleration feed forward */
+    if((eMIDStatePrev == kMID_Mech) && (g_sMIDCtrl.eState != kMID_Mech) && (g_sMID.ui16FaultMID == 0U) &&
+       (g_sMID.sMIDMech.fltInertiaConst > 0.0F))
+    {
+        psDrive->sPosition.fltGainAccFwd = g_sMID.sMIDMech.fltInertiaConst;
+    }
+
+    /* Measured Rs, Ld and Lq give the current controller gains for the rest of the measurement and the next starts */
+    if((eMIDStatePrev == kMID_Lq) && (g_sMIDCtrl.eState == kMID_Ke) && (g_sMID.sMIDTune.ui16CurDone == TRUE))
+    {
+        psDrive->sCtrlTuning.fltDKpGain = g_sMID.sMIDTune.fltDKpGain;
+        psDrive->sCtrlTuning.fltDKiGain = g_sMID.sMIDTune.fltDKiGain;
+        psDrive->sCtrlTuning.fltQKpGain = g_sMID.sMIDTune.fltQKpGain;
+        psDrive->sCtrlTuning.fltQKiGain = g_sMID.sMIDTune.fltQKiGain;
+        psDrive->sCtrlTuning.ui32Valid |= MC_CTRL_TUNING_CURRENT;
+        psDrive->sCtrlTuning.ui32Update++;
+
+        psDrive->sFocPMSM.sIdPiParams.fltPGain = psDrive->sCtrlTuning.fltDKpGain;
+        psDrive->sFocPMSM.sIdPiParams.fltIGain = psDrive->sCtrlTuning.fltDKiGain;
+        psDrive->sFocPMSM.sIqPiParams.fltPGain = psDrive->sCtrlTuning.fltQKpGain;
+        psDrive->sFocPMSM.sIqPiParams.fltIGain = psDrive->sCtrlTuning.fltQKiGain;
+    }
+
+    /* Measured inertia gives the speed controller gains for the next starts */
+    if((eMIDStatePrev == kMID_Mech) && (g_sMIDCtrl.eState != kMID_Mech) && (g_sMID.sMIDTune.ui16SpeedDone == TRUE))
+    {
+        psDrive->sCtrlTuning.fltSpeedPGain = g_sMID.sMIDTune.fltSpeedPGain;
+        psDrive->sCtrlTuning.fltSpeedIGain = g_sMID.sMIDTune.fltSpeedIGain;
+        psDrive->sCtrlTuning.ui32Valid |= MC_CTRL_TUNING_SPEED;
+        psDrive->sCtrlTuning.ui32Valid &= ~MC_CTRL_TUNING_SPEED_SCHED; /* the schedule was set up for the previous inertia */
+        psDrive->sCtrlTuning.ui32Update++;
+    }
+
+    /* Perform Current control if MID_START or MID_PWR_STG_CHARACT or MID_RS or MID_PP or MID_KE state */
+    if((g_sMIDCtrl.eState == kMID_Start) || (g_sMIDCtrl.eState == kMID_PwrStgCharact) || (g_sMIDCtrl.eState == kMID_Rs) || (g_sMIDCtrl.eState == kMID_Pp) || (g_sMIDCtrl.eState == kMID_Ke) || (g_sMIDCtrl.eState == kMID_Mech))
+    {    
+        /* enable current control loop */
+        psDrive->sFocPMSM.bCurrentLoopOn = TRUE;
+    }
+    
+    /* Perform Voltage control if MID_LD or MID_LQ or START state*/
+    else
+    {
+        /* disable current control loop */
+        psDrive->sFocPMSM.bCurrentLoopOn = FALSE;
+    }
+    
+    /* FOC */
+    MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+
+    /* Force sector to 4 to ensure that currents Ia, Ib will be sensed and Ic calculated */
+    psDrive->sFocPMSM.ui16SectorSVM = 4U;
+
+    /* When Measurement done go to RUN READY sub-state and then to STOP state and reset uw16Enable measurement */
+    if(g_sMIDCtrl.uiCtrl & MID_SM_CTRL_STOP_ACK)
+    {
+        Mx_TransRunMeasureReady(psMotor);
+        *psMotor->pbSwitchAppOnOff = FALSE;
+        g_sMID.ui16EnableMeasurement = 0U;
+    }
+}
+
+/*!
+ * @brief Ready state called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunReadyFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when in the RUN READY sub-state */
+    /* Clear actual speed values */
+    psDrive->sScalarCtrl.fltFreqRamp = 0.0F;
+    psDrive->sSpeed.fltSpeed = 0.0F;
+    psDrive->sSpeed.fltSpeedFilt = 0.0F;
+    psDrive->sFocPMSM.f16PosElEst = 0;
+    psDrive->sFocPMSM.fltSpeedElEst = 0.0F;
+
+#if FEATURE_MC_INVERTER_OUTPUT_DEBUG_ENABLE
+    /**************** Inverter output debug *************/
+    if(*psMotor->pui16PWMOutputDebugFlag == 1)
+    {
+        /* PWM peripheral update */
+        MCDRV_eFlexPwm3PhDutyUpdate(psMotor->psPwm3ph);
+        MCDRV_eFlexPwm3PhOutEnable(psMotor->psPwm3ph);
+    }
+    else
+    {
+    	MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+    }
+    /****************************************************/
+#endif
+    /* MCAT control structure switch */
+    switch (psDrive->eControl)
+    {
+    case kControlMode_Scalar:
+        if (!(psDrive->sScalarCtrl.fltFreqCmd == 0.0F))
+        {
+            psDrive->sScalarCtrl.fltFreqRamp = 0.0F;
+            psDrive->sScalarCtrl.sUDQReq.fltQ = 0.0F;
+
+            /* Transition to the RUN ALIGN sub-state */
+            Mx_TransRunReadyAlign(psMotor);
+
+
+        }
+        break;
+
+    case kControlMode_VoltageFOC:
+        if (!(psDrive->sMCATctrl.sUDQReqMCAT.fltQ == 0.0F ))
+        {
+            if(psDrive->sMCATctrl.sUDQReqMCAT.fltQ > 0.0F)
+                psDrive->sSpeed.fltSpeedCmd = psDrive->sStartUp.fltSpeedCatchUp * 2.0F;
+            else
+                psDrive->sSpeed.fltSpeedCmd = MLIB_Neg_FLT(psDrive->sStartUp.fltSpeedCatchUp * 2.0F);
+
+            /* Transition to the RUN ALIGN sub-state */
+            if((psMotor->psQdcSensor->bPosAbsoluteFlag == TRUE)&&(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL))
+            {
+            	Mx_TransRunReadySpin(psMotor);
+            }
+            else
+            {
+            	Mx_TransRunReadyAlign(psMotor);
+            }
+        }
+        break;
+
+    case kControlMode_VoltageOpenloop:
+        if ((!(psDrive->sMCATctrl.sUDQReqMCAT.fltQ == 0.0F ))&&(psDrive->sSpeed.fltSpeedCmd != 0))
+        {
+            if(psDrive->sMCATctrl.sUDQReqMCAT.fltQ > 0.0F)
+                psDrive->sStartUp.fltSpeedReq = psDrive->sSpeed.fltSpeedCmd;
+            else
+                psDrive->sStartUp.fltSpeedReq = MLIB_Neg_FLT(psDrive->sSpeed.fltSpeedCmd);
+
+            Mx_TransRunReadyAlign(psMotor);
+        }
+        break;
+
+    case kControlMode_CurrentFOC:
+        if (!(psDrive->sMCATctrl.sIDQReqMCAT.fltQ == 0.0F ))
+        {
+            if(psDrive->sMCATctrl.sIDQReqMCAT.fltQ > 0.0F)
+                psDrive->sSpeed.fltSpeedCmd = psDrive->sStartUp.fltSpeedCatchUp * 2.0F;
+            else
+                psDrive->sSpeed.fltSpeedCmd = MLIB_Neg_FLT(psDrive->sStartUp.fltSpeedCatchUp * 2.0F);
+
+            /* Transition to the RUN ALIGN sub-state */
+            if((psMotor->psQdcSensor->bPosAbsoluteFlag == TRUE)&&(psDrive->sMCATctrl.ui16PospeSensor==MCAT_ENC_CTRL))
+            {
+            	Mx_TransRunReadySpin(psMotor);
+            }
+            else
+            {
+            	Mx_TransRunReadyAlign(psMotor);
+            }
+        }
+        break;
+
+    case kControlMode_CurrentOpenloop:
+        if ((!(psDrive->sMCATctrl.sIDQReqMCAT.fltQ == 0.0F ))&&(psDrive->sSpeed.fltSpeedCmd != 0))
+        {
+            if(psDrive->sMCATctrl.sIDQReqMCAT.fltQ > 0.0F)
+                psDrive->sStartUp.fltSpeedReq = psDrive->sSpeed.fltSpeedCmd;
+            else
+                psDrive->sStartUp.fltSpeedReq = MLIB_Neg_FLT(psDrive->sSpeed.fltSpeedCmd);
+
+            Mx_TransRunReadyAlign(psMotor);
+        }
+        break;
+
+    case kControlMode_SpeedFOC:
+               
+    case kControlMode_PositionFOC:
+      
+    default: 
+    	if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+    	{
+            if(psMotor->psQdcSensor->bPosAbsoluteFlag == TRUE)
+            {
+            	Mx_TransRunReadySpin(psMotor);
+            }
+            else
+            {
+            	Mx_TransRunReadyAlign(psMotor);
+            }
+    	}
+    	else if((psDrive->sMCATctrl.ui16PospeSensor == MCAT_SENSORLESS_CTRL) &&
+                ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedCmd) > psDrive->sFaultThresholds.fltSpeedMin) &&
+                (MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedCmd) <= psDrive->sFaultThresholds.fltSpeedNom)))
+    	{
+    		Mx_TransRunReadyAlign(psMotor);
+    	}
+        else
+        {
+            psDrive->sSpeed.fltSpeedCmd = 0.0F;
+        }
+    }
+}
+
+/*!
+ * @brief Alignment process called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunAlignFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+
+    /* type the code to do when in the RUN ALIGN sub-state */
+    /* When alignment elapsed go to Startup */
+    if (--psDrive->ui16CounterState == 0U)
+    {
+        if((psDrive->sMCATctrl.ui16PospeSensor==MCAT_ENC_CTRL) && 
+           (psDrive->eControl != kControlMode_Scalar)&&(psDrive->eControl != kControlMode_VoltageOpenloop)&&(psDrive->eControl != kControlMode_CurrentOpenloop))
+        {
+            /* Transition to the RUN kRunState_Spin sub-state */
+            Mx_TransRunAlignSpin(psMotor);
+        }
+        else
+        {    
+            /* Transition to the RUN kRunState_Startup sub-state */
+            Mx_TransRunAlignStartup(psMotor);
+        }
+    }
+
+    /* If zero speed command go back to Ready */
+    if((psDrive->sMCATctrl.ui16PospeSensor==MCAT_SENSORLESS_CTRL) && (psDrive->sSpeed.fltSpeedCmd == 0.0F) && (psDrive->sScalarCtrl.fltFreqCmd == 0.0F))
+        Mx_TransRunAlignReady(psMotor);
+
+    /* clear actual speed values */
+    psDrive->sScalarCtrl.fltFreqRamp = 0.0F;
+    psDrive->sSpeed.fltSpeed = 0.0F;
+    psDrive->sSpeed.fltSpeedFilt = 0.0F;
+    psDrive->sFocPMSM.f16PosElEst = 0;
+    psDrive->sFocPMSM.fltSpeedElEst = 0.0F;
+
+    if(psDrive->ui16CounterState < (psConfig->ui16AlignDuration - psConfig->ui16BootstrapChargeDuration))
+    {
+		MCS_PMSMAlignment(&psDrive->sAlignment);
+		psDrive->sFocPMSM.f16PosElExt = psDrive->sAlignment.f16PosAlign;
+		MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+    }
+}
+
+/*!
+ * @brief Start-up process called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunStartupFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+	frac16_t f16PosDiff = 0; // Position difference between "Merged Position" and "Open-loop Position"
+	float_t  fltCosPosDiff;
+
+	/* If f16SpeedCmd = 0, go to Free-wheel state */
+    if((psDrive->sSpeed.fltSpeedCmd==0) && (psDrive->eControl==kControlMode_SpeedFOC))
+        Mx_TransRunStartupFreewheel(psMotor);
+
+    /* Type the code to do when in the RUN STARTUP sub-state */
+    /* pass actual estimation position to OL startup structure */
+    psDrive->sStartUp.f16PosEst = psDrive->sFocPMSM.f16PosElEst;
+
+    /*open loop startup */
+    MCS_PMSMOpenLoopStartUp(&psDrive->sStartUp);
+
+    /* Pass f16SpeedRampOpenloop to f16SpeedRamp*/
+    psDrive->sSpeed.fltSpeedRamp = psDrive->sStartUp.fltSpeedRampOpenLoop;
+
+    /* Position and speed for FOC */
+    psDrive->sFocPMSM.f16PosElExt = psDrive->sStartUp.f16PosMerged;
+
+    /* MCAT control structure switch */
+    switch (psDrive->eControl)
+    {
+    case kControlMode_Scalar: 
+        /* switch directly to SPIN state */
+        Mx_TransRunStartupSpin(psMotor);
+        break;
+
+    case kControlMode_VoltageFOC:
+        /* pass MCAT required values in run-time */
+        psDrive->sFocPMSM.sUDQReq.fltD = psDrive->sMCATctrl.sUDQReqMCAT.fltD;
+        psDrive->sFocPMSM.sUDQReq.fltQ = psDrive->sMCATctrl.sUDQReqMCAT.fltQ;
+        /* FOC */
+        psDrive->sFocPMSM.bCurrentLoopOn = FALSE;
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+        break;  
+
+    case kControlMode_CurrentFOC:
+        /* FOC */
+        psDrive->sFocPMSM.sIDQReq.fltD = psDrive->sMCATctrl.sIDQReqMCAT.fltD;
+        psDrive->sFocPMSM.sIDQReq.fltQ = psDrive->sMCATctrl.sIDQReqMCAT.fltQ;
+        psDrive->sFocPMSM.bCurrentLoopOn = TRUE;
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+        break;
+
+    case kControlMode_VoltageOpenloop:
+        /* pass MCAT required values in run-time */
+        psDrive->sFocPMSM.sUDQReq.fltD = psDrive->sMCATctrl.sUDQReqMCAT.fltD;
+        psDrive->sFocPMSM.sUDQReq.fltQ = psDrive->sMCATctrl.sUDQReqMCAT.fltQ;
+
+        if ((!(psDrive->sMCATctrl.sUDQReqMCAT.fltQ == 0.0F ))&&(psDrive->sSpeed.fltSpeedCmd != 0))
+        {
+            if(psDrive->sMCATctrl.sUDQReqMCAT.fltQ > 0.0F)
+                psDrive->sStartUp.fltSpeedReq = psDrive->sSpeed.fltSpeedCmd;
+            else
+                psDrive->sStartUp.fltSpeedReq = MLIB_Neg_FLT(psDrive->sSpeed.fltSpeedCmd);
+        }
+        else
+        {
+        	 Mx_TransRunStartupFreewheel(psMotor);
+        }
+
+        /* FOC */
+        psDrive->sFocPMSM.bCurrentLoopOn = FALSE;
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+        break;
+
+    case kControlMode_CurrentOpenloop:
+
+        psDrive->sFocPMSM.sIDQReq.fltD = psDrive->sMCATctrl.sIDQReqMCAT.fltD;
+        psDrive->sFocPMSM.sIDQReq.fltQ = psDrive->sMCATctrl.sIDQReqMCAT.fltQ;
+
+        if ((!(psDrive->sMCATctrl.sIDQReqMCAT.fltQ == 0.0F ))&&(psDrive->sSpeed.fltSpeedCmd != 0))
+        {
+            if(psDrive->sMCATctrl.sIDQReqMCAT.fltQ > 0.0F)
+                psDrive->sStartUp.fltSpeedReq = psDrive->sSpeed.fltSpeedCmd;
+            else
+                psDrive->sStartUp.fltSpeedReq = MLIB_Neg_FLT(psDrive->sSpeed.fltSpeedCmd);
+        }
+        else
+        {
+        	 Mx_TransRunStartupFreewheel(psMotor);
+        }
+        /* FOC */
+        psDrive->sFocPMSM.bCurrentLoopOn = TRUE;
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+        break;
+
+
+    case kControlMode_SpeedFOC:
+      
+    case kControlMode_PositionFOC:
+        
+    default:
+        /* Current control loop */
+        psDrive->sFocPMSM.sIDQReq.fltD = 0.0F;
+
+        /* during the open loop start up the values of required Iq current are kept in pre-defined level*/
+        if (psDrive->sSpeed.fltSpeedCmd > 0.0F)
+            psDrive->sFocPMSM.sIDQReq.fltQ = psDrive->sStartUp.fltCurrentStartup;
+        else
+            psDrive->sFocPMSM.sIDQReq.fltQ = MLIB_Neg_FLT(psDrive->sStartUp.fltCurrentStartup);
+
+        /* Update Iq reference during open-loop and closed-loop merging when sensorless method is used */
+        if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_SENSORLESS_CTRL)
+        {
+        	if(psDrive->sStartUp.f16RatioMerging > 0) // In merging process
+        	{
+
+        		fltCosPosDiff = GFLIB_Cos_FLTa((acc32_t)MLIB_Mul_F16(psDrive->sStartUp.f16RatioMerging, f16PosDiff));
+        		psDrive->sFocPMSM.sIDQReq.fltQ = fltCosPosDiff * psDrive->sFocPMSM.sIDQReq.fltQ;
+        	}
+        	else
+        	{
+        		f16PosDiff = MLIB_Sub_F16(psDrive->sStartUp.f16PosEst, psDrive->sStartUp.f16PosGen);
+        	}
+        }
+        
+
+        /* Init Bemf observer if open-loop speed is under SpeedCatchUp/2 */
+        if (MLIB_Abs_FLT(psDrive->sStartUp.fltSpeedRampOpenLoop) <
+            (psDrive->sStartUp.fltSpeedCatchUp / 2.0F))
+        {
+            AMCLIB_PMSMBemfObsrvDQInit_A32fff(&psDrive->sFocPMSM.sBemfObsrv);
+            AMCLIB_TrackObsrvInit_A32af(ACC32(0.0), &psDrive->sFocPMSM.sTo);
+        }
+
+        /* FOC */
+        psDrive->sFocPMSM.bCurrentLoopOn = TRUE;
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+               
+        /* select source of actual speed value */
+        if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+            /* pass encoder speed to actual speed value */
+#ifdef USE_QDC_TO_SPEED
+            psDrive->sSpeed.fltSpeed = psMotor->psQdcSensor->sSpeedEstim.f16SpeedEstim;
+#else
+        psDrive->sSpeed.fltSpeed = MLIB_ConvSc_FLTsf(psMotor->psQdcSensor->sSpeed.f16SpeedFilt, psConfig->fltQdcSpeedScale); // Get angular electrical speed
+#endif
+        else
+            /* pass estimated speed to actual speed value */
+            psDrive->sSpeed.fltSpeed = psDrive->sFocPMSM.fltSpeedElEst;
+        
+        
+        
+    }
+
+    /* switch to close loop  */
+    if (!psDrive->sStartUp.bOpenLoop)
+    {
+        Mx_TransRunStartupSpin(psMotor);
+    }
+}
+
+/*!
+ * @brief Spin state called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunSpinFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+
+    /* Type the code to do when in the RUN SPIN sub-state */
+    /* MCAT control structure switch */
+    switch (psDrive->eControl)
+    {
+    case kControlMode_Scalar:
+        /* scalar control */
+        MCS_PMSMScalarCtrl(&psDrive->sScalarCtrl);
+
+        /* pass required voltages to Bemf Observer to work */
+        psDrive->sFocPMSM.sUDQReq.fltQ = psDrive->sScalarCtrl.sUDQReq.fltQ;
+        psDrive->sFocPMSM.sUDQReq.fltD = psDrive->sScalarCtrl.sUDQReq.fltD;
+        psDrive->sFocPMSM.f16PosElExt = psDrive->sScalarCtrl.f16PosElScalar;
+        
+        /* call voltage FOC to calculate PWM duty cycles */
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+
+        /* select source of actual speed value */
+        if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+#ifdef USE_QDC_TO_SPEED
+        psDrive->sSpeed.fltSpeed = MLIB_ConvSc_FLTsf(psMotor->psQdcSensor->sSpeedEstim.f16SpeedEstim, psConfig->fltFracToAngularSpeedCoeff); // Get electrical angular speed
+#else
+        psDrive->sSpeed.fltSpeed = psMotor->psQdcSensor->sSpeed.fltSpeed;
+#endif
+        else
+        	 /* pass estimated speed to actual speed value */
+        	 psDrive->sSpeed.fltSpeed = psDrive->sFocPMSM.fltSpeedElEst;
+
+        /* Sub-state RUN FREEWHEEL */
+        if(psDrive->sScalarCtrl.fltFreqCmd==0.0F)
+               Mx_TransRunSpinFreewheel(psMotor);
+        break;
+
+    case kControlMode_VoltageFOC:
+        /* FOC */
+        psDrive->sFocPMSM.sUDQReq.fltQ = psDrive->sMCATctrl.sUDQReqMCAT.fltQ;
+        psDrive->sFocPMSM.sUDQReq.fltD = psDrive->sMCATctrl.sUDQReqMCAT.fltD;
+        psDrive->sFocPMSM.bCurrentLoopOn = FALSE;
+        
+        /* Pass encoder position to FOC is enabled */
+        if(psDrive->sMCATctrl.ui16PospeSensor==MCAT_ENC_CTRL)
+        {
+            psDrive->sFocPMSM.f16PosElExt = psDrive->f16PosElEnc;
+            psDrive->sFocPMSM.bPosExtOn   = TRUE;
+        }
+        else
+        {
+            psDrive->sFocPMSM.bPosExtOn = FALSE;
+        }
+        
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+
+        /* select source of actual speed value */
+        if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+        {
+#ifdef USE_QDC_TO_SPEED
+            psDrive->sSpeed.fltSpeed = MLIB_ConvSc_FLTsf(psMotor->psQdcSensor->sSpeedEstim.f16SpeedEstim, psConfig->fltFracToAngularSpeedCoeff); // Get electrical angular speed
+#else
+            psDrive->sSpeed.fltSpeed = psMotor->psQdcSensor->sSpeed.fltSpeed;
+
+#endif
+        }
+        else
+        	 /* pass estimated speed to actual speed value */
+        	 psDrive->sSpeed.fltSpeed = psDrive->sFocPMSM.fltSpeedElEst;
+
+        /* Sub-state RUN FREEWHEEL */
+        if(psDrive->sMCATctrl.sUDQReqMCAT.fltQ==0.0F)
+            Mx_TransRunSpinFreewheel(psMotor);
+        break;
+
+    case kControlMode_CurrentFOC: 
+        /* current FOC */
+        psDrive->sFocPMSM.sIDQReq.fltQ = psDrive->sMCATctrl.sIDQReqMCAT.fltQ;
+        psDrive->sFocPMSM.sIDQReq.fltD = psDrive->sMCATctrl.sIDQReqMCAT.fltD;
+
+#if FEATURE_MC_LOOP_BANDWIDTH_TEST_ENABLE
+        if(*psMotor->sLoopTest.pui16SinCurrentCmdSwitch == 1)
+        {
+        	psDrive->sFocPMSM.sIDQReq.fltD = *psMotor->sLoopTest.pfltCurrentCmdTest;
+        }
+#endif
+        /* Pass encoder position to FOC is enabled */
+        if(psDrive->sMCATctrl.ui16PospeSensor==MCAT_ENC_CTRL)
+        {
+            psDrive->sFocPMSM.f16PosElExt = psDrive->f16PosElEnc;
+            psDrive->sFocPMSM.bPosExtOn   = TRUE;
+        }
+        else
+        {
+            psDrive->sFocPMSM.bPosExtOn = FALSE;
+        }
+        
+        psDrive->sFocPMSM.bCurrentLoopOn = TRUE;
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+
+        /* select source of actual speed value */
+        if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+        {
+#ifdef USE_QDC_TO_SPEED
+        psDrive->sSpeed.fltSpeed = MLIB_ConvSc_FLTsf(psMotor->psQdcSensor->sSpeedEstim.f16SpeedEstim, psConfig->fltFracToAngularSpeedCoeff); // Get electrical angular speed
+#else
+        psDrive->sSpeed.fltSpeed = psMotor->psQdcSensor->sSpeed.fltSpeed;
+#endif
+        }
+        else
+			 /* pass estimated speed to actual speed value */
+			 psDrive->sSpeed.fltSpeed = psDrive->sFocPMSM.fltSpeedElEst;
+
+        /* Sub-state RUN FREEWHEEL */
+        if(psDrive->sMCATctrl.sIDQReqMCAT.fltQ==0.0F)
+            Mx_TransRunSpinFreewheel(psMotor);
+        break;
+
+    case kControlMode_SpeedFOC:
+    case kControlMode_PositionFOC:
+    default: 
+        if ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedRamp) < 
+            psDrive->sFaultThresholds.fltSpeedMin) &&
+            (psDrive->sMCATctrl.ui16PospeSensor==MCAT_SENSORLESS_CTRL))
+        {
+            /* Sub-state RUN FREEWHEEL */
+            Mx_TransRunSpinFreewheel(psMotor);
+        }
+  
+        /* Pass encoder position to FOC is enabled */
+        if(psDrive->sMCATctrl.ui16PospeSensor==MCAT_ENC_CTRL)
+        {
+            psDrive->sFocPMSM.f16PosElExt = psDrive->f16PosElEnc;
+            psDrive->sFocPMSM.bPosExtOn   = TRUE;
+        }
+        else
+        {
+            psDrive->sFocPMSM.bPosExtOn = FALSE;
+        }
+        
+        /* FOC */
+        psDrive->sFocPMSM.bCurrentLoopOn = TRUE;
+
+        MCS_PMSMFocCtrl(&psDrive->sFocPMSM);
+        
+        /* select source of actual speed value */
+        if(psDrive->sMCATctrl.ui16PospeSensor==MCAT_ENC_CTRL)
+            /* pass encoder speed to actual speed value */
+#ifdef USE_QDC_TO_SPEED
+            psDrive->sSpeed.fltSpeed = MLIB_ConvSc_FLTsf(psMotor->psQdcSensor->sSpeedEstim.f16SpeedEstim, psConfig->fltFracToAngularSpeedCoeff); // Get electrical angular speed
+#else
+        psDrive->sSpeed.fltSpeed = psMotor->psQdcSensor->sSpeed.fltSpeed;
+#endif
+        else
+            /* pass estimated speed to actual speed value */
+            psDrive->sSpeed.fltSpeed = psDrive->sFocPMSM.fltSpeedElEst;
+        
+        break;
+    }
+}
+
+/*!
+ * @brief Free-wheel process called in fast state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunFreewheelFast(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when in the RUN FREEWHEEL sub-state */
+
+    /* clear actual speed values */
+    psDrive->sScalarCtrl.fltFreqRamp = 0.0F;
+    psDrive->sSpeed.fltSpeed = 0.0F;
+    psDrive->sSpeed.fltSpeedFilt = 0.0F;
+    psDrive->sSpeed.fltSpeedRamp = 0.0F;
+}
+
+/*!
+ * @brief Calibration process called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunCalibSlow(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    if (--psDrive->ui16CounterState == 0U)
+    {
+        /* write calibrated offset values */
+    	MCDRV_Curr3Ph2ShCalibSet(psMotor->psAdcSensor);
+
+        if(g_sMID.ui16EnableMeasurement != 0U)
+            /* To switch to the RUN MEASURE sub-state */
+            Mx_TransRunCalibMeasure(psMotor);
+        else
+            /* To switch to the RUN READY sub-state */
+            Mx_TransRunCalibReady(psMotor);
+    }
+}
+
+/*!
+ * @brief Measure state called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunMeasureSlow(sm_ref_sol_motor_t *const psMotor)
+{
+}
+
+/*!
+ * @brief Ready state called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunReadySlow(sm_ref_sol_motor_t *const psMotor)
+{
+}
+
+/*!
+ * @brief Alignment process called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunAlignSlow(sm_ref_sol_motor_t *const psMotor)
+{
+}
+
+/*!
+ * @brief Start-up process called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunStartupSlow(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    if(psDrive->eControl == kControlMode_SpeedFOC)
+    {
+        /* actual speed filter */
+        psDrive->sSpeed.fltSpeedFilt = GDFLIB_FilterIIR1_FLT(psDrive->sSpeed.fltSpeed, &psDrive->sSpeed.sSpeedFilter);
+
+        /* pass required speed values lower than nominal speed */
+        if ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedCmd) > psDrive->sFaultThresholds.fltSpeedNom))
+        {
+            /* set required speed to nominal speed if over speed command > speed nominal */
+            if (psDrive->sSpeed.fltSpeedCmd > 0.0F)
+                psDrive->sSpeed.fltSpeedCmd = psDrive->sFaultThresholds.fltSpeedNom;
+            else
+                psDrive->sSpeed.fltSpeedCmd = MLIB_Neg_FLT(psDrive->sFaultThresholds.fltSpeedNom);
+        }
+    }
+}
+
+/*!
+ * @brief Spin state called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunSpinSlow(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    if(psDrive->eControl == kControlMode_SpeedFOC)
+    {
+        /* Actual position */
+        MCDRV_GetRotorDeltaRev(psMotor->psQdcSensor);
+        psDrive->sPosition.i32Q16PosFdbk = psMotor->psQdcSensor->i32Q16DeltaRev;
+
+    	if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+    	{
+        /* actual speed filter */
+#ifdef USE_QDC_TO_SPEED
+        psDrive->sSpeed.fltSpeedFilt = GDFLIB_FilterIIR1_FLT(psDrive->sSpeed.fltSpeed, &psDrive->sSpeed.sSpeedFilter);
+#else
+        psDrive->sSpeed.fltSpeedFilt = psDrive->sSpeed.fltSpeed;
+#endif
+    	}
+    	else
+    	{
+    		psDrive->sSpeed.fltSpeedFilt = GDFLIB_FilterIIR1_FLT(psDrive->sSpeed.fltSpeed, &psDrive->sSpeed.sSpeedFilter);
+    	}
+
+        /* pass required speed values lower than nominal speed */
+        if ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedCmd) > psDrive->sFaultThresholds.fltSpeedNom))
+        {
+            /* set required speed to nominal speed if over speed command > speed nominal */
+            if (psDrive->sSpeed.fltSpeedCmd > 0.0F)
+                psDrive->sSpeed.fltSpeedCmd = psDrive->sFaultThresholds.fltSpeedNom;
+            else
+                psDrive->sSpeed.fltSpeedCmd = MLIB_Neg_FLT(psDrive->sFaultThresholds.fltSpeedNom);
+        }
+
+        if ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedRamp) < psDrive->sFaultThresholds.fltSpeedMin)&&
+           (psDrive->sMCATctrl.ui16PospeSensor==MCAT_SENSORLESS_CTRL))
+            Mx_TransRunSpinFreewheel(psMotor);
+
+#if FEATURE_MC_LOOP_BANDWIDTH_TEST_ENABLE
+        /* Speed loop bandwidth test - for debug only */
+        if(*psMotor->sLoopTest.pui16SinSpeedCmdSwitch == 1)
+        {
+        	psDrive->sSpeed.fltSpeedCmd = *psMotor->sLoopTest.pfltSpeedCmdTest;
+        }
+#endif
+        /* call PMSM speed control */
+        psDrive->sSpeed.bIqAccFwdOn = FALSE;
+        psDrive->sSpeed.bIqPiLimFlag = psDrive->sFocPMSM.sIqPiParams.bLimFlag;
+        MCS_PMSMFocCtrlSpeed(&psDrive->sSpeed);
+        MCS_PMSMFieldWeakening(&psDrive->sFieldWeak, &psDrive->sFocPMSM, &psDrive->sSpeed);
+
+//        psDrive->sFocPMSM.fltIqFiltReq = BSF_update(&psDrive->sPosition.sNotchFilter, psDrive->sFocPMSM.sIDQReq.fltQ);
+    }
+
+    if(psDrive->eControl == kControlMode_PositionFOC)
+    {
+    	if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_ENC_CTRL)
+    	{
+        /* actual speed filter */
+#ifdef USE_QDC_TO_SPEED
+        psDrive->sSpeed.fltSpeedFilt = GDFLIB_FilterIIR1_FLT(psDrive->sSpeed.fltSpeed, &psDrive->sSpeed.sSpeedFilter);
+#else
+        psDrive->sSpeed.fltSpeedFilt = psDrive->sSpeed.fltSpeed;
+#endif
+    	}
+    	else
+    	{
+    		psDrive->sSpeed.fltSpeedFilt = GDFLIB_FilterIIR1_FLT(psDrive->sSpeed.fltSpeed, &psDrive->sSpeed.sSpeedFilter);
+    	}
+        
+        /* pass required speed values lower than nominal speed */
+        if ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedCmd) > psDrive->sFaultThresholds.fltSpeedNom))
+        {
+            /* set required speed to nominal speed if over speed command > speed nominal */
+            if (psDrive->sSpeed.fltSpeedCmd > 0.0F)
+                psDrive->sSpeed.fltSpeedCmd = psDrive->sFaultThresholds.fltSpeedNom;
+            else
+                psDrive->sSpeed.fltSpeedCmd = MLIB_Neg_FLT(psDrive->sFaultThresholds.fltSpeedNom);
+        }
+
+        if ((MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedRamp) < psDrive->sFaultThresholds.fltSpeedMin)&&
+           (psDrive->sMCATctrl.ui16PospeSensor==MCAT_SENSORLESS_CTRL))
+            Mx_TransRunSpinFreewheel(psMotor);      
+          
+        /* Actual position */                 
+        MCDRV_GetRotorDeltaRev(psMotor->psQdcSensor);
+        psDrive->sPosition.i32Q16PosFdbk = psMotor->psQdcSensor->i32Q16DeltaRev;
+
+#if FEATURE_MC_LOOP_BANDWIDTH_TEST_ENABLE
+        if(*psMotor->sLoopTest.pui16SinPosCmdSwitch == 1)
+        {
+        	psDrive->sPosition.i32Q16PosCmd = *psMotor->sLoopTest.pi32Q16PosCmdTest;
+        }
+#endif
+        /* Set up speed feed-forward environment when switching from speed-control to position-control */
+        if(psDrive->eControl_1 == kControlMode_SpeedFOC)
+        {
+        	if(psDrive->sPosition.bIsRandomPosition == FALSE)
+        	{
+        		psDrive->sPosition.i32Q16PosRef_1 = psDrive->sPosition.i32Q16PosCmd;
+        	}
+        	else
+        	{
+        		psDrive->sPosition.sCurveRef.sPosRamp.f32State = psDrive->sPosition.i32Q16PosCmd;
+        		psDrive->sPosition.sCurveRef.sTrajFilter.i64M_1 = 0;
+        		psDrive->sPosition.sCurveRef.sTrajFilter.i64M = 0;
+        		psDrive->sPosition.sCurveRef.sTrajFilter.i64Out = ((int64_t)psDrive->sPosition.i32Q16PosCmd)<<32;
+        		psDrive->sPosition.sCurveRef.sTrajFilter.i64Out_1 = ((int64_t)psDrive->sPosition.i32Q16PosCmd)<<32;
+        		psDrive->sPosition.i32Q16PosRef_1 = psDrive->sPosition.i32Q16PosCmd;
+        	}
+        	psDrive->sPosition.fltSpeedTraj_1 = 0.0F;
+        }
+
+        /* Call PMSM position control */
+        MCS_PMSMFocCtrlPosition(&psDrive->sPosition);               
+        
+        /* Speed command is equal to position controller output */
+        psDrive->sSpeed.fltSpeedCmd = psDrive->sPosition.fltSpeedRef;
+        /* Trajectory acceleration feed forward instead of the speed command derivative */
+        psDrive->sSpeed.fltIqAccFwd = psDrive->sPosition.fltIqAccFwd;
+        psDrive->sSpeed.bIqAccFwdOn = (psDrive->sPosition.bIsRandomPosition == TRUE) && (psDrive->sPosition.fltGainAccFwd != 0.0F);
+        psDrive->sSpeed.sSpeedRampParams.fltState = psDrive->sSpeed.fltSpeedCmd; // Bypass speed ramp
+
+        /* Call PMSM speed control */
+        psDrive->sSpeed.bIqPiLimFlag = psDrive->sFocPMSM.sIqPiParams.bLimFlag;
+        MCS_PMSMFocCtrlSpeed(&psDrive->sSpeed);
+        MCS_PMSMFieldWeakening(&psDrive->sFieldWeak, &psDrive->sFocPMSM, &psDrive->sSpeed);
+
+    }
+
+    /* Track the stator resistance and flux drift while the observer closes the loop */
+    if (((psDrive->eControl == kControlMode_SpeedFOC) || (psDrive->eControl == kControlMode_PositionFOC)) &&
+        (psDrive->sMCATctrl.ui16PospeSensor == MCAT_SENSORLESS_CTRL))
+    {
+        MCS_PMSMParamEst(&psDrive->sParamEst, &psDrive->sFocPMSM);
+    }
+}
+
+/*!
+ * @brief Free-wheel process called in slow state machine as Run sub state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_StateRunFreewheelSlow(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* wait until free-wheel time passes */
+    if (--psDrive->ui16CounterState == 0)
+    {
+        /* switch to sub state READY */
+        Mx_TransRunFreewheelReady(psMotor);
+    }
+}
+
+/*!
+ * @brief Transition from Calib to Ready state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunCalibReady(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when going from the RUN CALIB to the RUN READY sub-state */
+
+    /* set 50% PWM duty cycle */
+    psDrive->sFocPMSM.sDutyABC.f16A = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16B = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16C = FRAC16(0.5);
+
+    /* switch to sub state READY */
+    *psMotor->peStateRun = kRunState_Ready;
+}
+
+/*!
+ * @brief Transition from Calib to Measure state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunCalibMeasure(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+
+    /* Type the code to do when going from the RUN CALIB to the RUN MEASURE sub-state */
+    /* Initialise measurement */
+  
+    /* Set all measurement as inactive */
+    g_sMID.sMIDAlignment.ui16Active     = FALSE;
+    g_sMID.sMIDPwrStgChar.ui16Active    = FALSE;
+    g_sMID.sMIDRs.ui16Active            = FALSE;
+    g_sMID.sMIDLs.ui16Active            = FALSE;
+    g_sMID.sMIDKe.ui16Active            = FALSE;
+    g_sMID.sMIDPp.ui16Active            = FALSE;
+    g_sMID.sMIDMech.ui16Active          = FALSE;
+    
+    /* I/O pointers */
+    g_sMID.sIO.pf16PosElExt = &(psDrive->sFocPMSM.f16PosElExt);
+    g_sMID.sIO.pfltId       = &(psDrive->sFocPMSM.sIDQ.fltD);
+    g_sMID.sIO.pfltIq       = &(psDrive->sFocPMSM.sIDQ.fltQ);
+    g_sMID.sIO.pfltIdReq    = &(psDrive->sFocPMSM.sIDQReq.fltD);
+    g_sMID.sIO.pfltIqReq    = &(psDrive->sFocPMSM.sIDQReq.fltQ);
+    g_sMID.sIO.pfltUdReq    = &(psDrive->sFocPMSM.sUDQReq.fltD);
+    g_sMID.sIO.pfltUqReq    = &(psDrive->sFocPMSM.sUDQReq.fltQ);
+    g_sMID.sIO.pfltUDCbus   = &(psDrive->sFocPMSM.fltUDcBusFilt);
+    g_sMID.sIO.pfltEd       = &(psDrive->sFocPMSM.sBemfObsrv.sEObsrv.fltD);
+    g_sMID.sIO.pfltEq       = &(psDrive->sFocPMSM.sBemfObsrv.sEObsrv.fltQ);
+    g_sMID.sIO.pfltSpeedEst = &(psDrive->sFocPMSM.fltSpeedElEst);
+    g_sMID.sIO.pf16PosElEst = &(psDrive->sFocPMSM.f16PosElEst);
+    g_sMID.sIO.pf16PosElExt = &(psDrive->sFocPMSM.f16PosElExt);
+
+    /* Ls measurement init */
+    g_sMID.sMIDLs.fltUdMax   = MLIB_Mul_FLT(MID_K_MODULATION_RATIO, psDrive->sFocPMSM.fltUDcBusFilt);
+    g_sMID.sMIDLs.fltFreqMax = (float_t)psDrive->ui16FastCtrlLoopFreq / 2U;
+
+    /* Ke measurement init */
+    g_sMID.sMIDKe.fltFreqMax = (float_t)psDrive->ui16FastCtrlLoopFreq / 2U;
+
+    /* Pp measurement init */
+    g_sMID.sMIDPp.fltFreqMax = (float_t)psDrive->ui16FastCtrlLoopFreq / 2U;
+    
+    /* PwrStg char init */
+    g_sMID.sMIDPwrStgChar.ui16NumOfChPnts = MID_CHAR_CURRENT_POINT_NUMBERS;
+
+    /* Controller tuning init, the configured bandwidths are kept and the gains follow the motor */
+    g_sMID.sMIDTune.fltCurFreq     = psConfig->fltCloopFreq;
+    g_sMID.sMIDTune.fltCurAtt      = psConfig->fltCloopAtt;
+    g_sMID.sMIDTune.fltCurLoopTs   = 1.0F / (float_t)psDrive->ui16FastCtrlLoopFreq;
+    g_sMID.sMIDTune.fltSpeedFreq   = psConfig->fltSloopFreq;
+    g_sMID.sMIDTune.fltSpeedAtt    = psConfig->fltSloopAtt;
+    g_sMID.sMIDTune.fltSpeedLoopTs = 1.0F / (float_t)psDrive->ui16SlowCtrlLoopFreq;
+
+    /* During the measurement motor is driven open-loop */
+    psDrive->sFocPMSM.bOpenLoop = TRUE; 
+
+    /* Reset DONE & ACK of all MID states */
+    g_sMIDCtrl.uiCtrl = 0;
+
+    /* First state in MID state machine will be kMID_Start */
+    g_sMIDCtrl.eState = kMID_Start;
+
+    /* Sub-state RUN MEASURE */
+    *psMotor->peStateRun = kRunState_Measure;
+}
+
+/*!
+ * @brief Transition from Measure to Ready state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+
+RAM_FUNC_CRITICAL static void Mx_TransRunMeasureReady(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when going from the RUN CALIB to the RUN READY sub-state */
+    /* Set off measurement */
+    g_sMID.ui16EnableMeasurement = 0;
+
+    /* set 50% PWM duty cycle */
+    psDrive->sFocPMSM.sDutyABC.f16A = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16B = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16C = FRAC16(0.5);
+
+    /* disable passing external electrical position to FOC */
+    psDrive->sFocPMSM.bPosExtOn = FALSE;                                   
+
+    /* swith to sub state READY */
+    *psMotor->peStateRun = kRunState_Ready;
+}
+
+/*!
+ * @brief Transition from Ready to Align state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunReadyAlign(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+
+    /* Type the code to do when going from the RUN kRunState_Ready to the RUN kRunState_Align sub-state */
+    /* Alignment duration set-up */
+    psDrive->ui16CounterState = psDrive->sAlignment.ui16Time;
+    /* Counter of half alignment duration */
+    psDrive->sAlignment.ui16TimeHalf = MLIB_ShR_F16(psDrive->sAlignment.ui16Time, 1);
+
+    /* set required alignment voltage to Ud */
+    psDrive->sFocPMSM.sUDQReq.fltD = psDrive->sAlignment.fltUdReq;
+    psDrive->sFocPMSM.sUDQReq.fltQ = 0.0F;
+
+    /* enable passing required position to FOC */
+    psDrive->sFocPMSM.bPosExtOn = TRUE;
+
+    /* disable current FOC */
+    psDrive->sFocPMSM.bCurrentLoopOn = FALSE;
+    
+    /* enable Open loop mode in main control structure */
+    psDrive->sFocPMSM.bOpenLoop = TRUE;
+
+    /* current and speed controller gains of this start */
+    Mx_SetCtrlGains(psMotor);
+
+    psDrive->sFocPMSM.sDutyABC.f16A = psConfig->f16BootstrapDuty;
+    psDrive->sFocPMSM.sDutyABC.f16B = psConfig->f16BootstrapDuty;
+    psDrive->sFocPMSM.sDutyABC.f16C = psConfig->f16BootstrapDuty;
+
+    /* Enable PWM output */
+    MCDRV_eFlexPwm3PhOutEnable(psMotor->psPwm3ph);
+
+    /* Sub-state RUN ALIGN */
+    *psMotor->peStateRun = kRunState_Align;
+}
+
+/*!
+ * @brief Transition from Align to Startup state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunAlignStartup(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when going from the RUN kRunState_Align to the RUN kRunState_Startup sub-state */
+    /* initialize encoder driver */
+	MCDRV_GetRotorInitPos(psMotor->psQdcSensor, MLIB_Conv_F32s(psDrive->sAlignment.f16PosAlign));
+	MCDRV_GetRotorInitRev(psMotor->psQdcSensor);
+  
+    /* clear application parameters */
+    Mx_ClearFOCVariables(psMotor);
+
+    /* pass required speed to open loop start-up structure */
+    if (psDrive->sSpeed.fltSpeedCmd > 0.0F)
+        psDrive->sStartUp.fltSpeedReq = psDrive->sStartUp.fltSpeedCatchUp;
+    else
+        psDrive->sStartUp.fltSpeedReq = MLIB_Neg_FLT(psDrive->sStartUp.fltSpeedCatchUp);
+
+    /* enable position merge in openloop startup  */
+    if((psDrive->eControl!= kControlMode_VoltageOpenloop)&&(psDrive->eControl!= kControlMode_CurrentOpenloop))
+    {
+    	psDrive->sStartUp.bMergeFlag = TRUE;
+    }
+    else
+    {
+    	psDrive->sStartUp.bMergeFlag = FALSE;
+    }
+
+    /* enable Open loop mode in main control structure */
+    psDrive->sStartUp.bOpenLoop = TRUE;
+    psDrive->sFocPMSM.bOpenLoop = TRUE;
+
+    /* enable Open loop mode in FOC module */
+    psDrive->sFocPMSM.bPosExtOn = TRUE;
+
+    psDrive->sFocPMSM.ui16SectorSVM = MX_SVM_SECTOR_DEFAULT;
+    GDFLIB_FilterIIR1Init_FLT(&psDrive->sSpeed.sSpeedFilter);
+
+    /* Go to sub-state RUN STARTUP */
+    *psMotor->peStateRun = kRunState_Startup;
+}
+
+/*!
+ * @brief Transition from Align to Spin state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunAlignSpin(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when going from the RUN STARTUP to the RUN SPIN sub-state */
+    /* initialize encoder driver */
+	MCDRV_GetRotorInitPos(psMotor->psQdcSensor, MLIB_Conv_F32s(psDrive->sAlignment.f16PosAlign));
+
+    /* Ensure the feedback position is reset to zero whenever state machine goes to spin */
+    MCDRV_GetRotorInitRev(psMotor->psQdcSensor);
+
+    /* Ensure position command starts from zero */
+    psDrive->sPosition.sCurveRef.sPosRamp.f32State = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64M = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64M_1 = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64Out_1 = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64Out = 0;
+  
+    psDrive->sFocPMSM.bPosExtOn = TRUE;                                        /* enable passing external electrical position from encoder to FOC */
+    psDrive->sFocPMSM.bOpenLoop = FALSE;                                       /* disable parallel running openloop and estimator */
+  
+    psDrive->sFocPMSM.ui16SectorSVM    = MX_SVM_SECTOR_DEFAULT;
+    psDrive->sFocPMSM.sIDQReq.fltD     = 0.0F;
+    psDrive->sFocPMSM.sIDQReq.fltQ     = 0.0F;
+    
+    psDrive->sSpeed.fltSpeedRamp = 0;
+    psDrive->sSpeed.fltSpeedRamp_1 = 0;
+    psDrive->sSpeed.sIqFwdFilter.fltFltBfrX[0] = 0;
+    psDrive->sSpeed.sIqFwdFilter.fltFltBfrY[0] = 0;
+
+    Mx_ClearFOCVariables(psMotor);
+
+    /* To switch to the RUN SPIN sub-state */
+    *psMotor->peStateRun = kRunState_Spin;
+}
+
+RAM_FUNC_CRITICAL static void Mx_TransRunReadySpin(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    psDrive->sFocPMSM.bPosExtOn = TRUE;                                        /* enable passing external electrical position from encoder to FOC */
+    psDrive->sFocPMSM.bOpenLoop = FALSE;                                       /* disable parallel running openloop and estimator */
+
+    psDrive->sFocPMSM.ui16SectorSVM    = MX_SVM_SECTOR_DEFAULT;
+    psDrive->sFocPMSM.sIDQReq.fltD     = 0.0F;
+    psDrive->sFocPMSM.sIDQReq.fltQ     = 0.0F;
+
+    Mx_ClearFOCVariables(psMotor);
+
+    /* Ensure the feedback position is reset whenever state machine goes to spin */
+    MCDRV_GetRotorInitRev(psMotor->psQdcSensor);
+
+    /* Ensure position command starts from zero */
+    psDrive->sPosition.sCurveRef.sPosRamp.f32State = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64M = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64M_1 = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64Out_1 = 0;
+    psDrive->sPosition.sCurveRef.sTrajFilter.i64Out = 0;
+
+    psDrive->sSpeed.fltSpeedRamp = 0;
+    psDrive->sSpeed.fltSpeedRamp_1 = 0;
+    psDrive->sSpeed.sIqFwdFilter.fltFltBfrX[0] = 0;
+    psDrive->sSpeed.sIqFwdFilter.fltFltBfrY[0] = 0;
+
+    /* Enable PWM output */
+    MCDRV_eFlexPwm3PhOutEnable(psMotor->psPwm3ph);
+
+    /* current and speed controller gains of this start */
+    Mx_SetCtrlGains(psMotor);
+
+    /* To switch to the RUN SPIN sub-state */
+    *psMotor->peStateRun = kRunState_Spin;
+}
+
+/*!
+ * @brief Transition from Align to Ready state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunAlignReady(sm_ref_sol_motor_t *const psMotor)
+{
+    /* Type the code to do when going from the RUN kRunState_Align to the RUN kRunState_Ready sub-state */
+    
+    /* Clear FOC accumulators */
+    Mx_ClearFOCVariables(psMotor);
+
+    /* Go to sub-state RUN READY */
+    *psMotor->peStateRun = kRunState_Ready;
+}
+
+/*!
+ * @brief Transition from Startup to Spin state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunStartupSpin(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when going from the RUN kRunState_Startup to the RUN kRunState_Spin sub-state */
+    /* for FOC control switch open loop off in DQ observer */
+    if(psDrive->eControl!=kControlMode_Scalar)
+    {    
+        psDrive->sFocPMSM.bPosExtOn = FALSE; /* disable passing external electrical position to FOC */
+        psDrive->sFocPMSM.bOpenLoop = FALSE; /* disable parallel running open-loop and estimator */
+    }
+
+    psDrive->sSpeed.sSpeedPiParams.fltIAccK_1 = psDrive->sFocPMSM.sIDQReq.fltQ;
+    psDrive->sSpeed.sSpeedRampParams.fltState = psDrive->sSpeed.fltSpeedFilt;
+    psDrive->sSpeed.fltSpeedRamp = psDrive->sSpeed.fltSpeedFilt;
+    psDrive->sSpeed.fltSpeedRamp_1 = psDrive->sSpeed.fltSpeedFilt;
+    psDrive->sSpeed.sIqFwdFilter.fltFltBfrX[0] = 0;
+    psDrive->sSpeed.sIqFwdFilter.fltFltBfrY[0] = 0;
+
+    /* To switch to the RUN kRunState_Spin sub-state */
+    *psMotor->peStateRun = kRunState_Spin;
+}
+
+/*!
+ * @brief Transition from Startup to Free-wheel state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunStartupFreewheel(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+	MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+
+    /* Free-wheel duration set-up */
+    psDrive->ui16CounterState = psDrive->ui16TimeFullSpeedFreeWheel;
+
+    /* enter FREEWHEEL sub-state */
+    *psMotor->peStateRun = kRunState_Freewheel;
+}
+
+/*!
+ * @brief Transition from Spin to Free-wheel state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunSpinFreewheel(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    /* Type the code to do when going from the RUN SPIN to the RUN FREEWHEEL sub-state */
+    /* set 50% PWM duty cycle */
+    psDrive->sFocPMSM.sDutyABC.f16A = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16B = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16C = FRAC16(0.5);
+
+    psDrive->sFocPMSM.ui16SectorSVM = MX_SVM_SECTOR_DEFAULT;
+
+    MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+
+    /* Generates a time gap before the alignment to assure the rotor is not rotating */
+    psDrive->ui16CounterState = psDrive->ui16TimeFullSpeedFreeWheel;
+
+    psDrive->sFocPMSM.sIDQReq.fltD = 0.0F;
+    psDrive->sFocPMSM.sIDQReq.fltQ = 0.0F;
+
+    psDrive->sFocPMSM.sUDQReq.fltD = 0.0F;
+    psDrive->sFocPMSM.sUDQReq.fltQ = 0.0F;
+
+    psDrive->sFocPMSM.sIAlBe.fltAlpha = 0.0F;
+    psDrive->sFocPMSM.sIAlBe.fltBeta = 0.0F;
+    psDrive->sFocPMSM.sUAlBeReq.fltAlpha = 0.0F;
+    psDrive->sFocPMSM.sUAlBeReq.fltBeta = 0.0F;
+
+    /* enter FREEWHEEL sub-state */
+    *psMotor->peStateRun = kRunState_Freewheel;
+}
+
+/*!
+ * @brief Transition from Free-wheel to Ready state
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_TransRunFreewheelReady(sm_ref_sol_motor_t *const psMotor)
+{
+    /* Type the code to do when going from the RUN kRunState_FreeWheel to the RUN kRunState_Ready sub-state */
+    /* clear application parameters */
+    Mx_ClearFOCVariables(psMotor);
+
+    MCDRV_eFlexPwm3PhOutDisable(psMotor->psPwm3ph);
+
+    /* Sub-state RUN READY */
+    *psMotor->peStateRun = kRunState_Ready;
+}
+
+/*!
+ * @brief Select the current and speed controller gains at motor start
+ *
+ * Gains calculated by the motor identification (or restored from the configuration)
+ * replace the Mx_pmsm_appconfig.h gains. A configured speed gain schedule takes precedence
+ * over the identified speed gains and Mx_SPEED_GAIN_TABLE. The sensorless speed gains are kept, as the
+ * observer rather than the inertia limits the sensorless speed loop bandwidth.
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_SetCtrlGains(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const sm_ref_sol_config_t *const psConfig = psMotor->psConfig;
+    uint16_t ui16Point;
+
+    if((psDrive->sCtrlTuning.ui32Valid & MC_CTRL_TUNING_CURRENT) != 0U)
+    {
+        psDrive->sFocPMSM.sIdPiParams.fltPGain = psDrive->sCtrlTuning.fltDKpGain;
+        psDrive->sFocPMSM.sIdPiParams.fltIGain = psDrive->sCtrlTuning.fltDKiGain;
+        psDrive->sFocPMSM.sIqPiParams.fltPGain = psDrive->sCtrlTuning.fltQKpGain;
+        psDrive->sFocPMSM.sIqPiParams.fltIGain = psDrive->sCtrlTuning.fltQKiGain;
+    }
+    else
+    {
+        psDrive->sFocPMSM.sIdPiParams.fltPGain = psConfig->fltDKpGain;
+        psDrive->sFocPMSM.sIdPiParams.fltIGain = psConfig->fltDKiGain;
+        psDrive->sFocPMSM.sIqPiParams.fltPGain = psConfig->fltQKpGain;
+        psDrive->sFocPMSM.sIqPiParams.fltIGain = psConfig->fltQKiGain;
+    }
+
+    if(psDrive->sMCATctrl.ui16PospeSensor == MCAT_SENSORLESS_CTRL)
+    {
+    	psDrive->sSpeed.fltIqFwdGain = 0; // Disable Iq feedforward in sensorless control
+    	psDrive->sSpeed.sSpeedPiParams.fltPGain = psConfig->fltSpeedPGainSensorless;
+    	psDrive->sSpeed.sSpeedPiParams.fltIGain = psConfig->fltSpeedIGainSensorless;
+    	psDrive->sSpeed.sGainSched.psTable = NULL;
+    }
+    else if((psDrive->sCtrlTuning.ui32Valid & MC_CTRL_TUNING_SPEED_SCHED) != 0U)
+    {
+    	/* configured gain schedule, in the breakpoint format of the speed loop */
+    	for(ui16Point = 0U; ui16Point < (uint16_t)psDrive->sCtrlTuning.ui32SpeedGainPoints; ui16Point++)
+    	{
+    		psDrive->sSpeedGainTable[ui16Point].fltSpeed = psDrive->sCtrlTuning.sSpeedGainSched[ui16Point].fltSpeed;
+    		psDrive->sSpeedGainTable[ui16Point].fltPGain = psDrive->sCtrlTuning.sSpeedGainSched[ui16Point].fltPGain;
+    		psDrive->sSpeedGainTable[ui16Point].fltIGain = psDrive->sCtrlTuning.sSpeedGainSched[ui16Point].fltIGain;
+    	}
+    	psDrive->sSpeed.fltIqFwdGain = psConfig->fltIqFwdGain;
+    	psDrive->sSpeed.sSpeedPiParams.fltPGain = psDrive->sSpeedGainTable[0].fltPGain;
+    	psDrive->sSpeed.sSpeedPiParams.fltIGain = psDrive->sSpeedGainTable[0].fltIGain;
+    	psDrive->sSpeed.sGainSched.psTable = psDrive->sSpeedGainTable;
+    	psDrive->sSpeed.sGainSched.ui16Size = ui16Point;
+    	psDrive->sSpeed.sGainSched.ui16Seg = 0U;
+    }
+    else if((psDrive->sCtrlTuning.ui32Valid & MC_CTRL_TUNING_SPEED) != 0U)
+    {
+    	/* identified gains replace the gain schedule, it was tuned for the configured inertia */
+    	psDrive->sSpeed.fltIqFwdGain = psConfig->fltIqFwdGain;
+    	psDrive->sSpeed.sSpeedPiParams.fltPGain = psDrive->sCtrlTuning.fltSpeedPGain;
+    	psDrive->sSpeed.sSpeedPiParams.fltIGain = psDrive->sCtrlTuning.fltSpeedIGain;
+    	psDrive->sSpeed.sGainSched.psTable = NULL;
+    }
+    else
+    {
+    	psDrive->sSpeed.fltIqFwdGain = psConfig->fltIqFwdGain;
+    	psDrive->sSpeed.sSpeedPiParams.fltPGain = psConfig->fltSpeedPGain;
+    	psDrive->sSpeed.sSpeedPiParams.fltIGain = psConfig->fltSpeedIGain;
+    	psDrive->sSpeed.sGainSched.psTable = psConfig->psSpeedGainTable;
+    	psDrive->sSpeed.sGainSched.ui16Size = psConfig->ui16SpeedGainTableSize;
+    	psDrive->sSpeed.sGainSched.ui16Seg = 0U;
+    }
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltPGain = psDrive->sSpeed.sSpeedPiParams.fltPGain;
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltIGain = psDrive->sSpeed.sSpeedPiParams.fltIGain;
+}
+
+/*!
+ * @brief Clear FOc variables in global variable
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_ClearFOCVariables(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+    psDrive->sAlignment.ui16TimeHalf = 0U;
+
+    /* Clear FOC variables */
+    psDrive->sFocPMSM.sIABC.fltA = 0.0F;
+    psDrive->sFocPMSM.sIABC.fltB = 0.0F;
+    psDrive->sFocPMSM.sIABC.fltC = 0.0F;
+    psDrive->sFocPMSM.sIAlBe.fltAlpha = 0.0F;
+    psDrive->sFocPMSM.sIAlBe.fltBeta = 0.0F;
+    psDrive->sFocPMSM.sIDQ.fltD = 0.0F;
+    psDrive->sFocPMSM.sIDQ.fltQ = 0.0F;
+    psDrive->sFocPMSM.sIDQReq.fltD = 0.0F;
+    psDrive->sFocPMSM.sIDQReq.fltQ = 0.0F;
+    psDrive->sFocPMSM.sIDQError.fltD = 0.0F;
+    psDrive->sFocPMSM.sIDQError.fltQ = 0.0F;
+    psDrive->sFocPMSM.sDutyABC.f16A = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16B = FRAC16(0.5);
+    psDrive->sFocPMSM.sDutyABC.f16C = FRAC16(0.5);
+    psDrive->sFocPMSM.sUAlBeReq.fltAlpha = 0.0F;
+    psDrive->sFocPMSM.sUAlBeReq.fltBeta = 0.0F;
+    psDrive->sFocPMSM.sUDQReq.fltD = 0.0F;
+    psDrive->sFocPMSM.sUDQReq.fltQ = 0.0F;
+    psDrive->sFocPMSM.sAnglePosEl.fltSin = 0.0F;
+    psDrive->sFocPMSM.sAnglePosEl.fltCos = 0.0F;
+    psDrive->sFocPMSM.sAnglePosEl.fltSin = 0.0F;
+    psDrive->sFocPMSM.sAnglePosEl.fltCos = 0.0F;
+    psDrive->sFocPMSM.sIdPiParams.bLimFlag = FALSE;
+    psDrive->sFocPMSM.sIqPiParams.bLimFlag = FALSE;
+    psDrive->sFocPMSM.sIdPiParams.fltIAccK_1 = 0.0F;
+    psDrive->sFocPMSM.sIdPiParams.fltIAccK_1 = 0.0F;
+    psDrive->sFocPMSM.sIqPiParams.fltIAccK_1 = 0.0F;
+    psDrive->sFocPMSM.sIqPiParams.fltIAccK_1 = 0.0F;
+    GDFLIB_FilterIIR1Init_FLT(&psDrive->sFocPMSM.sSpeedElEstFilt);
+    psDrive->sFocPMSM.bIdPiStopInteg = FALSE;
+    psDrive->sFocPMSM.bIqPiStopInteg = FALSE;
+
+    /* Clear Speed control state variables */
+    psDrive->sSpeed.sSpeedRampParams.fltState = 0.0F;
+    psDrive->sSpeed.fltSpeed = 0.0F;
+    psDrive->sSpeed.fltSpeedFilt = 0.0F;
+    psDrive->sSpeed.fltSpeedError = 0.0F;
+    psDrive->sSpeed.fltSpeedRamp = 0.0F;
+    psDrive->sSpeed.sSpeedPiParams.fltIAccK_1 = 0.0F;
+    psDrive->sSpeed.sSpeedPiParams.bLimFlag = FALSE;
+    psDrive->sSpeed.sSpeedFilter.fltFltBfrX[0] = 0.0F;
+    psDrive->sSpeed.sSpeedFilter.fltFltBfrY[0] = 0.0F;
+    psDrive->sSpeed.bSpeedPiStopInteg = FALSE;
+    GDFLIB_FilterIIR1Init_FLT(&psDrive->sSpeed.sSpeedFilter);
+    PIControllerDesatInit(&psDrive->sSpeed.sSpeedPiParamsDesat);
+
+    /* Clear field weakening, the speed controller output limits return to the current limit */
+    AMCLIB_CtrlFluxWkngInit_FLT(0.0F, &psDrive->sFieldWeak.sFwCtrl);
+    psDrive->sFieldWeak.fltIdMtpa = 0.0F;
+    psDrive->sFieldWeak.fltIdFw = 0.0F;
+    psDrive->sFieldWeak.fltIdFwMin = 0.0F;
+    psDrive->sFieldWeak.bFwStopInteg = FALSE;
+    psDrive->sSpeed.sSpeedPiParams.fltUpperLim = psDrive->sFieldWeak.fltIMax;
+    psDrive->sSpeed.sSpeedPiParams.fltLowerLim = MLIB_Neg_FLT(psDrive->sFieldWeak.fltIMax);
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltUpperLim = psDrive->sFieldWeak.fltIMax;
+    psDrive->sSpeed.sSpeedPiParamsDesat.sCoeff.fltLowerLim = MLIB_Neg_FLT(psDrive->sFieldWeak.fltIMax);
+
+    /* Init Blocked rotor filter */
+    GDFLIB_FilterMAInit_FLT(0.0F, psMotor->psBlockedRotorUqFilt);
+
+    /* Clear Scalar control variables */
+    psDrive->sScalarCtrl.fltFreqRamp = 0.0F;
+    psDrive->sScalarCtrl.f16PosElScalar = 0.0F;
+    psDrive->sScalarCtrl.sUDQReq.fltD = 0.0F;
+    psDrive->sScalarCtrl.sUDQReq.fltQ = 0.0F;
+    psDrive->sScalarCtrl.sFreqIntegrator.f32IAccK_1 = 0;
+    psDrive->sScalarCtrl.sFreqIntegrator.f16InValK_1 = 0;
+    psDrive->sScalarCtrl.sFreqRampParams.fltState = 0.0F;
+
+    /* Clear Startup variables */
+    psDrive->sStartUp.f16PosMerged = 0;
+    psDrive->sStartUp.f16PosEst = 0;
+    psDrive->sStartUp.f16PosGen = 0;
+    psDrive->sStartUp.f16RatioMerging = 0;
+    psDrive->sStartUp.fltSpeedRampOpenLoop = 0.0F;
+    psDrive->sStartUp.fltSpeedReq = 0.0F;
+    psDrive->sStartUp.sSpeedIntegrator.f32IAccK_1 = 0;
+    psDrive->sStartUp.sSpeedIntegrator.f16InValK_1 = 0;
+    psDrive->sStartUp.sSpeedRampOpenLoopParams.fltState = 0.0F;
+
+    BSF_init(&psDrive->sPosition.sNotchFilter);
+
+    /* Clear BEMF and Tracking observers state variables */
+    AMCLIB_PMSMBemfObsrvDQInit_A32fff(&psDrive->sFocPMSM.sBemfObsrv);
+    AMCLIB_TrackObsrvInit_A32af(ACC32(0.0), &psDrive->sFocPMSM.sTo);
+
+    /* Restart the parameter estimator filters, the estimates survive the stop */
+    MCS_PMSMParamEstRestart(&psDrive->sParamEst);
+}
+
+/*!
+ * @brief Fault detention routine - check various faults
+ *
+ * @param psMotor  Motor context
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL static void Mx_FaultDetection(sm_ref_sol_motor_t *const psMotor)
+{
+    mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+    const mcdef_fault_thresholds_t *const psThresholds = &psDrive->sFaultThresholds;
+    /* Copy of the GD3000 status 0, refreshed by the board service task */
+    const gd3000SR0_t uStatus0 = psMotor->psGD3000->sStatus.uStatus0;
+    const float_t fltUDcBusFilt = psDrive->sFocPMSM.fltUDcBusFilt;
+    uint32_t ui32Reset = 0U, ui32LowVls = 0U, ui32UOver = 0U, ui32UUnder = 0U;
+    uint32_t ui32PwmFault;
+    uint32_t ui32LoadOver = 0U, ui32SpeedOver = 0U, ui32RotorBlocked = 0U;
+    float_t fltSpeedFiltAbs, fltSpeedRampAbs;
+    mcdef_fault_t sFaultId = 0U;
+
+    ui32PwmFault = (uint32_t)(MCDRV_eFlexPwm3PhFaultGet(psMotor->psPwm3ph) != FALSE);
+
+    /* The faults are detected again in every call; a single test skips the evaluation when none is present */
+    if ((psMotor->psGD3000->ui8ResetRequest != 0U) || ((uStatus0.ui8R & FAULT_GD3000_SR0_MASK) != 0U) ||
+        (ui32PwmFault != 0U) || (fltUDcBusFilt > psThresholds->fltUDcBusOver) ||
+        (fltUDcBusFilt < psThresholds->fltUDcBusUnder))
+    {
+        /* Each condition is evaluated to 0 or 1 and masked into the fault word */
+        ui32Reset = (uint32_t)(psMotor->psGD3000->ui8ResetRequest != 0U);
+        ui32LowVls = (uint32_t)uStatus0.B.lowVls;
+        ui32UOver = (uint32_t)(fltUDcBusFilt > psThresholds->fltUDcBusOver);
+        ui32UUnder = (uint32_t)(fltUDcBusFilt < psThresholds->fltUDcBusUnder);
+
+        sFaultId = FAULT_BIT(ui32Reset, FAULT_GD3000_IN_RESET) |
+                   FAULT_BIT(uStatus0.B.overCurrent, FAULT_GD3000_OC) |
+                   FAULT_BIT(ui32LowVls, FAULT_GD3000_VLS_UV) |
+                   FAULT_BIT(uStatus0.B.overTemp, FAULT_GD3000_OT) |
+                   FAULT_BIT(uStatus0.B.phaseErr, FAULT_GD3000_PHASE_ERR) |
+                   FAULT_BIT(uStatus0.B.desaturation, FAULT_GD3000_DESAT) |
+                   FAULT_BIT(ui32PwmFault, FAULT_I_DCBUS_OVER) |
+                   FAULT_BIT(ui32UOver, FAULT_U_DCBUS_OVER) |
+                   FAULT_BIT(ui32UUnder, FAULT_U_DCBUS_UNDER);
+
+        /* GD3000 VLS under voltage and DC-bus under-voltage reset the GD3000 */
+        if ((ui32LowVls | ui32UUnder) != 0U)
+        {
+            psMotor->psGD3000->ui8ResetRequest = 1U;
+        }
+    }
+
+    /* Check only in SPEED_FOC control, RUN state, kRunState_Spin and kRunState_FreeWheel sub-states */
+    if((psDrive->eControl==kControlMode_SpeedFOC) && 
+       (psMotor->psCtrl->eState==kSM_AppRun) && 
+       (*psMotor->peStateRun==kRunState_Spin || *psMotor->peStateRun==kRunState_Freewheel) &&
+       (psDrive->sMCATctrl.ui16PospeSensor==MCAT_SENSORLESS_CTRL))
+    {
+        fltSpeedFiltAbs = MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedFilt);
+        fltSpeedRampAbs = MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedRamp);
+
+        /* Fault: Overload  */
+        if ((fltSpeedFiltAbs < psThresholds->fltSpeedMin) && (fltSpeedRampAbs > psThresholds->fltSpeedMin) &&
+            (psDrive->sSpeed.bSpeedPiStopInteg == TRUE))
+        {
+            ui32LoadOver = 1U;
+        }
+
+        /* Fault: Over-speed  */
+        if ((fltSpeedFiltAbs > psThresholds->fltSpeedOver) &&
+            (MLIB_Abs_FLT(psDrive->sSpeed.fltSpeedCmd) > psThresholds->fltSpeedMin))
+        {
+            ui32SpeedOver = 1U;
+        }
+
+        /* Fault: Blocked rotor detection */
+        /* filter of bemf Uq voltage */
+        psDrive->fltBemfUqAvg = GDFLIB_FilterMA_FLT(psDrive->sFocPMSM.sBemfObsrv.sEObsrv.fltQ,
+                                                      psMotor->psBlockedRotorUqFilt);
+        /* check the bemf Uq voltage threshold only in kRunState_Spin - RUN state */
+        if ((MLIB_Abs_FLT(psDrive->fltBemfUqAvg) < psThresholds->fltUqBemf) &&
+            (*psMotor->peStateRun == kRunState_Spin))
+        {
+            psDrive->ui16BlockRotorCnt++;
+        }
+        else
+        {
+            psDrive->ui16BlockRotorCnt = 0U;
+        }
+        /* for bemf voltage detected below limit longer than defined period number set blocked rotor fault */
+        if (psDrive->ui16BlockRotorCnt > psThresholds->ui16BlockedPerNum)
+        {
+            ui32RotorBlocked = 1U;
+            psDrive->ui16BlockRotorCnt = 0U;
+        }
+
+        sFaultId |= FAULT_BIT(ui32LoadOver, FAULT_LOAD_OVER) |
+                    FAULT_BIT(ui32SpeedOver, FAULT_SPEED_OVER) |
+                    FAULT_BIT(ui32RotorBlocked, FAULT_ROTOR_BLOCKED);
+    }
+
+    /* pass fault to Fault ID Pending and Captured */
+    psDrive->sFaultIdPending = sFaultId;
+    psDrive->sFaultIdCaptured |= sFaultId;
+
+    /* pass fault to the captured external faults, only when there is a fault */
+    if (sFaultId != 0U)
+    {
+        psDrive->ui32FaultIdCapturedExt |= FAULT_EXT_BIT(ui32Reset, kMC_GD3000_Reset) |
+                                           FAULT_EXT_BIT(uStatus0.B.overCurrent, kMC_GD3000_OverCurrent) |
+                                           FAULT_EXT_BIT(ui32LowVls, kMC_GD3000_LowVLS) |
+                                           FAULT_EXT_BIT(uStatus0.B.overTemp, kMC_GD3000_OverTemperature) |
+                                           FAULT_EXT_BIT(uStatus0.B.phaseErr, kMC_GD3000_PhaseError) |
+                                           FAULT_EXT_BIT(uStatus0.B.desaturation, kMC_GD3000_Desaturation) |
+                                           FAULT_EXT_BIT(ui32PwmFault, kMC_OverCurrent) |
+                                           FAULT_EXT_BIT(ui32UOver, kMC_OverDcBusVoltage) |
+                                           FAULT_EXT_BIT(ui32UUnder, kMC_UnderDcBusVoltage) |
+                                           FAULT_EXT_BIT(ui32LoadOver | ui32RotorBlocked, kMC_OverLoad) |
+                                           FAULT_EXT_BIT(ui32SpeedOver, kMC_OverSpeed);
+    }
+}
+
+
+
+
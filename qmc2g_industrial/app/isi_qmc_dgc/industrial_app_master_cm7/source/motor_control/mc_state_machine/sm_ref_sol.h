@@ -0,0 +1,243 @@
+/*
+ * Copyright 2022-2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#ifndef SM_REF_SOL_H
+#define SM_REF_SOL_H
+
+#include "sm_ref_sol_comm.h"
+#include "state_machine.h"
+#include "mcinit_qmc2g_imxrt1170.h"
+#include "qmc_features_config.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define MCAT_SENSORLESS_CTRL 0 /* Sensorless control flag */
+#define MCAT_ENC_CTRL 1 /* Position quadrature encoder control flag */
+
+/*! @brief Motor specific constants of the state machine, filled from the Mx_pmsm_appconfig.h macros */
+typedef struct sm_ref_sol_config
+{
+    /* Current loop */
+    float_t fltDKpGain;                              /* Mx_D_KP_GAIN */
+    float_t fltDKiGain;                              /* Mx_D_KI_GAIN */
+    float_t fltQKpGain;                              /* Mx_Q_KP_GAIN */
+    float_t fltQKiGain;                              /* Mx_Q_KI_GAIN */
+    float_t fltCloopFreq;                            /* Mx_CLOOP_FREQ, also the bandwidth of the identification tuning */
+    float_t fltCloopAtt;                             /* Mx_CLOOP_ATT */
+    float_t fltUMax;                                 /* Mx_U_MAX, also the FreeMASTER voltage scale */
+    float_t fltCloopLimit;                           /* Mx_CLOOP_LIMIT */
+    GDFLIB_FILTER_IIR1_COEFF_T_FLT sUDcBusFiltCoeff; /* Mx_UDCB_IIR_B0, B1, A1 */
+    mcdef_fault_thresholds_t sFaultThresholds;       /* Mx_U_DCB_OVERVOLTAGE, ..., Mx_E_BLOCK_PER */
+    float_t fltBlockedRotorLambda;                   /* Mx_BLOCK_ROT_FAULT_SH */
+
+    /* Alignment */
+    float_t fltAlignVoltage;                         /* Mx_ALIGN_VOLTAGE */
+    uint16_t ui16AlignDuration;                      /* Mx_ALIGN_DURATION */
+    uint16_t ui16BootstrapChargeDuration;            /* Mx_BOOTSTRAP_CHARGE_DURATION */
+    frac16_t f16BootstrapDuty;                       /* FRAC16(Mx_BOOTSTRAP_DUTY) */
+
+    /* Position and speed observer */
+    float_t fltToKpGain;                             /* Mx_BEMF_DQ_TO_KP_GAIN */
+    float_t fltToKiGain;                             /* Mx_BEMF_DQ_TO_KI_GAIN */
+    float_t fltToThGain;                             /* Mx_BEMF_DQ_TO_THETA_GAIN */
+    float_t fltBemfIGain;                            /* Mx_I_SCALE */
+    float_t fltBemfUGain;                            /* Mx_U_SCALE */
+    float_t fltBemfEGain;                            /* Mx_E_SCALE */
+    float_t fltBemfWIGain;                           /* Mx_WI_SCALE */
+    float_t fltBemfKpGain;                           /* Mx_BEMF_DQ_KP_GAIN */
+    float_t fltBemfKiGain;                           /* Mx_BEMF_DQ_KI_GAIN */
+    GDFLIB_FILTER_IIR1_COEFF_T_FLT sSpeedElEstFiltCoeff; /* Mx_TO_SPEED_IIR_B0, B1, A1 */
+    mcs_param_est_coeff_t sParamEstCoeff;            /* Mx_R, Mx_FLUX, Mx_PARAM_EST_* */
+
+    /* Speed loop */
+    float_t fltSpeedPGain;                           /* Mx_SPEED_PI_PROP_GAIN */
+    float_t fltSpeedIGain;                           /* Mx_SPEED_PI_INTEG_GAIN */
+    float_t fltSpeedPGainSensorless;                 /* Mx_SPEED_PI_PROP_SENSORLESS_GAIN */
+    float_t fltSpeedIGainSensorless;                 /* Mx_SPEED_PI_INTEG_SENSORLESS_GAIN */
+    float_t fltSloopFreq;                            /* Mx_SLOOP_FREQ */
+    float_t fltSloopAtt;                             /* Mx_SLOOP_ATT */
+    float_t fltSpeedDesatGain;                       /* Mx_SPEED_PI_DESAT_GAIN */
+    const mcs_speed_gain_point_t *psSpeedGainTable;  /* Mx_SPEED_GAIN_TABLE, NULL for the fixed gains */
+    uint16_t ui16SpeedGainTableSize;                 /* Mx_SPEED_GAIN_TABLE rows */
+    float_t fltSpeedUpperLim;                        /* Mx_SPEED_LOOP_HIGH_LIMIT */
+    float_t fltSpeedLowerLim;                        /* Mx_SPEED_LOOP_LOW_LIMIT */
+    float_t fltSpeedRampUp;                          /* Mx_SPEED_RAMP_UP */
+    float_t fltSpeedRampDown;                        /* Mx_SPEED_RAMP_DOWN */
+    GDFLIB_FILTER_IIR1_COEFF_T_FLT sSpeedFiltCoeff;  /* Mx_SPEED_IIR_B0, B1, A1 */
+    GDFLIB_FILTER_IIR1_COEFF_T_FLT sIqFwdFiltCoeff;  /* Mx_CUR_FWD_IIR_B0, B1, A1 */
+    float_t fltIqFwdGain;                            /* Mx_SPEED_LOOP_IQ_FWD_GAIN */
+
+    /* MTPA and field weakening */
+    bool_t bFwOn;                                    /* Mx_FW_ON */
+    float_t fltFwUqLimGain;                          /* Mx_FW_U_LIM_GAIN */
+    float_t fltFwIdMin;                              /* Mx_FW_ID_MIN */
+    float_t fltFwUToIdGain;                          /* Mx_FW_U_TO_ID_GAIN */
+    float_t fltFwKpGain;                             /* Mx_FW_KP_GAIN */
+    float_t fltFwKiGain;                             /* Mx_FW_KI_GAIN */
+    GDFLIB_FILTER_IIR1_COEFF_T_FLT sFwIqErrFiltCoeff; /* Mx_FW_IQ_ERR_IIR_B0, B1, A1 */
+    float_t fltMtpaLqLdDiff;                         /* Mx_MTPA_LQ_LD_DIFF */
+
+    /* Position loop */
+    frac32_t f32TrajFilterW;                         /* Mx_QDC_TRAJECTORY_FILTER_FREQ_FRAC */
+    frac16_t f16SpeedRefLim;                         /* Mx_QDC_POSITION_CTRL_LIMIT_FRAC */
+    float_t fltSpeedRefLim;                          /* Mx_QDC_POSITION_CTRL_LIMIT */
+    frac32_t f32PosRampUp;                           /* Mx_QDC_POSITION_RAMP_UP_FRAC */
+    frac32_t f32PosRampDown;                         /* Mx_QDC_POSITION_RAMP_DOWN_FRAC */
+    acc32_t a32PosGain;                              /* Mx_QDC_POSITION_CTRL_P_GAIN_FRAC */
+    float_t fltFreqToAngularSpeedCoeff;              /* 2*PI*Mx_MOTOR_PP */
+    float_t fltFracToAngularSpeedCoeff;              /* Mx_SPEED_FRAC_TO_ANGULAR_COEFF */
+    float_t fltRpmToAngularSpeedCoeff;               /* Mx_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF */
+    float_t fltGainSpeedFwd;                         /* Mx_QDC_POSITION_CTRL_SPEED_FWD_GAIN */
+    float_t fltGainAccFwd;                           /* Mx_QDC_POSITION_CTRL_ACC_FWD_GAIN */
+
+    /* Scalar control and open loop start-up */
+    float_t fltVHzGain;                              /* Mx_SCALAR_VHZ_FACTOR_GAIN */
+    float_t fltScalarRampUp;                         /* Mx_SCALAR_RAMP_UP */
+    float_t fltScalarRampDown;                       /* Mx_SCALAR_RAMP_DOWN */
+    acc32_t a32ScalarIntegGain;                      /* Mx_SCALAR_INTEG_GAIN */
+    float_t fltFreqMax;                              /* Mx_FREQ_MAX */
+    float_t fltQdcSpeedScale;                        /* 2*FLOAT_PI*Mx_FREQ_MAX */
+    frac16_t f16CoeffMerging;                        /* Mx_MERG_COEFF */
+    float_t fltSpeedCatchUp;                         /* Mx_MERG_SPEED_TRH */
+    float_t fltCurrentStartup;                       /* Mx_OL_START_I */
+    float_t fltOpenLoopRampInc;                      /* Mx_OL_START_RAMP_INC */
+    float_t fltSpeedMax;                             /* Mx_RAD_MAX */
+
+    /* Application timing */
+    uint16_t ui16TimeFullSpeedFreeWheel;             /* Mx_FREEWHEEL_DURATION */
+    uint16_t ui16TimeCalibration;                    /* Mx_CALIB_DURATION */
+    uint16_t ui16TimeFaultRelease;                   /* Mx_FAULT_DURATION */
+    uint16_t ui16FastCtrlLoopFreq;                   /* Mx_PWM_FREQ/Mx_FOC_FREQ_VS_PWM_FREQ */
+    uint16_t ui16SlowCtrlLoopFreq;                   /* Mx_SLOW_LOOP_FREQ */
+
+    /* FreeMASTER scales */
+    float_t fltIMax;                                 /* Mx_I_MAX */
+    float_t fltUDcBusMax;                            /* Mx_U_DCB_MAX */
+    float_t fltNMax;                                 /* Mx_N_MAX */
+    float_t fltSpeedAngularScale;                    /* Mx_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF */
+
+    /* Quadrature decoder */
+    GDFLIB_FILTER_IIR1_COEFF_T_F32 sQdcSpeedFiltCoeff; /* Mx_QDC_SPEED_FILTER_IIR_B0_FRAC, B1, A1 */
+
+#if FEATURE_MC_LOOP_BANDWIDTH_TEST_ENABLE
+    float_t fltFastLoopFreq;                         /* Mx_FAST_LOOP_FREQ */
+#endif
+} sm_ref_sol_config_t;
+
+/*!
+ * @brief Sinusoidal command generators for the loop bandwidth tests - for debug only
+ *
+ * Points to the per-motor globals of the mx_sm_ref_sol.c files (e.g. ui16SinSpeedCmdSwitchM1),
+ * which the FreeMASTER projects access by name.
+ */
+typedef struct sm_ref_sol_loop_test
+{
+    /* Speed loop bandwidth test */
+    volatile uint16_t *pui16SinSpeedCmdSwitch; /* A switch to turn on/off speed loop bandwidth test in speed FOC mode */
+    volatile frac32_t *pf32Angle;
+    volatile frac32_t *pf32FreqIn;             /* Frequency of sinusoidal speed command */
+    volatile float_t *pfltSin;                 /* Sin() of speed command frequency */
+    volatile float_t *pfltSpeedCmdAmplitude;   /* Amplitude of sinusoidal speed command */
+    volatile float_t *pfltSpeedCmdTest;        /* Sinusoidal speed command */
+
+    /* Current loop bandwidth test */
+    volatile uint16_t *pui16SinCurrentCmdSwitch; /* A switch to turn on/off current loop bandwidth test in current FOC mode */
+    volatile frac32_t *pf32AngleCur;
+    volatile frac32_t *pf32FreqInCur;            /* Frequency of sinusoidal current command */
+    volatile float_t *pfltSinCur;                /* Sin() of current command frequency */
+    volatile float_t *pfltCurrentCmdAmplitude;   /* Amplitude of sinusoidal current command */
+    volatile float_t *pfltCurrentCmdTest;        /* Sinusoidal current command */
+
+    /* Position loop bandwidth test */
+    volatile uint16_t *pui16SinPosCmdSwitch;     /* A switch to turn on/off position loop bandwidth test in position FOC mode */
+    volatile frac32_t *pf32AnglePos;
+    volatile frac32_t *pf32FreqInPos;            /* Frequency of sinusoidal position command */
+    volatile frac16_t *pf16SinPos;               /* Sin() of position command frequency */
+    volatile int32_t *pi32Q16PosCmdAmplitude;    /* Amplitude of sinusoidal position command */
+    volatile int32_t *pi32Q16PosCmdTest;         /* Sinusoidal position command */
+} sm_ref_sol_loop_test_t;
+
+/*! @brief Links the loop bandwidth tests to the globals of the motor with the name suffix Mx (M1..M4) */
+#define SM_REF_SOL_LOOP_TEST_INIT(Mx)                                                                  \
+    {                                                                                                  \
+        .pui16SinSpeedCmdSwitch = &ui16SinSpeedCmdSwitch##Mx, .pf32Angle = &f32Angle##Mx,              \
+        .pf32FreqIn = &f32FreqIn##Mx, .pfltSin = &fltSin##Mx,                                          \
+        .pfltSpeedCmdAmplitude = &fltSpeedCmdAmplitude##Mx, .pfltSpeedCmdTest = &fltSpeedCmdTest##Mx,  \
+        .pui16SinCurrentCmdSwitch = &ui16SinCurrentCmdSwitch##Mx, .pf32AngleCur = &f32AngleCur##Mx,    \
+        .pf32FreqInCur = &f32FreqInCur##Mx, .pfltSinCur = &fltSinCur##Mx,                              \
+        .pfltCurrentCmdAmplitude = &fltCurrentCmdAmplitude##Mx,                                        \
+        .pfltCurrentCmdTest = &fltCurrentCmdTest##Mx,                                                  \
+        .pui16SinPosCmdSwitch = &ui16SinPosCmdSwitch##Mx, .pf32AnglePos = &f32AnglePos##Mx,            \
+        .pf32FreqInPos = &f32FreqInPos##Mx, .pf16SinPos = &f16SinPos##Mx,                              \
+        .pi32Q16PosCmdAmplitude = &i32Q16PosCmdAmplitude##Mx, .pi32Q16PosCmdTest = &i32Q16PosCmdTest##Mx \
+    }
+
+/*! @brief Per-motor context of the state machine - configuration, peripherals and control state */
+typedef struct sm_ref_sol_motor
+{
+    const sm_ref_sol_config_t *psConfig;          /* Motor specific constants */
+    mcdef_pmsm_t *psDrive;                        /* Main control structure, g_sMxDrive */
+    sm_app_ctrl_t *psCtrl;                        /* Application state machine, g_sMxCtrl */
+    run_substate_t *peStateRun;                   /* Run sub-state, g_eMxStateRun */
+    bool_t *pbSwitchAppOnOff;                     /* Main application switch, g_bMxSwitchAppOnOff */
+    mcdrv_adc_t *psAdcSensor;                     /* ADC driver, g_sMxAdcSensor */
+    mcdrv_pwm3ph_pwma_t *psPwm3ph;                /* PWM driver, g_sMxPwm3ph */
+    qdc_block_t *psQdcSensor;                     /* Quadrature decoder driver, g_sMxQdcSensor */
+    GD3000_t *psGD3000;                           /* Gate driver, g_sMxGD3000 */
+    GDFLIB_FILTER_MA_T_FLT *psBlockedRotorUqFilt; /* Blocked rotor detection filter inside psDrive */
+    volatile float *pfltVoltageScale;             /* FreeMASTER scales, g_fltMx...Scale */
+    volatile float *pfltDCBvoltageScale;
+    volatile float *pfltCurrentScale;
+    volatile float *pfltSpeedScale;
+    volatile float *pfltSpeedAngularScale;
+    mc_motor_id_t eMotorId;                       /* Motor index used by the fault handling */
+    volatile uint16_t *pui16PWMOutputDebugFlag;   /* Output the PWM in the READY sub-state, ui16PWMOutputDebugFlagMx */
+    sm_ref_sol_loop_test_t sLoopTest;             /* Loop bandwidth tests - for debug only */
+} sm_ref_sol_motor_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/*
+ * Motor independent implementation of the application states and transitions. The m1..m4_sm_ref_sol.c
+ * files instantiate sm_ref_sol_motor_t for their motor and register thin wrappers of these functions
+ * in their sm_app_ctrl_t.
+ */
+
+RAM_FUNC_CRITICAL void Mx_StateFaultFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_StateInitFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_StateStopFast(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_StateRunFast(sm_ref_sol_motor_t *const psMotor);
+
+RAM_FUNC_CRITICAL void Mx_StateFaultSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_StateInitSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_StateStopSlow(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_StateRunSlow(sm_ref_sol_motor_t *const psMotor);
+
+RAM_FUNC_CRITICAL void Mx_TransFaultStop(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_TransInitFault(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_TransInitStop(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_TransStopFault(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_TransStopRun(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_TransRunFault(sm_ref_sol_motor_t *const psMotor);
+RAM_FUNC_CRITICAL void Mx_TransRunStop(sm_ref_sol_motor_t *const psMotor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SM_REF_SOL_H */
@@ -63,11 +63,15 @@ typedef struct mcdef_pmsm
 {
     mcs_pmsm_foc_t sFocPMSM;                    /* Field Oriented Control structure */
     mcs_speed_t sSpeed;                         /* Speed control loop structure */
+    mcs_pmsm_fw_t sFieldWeak;                   /* MTPA and field weakening, the d-axis current request */
     mcs_position_t sPosition;                   /* Position control loop structure */
     mcs_pmsm_startup_t sStartUp;                /* Open loop start-up */
     mcs_alignment_t sAlignment;                 /* PMSM simple two-step Ud voltage alignment */
     mcs_mcat_ctrl_t sMCATctrl;                  /* Structure containing control variables directly updated from MCAT */
     mcs_pmsm_scalar_ctrl_t sScalarCtrl;         /* Scalar control structure */
+    mcs_param_est_t sParamEst;                  /* Online resistance and flux estimator */
+    mc_ctrl_tuning_t sCtrlTuning;               /* Controller gains from the identification or the configuration */
+    mcs_speed_gain_point_t sSpeedGainTable[MC_SPEED_GAIN_SCHED_MAX_POINTS]; /* Speed gain schedule of sCtrlTuning in use */
     mcdef_fault_t sFaultIdCaptured;                /* Captured faults (must be cleared manually) */
     mcdef_fault_t sFaultIdPending;                 /* Fault pending structure */
     mcdef_fault_thresholds_t sFaultThresholds;     /* Fault thresholds */
@@ -109,6 +113,15 @@ typedef struct mcdef_pmsm
 /* Sets the fault bit defined by faultid in the faults variable */
 #define FAULT_SET(faults, faultid) (faults |= ((mcdef_fault_t)1 << faultid))
 
+/* Fault bit defined by faultid if cond is 1, no bit if cond is 0 */
+#define FAULT_BIT(cond, faultid) ((mcdef_fault_t)((mcdef_fault_t)(cond) << (faultid)))
+
+/* External fault mask ext (mc_fault_t) if cond is 1, 0 if cond is 0 */
+#define FAULT_EXT_BIT(cond, ext) ((0U - (uint32_t)(cond)) & (uint32_t)(ext))
+
+/* GD3000 status register 0 flags handled as faults: overTemp, desaturation, lowVls, overCurrent and phaseErr */
+#define FAULT_GD3000_SR0_MASK (0x1FU)
+
 /* Clears the fault bit defined by faultid in the faults variable */
 #define FAULT_CLEAR(faults, faultid) (faults &= ~((mcdef_fault_t)1 << faultid))
 
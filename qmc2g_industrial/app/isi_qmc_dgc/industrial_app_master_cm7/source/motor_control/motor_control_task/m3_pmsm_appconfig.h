@@ -62,6 +62,7 @@
 #define M3_LQ				(0.0002)	  /* [H], q-axis inductance */
 #define M3_R				(0.36)	  /* [ohm], phase resistance */
 #define M3_ENCODER_LINES	(1000)	  	 /* Encoder lines per mechanical revolution */
+#define M3_FLUX				(0.0047)  /* [Wb], permanent magnet flux linkage, online parameter estimator */
 #endif
 
 #ifdef M3_M_2311S_LN_08K
@@ -69,6 +70,7 @@
 #define M3_LQ				(0.001465)	  /* [H], q-axis inductance */
 #define M3_R				(1.38)	  /* [ohm], phase resistance */
 #define M3_ENCODER_LINES	(2000)	  	 /* Encoder lines per mechanical revolution */
+#define M3_FLUX				(0.0155)  /* [Wb], permanent magnet flux linkage, online parameter estimator */
 #endif
 
 #define M3_N_NOM 			(6000.0F) /* [RPM], motor nominal mechanical speed */
@@ -172,12 +174,18 @@
 #define M3_SPEED_PI_INTEG_GAIN             (0.0002F)//(0.00065685F)	/* integral gain */
 #define M3_SPEED_PI_PROP_SENSORLESS_GAIN              (0.005F)		/* proportional gain */
 #define M3_SPEED_PI_INTEG_SENSORLESS_GAIN             (0.00002F)	/* integral gain */
+#define M3_SLOOP_ATT                       (1.0F)           /* attenuation of the speed loop tuned from the identified inertia */
+#define M3_SLOOP_FREQ                      (20.0F)          /* [Hz], oscillating frequency of the speed loop tuned from the identified inertia, 0 disables the tuning */
 #define M3_SPEED_PI_DESAT_GAIN			   (0.5F)
 #define M3_SPEED_LOOP_HIGH_LIMIT           (7.0F)			/* [A], current output upper limitation */
 #define M3_SPEED_LOOP_LOW_LIMIT            (-7.0F)			/* [A], current output lower limitation */
 #define M3_CL_SPEED_RAMP			   	   (4000.0F) 		/* [RPM/s], (mechanical) speed accelerating rate during closed-loop */
 #define M3_SPEED_CUTOFF_FREQ    		   (10.0F)          /* [Hz], cutoff frequency of IIR1 low pass filter for speed from sensor or observer */
 #define M3_SPEED_LOOP_IQ_FWD_GAIN 		   (0.5F)		    /* [A], Iq feed forward gain */
+/* Speed PI gain schedule for encoder control, rows {|speed| [rad/s] electrical, Kp, Ki} in ascending speed.
+   The gains are interpolated between the rows and held outside, the fixed gains above apply when undefined.
+   A schedule in the M3_ctrl_tuning configuration record (MC_SetControllerTuning) replaces this one at run time. */
+//#define M3_SPEED_GAIN_TABLE {{70.0F*M3_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, 0.025F, 0.0002F}, {120.0F*M3_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, 0.03F, 0.00025F}, {1000.0F*M3_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, 0.035F, 0.00025F}}
 
 #define M3_CUR_FWD_CUTOFF_FREQ  		   (160.0F)   /* [Hz], cutoff frequency of IIR1 low pass filter */
 
@@ -193,6 +201,22 @@
 #define M3_SPEED_IIR_B1				       WARP(M3_SPEED_CUTOFF_FREQ, M3_SLOW_LOOP_FREQ)/(WARP(M3_SPEED_CUTOFF_FREQ, M3_SLOW_LOOP_FREQ) + 2.0F)
 #define M3_SPEED_IIR_A1				       (1.0F - M3_SPEED_IIR_B0 - M3_SPEED_IIR_B1)
 
+// MTPA and field weakening
+//-----------------------------------------------------------------------------------------------------------
+#define M3_FW_ON					   	   (FALSE)			/* voltage feedback field weakening above the base speed, MTPA is independent of it */
+#define M3_FW_U_LIM_GAIN				   (0.95F)			/* part of the q-axis voltage limit kept by the field weakening */
+#define M3_FW_ID_MIN					   (-5.0F)			/* [A], lowest field weakening d-axis current, within M3_SPEED_LOOP_HIGH_LIMIT */
+#define M3_FW_FREQ					   (50.0F)			/* [Hz], crossover frequency of the field weakening integrator */
+#define M3_FW_IQ_ERR_CUTOFF_FREQ		   (50.0F)			/* [Hz], cutoff frequency of IIR1 low pass filter for the Iq error */
+#define M3_FW_U_TO_ID_GAIN			   (float_t)(1.0/(M3_N_NOM_RAD*M3_LD))	/* [A/V], q-axis voltage margin to d-axis current at the nominal speed */
+#define M3_FW_KP_GAIN					   (0.0F)			/* proportional gain */
+#define M3_FW_KI_GAIN					   (2.0F*PI*M3_FW_FREQ/M3_SLOW_LOOP_FREQ)	/* integral gain */
+#define M3_MTPA_LQ_LD_DIFF			   (float_t)(M3_LQ - M3_LD)	/* [H], reluctance torque of the MTPA, 0 keeps Id = 0 below the base speed */
+
+#define M3_FW_IQ_ERR_IIR_B0			   WARP(M3_FW_IQ_ERR_CUTOFF_FREQ, M3_SLOW_LOOP_FREQ)/(WARP(M3_FW_IQ_ERR_CUTOFF_FREQ, M3_SLOW_LOOP_FREQ) + 2.0F)
+#define M3_FW_IQ_ERR_IIR_B1			   WARP(M3_FW_IQ_ERR_CUTOFF_FREQ, M3_SLOW_LOOP_FREQ)/(WARP(M3_FW_IQ_ERR_CUTOFF_FREQ, M3_SLOW_LOOP_FREQ) + 2.0F)
+#define M3_FW_IQ_ERR_IIR_A1			   (1.0F - M3_FW_IQ_ERR_IIR_B0 - M3_FW_IQ_ERR_IIR_B1)
+
 
 // Position loop control
 //-----------------------------------------------------------------------------------------------------------
@@ -201,6 +225,7 @@
 #define M3_QDC_POSITION_CTRL_P_GAIN			4.0			 /* proportional gain for position controller */
 #define M3_QDC_POSITION_CTRL_LIMIT	   		4000.0F		 /* [RPM], mechanical speed - position controller output upper limit. Lower limit is its negative value */
 #define M3_QDC_POSITION_CTRL_SPEED_FWD_GAIN 1.0F		 /* Speed feed forward gain */
+#define M3_QDC_POSITION_CTRL_ACC_FWD_GAIN 0.0F		 /* [A.s^2/rad], Iq per electrical angular acceleration of the trajectory, 0 disables. Set by the mechanical measurement */
 
 
 #define M3_QDC_POSITION_RAMP_UP_FRAC	 	((M3_QDC_POSITION_RAMP/M3_SLOW_LOOP_FREQ)*65535)  /* Q16.16 format */
@@ -216,6 +241,7 @@
 #define M3_QDC_TIMER_PRESCALER				6 //10			 /* Prescaler for the timer within QDC, the prescaling value is 2^Mx_QDC_TIMER_PRESCALER */
 #define M3_QDC_CLOCK	 					240000000	 /* [Hz], QDC module clock, which is the bus clock of the system */
 #define M3_QDC_SPEED_FILTER_CUTOFF_FREQ 	100.0 		 /* [Hz], cutoff frequency of IIR1 low pass filter for calculated raw speed out of QDC HW feature */
+#define M3_QDC_SPEED_LOW_SPEED_INTERP		FALSE		 /* TRUE: single count speed measurements are extrapolated to the present with the measured acceleration */
 #define M3_QDC_TO_ATT						(0.85F)		 /* attenuation for tracking observer, which is to estimate rotor speed from real QDC position */
 #define M3_QDC_TO_FREQ						(300.0)		 /* [Hz], oscillating frequency for tracking observer */
 
@@ -256,6 +282,21 @@
 #define M3_TO_SPEED_IIR_B1		WARP(M3_BEMF_DQ_TO_SPEED_CUTOFF_FREQ, M3_FAST_LOOP_FREQ)/(WARP(M3_BEMF_DQ_TO_SPEED_CUTOFF_FREQ, M3_FAST_LOOP_FREQ) + 2.0F)
 #define M3_TO_SPEED_IIR_A1		(1.0F - M3_TO_SPEED_IIR_B0 - M3_TO_SPEED_IIR_B1)
 
+// Online resistance and flux estimator (sensorless speed and position FOC)
+//-----------------------------------------------------------------------------------------------------------  
+#define M3_PARAM_EST_R_MIN			(0.7F*M3_R)		/* [ohm], lower bound of the resistance estimate */
+#define M3_PARAM_EST_R_MAX			(1.6F*M3_R)		/* [ohm], upper bound of the resistance estimate, hot winding */
+#define M3_PARAM_EST_FLUX_MIN		(0.8F*M3_FLUX)		/* [Wb], lower bound of the flux estimate, hot magnet */
+#define M3_PARAM_EST_FLUX_MAX		(1.05F*M3_FLUX)	/* [Wb], upper bound of the flux estimate */
+#define M3_PARAM_EST_FILT_LAMBDA	(1.0F/64.0F)		/* input moving average filter smoothing factor */
+#define M3_PARAM_EST_FORGET		(0.9995F)			/* RLS forgetting factor per update */
+#define M3_PARAM_EST_COV_MAX		(10.0F)				/* bound of the RLS covariance trace */
+#define M3_PARAM_EST_EXCIT_LAMBDA	(1.0F/256.0F)		/* regressor average smoothing factor */
+#define M3_PARAM_EST_EXCIT_MIN		(0.087F)			/* sine of the minimum regressor deviation (5 deg) to update */
+#define M3_PARAM_EST_SETTLE		(256U)				/* slow loop periods to settle the filters after start */
+#define M3_PARAM_EST_DECIM			(8U)				/* slow loop periods per RLS update */
+#define M3_PARAM_EST_OBSRV_UPDATE	(FALSE)				/* write the resistance estimate into the BEMF observer gains */
+
 // OpenLoop startup
 //-----------------------------------------------------------------------------------------------------------
 #define M3_OL_START_SPEED_RAMP		(1000.0F) /* [RPM/s], (mechanical) speed accelerating rate during startup */
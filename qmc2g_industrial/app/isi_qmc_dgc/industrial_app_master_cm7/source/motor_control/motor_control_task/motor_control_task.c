@@ -34,6 +34,26 @@
  * Definitions
  ******************************************************************************/
 
+/*! @brief Per-motor parameters of the generic fast and slow loop handlers */
+typedef struct _mc_loop_motor
+{
+    mc_motor_id_t eMotorId;                  /* Motor index */
+    mcdef_pmsm_t *psDrive;                   /* g_sMxDrive */
+    sm_app_ctrl_t *psCtrl;                   /* g_sMxCtrl */
+    bool_t *pbSwitchAppOnOff;                /* g_bMxSwitchAppOnOff */
+    qdc_block_t *psQdcSensor;                /* g_sMxQdcSensor */
+    volatile uint32_t *pui32FastIrqFlag;     /* ADC_ETC DONE register of the fast loop trigger */
+    uint32_t ui32FastIrqFlagMask;            /* Write-1-to-clear mask of the fast loop trigger */
+    float_t fltRpmToElecAngularCoeff;        /* Mx_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF */
+    float_t fltElecAngularToRpmCoeff;        /* Mx_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF */
+    uint16_t ui16FastLoopFreq;               /* Mx_FAST_LOOP_FREQ */
+    uint16_t ui16SlowLoopFreq;               /* Mx_SLOW_LOOP_FREQ */
+    bool_t bCmdFromFmstr;                    /* MOTORx_CMD_FROM_FMSTR */
+    uint16_t *pui16CntFastloop;              /* ui16CntFastloopMx */
+    uint16_t *pui16CntSlowloop;              /* ui16CntSlowloopMx */
+    volatile uint16_t *pui16ExeTimeFastloop; /* ui16ExeTime_fastloopMx */
+} mc_loop_motor_t;
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
@@ -57,6 +77,30 @@ static uint16_t ui16ADC_ETC_err_flag;
 
 TaskHandle_t g_getMotorStatus_task_handle;
 
+/*! @brief Motor descriptors of the loop handlers, kept in RAM like the state machine tables */
+static mc_loop_motor_t s_sMotorLoop[MC_MAX_MOTORS] = {
+    {kMC_Motor1, &g_sM1Drive, &g_sM1Ctrl, &g_bM1SwitchAppOnOff, &g_sM1QdcSensor,
+     &ADC_ETC->DONE0_1_IRQ, ADC_ETC_DONE0_1_IRQ_TRIG4_DONE0_MASK,
+     M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, M1_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF,
+     (uint16_t)(M1_FAST_LOOP_FREQ), (uint16_t)(M1_SLOW_LOOP_FREQ), MOTOR1_CMD_FROM_FMSTR,
+     &ui16CntFastloopM1, &ui16CntSlowloopM1, &ui16ExeTime_fastloopM1},
+    {kMC_Motor2, &g_sM2Drive, &g_sM2Ctrl, &g_bM2SwitchAppOnOff, &g_sM2QdcSensor,
+     &ADC_ETC->DONE0_1_IRQ, ADC_ETC_DONE0_1_IRQ_TRIG5_DONE1_MASK,
+     M2_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, M2_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF,
+     (uint16_t)(M2_FAST_LOOP_FREQ), (uint16_t)(M2_SLOW_LOOP_FREQ), MOTOR2_CMD_FROM_FMSTR,
+     &ui16CntFastloopM2, &ui16CntSlowloopM2, &ui16ExeTime_fastloopM2},
+    {kMC_Motor3, &g_sM3Drive, &g_sM3Ctrl, &g_bM3SwitchAppOnOff, &g_sM3QdcSensor,
+     &ADC_ETC->DONE2_3_ERR_IRQ, ADC_ETC_DONE2_3_ERR_IRQ_TRIG6_DONE2_MASK,
+     M3_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, M3_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF,
+     (uint16_t)(M3_FAST_LOOP_FREQ), (uint16_t)(M3_SLOW_LOOP_FREQ), MOTOR3_CMD_FROM_FMSTR,
+     &ui16CntFastloopM3, &ui16CntSlowloopM3, &ui16ExeTime_fastloopM3},
+    {kMC_Motor4, &g_sM4Drive, &g_sM4Ctrl, &g_bM4SwitchAppOnOff, &g_sM4QdcSensor,
+     &ADC_ETC->DONE2_3_ERR_IRQ, ADC_ETC_DONE2_3_ERR_IRQ_TRIG7_DONE3_MASK,
+     M4_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF, M4_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF,
+     (uint16_t)(M4_FAST_LOOP_FREQ), (uint16_t)(M4_SLOW_LOOP_FREQ), MOTOR4_CMD_FROM_FMSTR,
+     &ui16CntFastloopM4, &ui16CntSlowloopM4, &ui16ExeTime_fastloopM4},
+};
+
 /* Application and board ID  */
 app_ver_t   g_sAppId = {
     "evk_imxrt1170",    /* board id */
@@ -70,147 +114,167 @@ app_ver_t   g_sAppIdFM;
  * Code
  ******************************************************************************/
 /*!
- * @brief Motor1 slow loop ISR where speed and position loops are executed.
+ * @brief Slow loop of one motor where speed and position loops are executed.
  *
- * @param None
+ * @param psMotor Motor descriptor
  *
  * @return None
  */
-RAM_FUNC_CRITICAL void M1_slowloop_handler(void)
+RAM_FUNC_CRITICAL static void Mx_slowloop_handler(mc_loop_motor_t *const psMotor)
 {
-	// Clear flag
-	PIT1->CHANNEL[0].TFLG = 1;
-#if MOTOR1_CMD_FROM_FMSTR == 0
-	// Get motor command from external sources
-	g_sM1Drive.psMotorCmd = MC_GetMotorCommand_fromISR(kMC_Motor1);
+	mcdef_pmsm_t *const psDrive = psMotor->psDrive;
 
-	// Set up motor commands
-	if(NULL != g_sM1Drive.psMotorCmd)
+	if(FALSE == psMotor->bCmdFromFmstr)
 	{
-		switch(g_sM1Drive.psMotorCmd->eControlMethodSel)
+		// Get motor command from external sources
+		psDrive->psMotorCmd = MC_GetMotorCommand_fromISR(psMotor->eMotorId);
+
+		// Set up motor commands
+		if(NULL != psDrive->psMotorCmd)
 		{
-		case kMC_ScalarControl:
-			g_sM1Drive.eControl = kControlMode_Scalar;
-			g_sM1Drive.sScalarCtrl.fltVHzGain = g_sM1Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain;
-			g_sM1Drive.sScalarCtrl.fltFreqCmd = g_sM1Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency;
-			break;
-		case kMC_FOC_SpeedControl:
-			g_sM1Drive.eControl = kControlMode_SpeedFOC;
-			g_sM1Drive.sSpeed.fltSpeedCmd = g_sM1Drive.psMotorCmd->uSpeed_pos.fltSpeed * M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF;
-			break;
-		case kMC_FOC_PositionControl:
-		default:
-			g_sM1Drive.eControl = kControlMode_PositionFOC;
-			if(g_sM1Drive.psMotorCmd->uSpeed_pos.sPosParam.bIsRandomPosition == true)
+			switch(psDrive->psMotorCmd->eControlMethodSel)
 			{
-				g_sM1Drive.sPosition.bIsRandomPosition = TRUE; // Don't generate trajectory in position loop
+			case kMC_ScalarControl:
+				psDrive->eControl = kControlMode_Scalar;
+				psDrive->sScalarCtrl.fltVHzGain = psDrive->psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain;
+				psDrive->sScalarCtrl.fltFreqCmd = psDrive->psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency;
+				break;
+			case kMC_FOC_SpeedControl:
+				psDrive->eControl = kControlMode_SpeedFOC;
+				psDrive->sSpeed.fltSpeedCmd = psDrive->psMotorCmd->uSpeed_pos.fltSpeed * psMotor->fltRpmToElecAngularCoeff;
+				break;
+			case kMC_FOC_PositionControl:
+			default:
+				psDrive->eControl = kControlMode_PositionFOC;
+				if(psDrive->psMotorCmd->uSpeed_pos.sPosParam.bIsRandomPosition == true)
+				{
+					psDrive->sPosition.bIsRandomPosition = TRUE; // Don't generate trajectory in position loop
+
+				}
+				else
+				{
+					psDrive->sPosition.bIsRandomPosition = FALSE;
+				}
+				psDrive->sPosition.i32Q16PosCmd = psDrive->psMotorCmd->uSpeed_pos.sPosParam.uPosition.i32Raw;
+
+				break;
+			}
 
+			// Turn on/off motor
+			if(psDrive->psMotorCmd->eAppSwitch == kMC_App_On)
+			{
+				*psMotor->pbSwitchAppOnOff = TRUE;
 			}
 			else
 			{
-				g_sM1Drive.sPosition.bIsRandomPosition = FALSE;
+				*psMotor->pbSwitchAppOnOff = FALSE;
 			}
-			g_sM1Drive.sPosition.i32Q16PosCmd = g_sM1Drive.psMotorCmd->uSpeed_pos.sPosParam.uPosition.i32Raw;
-
-			break;
 		}
+	}
 
-		// Turn on/off motor
-		if(g_sM1Drive.psMotorCmd->eAppSwitch == kMC_App_On)
-		{
-			g_bM1SwitchAppOnOff = TRUE;
-		}
-		else
-		{
-			g_bM1SwitchAppOnOff = FALSE;
-		}
-    }
-#endif
-    /* M1 Slow StateMachine call */
-    SM_StateMachineSlow(&g_sM1Ctrl);
+    /* Slow StateMachine call */
+    SM_StateMachineSlow(psMotor->psCtrl);
+
+    sMotorStatusFromMotorLoopIsr.sSlow.eAppSwitch = *psMotor->pbSwitchAppOnOff;
+    sMotorStatusFromMotorLoopIsr.sSlow.fltSpeed = psDrive->sSpeed.fltSpeedFilt*psMotor->fltElecAngularToRpmCoeff;
+    sMotorStatusFromMotorLoopIsr.sSlow.uPosition.i32Raw = psDrive->sPosition.i32Q16PosFdbk;
+    MC_SetSlowMotorStatus_fromISR(psMotor->eMotorId, &sMotorStatusFromMotorLoopIsr.sSlow);
 
-    sMotorStatusFromMotorLoopIsr.sSlow.eAppSwitch = g_bM1SwitchAppOnOff;
-    sMotorStatusFromMotorLoopIsr.sSlow.fltSpeed = g_sM1Drive.sSpeed.fltSpeedFilt*M1_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF;
-    sMotorStatusFromMotorLoopIsr.sSlow.uPosition.i32Raw = g_sM1Drive.sPosition.i32Q16PosFdbk;
-    MC_SetSlowMotorStatus_fromISR(kMC_Motor1, &sMotorStatusFromMotorLoopIsr.sSlow);
+    /* Identified controller gains out, gains restored from the configuration in */
+    MC_ExchangeControllerTuning_fromISR(psMotor->eMotorId, &psDrive->sCtrlTuning, (psMotor->psCtrl->eState != kSM_AppRun));
 
-	if(++ui16CntSlowloopM1 >= (uint16_t)(M1_SLOW_LOOP_FREQ))
+	if(++(*psMotor->pui16CntSlowloop) >= psMotor->ui16SlowLoopFreq)
 	{
-		ui16CntSlowloopM1 = 0;
+		*psMotor->pui16CntSlowloop = 0;
 	}
 	__DSB();
 }
 
 /*!
- * @brief Motor2 slow loop ISR where speed and position loops are executed.
+ * @brief Fast loop of one motor where current loop is executed.
  *
- * @param None
+ * @param psMotor Motor descriptor
  *
  * @return None
  */
-RAM_FUNC_CRITICAL void M2_slowloop_handler(void)
+RAM_FUNC_CRITICAL static void Mx_fastloop_handler(mc_loop_motor_t *const psMotor)
 {
+	mcdef_pmsm_t *const psDrive = psMotor->psDrive;
+
+	RESET_TIMER1();
 	// Clear flag
-	PIT2->CHANNEL[0].TFLG = 1;
-#if MOTOR2_CMD_FROM_FMSTR == 0
-	// Get motor command from external sources
-	g_sM2Drive.psMotorCmd = MC_GetMotorCommand_fromISR(kMC_Motor2);
+	*psMotor->pui32FastIrqFlag = psMotor->ui32FastIrqFlagMask;
 
-	// Set up motor commands
-	if(NULL != g_sM2Drive.psMotorCmd)
-	{
-		switch(g_sM2Drive.psMotorCmd->eControlMethodSel)
-		{
-		case kMC_ScalarControl:
-			g_sM2Drive.eControl = kControlMode_Scalar;
-			g_sM2Drive.sScalarCtrl.fltVHzGain = g_sM2Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain;
-			g_sM2Drive.sScalarCtrl.fltFreqCmd = g_sM2Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency;
-			break;
-		case kMC_FOC_SpeedControl:
-			g_sM2Drive.eControl = kControlMode_SpeedFOC;
-			g_sM2Drive.sSpeed.fltSpeedCmd = g_sM2Drive.psMotorCmd->uSpeed_pos.fltSpeed * M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF;
-			break;
-		case kMC_FOC_PositionControl:
-		default:
-			g_sM2Drive.eControl = kControlMode_PositionFOC;
-			if(g_sM2Drive.psMotorCmd->uSpeed_pos.sPosParam.bIsRandomPosition == true)
-			{
-				g_sM2Drive.sPosition.bIsRandomPosition = TRUE; // Don't generate trajectory in position loop
+	MCDRV_GetRotorCurrentRev(psMotor->psQdcSensor);
+	MCDRV_GetRotorDeltaRev(psMotor->psQdcSensor);
 
-			}
-			else
-			{
-				g_sM2Drive.sPosition.bIsRandomPosition = FALSE;
-			}
-			g_sM2Drive.sPosition.i32Q16PosCmd = g_sM2Drive.psMotorCmd->uSpeed_pos.sPosParam.uPosition.i32Raw;
+    /*========================= State machine begin========================================================*/
 
-			break;
-		}
+    SM_StateMachineFast(psMotor->psCtrl);
 
-		// Turn on/off motor
-		if(g_sM2Drive.psMotorCmd->eAppSwitch == kMC_App_On)
-		{
-			g_bM2SwitchAppOnOff = TRUE;
-		}
-		else
-		{
-			g_bM2SwitchAppOnOff = FALSE;
-		}
-	}
+    /*========================= State machine end =========================================================*/
+    RESET_TIMER2();
+    sMotorStatusFromMotorLoopIsr.sFast.eFaultStatus = psDrive->ui32FaultIdCapturedExt;
+    psDrive->ui32FaultIdCapturedExt = kMC_NoFaultMC; // Clear captured fault Id
+    sMotorStatusFromMotorLoopIsr.sFast.eMotorState = psMotor->psCtrl->eState;
+    sMotorStatusFromMotorLoopIsr.sFast.fltIa = psDrive->sFocPMSM.sIABC.fltA;
+    sMotorStatusFromMotorLoopIsr.sFast.fltIb = psDrive->sFocPMSM.sIABC.fltB;
+    sMotorStatusFromMotorLoopIsr.sFast.fltIc = psDrive->sFocPMSM.sIABC.fltC;
+    sMotorStatusFromMotorLoopIsr.sFast.fltVDcBus = psDrive->sFocPMSM.fltUDcBusFilt;
+    sMotorStatusFromMotorLoopIsr.sFast.fltValpha = psDrive->sFocPMSM.sUAlBeReq.fltAlpha;
+    sMotorStatusFromMotorLoopIsr.sFast.fltVbeta = psDrive->sFocPMSM.sUAlBeReq.fltBeta;
+    MC_SetFastMotorStatus_fromISR(psMotor->eMotorId, &sMotorStatusFromMotorLoopIsr.sFast);
+
+    if(kMC_Motor1 == psMotor->eMotorId)
+    {
+        ui16CntSetfastloopStatus = READ_TIMER2();
+#if FEATURE_FREEMASTER_ENABLE
+        /* Recorder of FreeMASTER*/
+        FMSTR_Recorder(0);
 #endif
-    /* M1 Slow StateMachine call */
-    SM_StateMachineSlow(&g_sM2Ctrl);
+    }
 
-    sMotorStatusFromMotorLoopIsr.sSlow.eAppSwitch = g_bM2SwitchAppOnOff;
-    sMotorStatusFromMotorLoopIsr.sSlow.fltSpeed = g_sM2Drive.sSpeed.fltSpeedFilt*M2_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF;
-    sMotorStatusFromMotorLoopIsr.sSlow.uPosition.i32Raw = g_sM2Drive.sPosition.i32Q16PosFdbk;
-    MC_SetSlowMotorStatus_fromISR(kMC_Motor2, &sMotorStatusFromMotorLoopIsr.sSlow);
+    if(++(*psMotor->pui16CntFastloop) >= psMotor->ui16FastLoopFreq)
+    {
+    	*psMotor->pui16CntFastloop = 0;
+#if FEATURE_TOOGLE_USER_LED_ENABLE
+    	if(kMC_Motor1 == psMotor->eMotorId)
+    	{
+    		GPIO_PortToggle(BOARD_INITUSERLEDSPINS_USER_LED1_BOOT_CFG10_PERIPHERAL, 1<<BOARD_INITUSERLEDSPINS_USER_LED1_BOOT_CFG10_CHANNEL);
+    	}
+#endif
+    }
+    *psMotor->pui16ExeTimeFastloop = READ_TIMER1();
 
-	if(++ui16CntSlowloopM2 >= (uint16_t)(M2_SLOW_LOOP_FREQ))
-	{
-		ui16CntSlowloopM2 = 0;
-	}
-	__DSB();
+    __DSB();
+}
+
+/*!
+ * @brief Motor1 slow loop ISR where speed and position loops are executed.
+ *
+ * @param None
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void M1_slowloop_handler(void)
+{
+	// Clear flag
+	PIT1->CHANNEL[0].TFLG = 1;
+	Mx_slowloop_handler(&s_sMotorLoop[kMC_Motor1]);
+}
+
+/*!
+ * @brief Motor2 slow loop ISR where speed and position loops are executed.
+ *
+ * @param None
+ *
+ * @return None
+ */
+RAM_FUNC_CRITICAL void M2_slowloop_handler(void)
+{
+	// Clear flag
+	PIT2->CHANNEL[0].TFLG = 1;
+	Mx_slowloop_handler(&s_sMotorLoop[kMC_Motor2]);
 }
 
 /*!
@@ -224,65 +288,7 @@ RAM_FUNC_CRITICAL void M3_slowloop_handler(void)
 {
 	// Clear flag
 	TMR1->CHANNEL[0].SCTRL &= ~TMR_SCTRL_TCF_MASK;
-#if MOTOR3_CMD_FROM_FMSTR == 0
-	// Get motor command from external sources
-	g_sM3Drive.psMotorCmd = MC_GetMotorCommand_fromISR(kMC_Motor3);
-
-	// Set up motor commands
-	if(NULL != g_sM3Drive.psMotorCmd)
-	{
-		switch(g_sM3Drive.psMotorCmd->eControlMethodSel)
-		{
-		case kMC_ScalarControl:
-			g_sM3Drive.eControl = kControlMode_Scalar;
-			g_sM3Drive.sScalarCtrl.fltVHzGain = g_sM3Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain;
-			g_sM3Drive.sScalarCtrl.fltFreqCmd = g_sM3Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency;
-			break;
-		case kMC_FOC_SpeedControl:
-			g_sM3Drive.eControl = kControlMode_SpeedFOC;
-			g_sM3Drive.sSpeed.fltSpeedCmd = g_sM3Drive.psMotorCmd->uSpeed_pos.fltSpeed * M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF;
-			break;
-		case kMC_FOC_PositionControl:
-		default:
-			g_sM3Drive.eControl = kControlMode_PositionFOC;
-			if(g_sM3Drive.psMotorCmd->uSpeed_pos.sPosParam.bIsRandomPosition == true)
-			{
-				g_sM3Drive.sPosition.bIsRandomPosition = TRUE; // Don't generate trajectory in position loop
-
-			}
-			else
-			{
-				g_sM3Drive.sPosition.bIsRandomPosition = FALSE;
-			}
-			g_sM3Drive.sPosition.i32Q16PosCmd = g_sM3Drive.psMotorCmd->uSpeed_pos.sPosParam.uPosition.i32Raw;
-
-			break;
-		}
-
-		// Turn on/off motor
-		if(g_sM3Drive.psMotorCmd->eAppSwitch == kMC_App_On)
-		{
-			g_bM3SwitchAppOnOff = TRUE;
-		}
-		else
-		{
-			g_bM3SwitchAppOnOff = FALSE;
-		}
-	}
-#endif
-    /* M1 Slow StateMachine call */
-    SM_StateMachineSlow(&g_sM3Ctrl);
-
-    sMotorStatusFromMotorLoopIsr.sSlow.eAppSwitch = g_bM3SwitchAppOnOff;
-    sMotorStatusFromMotorLoopIsr.sSlow.fltSpeed = g_sM3Drive.sSpeed.fltSpeedFilt*M3_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF;
-    sMotorStatusFromMotorLoopIsr.sSlow.uPosition.i32Raw = g_sM3Drive.sPosition.i32Q16PosFdbk;
-    MC_SetSlowMotorStatus_fromISR(kMC_Motor3, &sMotorStatusFromMotorLoopIsr.sSlow);
-
-	if(++ui16CntSlowloopM3 >= (uint16_t)(M3_SLOW_LOOP_FREQ))
-	{
-		ui16CntSlowloopM3 = 0;
-	}
-	__DSB();
+	Mx_slowloop_handler(&s_sMotorLoop[kMC_Motor3]);
 }
 
 /*!
@@ -296,65 +302,7 @@ RAM_FUNC_CRITICAL void M4_slowloop_handler(void)
 {
 	// Clear flag
 	TMR2->CHANNEL[0].SCTRL &= ~TMR_SCTRL_TCF_MASK;
-#if MOTOR4_CMD_FROM_FMSTR == 0
-	// Get motor command from external sources
-	g_sM4Drive.psMotorCmd = MC_GetMotorCommand_fromISR(kMC_Motor4);
-
-	// Set up motor commands
-	if(NULL != g_sM4Drive.psMotorCmd)
-	{
-		switch(g_sM4Drive.psMotorCmd->eControlMethodSel)
-		{
-		case kMC_ScalarControl:
-			g_sM4Drive.eControl = kControlMode_Scalar;
-			g_sM4Drive.sScalarCtrl.fltVHzGain = g_sM4Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlVHzGain;
-			g_sM4Drive.sScalarCtrl.fltFreqCmd = g_sM4Drive.psMotorCmd->uSpeed_pos.sScalarParam.fltScalarControlFrequency;
-			break;
-		case kMC_FOC_SpeedControl:
-			g_sM4Drive.eControl = kControlMode_SpeedFOC;
-			g_sM4Drive.sSpeed.fltSpeedCmd = g_sM4Drive.psMotorCmd->uSpeed_pos.fltSpeed * M1_SPEED_MECH_RPM_TO_ELEC_ANGULAR_COEFF;
-			break;
-		case kMC_FOC_PositionControl:
-		default:
-			g_sM4Drive.eControl = kControlMode_PositionFOC;
-			if(g_sM4Drive.psMotorCmd->uSpeed_pos.sPosParam.bIsRandomPosition == true)
-			{
-				g_sM4Drive.sPosition.bIsRandomPosition = TRUE; // Don't generate trajectory in position loop
-
-			}
-			else
-			{
-				g_sM4Drive.sPosition.bIsRandomPosition = FALSE;
-			}
-			g_sM4Drive.sPosition.i32Q16PosCmd = g_sM4Drive.psMotorCmd->uSpeed_pos.sPosParam.uPosition.i32Raw;
-
-			break;
-		}
-
-		// Turn on/off motor
-		if(g_sM4Drive.psMotorCmd->eAppSwitch == kMC_App_On)
-		{
-			g_bM4SwitchAppOnOff = TRUE;
-		}
-		else
-		{
-			g_bM4SwitchAppOnOff = FALSE;
-		}
-	}
-#endif
-    /* M1 Slow StateMachine call */
-    SM_StateMachineSlow(&g_sM4Ctrl);
-
-    sMotorStatusFromMotorLoopIsr.sSlow.eAppSwitch = g_bM4SwitchAppOnOff;
-    sMotorStatusFromMotorLoopIsr.sSlow.fltSpeed = g_sM4Drive.sSpeed.fltSpeedFilt*M4_SPEED_ELEC_ANGULAR_TO_MECH_RPM_COEFF;
-    sMotorStatusFromMotorLoopIsr.sSlow.uPosition.i32Raw = g_sM4Drive.sPosition.i32Q16PosFdbk;
-    MC_SetSlowMotorStatus_fromISR(kMC_Motor4, &sMotorStatusFromMotorLoopIsr.sSlow);
-
-	if(++ui16CntSlowloopM4 >= (uint16_t)(M4_SLOW_LOOP_FREQ))
-	{
-		ui16CntSlowloopM4 = 0;
-	}
-	__DSB();
+	Mx_slowloop_handler(&s_sMotorLoop[kMC_Motor4]);
 }
 
 /*!
@@ -366,53 +314,7 @@ RAM_FUNC_CRITICAL void M4_slowloop_handler(void)
  */
 RAM_FUNC_CRITICAL void M1_fastloop_handler(void)
 {
-
-
-	RESET_TIMER1();
-	// Clear flag
-	ADC_ETC->DONE0_1_IRQ = ADC_ETC_DONE0_1_IRQ_TRIG4_DONE0_MASK;
-
-
-	MCDRV_GetRotorCurrentRev(&g_sM1QdcSensor);
-	MCDRV_GetRotorDeltaRev(&g_sM1QdcSensor);
-
-
-    /*========================= State machine begin========================================================*/
-
-    /* M1 State machine */
-    SM_StateMachineFast(&g_sM1Ctrl);
-
-
-    /*========================= State machine end =========================================================*/
-    RESET_TIMER2();
-    sMotorStatusFromMotorLoopIsr.sFast.eFaultStatus = g_sM1Drive.ui32FaultIdCapturedExt;
-    g_sM1Drive.ui32FaultIdCapturedExt = kMC_NoFaultMC; // Clear captured fault Id
-    sMotorStatusFromMotorLoopIsr.sFast.eMotorState = g_sM1Ctrl.eState;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIa = g_sM1Drive.sFocPMSM.sIABC.fltA;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIb = g_sM1Drive.sFocPMSM.sIABC.fltB;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIc = g_sM1Drive.sFocPMSM.sIABC.fltC;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVDcBus = g_sM1Drive.sFocPMSM.fltUDcBusFilt;
-    sMotorStatusFromMotorLoopIsr.sFast.fltValpha = g_sM1Drive.sFocPMSM.sUAlBeReq.fltAlpha;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVbeta = g_sM1Drive.sFocPMSM.sUAlBeReq.fltBeta;
-    MC_SetFastMotorStatus_fromISR(kMC_Motor1, &sMotorStatusFromMotorLoopIsr.sFast);
-
-    ui16CntSetfastloopStatus = READ_TIMER2();
-#if FEATURE_FREEMASTER_ENABLE
-   /* Recorder of FreeMASTER*/
-	FMSTR_Recorder(0);
-#endif
-
-    if(++ui16CntFastloopM1 >= (uint16_t)(M1_FAST_LOOP_FREQ))
-    {
-    	ui16CntFastloopM1 = 0;
-#if FEATURE_TOOGLE_USER_LED_ENABLE
-    	GPIO_PortToggle(BOARD_INITUSERLEDSPINS_USER_LED1_BOOT_CFG10_PERIPHERAL, 1<<BOARD_INITUSERLEDSPINS_USER_LED1_BOOT_CFG10_CHANNEL);
-#endif
-    }
-    ui16ExeTime_fastloopM1 = READ_TIMER1();
-
-
-    __DSB();
+	Mx_fastloop_handler(&s_sMotorLoop[kMC_Motor1]);
 }
 
 /*!
@@ -424,44 +326,7 @@ RAM_FUNC_CRITICAL void M1_fastloop_handler(void)
  */
 RAM_FUNC_CRITICAL void M2_fastloop_handler(void)
 {
-
-//	GPIO_PortSet(DEBUG_INITTESTIO_BUTTON1_GPIO, DEBUG_INITTESTIO_BUTTON1_GPIO_PIN_MASK);
-
-	RESET_TIMER1();
-
-	// Clear flag
-	ADC_ETC->DONE0_1_IRQ = ADC_ETC_DONE0_1_IRQ_TRIG5_DONE1_MASK;
-
-
-	MCDRV_GetRotorCurrentRev(&g_sM2QdcSensor);
-	MCDRV_GetRotorDeltaRev(&g_sM2QdcSensor);
-
-
-    /*========================= State machine begin========================================================*/
-
-    /* M1 State machine */
-    SM_StateMachineFast(&g_sM2Ctrl);
-
-   	/*========================= State machine end =========================================================*/
-    sMotorStatusFromMotorLoopIsr.sFast.eFaultStatus = g_sM2Drive.ui32FaultIdCapturedExt;
-    g_sM2Drive.ui32FaultIdCapturedExt = kMC_NoFaultMC; // Clear captured fault Id
-    sMotorStatusFromMotorLoopIsr.sFast.eMotorState = g_sM2Ctrl.eState;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIa = g_sM2Drive.sFocPMSM.sIABC.fltA;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIb = g_sM2Drive.sFocPMSM.sIABC.fltB;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIc = g_sM2Drive.sFocPMSM.sIABC.fltC;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVDcBus = g_sM2Drive.sFocPMSM.fltUDcBusFilt;
-    sMotorStatusFromMotorLoopIsr.sFast.fltValpha = g_sM2Drive.sFocPMSM.sUAlBeReq.fltAlpha;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVbeta = g_sM2Drive.sFocPMSM.sUAlBeReq.fltBeta;
-    MC_SetFastMotorStatus_fromISR(kMC_Motor2, &sMotorStatusFromMotorLoopIsr.sFast);
-
-    if(++ui16CntFastloopM2 >= (uint16_t)(M2_FAST_LOOP_FREQ))
-    {
-    	ui16CntFastloopM2 = 0;
-    }
-
-    ui16ExeTime_fastloopM2 = READ_TIMER1();
-
-    __DSB();
+	Mx_fastloop_handler(&s_sMotorLoop[kMC_Motor2]);
 }
 
 /*!
@@ -473,43 +338,7 @@ RAM_FUNC_CRITICAL void M2_fastloop_handler(void)
  */
 RAM_FUNC_CRITICAL void M3_fastloop_handler(void)
 {
-//	GPIO_PortSet(DEBUG_INITTESTIO_BUTTON1_GPIO, DEBUG_INITTESTIO_BUTTON1_GPIO_PIN_MASK);
-
-	RESET_TIMER1();
-
-	// Clear flag
-	ADC_ETC->DONE2_3_ERR_IRQ = ADC_ETC_DONE2_3_ERR_IRQ_TRIG6_DONE2_MASK;
-
-
-	MCDRV_GetRotorCurrentRev(&g_sM3QdcSensor);
-	MCDRV_GetRotorDeltaRev(&g_sM3QdcSensor);
-
-
-    /*========================= State machine begin========================================================*/
-
-    /* M1 State machine */
-    SM_StateMachineFast(&g_sM3Ctrl);
-
-   	/*========================= State machine end =========================================================*/
-    sMotorStatusFromMotorLoopIsr.sFast.eFaultStatus = g_sM3Drive.ui32FaultIdCapturedExt;
-    g_sM3Drive.ui32FaultIdCapturedExt = kMC_NoFaultMC; // Clear captured fault Id
-    sMotorStatusFromMotorLoopIsr.sFast.eMotorState = g_sM3Ctrl.eState;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIa = g_sM3Drive.sFocPMSM.sIABC.fltA;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIb = g_sM3Drive.sFocPMSM.sIABC.fltB;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIc = g_sM3Drive.sFocPMSM.sIABC.fltC;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVDcBus = g_sM3Drive.sFocPMSM.fltUDcBusFilt;
-    sMotorStatusFromMotorLoopIsr.sFast.fltValpha = g_sM3Drive.sFocPMSM.sUAlBeReq.fltAlpha;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVbeta = g_sM3Drive.sFocPMSM.sUAlBeReq.fltBeta;
-    MC_SetFastMotorStatus_fromISR(kMC_Motor3, &sMotorStatusFromMotorLoopIsr.sFast);
-
-    if(++ui16CntFastloopM3 >= (uint16_t)(M3_FAST_LOOP_FREQ))
-    {
-    	ui16CntFastloopM3 = 0;
-    }
-
-    ui16ExeTime_fastloopM3 = READ_TIMER1();
-
-    __DSB();
+	Mx_fastloop_handler(&s_sMotorLoop[kMC_Motor3]);
 }
 
 /*!
@@ -521,43 +350,7 @@ RAM_FUNC_CRITICAL void M3_fastloop_handler(void)
  */
 RAM_FUNC_CRITICAL void M4_fastloop_handler(void)
 {
-
-//	GPIO_PortSet(DEBUG_INITTESTIO_BUTTON1_GPIO, DEBUG_INITTESTIO_BUTTON1_GPIO_PIN_MASK);
-	RESET_TIMER1();
-
-	// Clear flag
-	ADC_ETC->DONE2_3_ERR_IRQ = ADC_ETC_DONE2_3_ERR_IRQ_TRIG7_DONE3_MASK;
-
-
-	MCDRV_GetRotorCurrentRev(&g_sM4QdcSensor);
-	MCDRV_GetRotorDeltaRev(&g_sM4QdcSensor);
-
-
-    /*========================= State machine begin========================================================*/
-
-    /* M1 State machine */
-    SM_StateMachineFast(&g_sM4Ctrl);
-
-   	/*========================= State machine end =========================================================*/
-    sMotorStatusFromMotorLoopIsr.sFast.eFaultStatus = g_sM4Drive.ui32FaultIdCapturedExt;
-    g_sM4Drive.ui32FaultIdCapturedExt = kMC_NoFaultMC; // Clear captured fault Id
-    sMotorStatusFromMotorLoopIsr.sFast.eMotorState = g_sM4Ctrl.eState;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIa = g_sM4Drive.sFocPMSM.sIABC.fltA;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIb = g_sM4Drive.sFocPMSM.sIABC.fltB;
-    sMotorStatusFromMotorLoopIsr.sFast.fltIc = g_sM4Drive.sFocPMSM.sIABC.fltC;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVDcBus = g_sM4Drive.sFocPMSM.fltUDcBusFilt;
-    sMotorStatusFromMotorLoopIsr.sFast.fltValpha = g_sM4Drive.sFocPMSM.sUAlBeReq.fltAlpha;
-    sMotorStatusFromMotorLoopIsr.sFast.fltVbeta = g_sM4Drive.sFocPMSM.sUAlBeReq.fltBeta;
-    MC_SetFastMotorStatus_fromISR(kMC_Motor4, &sMotorStatusFromMotorLoopIsr.sFast);
-
-    if(++ui16CntFastloopM4 >= (uint16_t)(M4_FAST_LOOP_FREQ))
-    {
-    	ui16CntFastloopM4 = 0;
-    }
-
-    ui16ExeTime_fastloopM4 = READ_TIMER1();
-
-    __DSB();
+	Mx_fastloop_handler(&s_sMotorLoop[kMC_Motor4]);
 }
 
 /*!
@@ -27,6 +27,8 @@
                                                        Enable the test of speed loop bandwidth in speed FOC mode.
                                                        Enable the test of position loop bandwidth in position FOC mode */
 #define FEATURE_MC_PSB_TEMPERATURE_FAULTS		(0)
+#define FEATURE_MC_FOC_PROFILING                (0) /* Enable the DWT cycle counter probes around the fast loop stages (see mc_profile.h) */
+#define FEATURE_MC_PLANT_SIMULATION             (0) /* Enable the motor 1 control loop step experiments against a simulated PMSM (see mc_plant_sim.h) */
 #define FEATURE_TSN_DEBUG_ENABLED				(0)
 #define FEATURE_TSN_PRINT_IF					(1)
 #define FEATURE_FREEMASTER_ENABLE				(1) // TODO: Disable freemaster in the final release
@@ -44,6 +46,7 @@
 #define MC_LIMIT_L_FREQUENCY (-40.0f)     /* Lower limit for the frequency in HZ when using kMC_ScalarControl */
 #define MC_LIMIT_H_POSITION  (100 << 16)  /* Upper limit for the position (revolutions) in Q16.16 format when using kMC_FOC_PositionControl */
 #define MC_LIMIT_L_POSITION  (-100 << 16) /* Lower limit for the position (revolutions) in Q16.16 format when using kMC_FOC_PositionControl */
+#define MC_LIMIT_CTRL_TUNING_GAIN_RANGE (32.0f) /* Controller gains handed to MC_SetControllerTuning() may exceed the Mx_pmsm_appconfig.h gains at most by this factor */
 
 
 
@@ -55,9 +58,12 @@
 
 /* CONFIGURATION */
 #define DATAHUB_MAX_STATUS_QUEUES           (4)
-#define DATAHUB_STATUS_QUEUE_LENGTH         (10)
+#define DATAHUB_STATUS_RING_LENGTH          (32)  /* Number of motor status snapshots shared by all status queue handles; must be a power of two */
 #define DATAHUB_COMMAND_QUEUE_LENGTH        (10)
 #define DATAHUB_STATUS_SAMPLING_INTERVAL_MS (100)
+#define DATAHUB_FUNCTIONAL_WATCHDOG_KICK_PERIOD_MS (5000)  /* Kick period of the DataHub functional watchdog; independent of the command and status traffic */
+#define DATAHUB_CTRL_TUNING_STORE_INTERVAL_MS (1000)  /* Period in which changed controller gains are written to the configuration; at most one flash update per period */
+#define DATAHUB_CTRL_TUNING_STORE_MAX_FAILURES (3)    /* Failed flash updates after which changed controller gains are no longer retried until the next identification */
 
 
 
@@ -88,7 +94,9 @@
 #define FEATURE_BOARD_SANITY_CHECK_DAY_OF_WEEK   (1)
 
 /* CONFIGURATION */
-#define BOARD_GETTIME_REFRESH_INTERVAL_S (24*60*60) /* After this time the tick-based time is synchronized to the RTC again */
+#define BOARD_GETTIME_REFRESH_INTERVAL_S (60)        /* Interval in which the counter-based time is disciplined against the RTC */
+#define BOARD_GETTIME_MAX_RATE_PPM       (500)       /* Maximal rate correction applied to the counter-based time, must exceed the tolerance of the 24 MHz crystal clocking GPT5 */
+#define BOARD_GETTIME_STEP_THRESHOLD_MS  (1000)      /* Larger deviations from the RTC are stepped instead of slewed */
 
 /*******************************************************************************
  * Fault Detection
@@ -187,6 +195,9 @@
 /* Enables the secure watchdog */
 #define FEATURE_SECURE_WATCHDOG (0)
 
+/* Enables the RPC latency instrumentation (see RPC_GetCallStats()) */
+#define FEATURE_RPC_STATS (0)
+
 /* URL of the secure watchdog ticket server
  * (client attempts to connect to port 443 as TLS must be used) */
 #define SECURE_WATCHDOG_HOST "api.awdt.server"
@@ -389,8 +400,8 @@
 #error "Datalogger data area space exceeds UINT32_MAX"
 #endif
 
-#if BOARD_GETTIME_REFRESH_INTERVAL_S > UINT32_MAX
-    #error "BOARD_GETTIME_REFRESH_INTERVAL_S must not exceed UINT32_MAX"
+#if( (BOARD_GETTIME_REFRESH_INTERVAL_S < 1) || (BOARD_GETTIME_REFRESH_INTERVAL_S > 3600) )
+    #error "BOARD_GETTIME_REFRESH_INTERVAL_S out of range! <1,3600> allowed (1 MHz counter wraps after 71 minutes)."
 #endif
 
 #if( (MC_MAX_MOTORS < 1) || (MC_MAX_MOTORS > 4) )
@@ -409,8 +420,8 @@
     #error "BOARD_GETTIME_REFRESH_INTERVAL_S must not exceed UINT32_MAX"
 #endif
 
-#if(DATAHUB_STATUS_QUEUE_LENGTH < MC_MAX_MOTORS)
-    #error "Status queue length cannot be smaller than the number of motors."
+#if((DATAHUB_STATUS_RING_LENGTH < 2) || ((DATAHUB_STATUS_RING_LENGTH & (DATAHUB_STATUS_RING_LENGTH - 1)) != 0))
+    #error "Status ring length must be a power of two and hold at least two snapshots."
 #endif
 
 #if ((MC_HAS_AFE_MOTOR1 > 1 || MC_HAS_AFE_MOTOR1 < 0) || (MC_HAS_AFE_MOTOR2 > 1 || MC_HAS_AFE_MOTOR2 < 0) ||\
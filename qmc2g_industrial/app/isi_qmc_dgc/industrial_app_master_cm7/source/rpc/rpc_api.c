@@ -93,6 +93,7 @@
 #include "event_groups.h"
 
 #include "api_qmc_common.h"
+#include "api_board.h"
 #include "api_logging.h"
 #include "api_usermanagement.h"
 #include "main_cm7.h"
@@ -142,20 +143,39 @@ STATIC_TEST_VISIBLE EventGroupHandle_t
 /* NOTE: Add a rpc_call_data_t struct for registering a new command here. */
 #if FEATURE_SECURE_WATCHDOG
 STATIC_TEST_VISIBLE rpc_call_data_t gs_secWdCallData = {&gs_rpcSHM.secWd.status, kRPC_EventSecWdDone,
-                                                        RPC_SECWD_TIMEOUT_TICKS}; /*!< Sec WD PRC data. */
+                                                        RPC_SECWD_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                            kRPC_StatsCallSecWd)}; /*!< Sec WD PRC data. */
 #endif
 STATIC_TEST_VISIBLE rpc_call_data_t gs_funcWdCallData   = {&gs_rpcSHM.funcWd.status, kRPC_EventFuncWdDone,
-                                                           RPC_FUNCWD_TIMEOUT_TICKS}; /*!< Func WD RPC data. */
+                                                           RPC_FUNCWD_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                               kRPC_StatsCallFuncWd)}; /*!< Func WD RPC data. */
 STATIC_TEST_VISIBLE rpc_call_data_t gs_gpioOutCallData  = {&gs_rpcSHM.gpioOut.status, kRPC_EventGpioOutDone,
-                                                           RPC_GPIOOUT_TIMEOUT_TICKS}; /*!< GPIO out RPC data. */
+                                                           RPC_GPIOOUT_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                               kRPC_StatsCallGpioOut)}; /*!< GPIO out RPC data. */
 STATIC_TEST_VISIBLE rpc_call_data_t gs_rtcCallData      = {&gs_rpcSHM.rtc.status, kRPC_EventRtcDone,
-                                                           RPC_RTC_TIMEOUT_TICKS}; /*!< RTC RPC data. */
+                                                           RPC_RTC_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                               kRPC_StatsCallRtc)}; /*!< RTC RPC data. */
 STATIC_TEST_VISIBLE rpc_call_data_t gs_fwUpdateCallData = {&gs_rpcSHM.fwUpdate.status, kRPC_EventFwUpdateDone,
-                                                           RPC_FWUPDATE_TIMEOUT_TICKS}; /*!< FWU RPC data. */
+                                                           RPC_FWUPDATE_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                               kRPC_StatsCallFwUpdate)}; /*!< FWU RPC data. */
 STATIC_TEST_VISIBLE rpc_call_data_t gs_resetCallData    = {&gs_rpcSHM.reset.status, kRPC_EventResetDone,
-                                                           RPC_RESET_TIMEOUT_TICKS}; /*!< Reset RPC data. */
+                                                           RPC_RESET_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                               kRPC_StatsCallReset)}; /*!< Reset RPC data. */
 STATIC_TEST_VISIBLE rpc_call_data_t gs_mcuTempCallData  = {&gs_rpcSHM.mcuTemp.status, kRPC_EventMcuTempDone,
-                                                           RPC_MCU_TEMP_TIMEOUT_TICKS}; /*!< MCU temp RPC data. */                                                           
+                                                           RPC_MCU_TEMP_TIMEOUT_TICKS RPC_CALL_STATS_INIT(
+                                                               kRPC_StatsCallMcuTemp)}; /*!< MCU temp RPC data. */
+STATIC_TEST_VISIBLE rpc_call_data_t gs_memDeltaWriteCallData = {
+    &gs_rpcSHM.memDeltaWrite.status, kRPC_EventMemDeltaWriteDone,
+    RPC_MEM_DELTA_WRITE_TIMEOUT_TICKS RPC_CALL_STATS_INIT(kRPC_StatsCallMemDeltaWrite)}; /*!< Mem delta write RPC data. */
+
+#if FEATURE_RPC_STATS
+rpc_call_stats_t g_rpcCallStats[kRPC_StatsCallCount]; /*!< Latency statistics of all remote calls. */
+
+/*! @brief Names of the remote call types, indexed by rpc_stats_call_id_t. */
+static const char *const gs_kRpcStatsCallNames[kRPC_StatsCallCount] = {
+    "secWd", "funcWd", "gpioOut", "rtc", "fwUpdate", "reset", "mcuTemp", "memDeltaWrite"};
+#endif
+
 /*!
  * @brief Pointers to information about all available RPCs.
  *
@@ -166,7 +186,7 @@ static rpc_call_data_t *const gs_kRpcDataPointers[] = {
     &gs_secWdCallData,
 #endif
     &gs_funcWdCallData, &gs_gpioOutCallData, &gs_rtcCallData, &gs_fwUpdateCallData, &gs_resetCallData,
-    &gs_mcuTempCallData};    
+    &gs_mcuTempCallData, &gs_memDeltaWriteCallData};    
 
 /*******************************************************************************
  * Code
@@ -373,6 +393,22 @@ void RPC_Init(void)
         assert(NULL != gs_kRpcDataPointers[i]->mutex);
     }
 
+    /* enable the cycle counter (without resetting it, it may be used elsewhere) */
+    DEBUG_ARM_CM_DEMCR |= 1U << 24U;
+    DEBUG_ARM_CM_DWT_CTRL |= 1U << 0U;
+
+#if FEATURE_RPC_STATS
+    /* initialize RPC latency statistics */
+    for (size_t i = 0U; i < kRPC_StatsCallCount; i++)
+    {
+        stats_init(&g_rpcCallStats[i].prepare, RPC_STATS_LOG2_WINDOW, NULL, NULL);
+        stats_init(&g_rpcCallStats[i].notify, RPC_STATS_LOG2_WINDOW, NULL, NULL);
+        stats_init(&g_rpcCallStats[i].roundTrip, RPC_STATS_LOG2_WINDOW, NULL, NULL);
+        /* hist_init() adds the overflow slot itself */
+        (void)hist_init(&g_rpcCallStats[i].roundTripLog2, RPC_STATS_HIST_SLOTS - 1U, 1U);
+    }
+#endif
+
     /* priority of the inter-core interrupt and communication */
     NVIC_SetPriority(GPR_IRQ_IRQn, RPC_INTERCORE_IRQ_PRIORITY);
     /* enable interrupt */
@@ -444,9 +480,103 @@ static void TriggerInterCoreIRQ(void)
     __ISB();
 }
 
+#if FEATURE_RPC_STATS
+/*!
+ * @brief Records the round trip time of a completed remote call.
+ *
+ * Must be called while the remote call's mutex is held.
+ *
+ * @param[in,out] pStats Pointer to the remote call's statistics.
+ */
+static void RecordRoundTrip(rpc_call_stats_t *const pStats)
+{
+    const uint32_t cycles = DEBUG_ARM_CM_DWT_CYCCNT - pStats->startCycles;
+
+    stats_update(&pStats->roundTrip, (int32_t)cycles);
+    /* slot 0: 0 cycles, slot n: [2^(n-1), 2^n) cycles */
+    hist_update(&pStats->roundTripLog2, 32U - __CLZ(cycles));
+    pStats->calls++;
+}
+#endif
+
+/*!
+ * @brief Polls until the CM4 has completed the pending command of a remote call, without sleeping.
+ *
+ * Yields to other ready tasks of the same priority between the polls.
+ *
+ * Reentrant function.
+ *
+ * @param[in] pRpcCallData Pointer to a rpc_call_data_t struct describing the remote call.
+ * @param[in] spinCycles Maximal polling time in CM7 core cycles.
+ * @return true if the pending command was completed within spinCycles.
+ *
+ */
+static bool PollCompletion(const rpc_call_data_t *const pRpcCallData, const uint32_t spinCycles)
+{
+    const uint32_t startCycles = DEBUG_ARM_CM_DWT_CYCCNT;
+
+    while (pRpcCallData->pStatus->isNew && ((DEBUG_ARM_CM_DWT_CYCCNT - startCycles) < spinCycles))
+    {
+        /* CM4 still processing, let other tasks run before trying again */
+        taskYIELD();
+    }
+
+    return !pRpcCallData->pStatus->isNew;
+}
+
+/*!
+ * @brief Re-arms the completion notification of a pending remote call and retriggers the CM4.
+ *
+ * WaitCM4() gives up the notification of a timed-out command by setting isProcessed. Clearing it again makes
+ * the CM4 notify the CM7 as soon as the pending command is completed, or immediately if it already is, so that
+ * the completion event of the remote call is set.
+ *
+ * Reentrant function.
+ *
+ * @param[in] pRpcCallData Pointer to a rpc_call_data_t struct describing the remote call.
+ *
+ */
+static void RearmCompletion(const rpc_call_data_t *const pRpcCallData)
+{
+    BaseType_t semaphoreRet = pdFALSE;
+    (void)semaphoreRet;
+
+    /* if we can not get the inter-core mutex, then continue normally
+     *  -> some task has recently performed or will shortly perform an inter-core interrupt */
+    if (pdTRUE == xSemaphoreTake(gs_rpcTriggerIrqMutex, portMAX_DELAY))
+    {
+        /* disable communication interrupt, so that the completion can not be detected by RPC_HandleISR
+         * before the event group bit is cleared (see NotifyCM4()) */
+        NVIC_DisableIRQ(GPR_IRQ_IRQn);
+        /* see TriggerInterCoreIRQ for reasoning of barrier */
+        __DSB();
+        __ISB();
+
+        /* critical section */
+        pRpcCallData->pStatus->isProcessed = false;
+        (void)xEventGroupClearBits(gs_rpcDoneEventGroup, pRpcCallData->completionEvent);
+
+        /* maybe the IRQ was missed on the CM4 */
+        TriggerInterCoreIRQWhileIRQDisabled();
+
+        NVIC_EnableIRQ(GPR_IRQ_IRQn);
+        /* see triggerInterCoreIRQ for reasoning of barrier */
+        __DSB();
+        __ISB();
+        semaphoreRet = xSemaphoreGive(gs_rpcTriggerIrqMutex);
+        /* would be an programming error */
+        assert(pdTRUE == semaphoreRet);
+    }
+}
+
 /*!
  * @brief Checks if the SHM for communication is in a consistent state.
  *
+ * The CM4 writes the return value before it clears isNew (with a barrier in between) and the CM7 reads it only
+ * after it observed isNew cleared, so a return value can not be read torn. The only inconsistent state is a
+ * command of a previous, timed-out invocation which is still pending on the CM4. Then the task blocks on the
+ * remote call's completion event, which is set as soon as the CM4 completes the pending command.
+ *
  * Reentrant function.
  *
  * @param[in] pRpcCallData Pointer to a rpc_call_data_t struct describing the remote call.
@@ -459,9 +589,7 @@ static void TriggerInterCoreIRQ(void)
  */
 static qmc_status_t ConsistencyCheck(const rpc_call_data_t *const pRpcCallData)
 {
-    qmc_status_t ret        = kStatus_QMC_Err;
-    BaseType_t semaphoreRet = pdFALSE;
-    (void)semaphoreRet;
+    qmc_status_t ret = kStatus_QMC_Err;
 
     /* should a command still be pending from a previous invocation we have to wait
      * until its completed or else time out and return an inconsistency error
@@ -471,29 +599,34 @@ static qmc_status_t ConsistencyCheck(const rpc_call_data_t *const pRpcCallData)
      */
     if (pRpcCallData->pStatus->isNew)
     {
-        /* if we can not get the inter-core mutex, then continue normally
-         *  -> some task has recently performed or will shortly perform an inter-core interrupt */
-        if (pdTRUE == xSemaphoreTake(gs_rpcTriggerIrqMutex, portMAX_DELAY))
+        RearmCompletion(pRpcCallData);
+
+        /* poll first, as a retriggered command is usually completed within microseconds;
+         * commands deferred to the CM4 main loop take longer, so do not spin for them */
+        if (pRpcCallData->pStatus->waitForAsyncCompletionCM4 ||
+            !PollCompletion(pRpcCallData, RPC_CONSISTENCY_SPIN_US * (SystemCoreClock / 1000000U)))
         {
-            /* maybe the IRQ was missed on the CM4 */
-            TriggerInterCoreIRQ();
-            semaphoreRet = xSemaphoreGive(gs_rpcTriggerIrqMutex);
-            /* would be an programming error */
-            assert(pdTRUE == semaphoreRet);
+            /* wait for the completion of the pending command, returns as soon as the CM4 completed it */
+#if FEATURE_RPC_STATS
+            pRpcCallData->pStats->consistencySleeps++;
+#endif
+            (void)xEventGroupWaitBits(gs_rpcDoneEventGroup, pRpcCallData->completionEvent, pdFALSE, pdFALSE,
+                                      pRpcCallData->timeoutTicks);
         }
-
-        /* wait */
-        vTaskDelay(pRpcCallData->timeoutTicks);
     }
 
     /* still not processed */
     if (pRpcCallData->pStatus->isNew)
     {
+        /* give up the notification again (see WaitCM4()) */
+        pRpcCallData->pStatus->isProcessed = true;
         /* return inconsistency error */
         ret = kStatus_QMC_ErrSync;
     }
     else
     {
+        /* the CM4 completed its accesses to the call's data before it cleared isNew */
+        __DMB();
         ret = kStatus_QMC_Ok;
     }
 
@@ -530,6 +663,9 @@ static qmc_status_t PrepareCall(const rpc_call_data_t *const pRpcCallData)
     qmc_status_t ret        = kStatus_QMC_Err;
     BaseType_t semaphoreRet = pdFALSE;
     (void)semaphoreRet;
+#if FEATURE_RPC_STATS
+    const uint32_t startCycles = DEBUG_ARM_CM_DWT_CYCCNT;
+#endif
 
     /* try to take semaphore
      * another task might be processing this call right now,
@@ -555,6 +691,10 @@ static qmc_status_t PrepareCall(const rpc_call_data_t *const pRpcCallData)
         }
         else
         {
+#if FEATURE_RPC_STATS
+            pRpcCallData->pStats->startCycles = startCycles;
+            stats_update(&pRpcCallData->pStats->prepare, (int32_t)(DEBUG_ARM_CM_DWT_CYCCNT - startCycles));
+#endif
             ret = kStatus_QMC_Ok;
         }
     }
@@ -591,6 +731,9 @@ static qmc_status_t NotifyCM4(const rpc_call_data_t *const pRpcCallData)
     qmc_status_t ret        = kStatus_QMC_Err;
     BaseType_t semaphoreRet = pdFALSE;
     (void)semaphoreRet;
+#if FEATURE_RPC_STATS
+    const uint32_t startCycles = DEBUG_ARM_CM_DWT_CYCCNT;
+#endif
 
     /* to allow the use of the preemptive scheduler we have to ensure
      * that the following part is not entered by any other task
@@ -627,6 +770,9 @@ static qmc_status_t NotifyCM4(const rpc_call_data_t *const pRpcCallData)
         /* would be an programming error */
         assert(pdTRUE == semaphoreRet);
 
+#if FEATURE_RPC_STATS
+        stats_update(&pRpcCallData->pStats->notify, (int32_t)(DEBUG_ARM_CM_DWT_CYCCNT - startCycles));
+#endif
         ret = kStatus_QMC_Ok;
     }
     else
@@ -638,6 +784,60 @@ static qmc_status_t NotifyCM4(const rpc_call_data_t *const pRpcCallData)
     return ret;
 }
 
+/*!
+ * @brief Waits for the result of a remote call previously posted with NotifyCM4().
+ *
+ * Waits for the remote command to finish (with a timeout defined in the remote call's
+ * rpc_call_data_t struct) and returns its result.
+ *
+ * Reentrant function, multiple invocations for different remote calls
+ * (different rpc_call_data_t structures) are allowed.
+ *
+ * @param[in] pRpcCallData Pointer to a rpc_call_data_t struct describing the remote call.
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_Timeout
+ * The command execution timed out on the CM4.
+ * @retval Any return value the remote command might return.
+ *
+ */
+static qmc_status_t WaitCM4(const rpc_call_data_t *const pRpcCallData)
+{
+    qmc_status_t ret        = kStatus_QMC_Err;
+    EventBits_t uxEventBits = 0U;
+
+    /* wait until RPC call finishes */
+    uxEventBits = xEventGroupWaitBits(gs_rpcDoneEventGroup, pRpcCallData->completionEvent, pdFALSE, pdFALSE,
+                                      pRpcCallData->timeoutTicks);
+    if (0x00U == (uxEventBits & pRpcCallData->completionEvent))
+    {
+        /* timed out
+         * set back isProcessed to true
+         * the event bit for the timed-out command is not set anymore in the communication ISR
+         * after this point (so the result of the timed-out command is ignored)
+         * still, there might be a problem if a command hangs until we are at this point again
+         * then, the result of the old (hanging) invocation might be returned
+         * to avoid such cases the state of the communication flags is checked beforehand
+         * (see ConsistencyCheck)
+         */
+        DEBUG_LOG_W(DEBUG_M7_TAG "RPC call timed out!\r\n");
+        pRpcCallData->pStatus->isProcessed = true;
+        ret                                = kStatus_QMC_Timeout;
+#if FEATURE_RPC_STATS
+        pRpcCallData->pStats->timeouts++;
+#endif
+    }
+    else
+    {
+        /* pass on received response */
+        ret = pRpcCallData->pStatus->retval;
+#if FEATURE_RPC_STATS
+        RecordRoundTrip(pRpcCallData->pStats);
+#endif
+    }
+
+    return ret;
+}
+
 /*!
  * @brief Notifies the CM4 about a pending remote call and returns its result.
  *
@@ -646,8 +846,7 @@ static qmc_status_t NotifyCM4(const rpc_call_data_t *const pRpcCallData)
  * the command should have been set in the shared memory region dedicated for communication.
  * This function sets the necessary synchronization flags and notifies the CM4
  * about the pending remote call request. Then, it waits for the remote command
- * to finish (with a timeout defined in the remote call's rpc_call_data_t
- * struct).
+ * to finish (see WaitCM4()).
  *
  * Reentrant function, multiple invocations for different remote calls
  * (different rpc_call_data_t structures) are allowed.
@@ -661,36 +860,13 @@ static qmc_status_t NotifyCM4(const rpc_call_data_t *const pRpcCallData)
  */
 static qmc_status_t NotifyWaitCM4(const rpc_call_data_t *const pRpcCallData)
 {
-    qmc_status_t ret        = kStatus_QMC_Err;
-    EventBits_t uxEventBits = 0U;
+    qmc_status_t ret = kStatus_QMC_Err;
 
     ret = NotifyCM4(pRpcCallData);
     /* everything ok, no timeout */
     if (kStatus_QMC_Ok == ret)
     {
-        /* wait until RPC call finishes */
-        uxEventBits = xEventGroupWaitBits(gs_rpcDoneEventGroup, pRpcCallData->completionEvent, pdFALSE, pdFALSE,
-                                          pRpcCallData->timeoutTicks);
-        if (0x00U == (uxEventBits & pRpcCallData->completionEvent))
-        {
-            /* timed out
-             * set back isProcessed to true
-             * the event bit for the timed-out command is not set anymore in the communication ISR
-             * after this point (so the result of the timed-out command is ignored)
-             * still, there might be a problem if a command hangs until we are at this point again
-             * then, the result of the old (hanging) invocation might be returned
-             * to avoid such cases the state of the communication flags is checked beforehand
-             * (see ConsistencyCheck)
-             */
-            DEBUG_LOG_W(DEBUG_M7_TAG "RPC call timed out!\r\n");
-            pRpcCallData->pStatus->isProcessed = true;
-            ret                                = kStatus_QMC_Timeout;
-        }
-        else
-        {
-            /* pass on received response */
-            ret = pRpcCallData->pStatus->retval;
-        }
+        ret = WaitCM4(pRpcCallData);
     }
 
     DEBUG_LOG_I(DEBUG_M7_TAG "RPC call return status = %d\r\n.", ret);
@@ -864,32 +1040,50 @@ qmc_status_t RPC_SetSnvsOutput(uint16_t gpioState)
     return ret;
 }
 
-qmc_status_t RPC_SelectPowerStageBoardSpiDevice(qmc_spi_id_t mode)
+/*!
+ * @brief Encodes the SPI selection pin states for the given SPI device.
+ *
+ * @param[in] mode The SPI device to be selected
+ * @param[out] pGpioState Pointer to write the gpioState (see RPC_SetSnvsOutput()) to
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_ErrRange
+ * Specified mode was not part of the supported enumeration.
+ * @retval kStatus_QMC_Ok
+ * The operation was successful.
+ */
+static qmc_status_t EncodePowerStageBoardSpiDevice(qmc_spi_id_t mode, uint16_t *pGpioState)
 {
-    qmc_status_t ret   = kStatus_QMC_Err;
-    uint16_t gpioState = 0U;
+    qmc_status_t ret = kStatus_QMC_Ok;
 
-    /* decode + sanity check */
-    ret = kStatus_QMC_Ok;
     switch (mode)
     {
         case kQMC_SpiNone:
-            gpioState = (RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            *pGpioState = (RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
             break;
         case kQMC_SpiMotorDriver:
-            gpioState = (RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            *pGpioState = (RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
             break;
         case kQMC_SpiAfe:
-            gpioState = (RPC_SPI_CS0_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            *pGpioState = (RPC_SPI_CS0_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
             break;
         case kQMC_SpiAbsEncoder:
-            gpioState = (RPC_SPI_CS1_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            *pGpioState = (RPC_SPI_CS1_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
             break;
         default:
             ret = kStatus_QMC_ErrRange;
             break;
     }
 
+    return ret;
+}
+
+qmc_status_t RPC_SelectPowerStageBoardSpiDevice(qmc_spi_id_t mode)
+{
+    qmc_status_t ret   = kStatus_QMC_Err;
+    uint16_t gpioState = 0U;
+
+    /* decode + sanity check */
+    ret = EncodePowerStageBoardSpiDevice(mode, &gpioState);
     if (kStatus_QMC_Ok == ret)
     {
         ret = RPC_SetSnvsOutput(gpioState);
@@ -898,6 +1092,162 @@ qmc_status_t RPC_SelectPowerStageBoardSpiDevice(qmc_spi_id_t mode)
     return ret;
 }
 
+qmc_status_t RPC_SetSnvsOutputAsync(uint16_t gpioState, rpc_async_token_t *token)
+{
+    qmc_status_t ret                          = kStatus_QMC_Err;
+    const rpc_call_data_t *const pRpcCallData = &gs_gpioOutCallData;
+
+    /* invalid arguments */
+    if (NULL == token)
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    /* valid arguments */
+    else
+    {
+        token->pCallData = NULL;
+        /* prepare remote call */
+        ret = PrepareCall(pRpcCallData);
+    }
+
+    /* process if no errors occurred */
+    if (kStatus_QMC_Ok == ret)
+    {
+        /* call specific data preparation */
+        gs_rpcSHM.gpioOut.gpioState = gpioState;
+
+        /* notify CM4, the result is collected by RPC_WaitAsync() */
+        ret = NotifyCM4(pRpcCallData);
+        if (kStatus_QMC_Ok == ret)
+        {
+            /* the remote call stays locked until RPC_WaitAsync() is called */
+            token->pCallData = pRpcCallData;
+        }
+        else
+        {
+            /* clean up remote call */
+            RPC_CleanupCall(pRpcCallData);
+        }
+    }
+
+    return ret;
+}
+
+qmc_status_t RPC_SelectPowerStageBoardSpiDeviceAsync(qmc_spi_id_t mode, rpc_async_token_t *token)
+{
+    qmc_status_t ret   = kStatus_QMC_Err;
+    uint16_t gpioState = 0U;
+
+    /* decode + sanity check */
+    ret = EncodePowerStageBoardSpiDevice(mode, &gpioState);
+    if (kStatus_QMC_Ok == ret)
+    {
+        ret = RPC_SetSnvsOutputAsync(gpioState, token);
+    }
+
+    return ret;
+}
+
+bool RPC_IsAsyncCompleted(const rpc_async_token_t *token)
+{
+    const rpc_call_data_t *pRpcCallData = NULL;
+
+    if ((NULL == token) || (NULL == token->pCallData))
+    {
+        return false;
+    }
+
+    pRpcCallData = token->pCallData;
+    return (0U != (xEventGroupGetBits(gs_rpcDoneEventGroup) & pRpcCallData->completionEvent));
+}
+
+qmc_status_t RPC_WaitAsync(rpc_async_token_t *token)
+{
+    qmc_status_t ret                    = kStatus_QMC_Err;
+    const rpc_call_data_t *pRpcCallData = NULL;
+
+    /* invalid arguments */
+    if ((NULL == token) || (NULL == token->pCallData))
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    else
+    {
+        pRpcCallData     = token->pCallData;
+        token->pCallData = NULL;
+
+        /* wait for result */
+        ret = WaitCM4(pRpcCallData);
+        DEBUG_LOG_I(DEBUG_M7_TAG "RPC call return status = %d\r\n.", ret);
+
+        /* clean up remote call */
+        RPC_CleanupCall(pRpcCallData);
+    }
+
+    return ret;
+}
+
+qmc_status_t RPC_GpioBatchAddSnvsOutput(rpc_gpio_batch_t *batch, uint16_t gpioState)
+{
+    uint16_t dataMask   = 0U;
+    uint16_t modifyMask = 0U;
+
+    /* invalid arguments */
+    if ((NULL == batch) || (0U != (gpioState & ~RPC_OUTPUT_CONTROL_MASK)))
+    {
+        return kStatus_QMC_ErrArgInvalid;
+    }
+
+    /* the modify bits are located 4 (outputs) resp. 2 (SPI selection) bits above their data bits
+     * a later change overrides the data of an earlier change of the same pin,
+     * data bits of pins which are not modified by this change are ignored */
+    dataMask = ((gpioState >> 4U) & (RPC_DIGITAL_OUTPUT4_DATA | RPC_DIGITAL_OUTPUT5_DATA | RPC_DIGITAL_OUTPUT6_DATA |
+                                     RPC_DIGITAL_OUTPUT7_DATA)) |
+               ((gpioState >> 2U) & (RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA));
+    modifyMask = gpioState & (RPC_DIGITAL_OUTPUT4_MODIFY | RPC_DIGITAL_OUTPUT5_MODIFY | RPC_DIGITAL_OUTPUT6_MODIFY |
+                              RPC_DIGITAL_OUTPUT7_MODIFY | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+    batch->gpioState = (batch->gpioState & ~dataMask) | (gpioState & dataMask) | modifyMask;
+
+    return kStatus_QMC_Ok;
+}
+
+qmc_status_t RPC_GpioBatchAddPowerStageBoardSpiDevice(rpc_gpio_batch_t *batch, qmc_spi_id_t mode)
+{
+    qmc_status_t ret   = kStatus_QMC_Err;
+    uint16_t gpioState = 0U;
+
+    /* decode + sanity check */
+    ret = EncodePowerStageBoardSpiDevice(mode, &gpioState);
+    if (kStatus_QMC_Ok == ret)
+    {
+        ret = RPC_GpioBatchAddSnvsOutput(batch, gpioState);
+    }
+
+    return ret;
+}
+
+qmc_status_t RPC_GpioBatchCommitAsync(rpc_gpio_batch_t *batch, rpc_async_token_t *token)
+{
+    qmc_status_t ret = kStatus_QMC_Err;
+
+    /* invalid arguments */
+    if (NULL == batch)
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    else
+    {
+        /* all coalesced changes are applied by the CM4 within one command */
+        ret = RPC_SetSnvsOutputAsync(batch->gpioState, token);
+        if (kStatus_QMC_Ok == ret)
+        {
+            batch->gpioState = 0U;
+        }
+    }
+
+    return ret;
+}
+
 qmc_status_t RPC_GetTimeFromRTC(qmc_timestamp_t *timestamp)
 {
     qmc_status_t ret                          = kStatus_QMC_Err;
@@ -971,6 +1321,11 @@ qmc_status_t RPC_SetTimeToRTC(const qmc_timestamp_t *timestamp)
 
         /* make sure BOARD_GetTime synchronizes its internal timestamp with the RTC */
         g_needsRefresh_getTime = true;
+        if (kStatus_QMC_Ok == ret)
+        {
+            /* step the time right away instead of waiting for the next background discipline */
+            (void)BOARD_DisciplineTime();
+        }
 
         /* run callback function if it is registered */
         if (g_TimeChangedCallback)
@@ -1209,6 +1564,193 @@ qmc_status_t RPC_GetMcuTemperature(float *temp)
     return ret;
 }
 
+qmc_status_t RPC_MemoryDeltaWrite(const qmc_mem_delta_write_t *write, uint32_t *ackMask)
+{
+    qmc_status_t ret                          = kStatus_QMC_Err;
+    const rpc_call_data_t *const pRpcCallData = &gs_memDeltaWriteCallData;
+    size_t dataIdx                            = 0U;
+
+    /* invalid arguments */
+    if ((NULL == write) || (0U == write->segmentCount) || (write->segmentCount > QMC_MEM_DELTA_WRITE_MAX_SEGMENTS))
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    /* valid arguments */
+    else
+    {
+        /* prepare remote call */
+        ret = PrepareCall(pRpcCallData);
+    }
+
+    /* process if no errors occurred */
+    if (kStatus_QMC_Ok == ret)
+    {
+        /* call specific data preparation; only the used part of the data buffer is transferred */
+        gs_rpcSHM.memDeltaWrite.write.baseAddress  = write->baseAddress;
+        gs_rpcSHM.memDeltaWrite.write.segmentCount = write->segmentCount;
+        gs_rpcSHM.memDeltaWrite.ackMask            = 0U;
+        for (size_t seg = 0U; seg < write->segmentCount; seg++)
+        {
+            const qmc_mem_delta_segment_t *const pSegment = &write->segments[seg];
+            const size_t segmentBytes                     = ((size_t)pSegment->dataWords) * sizeof(uint32_t);
+
+            if ((0U == pSegment->dataWords) || (pSegment->dataWords > (QMC_MEM_DELTA_WRITE_MAX_DATA_WORDS - dataIdx)))
+            {
+                ret = kStatus_QMC_ErrArgInvalid;
+                break;
+            }
+
+            gs_rpcSHM.memDeltaWrite.write.segments[seg] = *pSegment;
+            (void)vmemcpy(&gs_rpcSHM.memDeltaWrite.write.data[dataIdx], &write->data[dataIdx], segmentBytes);
+            gs_rpcSHM.memDeltaWrite.segmentCrc[seg] =
+                crc32Update(crc32Update(0U, pSegment, sizeof(qmc_mem_delta_segment_t)), &write->data[dataIdx],
+                            segmentBytes);
+            dataIdx += pSegment->dataWords;
+        }
+
+        if (kStatus_QMC_Ok == ret)
+        {
+            /* notify CM4 and wait for result */
+            ret = NotifyWaitCM4(pRpcCallData);
+
+            /* call specific return data passing */
+            if (NULL != ackMask)
+            {
+                *ackMask = (kStatus_QMC_Ok == ret) ? gs_rpcSHM.memDeltaWrite.ackMask : 0U;
+            }
+        }
+
+        /* cleanup remote call */
+        RPC_CleanupCall(pRpcCallData);
+    }
+
+    return ret;
+}
+
+qmc_status_t RPC_MemoryDeltaWriteAddChanges(qmc_mem_delta_write_t *write, uint16_t offset, const uint32_t *oldData,
+                                            const uint32_t *newData, size_t dataWords)
+{
+    qmc_status_t ret = kStatus_QMC_Ok;
+    size_t dataIdx   = 0U;
+    size_t i         = 0U;
+
+    /* invalid arguments */
+    if ((NULL == write) || (NULL == oldData) || (NULL == newData) ||
+        (write->segmentCount > QMC_MEM_DELTA_WRITE_MAX_SEGMENTS) ||
+        ((offset + (dataWords * sizeof(uint32_t))) > (UINT16_MAX + 1U)))
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    else
+    {
+        /* data words already used by the present segments */
+        for (size_t seg = 0U; seg < write->segmentCount; seg++)
+        {
+            dataIdx += write->segments[seg].dataWords;
+        }
+    }
+
+    /* append one word access segment per run of changed words */
+    while ((kStatus_QMC_Ok == ret) && (i < dataWords))
+    {
+        if (oldData[i] == newData[i])
+        {
+            i++;
+        }
+        else if ((write->segmentCount >= QMC_MEM_DELTA_WRITE_MAX_SEGMENTS) ||
+                 (dataIdx >= QMC_MEM_DELTA_WRITE_MAX_DATA_WORDS))
+        {
+            ret = kStatus_QMC_ErrNoBufs;
+        }
+        else
+        {
+            qmc_mem_delta_segment_t *const pSegment = &write->segments[write->segmentCount];
+
+            pSegment->offset     = (uint16_t)(offset + (i * sizeof(uint32_t)));
+            pSegment->dataWords  = 0U;
+            pSegment->accessSize = sizeof(uint32_t);
+            while ((i < dataWords) && (oldData[i] != newData[i]) && (dataIdx < QMC_MEM_DELTA_WRITE_MAX_DATA_WORDS) &&
+                   (pSegment->dataWords < UINT8_MAX))
+            {
+                write->data[dataIdx++] = newData[i++];
+                pSegment->dataWords++;
+            }
+            write->segmentCount++;
+        }
+    }
+
+    return ret;
+}
+
+#if FEATURE_RPC_STATS
+qmc_status_t RPC_GetCallStats(rpc_stats_call_id_t id, rpc_call_stats_t *stats)
+{
+    qmc_status_t ret                    = kStatus_QMC_Err;
+    const rpc_call_data_t *pRpcCallData = NULL;
+    BaseType_t semaphoreRet             = pdFALSE;
+    (void)semaphoreRet;
+
+    /* invalid arguments */
+    if ((NULL == stats) || (id >= kRPC_StatsCallCount))
+    {
+        ret = kStatus_QMC_ErrArgInvalid;
+    }
+    else
+    {
+        /* find the remote call the statistics belong to */
+        for (size_t i = 0U; i < (sizeof(gs_kRpcDataPointers) / sizeof(rpc_call_data_t *)); i++)
+        {
+            if (&g_rpcCallStats[id] == gs_kRpcDataPointers[i]->pStats)
+            {
+                pRpcCallData = gs_kRpcDataPointers[i];
+            }
+        }
+
+        if (NULL == pRpcCallData)
+        {
+            ret = kStatus_QMC_ErrRange;
+        }
+        /* the statistics are only updated while the remote call's mutex is held */
+        else if (pdTRUE == xSemaphoreTake(pRpcCallData->mutex, pRpcCallData->timeoutTicks))
+        {
+            *stats       = g_rpcCallStats[id];
+            semaphoreRet = xSemaphoreGive(pRpcCallData->mutex);
+            /* would be an programming error */
+            assert(pdTRUE == semaphoreRet);
+            ret = kStatus_QMC_Ok;
+        }
+        else
+        {
+            ret = kStatus_QMC_Timeout;
+        }
+    }
+
+    /* compute the current window, otherwise keep the last completed one */
+    if (kStatus_QMC_Ok == ret)
+    {
+        if (0U != stats->prepare.current_count)
+        {
+            stats_compute(&stats->prepare);
+        }
+        if (0U != stats->notify.current_count)
+        {
+            stats_compute(&stats->notify);
+        }
+        if (0U != stats->roundTrip.current_count)
+        {
+            stats_compute(&stats->roundTrip);
+        }
+    }
+
+    return ret;
+}
+
+const char *RPC_GetCallStatsName(rpc_stats_call_id_t id)
+{
+    return (id < kRPC_StatsCallCount) ? gs_kRpcStatsCallNames[id] : "unknown";
+}
+#endif
+
 qmc_status_t RPC_MemoryWriteIntsDisabled(const qmc_mem_write_t *write)
 {
     qmc_status_t ret = kStatus_QMC_Err;
@@ -123,6 +123,20 @@
 #define RPC_FWUPDATE_TIMEOUT_TICKS pdMS_TO_TICKS(5U) /*!< timeout in ms for the FW update RPC processing */
 #define RPC_RESET_TIMEOUT_TICKS    pdMS_TO_TICKS(5U) /*!< timeout in ms for the reset RPC processing */
 #define RPC_MCU_TEMP_TIMEOUT_TICKS pdMS_TO_TICKS(5U) /*!< timeout in ms for the MCU Temperature RPC processing */
+#define RPC_MEM_DELTA_WRITE_TIMEOUT_TICKS pdMS_TO_TICKS(5U) /*!< timeout in ms for the memory delta write RPC processing */
+
+/* a pending command is normally completed by the CM4 within a few microseconds after retriggering,
+ * so ConsistencyCheck() first polls (yielding, not sleeping) for this time before it blocks on the completion event */
+#define RPC_CONSISTENCY_SPIN_US (50U) /*!< time in us to poll for the completion of a pending remote call */
+
+/*!
+ * @brief Initializes the statistics link of a rpc_call_data_t struct (appended to the positional initializer).
+ */
+#if FEATURE_RPC_STATS
+#define RPC_CALL_STATS_INIT(ID) , &g_rpcCallStats[(ID)]
+#else
+#define RPC_CALL_STATS_INIT(ID)
+#endif
 
 /*!
  * @brief Bit flags for describing remote call completion. Only used internally.
@@ -139,7 +153,8 @@ typedef enum
     kRPC_EventRtcDone      = (1U << 3U),
     kRPC_EventFwUpdateDone = (1U << 4U),
     kRPC_EventResetDone    = (1U << 5U),
-    kRPC_EventMcuTempDone  = (1U << 6U)
+    kRPC_EventMcuTempDone  = (1U << 6U),
+    kRPC_EventMemDeltaWriteDone = (1U << 7U)
 } rpc_done_event_t;
 
 /*!
@@ -151,6 +166,9 @@ typedef struct
     volatile rpc_status_t *const pStatus;   /*!< Link to the rpc_status_t struct of the call in the g_rpcSHM struct. */
     const uint32_t completionEvent;         /*!< Event flag for notifying about completion of this remote call. */
     const TickType_t timeoutTicks;          /*!< Maximal allowed processing time for the remote call. */
+#if FEATURE_RPC_STATS
+    rpc_call_stats_t *const pStats;         /*!< Latency statistics of the remote call. */
+#endif
     StaticSemaphore_t mutexStaticBuffer;    /*!< Buffer for creating a mutex statically. */
     SemaphoreHandle_t mutex;                /*!< The remote call's mutex. */
 } rpc_call_data_t;
@@ -15,6 +15,7 @@
 #include "api_logging.h"
 #include "api_rpc.h"
 #include "api_fault.h"
+#include "api_configuration.h"
 #include "FreeRTOS.h"
 #include "event_groups.h"
 #include "timers.h"
@@ -32,7 +33,7 @@
 #endif
 
 #if( DATAHUB_MAX_STATUS_QUEUES > 22 )
-    /* 24 events per event group; first bit used for motor command queue */
+    /* 24 events per event group; first two bits are kept reserved */
     #error "Max. number of motor status queues must not exceed 22"
 #endif
 
@@ -42,10 +43,10 @@
  * Definitions
  ******************************************************************************/
 #define DATAHUB_COMMAND_QUEUE_ITEM_SIZE     (sizeof(mc_motor_command_t))
-#define DATAHUB_STATUS_QUEUE_ITEM_SIZE      (sizeof(mc_motor_status_t))
-#define DATAHUB_EVENTBIT_COMMAND_QUEUE      (1U << 0)
-#define DATAHUB_EVENTBIT_STATUS_TIMER       (1U << 1)
 #define DATAHUB_EVENTBIT_FIRST_STATUS_QUEUE (1U << 2)
+#define DATAHUB_NOTIFY_COMMAND_QUEUE        (1U << 0)
+#define DATAHUB_NOTIFY_STATUS_TIMER         (1U << 1)
+#define DATAHUB_NOTIFY_WATCHDOG_TIMER       (1U << 2)
 
 
 
@@ -53,8 +54,15 @@
  * Prototypes
  ******************************************************************************/
 void DataHubTask(void *pvParameters);
+void CtrlTuningStoreTask(void *pvParameters);
 qmc_status_t DataHubInit(void);
 static void statusSamplingTimerCallback(TimerHandle_t xTimer);
+static void watchdogKickTimerCallback(TimerHandle_t xTimer);
+static void processMotorCommands(void);
+static void processMotorStatus(void);
+static void kickFunctionalWatchdog(void);
+static void loadControllerTuning(void);
+static void storeControllerTuning(void);
 
 
 
@@ -63,25 +71,27 @@ static void statusSamplingTimerCallback(TimerHandle_t xTimer);
  ******************************************************************************/
 
 bool                   g_isInitialized_DataHub = false;
-uint32_t               g_motorStatusQueuePrescalers[DATAHUB_MAX_STATUS_QUEUES] = { 1U };
-uint32_t               g_motorStatusQueuePrescalerCounters[DATAHUB_MAX_STATUS_QUEUES] = { 1U };
 QueueHandle_t          g_motorCommandQueue = NULL;
-QueueHandle_t          g_motorStatusQueues[DATAHUB_MAX_STATUS_QUEUES] = { NULL };
+mc_status_ring_t       g_motorStatusRing = { .ui32Head = 0U, .ui32Oldest = 0U };
+mc_status_reader_t     g_motorStatusReaders[DATAHUB_MAX_STATUS_QUEUES] = { { 0 } };
 qmc_msg_queue_handle_t g_motorStatusQueueHandles[DATAHUB_MAX_STATUS_QUEUES] = { {NULL, NULL, 0} };
 EventGroupHandle_t     g_motorQueueEventGroupHandle;
-const EventBits_t      g_motorCommandQueueEventBit = DATAHUB_EVENTBIT_COMMAND_QUEUE;
+const uint32_t         g_motorCommandQueueNotifyBit = DATAHUB_NOTIFY_COMMAND_QUEUE;
 TimerHandle_t          g_statusSamplingTimerHandle;
+TimerHandle_t          g_watchdogKickTimerHandle;
 SemaphoreHandle_t      g_statusQueueMutexHandle;
 
 static StaticQueue_t gs_commandQueue;
-static StaticQueue_t gs_statusQueues[DATAHUB_MAX_STATUS_QUEUES];
 static StaticEventGroup_t gs_motorQueueEventGroup;
 static uint8_t       gs_commandQueueBuffer[DATAHUB_COMMAND_QUEUE_ITEM_SIZE * DATAHUB_COMMAND_QUEUE_LENGTH];
-static uint8_t       gs_statusQueueBuffers[DATAHUB_MAX_STATUS_QUEUES][DATAHUB_STATUS_QUEUE_ITEM_SIZE * DATAHUB_STATUS_QUEUE_LENGTH];
 static StaticTimer_t gs_statusSamplingTimer;
+static StaticTimer_t gs_watchdogKickTimer;
 static StaticSemaphore_t gs_statusQueueMutex;
+static uint32_t      gs_ctrlTuningStored[MC_MAX_MOTORS] = { 0U }; /* ui32Update of the controller gains last written to the configuration */
+static uint32_t      gs_ctrlTuningStoreFailures = 0U; /* Consecutive failed flash updates of the controller gains */
 
 TaskHandle_t g_datahub_task_handle;
+TaskHandle_t g_ctrl_tuning_store_task_handle;
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -109,15 +119,13 @@ qmc_status_t DataHubInit(void)
     	return kStatus_QMC_Err;
     vQueueAddToRegistry(g_motorCommandQueue, "motor commands");
 
+    /* status queue handles read the shared status ring; they have no message queue of their own */
     for(i=0; i<DATAHUB_MAX_STATUS_QUEUES; i++)
     {
-    	g_motorStatusQueues[i] = xQueueCreateStatic(DATAHUB_STATUS_QUEUE_LENGTH, DATAHUB_STATUS_QUEUE_ITEM_SIZE, gs_statusQueueBuffers[i], &gs_statusQueues[i]);
-        if( NULL == g_motorStatusQueues[i] )
-        	return kStatus_QMC_Err;
+        g_motorStatusReaders[i].bIsActive        = false;
         g_motorStatusQueueHandles[i].queueHandle = NULL;
         g_motorStatusQueueHandles[i].eventHandle = &g_motorQueueEventGroupHandle;
         g_motorStatusQueueHandles[i].eventMask   = (DATAHUB_EVENTBIT_FIRST_STATUS_QUEUE << i);
-        vQueueAddToRegistry(g_motorStatusQueues[i], "motor status");
     }
 
     /* initialize mutex for queue handling protection */
@@ -129,6 +137,10 @@ qmc_status_t DataHubInit(void)
     g_statusSamplingTimerHandle = xTimerCreateStatic("DataHub sampling", pdMS_TO_TICKS(DATAHUB_STATUS_SAMPLING_INTERVAL_MS),
     					                             pdTRUE, NULL, statusSamplingTimerCallback, &gs_statusSamplingTimer);
 
+    /* initialize timer for kicking the functional watchdog */
+    g_watchdogKickTimerHandle = xTimerCreateStatic("DataHub watchdog", pdMS_TO_TICKS(DATAHUB_FUNCTIONAL_WATCHDOG_KICK_PERIOD_MS),
+    					                           pdTRUE, NULL, watchdogKickTimerCallback, &gs_watchdogKickTimer);
+
 	g_isInitialized_DataHub = true;
 
 	if (RPC_KickFunctionalWatchdog(kRPC_FunctionalWatchdogDataHub) != kStatus_QMC_Ok)
@@ -159,133 +171,262 @@ qmc_status_t DataHubInit(void)
  * @brief DataHub task
  *
  * The Data Hub task bridges best-effort and real-time parts of the motor control functionality.
- * It terminates one end of the message queues of the MotorAPI. Motor commands are de-queued
- * when they become available and are transferred to the shared memory (and hence to the motor
- * control algorithm). The current motor status for each motor is polled in a regular interval
- * and then pushed to each subscribed task through the corresponding registered message queue.
- * New motor status messages in the queue are announced by emitting the event MOTOR_STATUS_EVENT.
+ * It terminates one end of the message queues of the MotorAPI. The task is woken by a direct
+ * notification for each queued motor command and transfers all pending commands to the shared
+ * memory (and hence to the motor control algorithm) at once. The current motor status for each
+ * motor is polled in a regular interval and stored once in the status ring, which all subscribed
+ * tasks read with their own cursor.
+ * New motor status messages for a subscriber are announced by emitting the event of its handle.
+ * Status sampling and the functional watchdog kick run on their own timers and never delay a command.
  */
 void DataHubTask(void *pvParameters)
 {
 	while(!g_isInitialized_DataHub)
 		vTaskDelay(pdMS_TO_TICKS(10));
 
+	/* hand the identified controller gains of the last run back to the motor control loops */
+	loadControllerTuning();
+
+	/* the first kick follows the kick in DataHubInit() after one period */
+	xTimerStart(g_watchdogKickTimerHandle, 0);
+
 	while (1)
 	{
-		if (RPC_KickFunctionalWatchdog(kRPC_FunctionalWatchdogDataHub) != kStatus_QMC_Ok)
+		uint32_t notifications = 0U;
+
+		/* sleep until a command is queued or one of the timers expires */
+		(void)xTaskNotifyWait(0U, UINT32_MAX, &notifications, portMAX_DELAY);
+
+		/* commands first, they must not wait for the status sampling */
+		if(0U != (notifications & DATAHUB_NOTIFY_COMMAND_QUEUE))
+			processMotorCommands();
+
+		if(0U != (notifications & DATAHUB_NOTIFY_STATUS_TIMER))
+			processMotorStatus();
+
+		if(0U != (notifications & DATAHUB_NOTIFY_WATCHDOG_TIMER))
+			kickFunctionalWatchdog();
+	}
+}
+
+/*!
+ * @brief Controller gains persistence task
+ *
+ * Writes the controller gains of finished motor identifications to the configuration. Erasing and
+ * programming the configuration flash takes long, so this runs in its own task below the priority of
+ * the DataHub task and updates the flash at most once per DATAHUB_CTRL_TUNING_STORE_INTERVAL_MS.
+ */
+void CtrlTuningStoreTask(void *pvParameters)
+{
+	TickType_t xLastWakeTime;
+
+	while(!g_isInitialized_DataHub)
+		vTaskDelay(pdMS_TO_TICKS(10));
+
+	xLastWakeTime = xTaskGetTickCount();
+	while (1)
+	{
+		vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(DATAHUB_CTRL_TUNING_STORE_INTERVAL_MS));
+		storeControllerTuning();
+	}
+}
+
+/*!
+ * @brief Transfers all queued motor commands to the shared memory.
+ *
+ * Commands queued while draining set the notification again, so none is left behind until the next wake-up.
+ */
+static void processMotorCommands(void)
+{
+	mc_motor_command_t cmd;
+
+	while(pdTRUE == xQueueReceive(g_motorCommandQueue, &cmd, 0))
+	{
+		/* execute motor command */
+		qmc_status_t status = MC_SetMotorCommand(&cmd);
+
+		if (kStatus_QMC_ErrBusy == status)
+		{
+			/* motor commands have been frozen and are being ignored */
+			continue;
+		}
+		/* in case of an error, write a log message */
+		else if(kStatus_QMC_Ok != status)
 		{
-			log_record_t logEntryWithoutId = {
-					.rhead = {
-							.chksum				= 0,
-							.uuid				= 0,
-							.ts = {
-								.seconds		= 0,
-								.milliseconds	= 0
-							}
-					},
-					.type = kLOG_SystemData,
-					.data.systemData.source = LOG_SRC_DataHub,
-					.data.systemData.category = LOG_CAT_General,
-					.data.systemData.eventCode = LOG_EVENT_FunctionalWatchdogKickFailed
+			log_record_t logEntryWithId = {
+			    .rhead = {
+			        .chksum = 0,
+			        .uuid   = 0,
+			        .ts = {
+			            .seconds      = 0,
+			            .milliseconds = 0
+			        }
+			    },
+			    .type                           = kLOG_FaultDataWithID,
+			    .data.faultDataWithID.source    = LOG_SRC_MotorControl,
+			    .data.faultDataWithID.category  = LOG_CAT_General,
+			    .data.faultDataWithID.id   		= (uint8_t) cmd.eMotorId,
+			    .data.faultDataWithID.eventCode = LOG_EVENT_QueueingCommandFailedInternal
 			};
-
-			LOG_QueueLogEntry(&logEntryWithoutId, false);
+			LOG_QueueLogEntry(&logEntryWithId, false);
 		}
+		else
+		{
+			;
+		}
+	}
+}
+
+/*!
+ * @brief Stores a snapshot of the motor status values in the status ring and announces it to the subscribers.
+ */
+static void processMotorStatus(void)
+{
+	unsigned int i;
+	mc_motor_id_t k;
+	uint32_t head = g_motorStatusRing.ui32Head;
+	mc_motor_status_t* motorStatus = g_motorStatusRing.sSnapshots[head & (DATAHUB_STATUS_RING_LENGTH - 1U)];
+	EventBits_t readerEvents = 0U;
+
+	/* the oldest snapshot is overwritten; readers still copying it will retry */
+	g_motorStatusRing.ui32Oldest = head + 1U - DATAHUB_STATUS_RING_LENGTH;
+	__DMB();
+
+	/* retrieve motor status values directly into the ring */
+	for(k=kMC_Motor1; k<MC_MAX_MOTORS; k++)
+		MC_GetMotorStatus(k, motorStatus+k);
 
+	__DMB();
+	g_motorStatusRing.ui32Head = head + 1U;
+
+	/* announce the snapshot to active readers that have a snapshot due */
+	for( i=0; i<DATAHUB_MAX_STATUS_QUEUES; i++)
+	{
+		if(g_motorStatusReaders[i].bIsActive && ((int32_t)(head - g_motorStatusReaders[i].ui32NextSnapshot) >= 0))
+			readerEvents |= g_motorStatusQueueHandles[i].eventMask;
+	}
+	if(0U != readerEvents)
+		xEventGroupSetBits(g_motorQueueEventGroupHandle, readerEvents);
+}
+
+/*!
+ * @brief Kicks the functional watchdog of the DataHub task and logs a failed kick.
+ */
+static void kickFunctionalWatchdog(void)
+{
+	if (RPC_KickFunctionalWatchdog(kRPC_FunctionalWatchdogDataHub) != kStatus_QMC_Ok)
+	{
+		log_record_t logEntryWithoutId = {
+				.rhead = {
+						.chksum				= 0,
+						.uuid				= 0,
+						.ts = {
+							.seconds		= 0,
+							.milliseconds	= 0
+						}
+				},
+				.type = kLOG_SystemData,
+				.data.systemData.source = LOG_SRC_DataHub,
+				.data.systemData.category = LOG_CAT_General,
+				.data.systemData.eventCode = LOG_EVENT_FunctionalWatchdogKickFailed
+		};
 
-		EventBits_t events;
-        events =  xEventGroupWaitBits(g_motorQueueEventGroupHandle, (DATAHUB_EVENTBIT_COMMAND_QUEUE | DATAHUB_EVENTBIT_STATUS_TIMER), pdFALSE, pdFALSE, portMAX_DELAY);
-
-        /* process motor command events */
-        if(events & DATAHUB_EVENTBIT_COMMAND_QUEUE)
-        {
-        	mc_motor_command_t cmd;
-
-        	if(pdTRUE == xQueuePeek(g_motorCommandQueue, &cmd, 0))
-        	{
-        		/* execute motor command */
-        		qmc_status_t status = MC_SetMotorCommand(&cmd);
-
-        		if(kStatus_QMC_ErrInterrupted != status) /* if command was executed or failed */
-        		{
-        			/* pop command from queue */
-        			xQueueReceive(g_motorCommandQueue, &cmd, 0);
-
-        			/* clear event, if no commands are pending */
-        			if( 0 == uxQueueMessagesWaiting(g_motorCommandQueue))
-        				xEventGroupClearBits(g_motorQueueEventGroupHandle, DATAHUB_EVENTBIT_COMMAND_QUEUE);
-
-        			if (kStatus_QMC_ErrBusy == status)
-        			{
-        				/* motor commands have been frozen and are being ignored */
-        				continue;
-        			}
-        		    /* in case of an error, write a log message */
-        			else if(kStatus_QMC_Ok != status)
-        			{
-                        log_record_t logEntryWithId = {
-                            .rhead = {
-                                .chksum = 0,
-                                .uuid   = 0,
-                                .ts = {
-                                    .seconds      = 0,
-                                    .milliseconds = 0
-                                }
-                            },
-                            .type                           = kLOG_FaultDataWithID,
-                            .data.faultDataWithID.source    = LOG_SRC_MotorControl,
-                            .data.faultDataWithID.category  = LOG_CAT_General,
-                            .data.faultDataWithID.id   		= (uint8_t) cmd.eMotorId,
-							.data.faultDataWithID.eventCode = LOG_EVENT_QueueingCommandFailedInternal
-                        };
-                        LOG_QueueLogEntry(&logEntryWithId, false);
-        			}
-        			else
-        			{
-        				;
-        			}
-        		}
-        	}
-        }
-
-        /* process status sampling timer events */
-        if(events & DATAHUB_EVENTBIT_STATUS_TIMER)
-        {
-        	unsigned int i;
-        	mc_motor_id_t k;
-        	mc_motor_status_t motorStatus[MC_MAX_MOTORS];
-
-        	/* retrieve motor status values */
-        	for(k=kMC_Motor1; k<MC_MAX_MOTORS; k++)
-        	{
-        		MC_GetMotorStatus(k, motorStatus+k);
-        		motorStatus[k].eMotorId = k;
-        	}
-
-        	/* find active queues */
-            for( i=0; i<DATAHUB_MAX_STATUS_QUEUES; i++)
-            {
-            	/* if queue is active and counter has expired */
-            	if((g_motorStatusQueueHandles[i].queueHandle != NULL) && (0 == --g_motorStatusQueuePrescalerCounters[i]))
-            	{
-            		g_motorStatusQueuePrescalerCounters[i] = g_motorStatusQueuePrescalers[i]; /* reset counter */
-
-            		/* send status values */
-            		for(k=0; k<MC_MAX_MOTORS; k++)
-            			xQueueSend(*(g_motorStatusQueueHandles[i].queueHandle), motorStatus+k, 0);
-
-            		/* trigger corresponding new-status-event */
-            		xEventGroupSetBits(*(g_motorStatusQueueHandles[i].eventHandle), g_motorStatusQueueHandles[i].eventMask);
-            	}
-            }
-
-            /* clear timer event */
-            xEventGroupClearBits(g_motorQueueEventGroupHandle, DATAHUB_EVENTBIT_STATUS_TIMER);
-        }
+		LOG_QueueLogEntry(&logEntryWithoutId, false);
 	}
 }
 
 static void statusSamplingTimerCallback(TimerHandle_t xTimer)
 {
-	xEventGroupSetBits(g_motorQueueEventGroupHandle, DATAHUB_EVENTBIT_STATUS_TIMER);
+	xTaskNotify(g_datahub_task_handle, DATAHUB_NOTIFY_STATUS_TIMER, eSetBits);
+}
+
+static void watchdogKickTimerCallback(TimerHandle_t xTimer)
+{
+	xTaskNotify(g_datahub_task_handle, DATAHUB_NOTIFY_WATCHDOG_TIMER, eSetBits);
+}
+
+/*!
+ * @brief Passes the controller gains stored in the configuration to the motor control loops.
+ *
+ * Records without valid gains (e.g. the defaults) keep the gains of the Mx_pmsm_appconfig.h headers.
+ */
+static void loadControllerTuning(void)
+{
+	mc_ctrl_tuning_t tuning;
+	mc_motor_id_t k;
+
+	for(k=kMC_Motor1; k<MC_MAX_MOTORS; k++)
+	{
+		if(kStatus_QMC_Ok != CONFIG_GetBinValueById((config_id_t)(kCONFIG_Key_CtrlTuningFirst + k), (unsigned char*)&tuning, sizeof(tuning)))
+			continue;
+		if(0U != tuning.ui32Valid)
+			(void)MC_SetControllerTuning(k, &tuning); /* gains out of range are rejected */
+	}
+}
+
+/*!
+ * @brief Writes controller gains that changed since the last call to the configuration.
+ *
+ * The motor control loops count their identification results from zero after every reset,
+ * so gains restored by loadControllerTuning() are not written back.
+ * A failed flash update is retried with the next call; after DATAHUB_CTRL_TUNING_STORE_MAX_FAILURES
+ * failures in a row the gains are logged as not stored and only retried after the next identification.
+ * They stay in the configuration in RAM and are written by the next successful CONFIG_UpdateFlash().
+ */
+static void storeControllerTuning(void)
+{
+	mc_ctrl_tuning_t tuning;
+	mc_motor_id_t k;
+	uint32_t stored[MC_MAX_MOTORS];
+	bool isChanged = false;
+
+	for(k=kMC_Motor1; k<MC_MAX_MOTORS; k++)
+	{
+		stored[k] = gs_ctrlTuningStored[k];
+		if(kStatus_QMC_Ok != MC_GetControllerTuning(k, &tuning))
+			continue;
+		if((0U == tuning.ui32Valid) || (tuning.ui32Update == gs_ctrlTuningStored[k]))
+			continue;
+		if(kStatus_QMC_Ok == CONFIG_SetBinValueById((config_id_t)(kCONFIG_Key_CtrlTuningFirst + k), (const unsigned char*)&tuning, sizeof(tuning)))
+		{
+			stored[k] = tuning.ui32Update;
+			isChanged = true;
+		}
+	}
+
+	/* flash is only written after an identification */
+	if(!isChanged)
+		return;
+
+	if(kStatus_QMC_Ok == CONFIG_UpdateFlash())
+	{
+		gs_ctrlTuningStoreFailures = 0U;
+	}
+	else if(++gs_ctrlTuningStoreFailures >= DATAHUB_CTRL_TUNING_STORE_MAX_FAILURES)
+	{
+		log_record_t logEntryWithoutId = {
+				.rhead = {
+						.chksum				= 0,
+						.uuid				= 0,
+						.ts = {
+							.seconds		= 0,
+							.milliseconds	= 0
+						}
+				},
+				.type = kLOG_SystemData,
+				.data.systemData.source = LOG_SRC_DataHub,
+				.data.systemData.category = LOG_CAT_General,
+				.data.systemData.eventCode = LOG_EVENT_InternalError
+		};
+
+		LOG_QueueLogEntry(&logEntryWithoutId, false);
+		gs_ctrlTuningStoreFailures = 0U;
+	}
+	else
+	{
+		return;
+	}
+
+	for(k=kMC_Motor1; k<MC_MAX_MOTORS; k++)
+		gs_ctrlTuningStored[k] = stored[k];
 }
@@ -17,6 +17,7 @@
 #include "tsn_board.h"
 #include "fsl_debug_console.h"
 #include "board.h"
+#include "api_rpc_internal.h"
 
 /*	BOARD_NetPhy1Reset
  *
@@ -65,25 +66,58 @@ void ENET_QOS_SetSYSControl(enet_qos_mii_mode_t miiMode)
  *  				-ENET_QoS clock root
  *  				-ENET_Timer3 clock root
  *
+ *  				The CCM is read-only for the CM7, every register write traps and is forwarded
+ *  				to the CM4 by a memory write RPC with interrupts disabled (see MemManage_Handler).
+ *  				Therefore the changed control registers are written by one memory delta write
+ *  				RPC instead; the trapped writes are only used if it fails.
+ *
  *  params:
  *
  */
 void BOARD_InitEnetQosClock(void)
 {
-    clock_root_config_t rootCfg = {0};
-
-
-    /* Generate 125M root clock for Enet QOS */
-    /* 1G / 2 / 4 = 125M */
-    rootCfg.mux = kCLOCK_ENET_QOS_ClockRoot_MuxSysPll1Div2;
-    rootCfg.div = 4U;
-    CLOCK_SetRootClock(kCLOCK_Root_Enet_Qos, &rootCfg);
-
-    /* Generate 200M root clock for Enet Timer3 */
-    /* 1G / 5 / 1 = 200M */
-    rootCfg.mux = kCLOCK_ENET_QOS_ClockRoot_MuxSysPll1Div5;
-    rootCfg.div = 1U;
-    CLOCK_SetRootClock(kCLOCK_Root_Enet_Timer3, &rootCfg);
+    static const clock_root_t roots[] = {kCLOCK_Root_Enet_Qos, kCLOCK_Root_Enet_Timer3};
+    const clock_root_config_t rootCfg[] = {
+        /* Generate 125M root clock for Enet QOS */
+        /* 1G / 2 / 4 = 125M */
+        {.mux = kCLOCK_ENET_QOS_ClockRoot_MuxSysPll1Div2, .div = 4U},
+        /* Generate 200M root clock for Enet Timer3 */
+        /* 1G / 5 / 1 = 200M */
+        {.mux = kCLOCK_ENET_QOS_ClockRoot_MuxSysPll1Div5, .div = 1U},
+    };
+    qmc_mem_delta_write_t write = {.baseAddress = (uintptr_t)&CCM->CLOCK_ROOT[0].CONTROL, .segmentCount = 0U};
+    qmc_status_t ret            = kStatus_QMC_Ok;
+
+    for (size_t i = 0U; (kStatus_QMC_Ok == ret) && (i < (sizeof(roots) / sizeof(roots[0]))); i++)
+    {
+        /* same value as written by CLOCK_SetRootClock() */
+        const uint32_t oldControl = CCM->CLOCK_ROOT[roots[i]].CONTROL;
+        const uint32_t newControl = CCM_CLOCK_ROOT_CONTROL_MUX(rootCfg[i].mux) |
+                                    CCM_CLOCK_ROOT_CONTROL_DIV((uint32_t)rootCfg[i].div - 1UL);
+
+        ret = RPC_MemoryDeltaWriteAddChanges(
+            &write, (uint16_t)((uintptr_t)&CCM->CLOCK_ROOT[roots[i]].CONTROL - write.baseAddress), &oldControl,
+            &newControl, 1U);
+    }
+
+    /* nothing to do if the clock roots are configured already */
+    if ((kStatus_QMC_Ok == ret) && (0U != write.segmentCount))
+    {
+        ret = RPC_MemoryDeltaWrite(&write, NULL);
+    }
+
+    if (kStatus_QMC_Ok != ret)
+    {
+        for (size_t i = 0U; i < (sizeof(roots) / sizeof(roots[0])); i++)
+        {
+            CLOCK_SetRootClock(roots[i], &rootCfg[i]);
+        }
+    }
+    else
+    {
+        __DSB();
+        __ISB();
+    }
 }
 
 
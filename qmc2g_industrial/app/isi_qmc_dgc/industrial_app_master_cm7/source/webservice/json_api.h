@@ -11,6 +11,7 @@
 #ifndef WEBSERVICE_JSON_API_H_
 #define WEBSERVICE_JSON_API_H_
 #include "plug_json.h"
+#include "qmc_features_config.h"
 
 PLUG_JSON_CB_PROTOTYPE(json_motor_api);
 PLUG_JSON_CB_PROTOTYPE(json_log_api);
@@ -22,6 +23,13 @@ PLUG_JSON_CB_PROTOTYPE(json_user_list_api);
 PLUG_JSON_CB_PROTOTYPE(json_user_api);
 PLUG_JSON_CB_PROTOTYPE(json_motd_api);
 PLUG_JSON_CB_PROTOTYPE(json_reset_api);
+#if FEATURE_RPC_STATS
+PLUG_JSON_CB_PROTOTYPE(json_rpc_stats_api);
+void json_rpc_stats_api_init(void);
+#endif
+#if FEATURE_MC_FOC_PROFILING
+PLUG_JSON_CB_PROTOTYPE(json_foc_profile_api);
+#endif
 
 PLUG_EXTENSION_PROTOTYPE(qmc_logging);
 PLUG_EXTENSION_PROTOTYPE(qmc_fw_upload);
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "qmc_features_config.h"
+#include "api_qmc_common.h"
+#include "api_usermanagement.h"
+#include "plug_json.h"
+#include "json_string.h"
+#include "json_api_common.h"
+
+#include "mc_profile.h"
+#include "webservice/json_api_common.h"
+
+#if FEATURE_MC_FOC_PROFILING
+
+PLUG_JSON_CB(json_foc_profile_api);
+
+/**
+ * @brief FOC fast loop stage profiling debug endpoint
+ *
+ * Reports count, min / mean / max duration in CM7 cycles and the log2 histogram of the duration
+ * for every fast loop stage of every motor.
+ *
+ * @param request pointer to request struct
+ * @param json_body  pointer to validated JSON data
+ * @param json_body_len length of JSON data
+ * @param state pointer to plug_json's json_response_t.
+ * @param response output FILE
+ *
+ * @return http status code
+ */
+http_status_t json_foc_profile_api(
+    plug_request_t *request, char *json_body, u16_t json_body_len, json_response_t *state, FILE *response)
+{
+    http_status_t code              = HTTP_NOREPLY_UNPROCESSABLE_ENTITY;
+    usrmgmt_session_t *user_session = request->session;
+    static mc_profile_stats_t stats;
+    qmc_status_t status;
+
+    switch (request->method)
+    {
+        case HTTP_GET:
+            if (!user_session)
+            {
+                code = HTTP_NOREPLY_UNAUTHORIZED;
+                break;
+            }
+            if (user_session->role != kUSRMGMT_RoleMaintenance)
+            {
+                code = HTTP_NOREPLY_FORBIDDEN;
+                break;
+            }
+
+            fputs("[", response);
+            for (mc_motor_id_t motor = kMC_Motor1; motor < MC_MAX_MOTORS; motor++)
+            {
+                fprintf(response, (kMC_Motor1 == motor) ? "{\"motor\":%d,\"stages\":[" : ",\n{\"motor\":%d,\"stages\":[",
+                        (int)motor + 1);
+                for (mc_profile_stage_t stage = kMC_ProfileAdcGet; stage < kMC_ProfileStageCount; stage++)
+                {
+                    fputs((kMC_ProfileAdcGet == stage) ? "{\"stage\":" : ",{\"stage\":", response);
+                    fputs_json_string(MC_GetProfileStageName(stage), response);
+
+                    status = MC_GetProfileStats(motor, stage, &stats);
+                    if (kStatus_QMC_Ok != status)
+                    {
+                        fprintf(response, ",\"error\":\"%s\"}", webservice_error_string(status));
+                        continue;
+                    }
+                    if (0U == stats.ui32Count)
+                    {
+                        /* nothing recorded yet */
+                        fputs(",\"count\":0}", response);
+                        continue;
+                    }
+
+                    fprintf(response, ",\"count\":%lu,\"min\":%lu,\"mean\":%lu,\"max\":%lu,\"histLog2\":[",
+                            (unsigned long)stats.ui32Count, (unsigned long)stats.ui32Min,
+                            (unsigned long)(stats.ui64Sum / stats.ui32Count), (unsigned long)stats.ui32Max);
+                    for (uint32_t slot = 0U; slot < MC_PROFILE_HIST_SLOTS; slot++)
+                    {
+                        fprintf(response, (0U == slot) ? "%lu" : ",%lu", (unsigned long)stats.ui32HistLog2[slot]);
+                    }
+                    fputs("]}", response);
+                }
+                fputs("]}", response);
+            }
+            fputs("]\n", response);
+
+            code = HTTP_REPLY_OK;
+            break;
+        default:
+            break;
+    }
+    return code;
+}
+
+#endif /* FEATURE_MC_FOC_PROFILING */
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "qmc_features_config.h"
+#include "api_qmc_common.h"
+#include "api_usermanagement.h"
+#include "plug_json.h"
+#include "json_string.h"
+#include "json_api_common.h"
+
+#include "api_rpc_internal.h"
+#include "webservice/json_api_common.h"
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#if FEATURE_RPC_STATS
+
+PLUG_JSON_CB(json_rpc_stats_api);
+
+/* snapshot buffer of one call type's statistics, too large for the stack of the calling thread */
+static rpc_call_stats_t s_stats;
+static SemaphoreHandle_t s_statsMutex = NULL;
+static StaticSemaphore_t s_statsMutexBuffer;
+
+/**
+ * @brief create the mutex guarding the snapshot buffer of json_rpc_stats_api
+ *
+ * Must be called once before the web server is started.
+ */
+void json_rpc_stats_api_init(void)
+{
+    s_statsMutex = xSemaphoreCreateMutexStatic(&s_statsMutexBuffer);
+}
+
+/**
+ * @brief print a json representation of a stats structure
+ *
+ * {"min":1,"mean":2,"max":3,"absMin":1,"absMax":4}
+ *
+ * @param s the stats
+ * @param response FILE pointer
+ */
+static void print_json_stats(const struct stats *s, FILE *response)
+{
+    if (s->abs_min > s->abs_max)
+    {
+        /* nothing recorded yet */
+        fputs("null", response);
+        return;
+    }
+    fprintf(response, "{\"min\":%ld,\"mean\":%ld,\"max\":%ld,\"absMin\":%ld,\"absMax\":%ld}", (long)s->min,
+            (long)s->mean, (long)s->max, (long)s->abs_min, (long)s->abs_max);
+}
+
+/**
+ * @brief RPC latency statistics debug endpoint
+ *
+ * Reports count, timeouts, ConsistencyCheck sleeps, prepare / notify / round trip durations in CM7 cycles
+ * and the log2 histogram of the round trip duration for every remote call type.
+ *
+ * @param request pointer to request struct
+ * @param json_body  pointer to validated JSON data
+ * @param json_body_len length of JSON data
+ * @param state pointer to plug_json's json_response_t.
+ * @param response output FILE
+ *
+ * @return http status code
+ */
+http_status_t json_rpc_stats_api(
+    plug_request_t *request, char *json_body, u16_t json_body_len, json_response_t *state, FILE *response)
+{
+    http_status_t code              = HTTP_NOREPLY_UNPROCESSABLE_ENTITY;
+    usrmgmt_session_t *user_session = request->session;
+    qmc_status_t status;
+    bool first = true;
+
+    switch (request->method)
+    {
+        case HTTP_GET:
+            if (!user_session)
+            {
+                code = HTTP_NOREPLY_UNAUTHORIZED;
+                break;
+            }
+            if (user_session->role != kUSRMGMT_RoleMaintenance)
+            {
+                code = HTTP_NOREPLY_FORBIDDEN;
+                break;
+            }
+            if ((NULL == s_statsMutex) || (pdTRUE != xSemaphoreTake(s_statsMutex, 0)))
+            {
+                code = HTTP_NOREPLY_SERVICE_UNAVAILABLE;
+                break;
+            }
+
+            fputs("[", response);
+            for (rpc_stats_call_id_t id = kRPC_StatsCallSecWd; id < kRPC_StatsCallCount; id++)
+            {
+                status = RPC_GetCallStats(id, &s_stats);
+                if (kStatus_QMC_ErrRange == status)
+                {
+                    /* call not available in this configuration */
+                    continue;
+                }
+
+                fputs(first ? "{\"call\":" : ",\n{\"call\":", response);
+                first = false;
+                fputs_json_string(RPC_GetCallStatsName(id), response);
+                if (kStatus_QMC_Ok != status)
+                {
+                    fprintf(response, ",\"error\":\"%s\"}", webservice_error_string(status));
+                    continue;
+                }
+
+                fprintf(response, ",\"count\":%lu,\"timeouts\":%lu,\"consistencySleeps\":%lu,\"prepare\":",
+                        (unsigned long)s_stats.calls, (unsigned long)s_stats.timeouts,
+                        (unsigned long)s_stats.consistencySleeps);
+                print_json_stats(&s_stats.prepare, response);
+                fputs(",\"notify\":", response);
+                print_json_stats(&s_stats.notify, response);
+                fputs(",\"roundTrip\":", response);
+                print_json_stats(&s_stats.roundTrip, response);
+                fputs(",\"roundTripLog2\":[", response);
+                for (int slot = 0; slot < s_stats.roundTripLog2.n_slots; slot++)
+                {
+                    fprintf(response, (0 == slot) ? "%lu" : ",%lu", (unsigned long)s_stats.roundTripLog2.slots[slot]);
+                }
+                fputs("]}", response);
+            }
+            fputs("]\n", response);
+            xSemaphoreGive(s_statsMutex);
+
+            code = HTTP_REPLY_OK;
+            break;
+        default:
+            break;
+    }
+    return code;
+}
+
+#endif /* FEATURE_RPC_STATS */
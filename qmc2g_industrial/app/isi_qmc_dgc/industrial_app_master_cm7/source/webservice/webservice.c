@@ -72,6 +72,12 @@ static const plug_rule_t s_qmc_webservice_rules[] = {
     PLUG_RULE("./system$", HTTP_GET | HTTP_PUT | HTTP_POST, plug_json, 128, json_system_api),
     PLUG_RULE("./users/?$", HTTP_GET, plug_json, 0, json_user_list_api),
     PLUG_RULE("./users/", HTTP_GET | HTTP_PUT | HTTP_POST | HTTP_DELETE, plug_json, 512, json_user_api),
+#if FEATURE_RPC_STATS
+    PLUG_RULE("./debug/rpc$", HTTP_GET, plug_json, 0, json_rpc_stats_api),
+#endif
+#if FEATURE_MC_FOC_PROFILING
+    PLUG_RULE("./debug/foc$", HTTP_GET, plug_json, 0, json_foc_profile_api),
+#endif
 
 #if PLUG_ZIP_FS_FATFS && DEBUG
     // anything that starts with a / can be served from the webroot.zip
@@ -114,5 +120,8 @@ static void webservice_init_fn(void *ctx)
  */
 void webservice_init(void)
 {
+#if FEATURE_RPC_STATS
+    json_rpc_stats_api_init();
+#endif
     tcpip_callback(webservice_init_fn, NULL);
 }
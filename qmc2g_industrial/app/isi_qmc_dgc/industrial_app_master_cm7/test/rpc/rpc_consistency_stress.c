@@ -0,0 +1,328 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+/*!
+ * @file rpc_consistency_stress.c
+ * @brief Host stress test of the RPC completion and consistency protocol (source/rpc/rpc_api.c).
+ *
+ * Models one remote call with a CM7 task thread (PrepareCall() / ConsistencyCheck(), NotifyCM4(), WaitCM4()),
+ * a CM7 inter-core ISR thread (RPC_HandleISR()) and a CM4 thread (ProcessRpc() of the CM4 RPC module).
+ * Masking the CM7 inter-core IRQ is modelled by a mutex which the ISR thread holds while it runs.
+ * The CM4 handler sometimes takes longer than the call's timeout, so that calls time out and the next call
+ * finds the previous command still pending.
+ *
+ * Checks:
+ *  - every completed call returns the result of its own command (no stale or torn result),
+ *  - a pending command is detected and waited for without a fixed delay: the time from its completion
+ *    on the CM4 until ConsistencyCheck() returns is reported.
+ *
+ * Not part of the firmware build. Build and run on the host:
+ *     gcc -O2 -pthread -o rpc_consistency_stress rpc_consistency_stress.c && ./rpc_consistency_stress [calls]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define CALL_TIMEOUT_US      (5000U) /*!< timeout of the remote call (rpc_call_data_t::timeoutTicks) */
+#define CONSISTENCY_SPIN_US  (50U)   /*!< RPC_CONSISTENCY_SPIN_US */
+#define SLOW_HANDLER_PERMILL (20U)   /*!< share of CM4 handler runs which exceed the call timeout */
+
+/*! @brief Model of rpc_status_t plus the call's data in the shared memory. */
+typedef struct
+{
+    atomic_bool isNew;
+    atomic_bool isProcessed;
+    atomic_uint retval; /*!< echo of the command's data, identifies the command a result belongs to */
+    atomic_uint data;
+} shm_call_t;
+
+/*! @brief Model of one bit of the CM7 RPC done event group, also used for the inter-core IRQ lines. */
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool isSet;
+} event_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+static shm_call_t gs_shm = {false, true, 0U, 0U};
+static event_t gs_doneEvent = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false};
+static pthread_mutex_t gs_cm7IrqMask = PTHREAD_MUTEX_INITIALIZER; /*!< held while the CM7 inter-core IRQ is masked */
+static event_t gs_cm7Irq = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false};
+static event_t gs_cm4Irq = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, false};
+static atomic_bool gs_stop;
+static atomic_uint_least64_t gs_cm4CompletedNs; /*!< time at which the CM4 cleared isNew last */
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/*! @brief The CM4 runs on its own core, so its processing time does not take CPU time from the CM7 threads. */
+static void SleepUs(uint32_t us)
+{
+    struct timespec ts = {(time_t)(us / 1000000U), (long)(us % 1000000U) * 1000L};
+
+    (void)nanosleep(&ts, NULL);
+}
+
+static void EventClear(event_t *const pEvent)
+{
+    (void)pthread_mutex_lock(&pEvent->lock);
+    pEvent->isSet = false;
+    (void)pthread_mutex_unlock(&pEvent->lock);
+}
+
+static void EventSet(event_t *const pEvent)
+{
+    (void)pthread_mutex_lock(&pEvent->lock);
+    pEvent->isSet = true;
+    (void)pthread_cond_broadcast(&pEvent->cond);
+    (void)pthread_mutex_unlock(&pEvent->lock);
+}
+
+static bool EventWait(event_t *const pEvent, uint32_t timeoutUs)
+{
+    struct timespec ts;
+    bool isSet = false;
+    uint64_t end = 0U;
+
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    end = ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec + ((uint64_t)timeoutUs * 1000U);
+    ts.tv_sec = (time_t)(end / 1000000000U);
+    ts.tv_nsec = (long)(end % 1000000000U);
+
+    (void)pthread_mutex_lock(&pEvent->lock);
+    while (!pEvent->isSet && (0 == pthread_cond_timedwait(&pEvent->cond, &pEvent->lock, &ts)))
+    {
+        ;
+    }
+    isSet = pEvent->isSet;
+    (void)pthread_mutex_unlock(&pEvent->lock);
+
+    return isSet;
+}
+
+/*! @brief CM4 side: ProcessRpc(), run on every CM4 inter-core IRQ; retriggers itself while the CM7 is not done. */
+static void *Cm4Thread(void *arg)
+{
+    unsigned int seed = 1U;
+    (void)arg;
+
+    while (!atomic_load(&gs_stop))
+    {
+        bool sendTrigger = false;
+
+        if (!EventWait(&gs_cm4Irq, 1000U))
+        {
+            continue;
+        }
+        EventClear(&gs_cm4Irq);
+
+        if (atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed))
+        {
+            const unsigned int data = atomic_load_explicit(&gs_shm.data, memory_order_relaxed);
+
+            /* handler, sometimes slower than the call's timeout */
+            SleepUs(((unsigned int)rand_r(&seed) % 1000U) < SLOW_HANDLER_PERMILL ?
+                       CALL_TIMEOUT_US + ((unsigned int)rand_r(&seed) % (2U * CALL_TIMEOUT_US)) :
+                       (unsigned int)rand_r(&seed) % 5U);
+            atomic_store_explicit(&gs_shm.retval, data ^ 0x5A5A5A5AU, memory_order_relaxed);
+            /* HAL_DataMemoryBarrier() */
+            atomic_thread_fence(memory_order_seq_cst);
+            atomic_store_explicit(&gs_shm.isNew, false, memory_order_relaxed);
+            atomic_store(&gs_cm4CompletedNs, NowNs());
+            sendTrigger = true;
+        }
+        else if (!atomic_load_explicit(&gs_shm.isProcessed, memory_order_relaxed))
+        {
+            sendTrigger = true;
+        }
+        else
+        {
+            ;
+        }
+
+        if (sendTrigger)
+        {
+            EventSet(&gs_cm7Irq);
+            /* the CM4 keeps retriggering until the CM7 processed the result */
+            SleepUs(1U);
+            EventSet(&gs_cm4Irq);
+        }
+    }
+
+    return NULL;
+}
+
+/*! @brief CM7 side: RPC_HandleISR(), runs only while the inter-core IRQ is not masked. */
+static void *Cm7IsrThread(void *arg)
+{
+    (void)arg;
+
+    while (!atomic_load(&gs_stop))
+    {
+        if (!EventWait(&gs_cm7Irq, 1000U))
+        {
+            continue;
+        }
+
+        (void)pthread_mutex_lock(&gs_cm7IrqMask);
+        EventClear(&gs_cm7Irq);
+        if (!atomic_load_explicit(&gs_shm.isProcessed, memory_order_relaxed) &&
+            !atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed))
+        {
+            atomic_store_explicit(&gs_shm.isProcessed, true, memory_order_relaxed);
+            EventSet(&gs_doneEvent);
+        }
+        (void)pthread_mutex_unlock(&gs_cm7IrqMask);
+    }
+
+    return NULL;
+}
+
+/*! @brief RearmCompletion() */
+static void RearmCompletion(void)
+{
+    (void)pthread_mutex_lock(&gs_cm7IrqMask);
+    atomic_store_explicit(&gs_shm.isProcessed, false, memory_order_relaxed);
+    EventClear(&gs_doneEvent);
+    atomic_thread_fence(memory_order_seq_cst);
+    EventSet(&gs_cm4Irq);
+    (void)pthread_mutex_unlock(&gs_cm7IrqMask);
+}
+
+/*! @brief ConsistencyCheck(), returns true if the call is consistent; counts polls and waits. */
+static bool ConsistencyCheck(unsigned long *pPolled, unsigned long *pWaited, uint64_t *pMaxWakeNs)
+{
+    bool isConsistent = false;
+
+    if (atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed))
+    {
+        const uint64_t spinEnd = NowNs() + ((uint64_t)CONSISTENCY_SPIN_US * 1000U);
+
+        RearmCompletion();
+        while (atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed) && (NowNs() < spinEnd))
+        {
+            sched_yield();
+        }
+
+        if (atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed))
+        {
+            (*pWaited)++;
+            (void)EventWait(&gs_doneEvent, CALL_TIMEOUT_US);
+        }
+        else
+        {
+            (*pPolled)++;
+        }
+
+        if (!atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed))
+        {
+            const uint64_t wakeNs = NowNs() - atomic_load(&gs_cm4CompletedNs);
+
+            if (wakeNs > *pMaxWakeNs)
+            {
+                *pMaxWakeNs = wakeNs;
+            }
+        }
+    }
+
+    if (atomic_load_explicit(&gs_shm.isNew, memory_order_relaxed))
+    {
+        atomic_store_explicit(&gs_shm.isProcessed, true, memory_order_relaxed);
+    }
+    else
+    {
+        atomic_thread_fence(memory_order_seq_cst);
+        isConsistent = true;
+    }
+
+    return isConsistent;
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned long calls = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000UL;
+    unsigned long ok = 0U, timeouts = 0U, syncErrors = 0U, stale = 0U, polled = 0U, waited = 0U;
+    uint64_t maxWakeNs = 0U;
+    pthread_t cm4, cm7Isr;
+
+    (void)pthread_create(&cm4, NULL, Cm4Thread, NULL);
+    (void)pthread_create(&cm7Isr, NULL, Cm7IsrThread, NULL);
+
+    for (unsigned long n = 1U; n <= calls; n++)
+    {
+        /* PrepareCall() */
+        if (!ConsistencyCheck(&polled, &waited, &maxWakeNs))
+        {
+            syncErrors++;
+            continue;
+        }
+
+        /* NotifyCM4() */
+        (void)pthread_mutex_lock(&gs_cm7IrqMask);
+        atomic_store_explicit(&gs_shm.data, (unsigned int)n, memory_order_relaxed);
+        atomic_store_explicit(&gs_shm.isProcessed, false, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        atomic_store_explicit(&gs_shm.isNew, true, memory_order_relaxed);
+        EventClear(&gs_doneEvent);
+        EventSet(&gs_cm4Irq);
+        (void)pthread_mutex_unlock(&gs_cm7IrqMask);
+
+        /* WaitCM4() */
+        if (!EventWait(&gs_doneEvent, CALL_TIMEOUT_US))
+        {
+            atomic_store_explicit(&gs_shm.isProcessed, true, memory_order_relaxed);
+            timeouts++;
+        }
+        else if ((atomic_load_explicit(&gs_shm.retval, memory_order_relaxed) ^ 0x5A5A5A5AU) != (unsigned int)n)
+        {
+            stale++;
+        }
+        else
+        {
+            ok++;
+        }
+    }
+
+    atomic_store(&gs_stop, true);
+    (void)pthread_join(cm4, NULL);
+    (void)pthread_join(cm7Isr, NULL);
+
+    printf("calls %lu: ok %lu, timed out %lu, inconsistent %lu, stale or torn results %lu\n", calls, ok, timeouts,
+           syncErrors, stale);
+    printf("pending commands found: %lu completed while polling, %lu waited for on the completion event\n", polled,
+           waited);
+    printf("max time from the CM4 completing a pending command to ConsistencyCheck() returning: %.1f us\n",
+           (double)maxWakeNs / 1000.0);
+
+    return (0U == stale) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * NXP Confidential and Proprietary. This software is owned or controlled by NXP and may only be used strictly
+ * in accordance with the applicable license terms. By expressly accepting such terms or by downloading,
+ * installing, activating and/or otherwise using the software, you are agreeing that you have read,
+ * and that you agree to comply with and are bound by, such license terms. If you do not agree to be bound by
+ * the applicable license terms, then you may not retain, install, activate or otherwise use the software.
+ */
+
+/*!
+ * @file rpc_gpio_batch_test.c
+ * @brief Host protocol test of the coalesced SNVS output / SPI selection command (RPC_GpioBatch*()).
+ *
+ * The CM7 side mirrors RPC_GpioBatchAddSnvsOutput(), RPC_GpioBatchAddPowerStageBoardSpiDevice() and
+ * EncodePowerStageBoardSpiDevice() of source/rpc/rpc_api.c, the CM4 side mirrors HandleGpioOutCommand() of the
+ * CM4 RPC module. The bit layout is the one of api_rpc.h.
+ *
+ * Checks:
+ *  - a batch applied by one gpioOut command leaves the pins in the same state as applying each change
+ *    with its own command in the order the changes were added,
+ *  - each power stage board SPI device selects the expected chip-select levels,
+ *  - invalid arguments are rejected and a committed batch is empty again.
+ *
+ * Not part of the firmware build. Build and run on the host:
+ *     gcc -O2 -o rpc_gpio_batch_test rpc_gpio_batch_test.c && ./rpc_gpio_batch_test [sequences]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define RPC_DIGITAL_OUTPUT4_DATA   (UINT16_C(1) << 0U)
+#define RPC_DIGITAL_OUTPUT5_DATA   (UINT16_C(1) << 1U)
+#define RPC_DIGITAL_OUTPUT6_DATA   (UINT16_C(1) << 2U)
+#define RPC_DIGITAL_OUTPUT7_DATA   (UINT16_C(1) << 3U)
+#define RPC_DIGITAL_OUTPUT4_MODIFY (UINT16_C(1) << 4U)
+#define RPC_DIGITAL_OUTPUT5_MODIFY (UINT16_C(1) << 5U)
+#define RPC_DIGITAL_OUTPUT6_MODIFY (UINT16_C(1) << 6U)
+#define RPC_DIGITAL_OUTPUT7_MODIFY (UINT16_C(1) << 7U)
+#define RPC_SPI_CS0_DATA           (UINT16_C(1) << 8U)
+#define RPC_SPI_CS1_DATA           (UINT16_C(1) << 9U)
+#define RPC_SPI_CS0_MODIFY         (UINT16_C(1) << 10U)
+#define RPC_SPI_CS1_MODIFY         (UINT16_C(1) << 11U)
+
+#define RPC_OUTPUT_CONTROL_MASK (UINT16_C(0x0FFF))
+#define RPC_MODIFY_MASK         (UINT16_C(0x0CF0)) /*!< all modify bits */
+
+#define MAX_CHANGES_PER_BATCH (6U)
+
+typedef enum
+{
+    kStatus_QMC_Ok = 0,
+    kStatus_QMC_ErrRange,
+    kStatus_QMC_ErrArgInvalid,
+} qmc_status_t;
+
+typedef enum
+{
+    kQMC_SpiNone,
+    kQMC_SpiMotorDriver,
+    kQMC_SpiAfe,
+    kQMC_SpiAbsEncoder,
+    kQMC_SpiIdCount
+} qmc_spi_id_t;
+
+typedef struct
+{
+    uint16_t gpioState;
+} rpc_gpio_batch_t;
+
+/*! @brief Levels of the SNVS outputs 4 - 7 (bits 0 - 3) and SPI chip-selects 0 - 1 (bits 8 - 9) on the CM4. */
+static uint16_t gs_pins;
+static unsigned long gs_commands;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/*! @brief HandleGpioOutCommand() of the CM4: applies the data bit of every pin whose modify bit is set. */
+static qmc_status_t Cm4HandleGpioOut(uint16_t gpioState)
+{
+    static const uint16_t kModify[] = {RPC_DIGITAL_OUTPUT4_MODIFY, RPC_DIGITAL_OUTPUT5_MODIFY,
+                                       RPC_DIGITAL_OUTPUT6_MODIFY, RPC_DIGITAL_OUTPUT7_MODIFY,
+                                       RPC_SPI_CS0_MODIFY,         RPC_SPI_CS1_MODIFY};
+    static const uint16_t kData[]   = {RPC_DIGITAL_OUTPUT4_DATA, RPC_DIGITAL_OUTPUT5_DATA, RPC_DIGITAL_OUTPUT6_DATA,
+                                       RPC_DIGITAL_OUTPUT7_DATA, RPC_SPI_CS0_DATA,         RPC_SPI_CS1_DATA};
+
+    if (0U != (gpioState & ~RPC_OUTPUT_CONTROL_MASK))
+    {
+        return kStatus_QMC_ErrArgInvalid;
+    }
+
+    gs_commands++;
+    for (unsigned int i = 0U; i < (sizeof(kModify) / sizeof(kModify[0])); i++)
+    {
+        if (0U != (gpioState & kModify[i]))
+        {
+            gs_pins = (uint16_t)((gs_pins & ~kData[i]) | (gpioState & kData[i]));
+        }
+    }
+
+    return kStatus_QMC_Ok;
+}
+
+/*! @brief EncodePowerStageBoardSpiDevice() */
+static qmc_status_t EncodePowerStageBoardSpiDevice(qmc_spi_id_t mode, uint16_t *pGpioState)
+{
+    switch (mode)
+    {
+        case kQMC_SpiNone:
+            *pGpioState = (RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            return kStatus_QMC_Ok;
+        case kQMC_SpiMotorDriver:
+            *pGpioState = (RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            return kStatus_QMC_Ok;
+        case kQMC_SpiAfe:
+            *pGpioState = (RPC_SPI_CS0_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            return kStatus_QMC_Ok;
+        case kQMC_SpiAbsEncoder:
+            *pGpioState = (RPC_SPI_CS1_DATA | RPC_SPI_CS0_MODIFY | RPC_SPI_CS1_MODIFY);
+            return kStatus_QMC_Ok;
+        default:
+            return kStatus_QMC_ErrRange;
+    }
+}
+
+/*! @brief RPC_GpioBatchAddSnvsOutput() */
+static qmc_status_t BatchAddSnvsOutput(rpc_gpio_batch_t *batch, uint16_t gpioState)
+{
+    uint16_t dataMask = 0U;
+
+    if ((NULL == batch) || (0U != (gpioState & ~RPC_OUTPUT_CONTROL_MASK)))
+    {
+        return kStatus_QMC_ErrArgInvalid;
+    }
+
+    dataMask = ((gpioState >> 4U) & (RPC_DIGITAL_OUTPUT4_DATA | RPC_DIGITAL_OUTPUT5_DATA | RPC_DIGITAL_OUTPUT6_DATA |
+                                     RPC_DIGITAL_OUTPUT7_DATA)) |
+               ((gpioState >> 2U) & (RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA));
+    batch->gpioState = (uint16_t)((batch->gpioState & ~dataMask) | (gpioState & (dataMask | RPC_MODIFY_MASK)));
+
+    return kStatus_QMC_Ok;
+}
+
+/*! @brief RPC_GpioBatchAddPowerStageBoardSpiDevice() */
+static qmc_status_t BatchAddPowerStageBoardSpiDevice(rpc_gpio_batch_t *batch, qmc_spi_id_t mode)
+{
+    uint16_t gpioState = 0U;
+    qmc_status_t ret   = EncodePowerStageBoardSpiDevice(mode, &gpioState);
+
+    if (kStatus_QMC_Ok == ret)
+    {
+        ret = BatchAddSnvsOutput(batch, gpioState);
+    }
+
+    return ret;
+}
+
+/*! @brief RPC_GpioBatchCommitAsync() followed by RPC_WaitAsync(), the command is handled by the CM4 model. */
+static qmc_status_t BatchCommit(rpc_gpio_batch_t *batch)
+{
+    qmc_status_t ret = Cm4HandleGpioOut(batch->gpioState);
+
+    if (kStatus_QMC_Ok == ret)
+    {
+        batch->gpioState = 0U;
+    }
+
+    return ret;
+}
+
+/*! @brief A random valid change: either an SPI device selection or an SNVS output change. */
+static uint16_t RandomChange(void)
+{
+    uint16_t gpioState = 0U;
+
+    if (0 == (rand() % 3))
+    {
+        (void)EncodePowerStageBoardSpiDevice((qmc_spi_id_t)(rand() % kQMC_SpiIdCount), &gpioState);
+    }
+    else
+    {
+        gpioState = (uint16_t)(rand() & RPC_OUTPUT_CONTROL_MASK);
+    }
+
+    return gpioState;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long sequences = (argc > 1) ? strtoul(argv[1], NULL, 0) : 100000UL;
+    unsigned long failures  = 0UL;
+    rpc_gpio_batch_t batch  = {0U};
+
+    srand(1U);
+
+    /* one command per batch gives the same pin levels as one command per change */
+    for (unsigned long n = 0UL; n < sequences; n++)
+    {
+        uint16_t changes[MAX_CHANGES_PER_BATCH];
+        unsigned int count   = 1U + ((unsigned int)rand() % MAX_CHANGES_PER_BATCH);
+        uint16_t initialPins = (uint16_t)(rand() & (RPC_DIGITAL_OUTPUT4_DATA | RPC_DIGITAL_OUTPUT5_DATA |
+                                                    RPC_DIGITAL_OUTPUT6_DATA | RPC_DIGITAL_OUTPUT7_DATA |
+                                                    RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA));
+        uint16_t expectedPins;
+        unsigned long commands;
+
+        for (unsigned int i = 0U; i < count; i++)
+        {
+            changes[i] = RandomChange();
+        }
+
+        gs_pins = initialPins;
+        for (unsigned int i = 0U; i < count; i++)
+        {
+            (void)Cm4HandleGpioOut(changes[i]);
+        }
+        expectedPins = gs_pins;
+
+        gs_pins  = initialPins;
+        commands = gs_commands;
+        for (unsigned int i = 0U; i < count; i++)
+        {
+            failures += (kStatus_QMC_Ok != BatchAddSnvsOutput(&batch, changes[i])) ? 1UL : 0UL;
+        }
+        failures += (kStatus_QMC_Ok != BatchCommit(&batch)) ? 1UL : 0UL;
+
+        if ((gs_pins != expectedPins) || ((gs_commands - commands) != 1UL) || (0U != batch.gpioState))
+        {
+            if (failures < 10UL)
+            {
+                printf("sequence %lu: pins 0x%03x, expected 0x%03x\n", n, gs_pins, expectedPins);
+            }
+            failures++;
+        }
+    }
+
+    /* chip-select levels of each SPI device, selected from every other device */
+    static const uint16_t kCsLevels[kQMC_SpiIdCount] = {
+        RPC_SPI_CS0_DATA | RPC_SPI_CS1_DATA, /* kQMC_SpiNone */
+        0U,                                  /* kQMC_SpiMotorDriver */
+        RPC_SPI_CS0_DATA,                    /* kQMC_SpiAfe */
+        RPC_SPI_CS1_DATA,                    /* kQMC_SpiAbsEncoder */
+    };
+    for (int from = 0; from < kQMC_SpiIdCount; from++)
+    {
+        for (int to = 0; to < kQMC_SpiIdCount; to++)
+        {
+            gs_pins = (uint16_t)(kCsLevels[from] | RPC_DIGITAL_OUTPUT5_DATA);
+            (void)BatchAddPowerStageBoardSpiDevice(&batch, (qmc_spi_id_t)from);
+            (void)BatchAddPowerStageBoardSpiDevice(&batch, (qmc_spi_id_t)to);
+            (void)BatchCommit(&batch);
+            if (gs_pins != (kCsLevels[to] | RPC_DIGITAL_OUTPUT5_DATA))
+            {
+                printf("select %d after %d: pins 0x%03x\n", to, from, gs_pins);
+                failures++;
+            }
+        }
+    }
+
+    /* invalid arguments */
+    failures += (kStatus_QMC_ErrArgInvalid != BatchAddSnvsOutput(NULL, RPC_SPI_CS0_MODIFY)) ? 1UL : 0UL;
+    failures += (kStatus_QMC_ErrArgInvalid != BatchAddSnvsOutput(&batch, UINT16_C(1) << 12U)) ? 1UL : 0UL;
+    failures += (kStatus_QMC_ErrRange != BatchAddPowerStageBoardSpiDevice(&batch, kQMC_SpiIdCount)) ? 1UL : 0UL;
+    failures += (0U != batch.gpioState) ? 1UL : 0UL;
+
+    printf("%lu random batches, %d chip-select transitions: %lu failures\n", sequences,
+           kQMC_SpiIdCount * kQMC_SpiIdCount, failures);
+
+    return (0UL == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -243,6 +243,8 @@ typedef enum
  * Definitions => Related to Structures
  ******************************************************************************/
 #define QMC_MEM_WRITE_MAX_DATA_WORDS (16U)
+#define QMC_MEM_DELTA_WRITE_MAX_SEGMENTS   (8U)
+#define QMC_MEM_DELTA_WRITE_MAX_DATA_WORDS (32U)
 
 /*******************************************************************************
  * Definitions => Structures
@@ -309,6 +311,30 @@ typedef struct _qmc_mem_write
     uint8_t accessSize;
 } qmc_mem_write_t;
 
+/*!
+ * @brief Describes one segment of a memory delta write request.
+ *
+ * The segment's data words are stored consecutively in qmc_mem_delta_write_t.data, directly
+ * following the data words of the preceding segment.
+ */
+typedef struct _qmc_mem_delta_segment
+{
+    uint16_t offset;     /*!< Byte offset of the segment relative to qmc_mem_delta_write_t.baseAddress. */
+    uint8_t  dataWords;  /*!< Number of data words of the segment (must be 1 for byte or halfword accesses). */
+    uint8_t  accessSize; /*!< Access size in bytes (1, 2 or 4). */
+} qmc_mem_delta_segment_t;
+
+/*!
+ * @brief Represents a memory delta write request consisting of multiple segments relative to a common base address.
+ */
+typedef struct _qmc_mem_delta_write
+{
+    uintptr_t               baseAddress;
+    qmc_mem_delta_segment_t segments[QMC_MEM_DELTA_WRITE_MAX_SEGMENTS];
+    uint32_t                data[QMC_MEM_DELTA_WRITE_MAX_DATA_WORDS];
+    uint8_t                 segmentCount;
+} qmc_mem_delta_write_t;
+
 /*******************************************************************************
  * Definitions => Other
  ******************************************************************************/
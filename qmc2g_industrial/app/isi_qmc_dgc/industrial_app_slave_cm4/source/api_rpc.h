@@ -84,7 +84,8 @@
         .events = RPC_EVENT_STATIC_INIT, RPC_SHM_CALL_DATA_STATIC_INIT(funcWd), RPC_SHM_CALL_DATA_STATIC_INIT(secWd), \
         RPC_SHM_CALL_DATA_STATIC_INIT(gpioOut), RPC_SHM_CALL_DATA_STATIC_INIT(rtc),                                   \
         RPC_SHM_CALL_DATA_STATIC_INIT(fwUpdate), RPC_SHM_CALL_DATA_STATIC_INIT(reset),                                \
-        RPC_SHM_CALL_DATA_STATIC_INIT(mcuTemp), RPC_SHM_CALL_DATA_STATIC_INIT(memWrite)                               \
+        RPC_SHM_CALL_DATA_STATIC_INIT(mcuTemp), RPC_SHM_CALL_DATA_STATIC_INIT(memWrite),                              \
+        RPC_SHM_CALL_DATA_STATIC_INIT(memDeltaWrite)                                                                  \
     }
 
 /*!
@@ -218,6 +219,17 @@ typedef struct _rpc_mem_write_t
     qmc_mem_write_t write;
 } rpc_mem_write_t;
 
+/*!
+ * @brief Holds parameters of the RPC_MemoryDeltaWrite(write : qmc_mem_delta_write_t*, ackMask : uint32_t*) : qmc_status_t function.
+ */
+typedef struct _rpc_mem_delta_write_t
+{
+    rpc_status_t          status;
+    qmc_mem_delta_write_t write;
+    uint32_t              segmentCrc[QMC_MEM_DELTA_WRITE_MAX_SEGMENTS]; /*!< CRC-32 over each segment descriptor and its data words. */
+    uint32_t              ackMask;                                      /*!< Bit n set if segment n has been applied. */
+} rpc_mem_delta_write_t;
+
 /*!
  * @brief This structure is meant to be instantiated once as a global variable. It acts as a the shared memory interface between Cortex M4 and Cortex M7 cores.
  */
@@ -233,8 +245,20 @@ typedef struct _rpc_shm
     rpc_reset_t    reset     __attribute__ ((aligned)); /*!< Holds parameters of the RPC_Reset(cause : qmc_reset_cause_id_t) : qmc_status_t function. */
     rpc_mcu_temp_t mcuTemp   __attribute__ ((aligned)); /*!< Holds parameters of the RPC_GetMcuTemperature(temp : float*) : qmc_status_t function. */
     rpc_mem_write_t memWrite __attribute__ ((aligned)); /*!< Holds parameters of the RPC_MemoryWriteIntsDisabled(write : qmc_mem_write_t*) : qmc_status_t function. */
+    rpc_mem_delta_write_t memDeltaWrite __attribute__ ((aligned)); /*!< Holds parameters of the RPC_MemoryDeltaWrite(write : qmc_mem_delta_write_t*, ackMask : uint32_t*) : qmc_status_t function. */
 } rpc_shm_t;
 
+/*!
+ * @brief Completion token of an asynchronously posted remote call.
+ *
+ * Returned by the *Async functions. The remote call stays locked until the token is passed to RPC_WaitAsync(),
+ * which must be done exactly once by the task which posted the call.
+ */
+typedef struct _rpc_async_token
+{
+    const void *pCallData; /*!< Remote call the token belongs to, NULL if no call is pending. */
+} rpc_async_token_t;
+
 
 
 /*******************************************************************************
@@ -329,6 +353,51 @@ qmc_status_t RPC_RequestNonceFromSecureWatchdog(uint8_t *nonce, size_t *length);
  */
 qmc_status_t RPC_SelectPowerStageBoardSpiDevice(qmc_spi_id_t mode);
 
+/*!
+ * @brief Asynchronous variant of RPC_SelectPowerStageBoardSpiDevice().
+ *
+ * Posts the request to the CM4 and returns without waiting for the inter-core round trip. The result
+ * must be collected with RPC_WaitAsync() before the selected SPI device is accessed.
+ *
+ * @param[in] mode The SPI device to be selected
+ * @param[out] token Completion token of the posted request
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_Timeout
+ * Acquiring a mutex timed out.
+ * @retval kStatus_QMC_ErrSync
+ * Trying to recover the remote call from a previous timeout failed.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * A given pointer was NULL.
+ * @retval kStatus_QMC_ErrRange
+ * Specified mode was not part of the supported enumeration.
+ * @retval kStatus_QMC_Ok
+ * The request was posted, the token is valid.
+ */
+qmc_status_t RPC_SelectPowerStageBoardSpiDeviceAsync(qmc_spi_id_t mode, rpc_async_token_t *token);
+
+/*!
+ * @brief Checks without blocking whether the CM4 finished an asynchronously posted remote call.
+ *
+ * @param[in] token Completion token of the posted request
+ * @return true if the result is available and RPC_WaitAsync() will return immediately.
+ */
+bool RPC_IsAsyncCompleted(const rpc_async_token_t *token);
+
+/*!
+ * @brief Waits for an asynchronously posted remote call and returns its result.
+ *
+ * Releases the remote call, the token is invalid afterwards.
+ *
+ * @param[in,out] token Completion token of the posted request
+ * @return A qmc_status_t status code.
+ * @retval kStatus_QMC_Timeout
+ * Command execution on the CM4 timed out.
+ * @retval kStatus_QMC_ErrArgInvalid
+ * The token is NULL or does not belong to a pending call.
+ * @retval Any return value the remote command might return.
+ */
+qmc_status_t RPC_WaitAsync(rpc_async_token_t *token);
+
 /*!
  * @brief Request a timestamp from the real time clock implemented in the CM4 core.
  *
@@ -149,6 +149,7 @@ static qmc_status_t HandleFirmwareUpdateCommand(volatile void *const pArg, bool
 static qmc_status_t HandleResetCommand(volatile void *const pArg, bool *const pAsynchronous);
 static qmc_status_t HandleMcuTempCommand(volatile void *const pArg, bool *const pAsynchronous);
 static qmc_status_t HandleMemWriteCommand(volatile void *const pArg, bool *const pAsynchronous);
+static qmc_status_t HandleMemDeltaWriteCommand(volatile void *const pArg, bool *const pAsynchronous);
 
 /*******************************************************************************
  * Variables
@@ -181,6 +182,9 @@ static const rpc_call_info_t gs_kMcuTempCallInfo = {&g_rpcSHM.mcuTemp.status, &g
  * It is not necessary to trigger the M7 as it pools for the result in case of this RPC. */
 static const rpc_call_info_t gs_kMemWriteCallInfo = {&g_rpcSHM.memWrite.status, &g_rpcSHM.memWrite, false,
                                                      HandleMemWriteCommand};
+/*! @brief Data for maintaining the memory delta write RPC */
+static const rpc_call_info_t gs_kMemDeltaWriteCallInfo = {&g_rpcSHM.memDeltaWrite.status, &g_rpcSHM.memDeltaWrite, true,
+                                                          HandleMemDeltaWriteCommand};
 
 /*!
  * @brief Registers all available RPCs.
@@ -191,7 +195,7 @@ static const rpc_call_info_t *const gs_kRpcInfoPointers[] = {
     &gs_kSecWdCallInfo,
 #endif
     &gs_kFuncWdCallInfo, &gs_kGpioOutCallInfo, &gs_kRtcCallInfo, &gs_kFwUpdateCallInfo,
-    &gs_kResetCallInfo,  &gs_kMcuTempCallInfo, &gs_kMemWriteCallInfo};
+    &gs_kResetCallInfo,  &gs_kMcuTempCallInfo, &gs_kMemWriteCallInfo, &gs_kMemDeltaWriteCallInfo};
 
 /*! @brief Soft MPU for checking accesses performed with the memory write RPC 
  *  
@@ -1058,3 +1062,106 @@ static qmc_status_t HandleMemWriteCommand(volatile void *const pArg, bool *const
 
     return kStatus_QMC_Ok;
 }
+
+/*!
+ * @brief Processes a pending memory delta write command.
+ *
+ * Applies all segments of the rpc_mem_delta_write_t struct in place, relative to its base address.
+ * Before any write is performed, the CRC-32 of every segment (descriptor and data words) is checked
+ * against the one computed by the M7 application, so that a corrupted request is rejected as a whole.
+ * Bit n of the acknowledge mask is set if segment n has been applied.
+ *
+ * The same access restrictions as for HandleMemWriteCommand() apply (see gs_kMemWriteRpcMPU).
+ * Forbidden accesses are seen as security violation and the system will be reset with
+ * "kQMC_ResetSecureWd" as reason.
+ *
+ * @param[in,out] pArg Pointer to a rpc_mem_delta_write_t struct (member of rpc_shm_t).
+ * @param[out] pAsynchronous Pointer to a bool, if set true the user has to manually
+ *  notify the CM7 about the result of the operation using the ReturnAsynchronous() function.
+ *  Useful if part of the operation is performed asynchronously from the communication interrupt
+ *  context. Note that if this handler function fails, then the result is directly
+ *  returned synchronously.
+ * @return A qmc_status_t status code.
+ *         In case of a forbidden access the system is reset with "kQMC_ResetSecureWd" as reason.
+ * @retval kStatus_QMC_Ok
+ * All segments were applied.
+ * @retval kStatus_QMC_ErrRange
+ * Too many segments or data words were given; nothing was applied.
+ * @retval kStatus_QMC_ErrSync
+ * A segment's CRC did not match; nothing was applied.
+ */
+static qmc_status_t HandleMemDeltaWriteCommand(volatile void *const pArg, bool *const pAsynchronous)
+{
+    assert((NULL != pArg) && (NULL != pAsynchronous));
+    (void)pAsynchronous;
+
+    qmc_status_t ret                                        = kStatus_QMC_Ok;
+    volatile rpc_mem_delta_write_t *const pRpcMemDeltaWrite = pArg;
+    size_t dataIdx                                          = 0U;
+
+    DEBUG_LOG_I(DEBUG_M4_TAG "HandleMemDeltaWriteCommand called!\r\n");
+
+    pRpcMemDeltaWrite->ackMask = 0U;
+
+    /* latch */
+    qmc_mem_delta_write_t write = pRpcMemDeltaWrite->write;
+
+    if ((0U == write.segmentCount) || (write.segmentCount > QMC_MEM_DELTA_WRITE_MAX_SEGMENTS))
+    {
+        ret = kStatus_QMC_ErrRange;
+    }
+
+    /* verify all segments before touching any memory */
+    for (size_t seg = 0U; (kStatus_QMC_Ok == ret) && (seg < write.segmentCount); seg++)
+    {
+        const qmc_mem_delta_segment_t *const pSegment = &write.segments[seg];
+
+        if ((0U == pSegment->dataWords) || (pSegment->dataWords > (QMC_MEM_DELTA_WRITE_MAX_DATA_WORDS - dataIdx)))
+        {
+            ret = kStatus_QMC_ErrRange;
+            break;
+        }
+
+        uint32_t crc = crc32Update(0U, pSegment, sizeof(qmc_mem_delta_segment_t));
+        crc          = crc32Update(crc, &write.data[dataIdx], ((size_t)pSegment->dataWords) * sizeof(uint32_t));
+        if (crc != pRpcMemDeltaWrite->segmentCrc[seg])
+        {
+            ret = kStatus_QMC_ErrSync;
+            break;
+        }
+
+        /* an access smaller than a word must be at most one word */
+        if (((pSegment->accessSize < sizeof(uint32_t)) && (1U != pSegment->dataWords)) ||
+            (pSegment->accessSize > sizeof(uint32_t)))
+        {
+            /* security violation -> trigger secure watchdog reset */
+            QMC_CM4_ResetSystemIntsDisabled(kQMC_ResetSecureWd);
+        }
+
+        dataIdx += pSegment->dataWords;
+    }
+
+    /* apply in place */
+    if (kStatus_QMC_Ok == ret)
+    {
+        dataIdx = 0U;
+        for (size_t seg = 0U; seg < write.segmentCount; seg++)
+        {
+            const qmc_mem_delta_segment_t *const pSegment = &write.segments[seg];
+            const uintptr_t address                       = write.baseAddress + pSegment->offset;
+
+            for (size_t i = 0U; i < pSegment->dataWords; i++)
+            {
+                secureMemWrite(address + (i * sizeof(uint32_t)), write.data[dataIdx + i], pSegment->accessSize);
+            }
+            dataIdx += pSegment->dataWords;
+        }
+
+        /* ensure the memory writes have retired before giving control back to the M7 application */
+        HAL_DataSynchronizationBarrier();
+
+        pRpcMemDeltaWrite->ackMask = (1UL << write.segmentCount) - 1UL;
+    }
+
+    return ret;
+}
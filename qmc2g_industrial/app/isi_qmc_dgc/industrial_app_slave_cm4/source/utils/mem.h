@@ -14,7 +14,7 @@
  *
  * Includes memset and memcpy versions which support volatile pointers.
  * Further, it provides functions to unpack a uint32_t from a byte array 
- * (for both little and big-endian).
+ * (for both little and big-endian) and a CRC-32 over a memory region.
  */
 
 #ifndef _MEM_H_
@@ -101,4 +101,34 @@ static inline uint32_t unpackU32BigEndian(const uint8_t *const pSrc)
     return ((uint32_t)pSrc[0U] << 24U) | ((uint32_t)pSrc[1U] << 16U) | ((uint32_t)pSrc[2U] << 8U) |  (uint32_t)pSrc[3U];
 }
 
+/*!
+ * @brief Updates a CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) with a memory region.
+ *
+ * Bitwise implementation without lookup table; intended for short buffers only.
+ * Start with crc = 0 and chain further calls with the previously returned value.
+ *
+ * @param crc The CRC value returned by the previous call, 0 for the first call.
+ * @param pSrc Pointer to the start of the memory region.
+ * @param len The length of the memory region.
+ * @return uint32_t The updated CRC value.
+ *
+ */
+static inline uint32_t crc32Update(uint32_t crc, volatile const void *const pSrc, size_t len)
+{
+    assert((NULL != pSrc) || (0U == len));
+
+    volatile const uint8_t *const pSrcByte = pSrc;
+    crc = ~crc;
+    for (size_t off = 0U; off < len; off++)
+    {
+        crc ^= pSrcByte[off];
+        for (uint8_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = (crc >> 1U) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+
+    return ~crc;
+}
+
 #endif /* _MEM_H_ */
@@ -50,7 +50,8 @@
         .events = RPC_EVENT_STATIC_INIT, RPC_SHM_CALL_DATA_STATIC_INIT(funcWd), RPC_SHM_CALL_DATA_STATIC_INIT(secWd), \
         RPC_SHM_CALL_DATA_STATIC_INIT(gpioOut), RPC_SHM_CALL_DATA_STATIC_INIT(rtc),                                   \
         RPC_SHM_CALL_DATA_STATIC_INIT(fwUpdate), RPC_SHM_CALL_DATA_STATIC_INIT(reset),                                \
-        RPC_SHM_CALL_DATA_STATIC_INIT(mcuTemp), RPC_SHM_CALL_DATA_STATIC_INIT(memWrite)                               \
+        RPC_SHM_CALL_DATA_STATIC_INIT(mcuTemp), RPC_SHM_CALL_DATA_STATIC_INIT(memWrite),                              \
+        RPC_SHM_CALL_DATA_STATIC_INIT(memDeltaWrite)                                                                  \
     }
 
 /*!
@@ -184,6 +185,17 @@ typedef struct _rpc_mem_write_t
     qmc_mem_write_t write;
 } rpc_mem_write_t;
 
+/*!
+ * @brief Holds parameters of the RPC_MemoryDeltaWrite(write : qmc_mem_delta_write_t*, ackMask : uint32_t*) : qmc_status_t function.
+ */
+typedef struct _rpc_mem_delta_write_t
+{
+    rpc_status_t          status;
+    qmc_mem_delta_write_t write;
+    uint32_t              segmentCrc[8U];                               /*!< CRC-32 over each segment descriptor and its data words. */
+    uint32_t              ackMask;                                      /*!< Bit n set if segment n has been applied. */
+} rpc_mem_delta_write_t;
+
 /*!
  * @brief This structure is meant to be instantiated once as a global variable. It acts as a the shared memory interface between Cortex M4 and Cortex M7 cores.
  */
@@ -199,6 +211,7 @@ typedef struct _rpc_shm
     rpc_reset_t    reset     __attribute__ ((aligned)); /*!< Holds parameters of the RPC_Reset(cause : qmc_reset_cause_id_t) : qmc_status_t function. */
     rpc_mcu_temp_t mcuTemp   __attribute__ ((aligned)); /*!< Holds parameters of the RPC_GetMcuTemperature(temp : float*) : qmc_status_t function. */
     rpc_mem_write_t memWrite __attribute__ ((aligned)); /*!< Holds parameters of the RPC_MemoryWriteIntsDisabled(write : qmc_mem_write_t*) : qmc_status_t function. */
+    rpc_mem_delta_write_t memDeltaWrite __attribute__ ((aligned)); /*!< Holds parameters of the RPC_MemoryDeltaWrite(write : qmc_mem_delta_write_t*, ackMask : uint32_t*) : qmc_status_t function. */
 } rpc_shm_t;
 
 /*!
@@ -345,6 +345,27 @@ typedef struct _qmc_mem_write
     uint8_t accessSize;
 } qmc_mem_write_t;
 
+/*!
+ * @brief Describes one segment of a memory delta write request.
+ */
+typedef struct _qmc_mem_delta_segment
+{
+    uint16_t offset;
+    uint8_t  dataWords;
+    uint8_t  accessSize;
+} qmc_mem_delta_segment_t;
+
+/*!
+ * @brief Represents a memory delta write request.
+ */
+typedef struct _qmc_mem_delta_write
+{
+    uintptr_t               baseAddress;
+    qmc_mem_delta_segment_t segments[8U];
+    uint32_t                data[32U];
+    uint8_t                 segmentCount;
+} qmc_mem_delta_write_t;
+
 //------------------------------------------------------------------------------
 // Global Variables
 //------------------------------------------------------------------------------